@@ -0,0 +1,120 @@
+/**
+ * @file action_hash_bench.c
+ * @brief Cost of msgpack-encoding and hashing an L1 action
+ *
+ * Times hl_build_order_hash and hl_build_cancel_hash per action, and
+ * hl_build_action_hashes over groups of eight. "keccak only" hashes a
+ * preimage of the same length as the single order, so the difference is
+ * what the encoder costs. The order hash is checked against a known
+ * answer (msgpack-c and Python msgpack agree on it) before timing.
+ *
+ * Usage: action_hash_bench [iterations]
+ */
+
+#define _GNU_SOURCE
+
+#include "hl_msgpack.h"
+#include "hl_crypto_internal.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define BENCH_NONCE 1700000000000ULL
+#define BATCH_SIZE 8
+#define CANCEL_COUNT 20
+
+// msgpack({"type":"order","orders":[...],"grouping":"na"}) || nonce || 0x00
+#define ORDER_PREIMAGE_LEN 85
+
+static const char* ORDER_HASH_HEX =
+    "70b7e49c893d7c40b5327d99b732dd19540753cb7afa3e0dde46c244ae496657";
+
+static uint64_t mono_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+static void report(const char* name, uint64_t elapsed_ns, size_t iterations) {
+    printf("%-24s %9.0f ns/op %12.0f op/s\n", name,
+           (double)elapsed_ns / (double)iterations,
+           (double)iterations * 1e9 / (double)elapsed_ns);
+}
+
+int main(int argc, char** argv) {
+    size_t iterations = argc > 1 ? strtoul(argv[1], NULL, 10) : 200000;
+    if (iterations == 0) {
+        iterations = 1;
+    }
+
+    hl_order_request_t order = {
+        .a = 3, .b = true, .p = "187.25", .s = "12.5", .r = false, .limit = {.tif = "Gtc"}
+    };
+    hl_cancel_t cancels[CANCEL_COUNT];
+    for (size_t i = 0; i < CANCEL_COUNT; i++) {
+        cancels[i].a = (uint32_t)i;
+        cancels[i].o = 91234567890ULL + i;
+    }
+
+    uint8_t hash[32];
+    char hex[65];
+    hl_build_order_hash(&order, 1, "na", BENCH_NONCE, NULL, hash);
+    bytes_to_hex(hash, 32, hex, false);
+    if (strcmp(hex, ORDER_HASH_HEX) != 0) {
+        fprintf(stderr, "order hash mismatch: %s\n", hex);
+        return 1;
+    }
+
+    hl_order_action_t action = {.orders = &order, .orders_count = 1, .grouping = "na"};
+    hl_action_hash_request_t requests[BATCH_SIZE];
+    uint8_t hashes[BATCH_SIZE][32];
+    for (size_t i = 0; i < BATCH_SIZE; i++) {
+        requests[i].action_type = "order";
+        requests[i].action_data = &action;
+        requests[i].nonce = BENCH_NONCE + i;
+        requests[i].vault_address = NULL;
+    }
+
+    // The batch must agree with one hash at a time
+    hl_build_action_hashes(requests, BATCH_SIZE, hashes);
+    for (size_t i = 0; i < BATCH_SIZE; i++) {
+        hl_build_order_hash(&order, 1, "na", requests[i].nonce, NULL, hash);
+        if (memcmp(hash, hashes[i], 32) != 0) {
+            fprintf(stderr, "batch mismatch at %zu\n", i);
+            return 1;
+        }
+    }
+
+    printf("%zu iterations\n\n", iterations);
+
+    uint8_t preimage[ORDER_PREIMAGE_LEN] = {0};
+    uint64_t start = mono_ns();
+    for (size_t i = 0; i < iterations; i++) {
+        preimage[0] = (uint8_t)i;
+        keccak256(preimage, sizeof(preimage), hash);
+    }
+    report("keccak only", mono_ns() - start, iterations);
+
+    start = mono_ns();
+    for (size_t i = 0; i < iterations; i++) {
+        hl_build_order_hash(&order, 1, "na", BENCH_NONCE + i, NULL, hash);
+    }
+    report("order", mono_ns() - start, iterations);
+
+    start = mono_ns();
+    for (size_t i = 0; i < iterations; i++) {
+        hl_build_cancel_hash(cancels, CANCEL_COUNT, BENCH_NONCE + i, NULL, hash);
+    }
+    report("cancel x20", mono_ns() - start, iterations);
+
+    start = mono_ns();
+    for (size_t i = 0; i < iterations; i += BATCH_SIZE) {
+        requests[0].nonce = BENCH_NONCE + i;
+        hl_build_action_hashes(requests, BATCH_SIZE, hashes);
+    }
+    report("order, batches of 8", mono_ns() - start,
+           (iterations + BATCH_SIZE - 1) / BATCH_SIZE * BATCH_SIZE);
+
+    return 0;
+}
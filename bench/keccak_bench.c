@@ -0,0 +1,166 @@
+/**
+ * @file keccak_bench.c
+ * @brief Keccak-256 throughput for the input sizes signing actually hashes
+ *
+ * Inputs of 32 to 200 bytes cover the agent struct (96), the EIP-712
+ * envelope (66), public keys (64) and typical msgpack actions. The
+ * "loop" and "unrolled" columns run the same one-shot sponge over each
+ * permutation; "keccak256" is the library entry point, which uses
+ * whichever permutation the library was built with.
+ *
+ * A second table hashes batches of 64 inputs through keccak256_batch_with
+ * at each width the CPU supports.
+ *
+ * Usage: keccak_bench [iterations]
+ */
+
+#define _GNU_SOURCE
+
+#include "hl_crypto_internal.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define KECCAK256_RATE 136
+
+typedef void (*permutation_fn)(uint64_t s[25]);
+
+static uint64_t mono_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+static uint64_t load_le64(const uint8_t* p) {
+    uint64_t v = 0;
+    for (int i = 7; i >= 0; i--) {
+        v = (v << 8) | p[i];
+    }
+    return v;
+}
+
+/**
+ * @brief One-shot keccak256 over a given permutation
+ */
+static void sponge_keccak256(permutation_fn permute, const uint8_t* input, size_t len,
+                             uint8_t out[32]) {
+    uint64_t s[25] = {0};
+
+    while (len >= KECCAK256_RATE) {
+        for (size_t i = 0; i < KECCAK256_RATE / 8; i++) {
+            s[i] ^= load_le64(input + 8 * i);
+        }
+        permute(s);
+        input += KECCAK256_RATE;
+        len -= KECCAK256_RATE;
+    }
+
+    uint8_t block[KECCAK256_RATE] = {0};
+    memcpy(block, input, len);
+    block[len] ^= 0x01;
+    block[KECCAK256_RATE - 1] ^= 0x80;
+    for (size_t i = 0; i < KECCAK256_RATE / 8; i++) {
+        s[i] ^= load_le64(block + 8 * i);
+    }
+    permute(s);
+
+    for (size_t i = 0; i < 32; i++) {
+        out[i] = (uint8_t)(s[i / 8] >> (8 * (i % 8)));
+    }
+}
+
+static double rate_sponge(permutation_fn permute, uint8_t* input, size_t len, size_t iterations) {
+    uint8_t digest[32];
+    uint64_t start = mono_ns();
+    for (size_t i = 0; i < iterations; i++) {
+        sponge_keccak256(permute, input, len, digest);
+        input[0] = digest[0];           // Chain so the loop cannot be hoisted
+    }
+    return (double)iterations * 1e9 / (double)(mono_ns() - start);
+}
+
+static double rate_library(uint8_t* input, size_t len, size_t iterations) {
+    uint8_t digest[32];
+    uint64_t start = mono_ns();
+    for (size_t i = 0; i < iterations; i++) {
+        keccak256(input, len, digest);
+        input[0] = digest[0];
+    }
+    return (double)iterations * 1e9 / (double)(mono_ns() - start);
+}
+
+static double rate_batch(size_t ways, const uint8_t* const* inputs, const size_t* lengths,
+                         size_t count, uint8_t (*digests)[32], size_t iterations) {
+    size_t rounds = iterations / count ? iterations / count : 1;
+    uint64_t start = mono_ns();
+    for (size_t i = 0; i < rounds; i++) {
+        keccak256_batch_with(ways, inputs, lengths, count, digests);
+    }
+    return (double)(rounds * count) * 1e9 / (double)(mono_ns() - start);
+}
+
+int main(int argc, char** argv) {
+    size_t iterations = argc > 1 ? strtoul(argv[1], NULL, 10) : 200000;
+    if (iterations == 0) {
+        iterations = 1;
+    }
+
+    static const size_t lengths[] = {32, 64, 66, 96, 128, 160, 200};
+    uint8_t input[200];
+    for (size_t i = 0; i < sizeof(input); i++) {
+        input[i] = (uint8_t)(i * 131 + 7);
+    }
+
+    // The sponges must agree with the library before anything is timed
+    for (size_t i = 0; i < sizeof(lengths) / sizeof(lengths[0]); i++) {
+        uint8_t a[32], b[32], c[32];
+        sponge_keccak256(keccakf_loop, input, lengths[i], a);
+        sponge_keccak256(keccakf_unrolled, input, lengths[i], b);
+        keccak256(input, lengths[i], c);
+        if (memcmp(a, b, 32) != 0 || memcmp(a, c, 32) != 0) {
+            fprintf(stderr, "digest mismatch at %zu bytes\n", lengths[i]);
+            return 1;
+        }
+    }
+
+    printf("%zu hashes per size, hashes/s\n\n", iterations);
+    printf("%6s %14s %14s %14s %9s\n", "bytes", "loop", "unrolled", "keccak256", "speedup");
+
+    for (size_t i = 0; i < sizeof(lengths) / sizeof(lengths[0]); i++) {
+        double loop = rate_sponge(keccakf_loop, input, lengths[i], iterations);
+        double unrolled = rate_sponge(keccakf_unrolled, input, lengths[i], iterations);
+        double library = rate_library(input, lengths[i], iterations);
+        printf("%6zu %14.0f %14.0f %14.0f %8.2fx\n", lengths[i], loop, unrolled, library,
+               unrolled / loop);
+    }
+
+    enum { BATCH = 64 };
+    static const size_t widths[] = {1, 4, 8};
+    const uint8_t* batch_inputs[BATCH];
+    size_t batch_lengths[BATCH];
+    uint8_t digests[BATCH][32];
+    size_t supported = keccak256_batch_ways();
+
+    printf("\nbatches of %d, hashes/s (CPU supports %zu-wide)\n\n", BATCH, supported);
+    printf("%6s %14s %14s %14s\n", "bytes", "1-wide", "4-wide", "8-wide");
+
+    for (size_t i = 0; i < sizeof(lengths) / sizeof(lengths[0]); i++) {
+        for (size_t j = 0; j < BATCH; j++) {
+            batch_inputs[j] = input;
+            batch_lengths[j] = lengths[i];
+        }
+        printf("%6zu", lengths[i]);
+        for (size_t w = 0; w < sizeof(widths) / sizeof(widths[0]); w++) {
+            if (widths[w] > supported) {
+                printf(" %14s", "-");
+                continue;
+            }
+            printf(" %14.0f", rate_batch(widths[w], batch_inputs, batch_lengths, BATCH, digests,
+                                         iterations));
+        }
+        printf("\n");
+    }
+
+    return 0;
+}
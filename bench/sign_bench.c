@@ -0,0 +1,121 @@
+/**
+ * @file sign_bench.c
+ * @brief Cost of signing an L1 action, digest and ECDSA separately
+ *
+ * "recompute" rebuilds the EIP-712 domain hash and hashes the agent source
+ * for every action, as signing used to. "precomputed" is the library path
+ * (eip712_agent_signing_hash), where both are constants and only the agent
+ * struct hash and the signing hash are computed per action. Both must
+ * produce the same signature.
+ *
+ * Usage: sign_bench [iterations]
+ */
+
+#define _GNU_SOURCE
+
+#include "hl_crypto_internal.h"
+#include "hl_signer.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define BENCH_KEY "0x4c0883a69102937d6231471b5dbb6204fe5129617082792ae468d01a3f362318"
+
+static uint64_t mono_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+/**
+ * @brief Distinct connection id per iteration, like distinct nonces would give
+ */
+static void connection_id_for(size_t i, uint8_t connection_id[32]) {
+    memset(connection_id, 0xab, 32);
+    memcpy(connection_id, &i, sizeof(i));
+}
+
+/**
+ * @brief Signing digest with every EIP-712 component rebuilt
+ */
+static void digest_recompute(const uint8_t connection_id[32], uint8_t out[32]) {
+    uint8_t domain_hash[32];
+    uint8_t struct_hash[32];
+    eip712_domain_hash("Exchange", 1337, domain_hash);
+    eip712_agent_struct_hash("a", connection_id, struct_hash);
+    eip712_signing_hash(domain_hash, struct_hash, out);
+}
+
+static void report(const char* name, uint64_t elapsed_ns, size_t iterations) {
+    printf("%-24s %9.2f us/op %12.0f op/s\n", name,
+           (double)elapsed_ns / (double)iterations / 1000.0,
+           (double)iterations * 1e9 / (double)elapsed_ns);
+}
+
+int main(int argc, char** argv) {
+    size_t iterations = argc > 1 ? strtoul(argv[1], NULL, 10) : 20000;
+    if (iterations == 0) {
+        iterations = 1;
+    }
+
+    hl_signer_t* signer = hl_signer_create(BENCH_KEY);
+    if (!signer) {
+        fprintf(stderr, "cannot create signer\n");
+        return 1;
+    }
+
+    uint8_t connection_id[32];
+    uint8_t digest[32];
+    uint8_t expected[32];
+    uint8_t sig_before[65];
+    uint8_t sig_after[65];
+
+    // Both digest paths must agree before either is timed
+    for (size_t i = 0; i < 64; i++) {
+        connection_id_for(i, connection_id);
+        digest_recompute(connection_id, expected);
+        eip712_agent_signing_hash("Exchange", 1337, "a", connection_id, digest);
+        hl_signer_sign_hash(signer, expected, sig_before);
+        eip712_sign_agent_signer(signer, "Exchange", 1337, "a", connection_id, sig_after);
+        if (memcmp(digest, expected, 32) != 0 || memcmp(sig_before, sig_after, 65) != 0) {
+            fprintf(stderr, "digest mismatch at %zu\n", i);
+            hl_signer_destroy(signer);
+            return 1;
+        }
+    }
+
+    printf("%zu iterations\n\n", iterations);
+
+    uint64_t start = mono_ns();
+    for (size_t i = 0; i < iterations; i++) {
+        connection_id_for(i, connection_id);
+        digest_recompute(connection_id, digest);
+    }
+    report("digest recompute", mono_ns() - start, iterations);
+
+    start = mono_ns();
+    for (size_t i = 0; i < iterations; i++) {
+        connection_id_for(i, connection_id);
+        eip712_agent_signing_hash("Exchange", 1337, "a", connection_id, digest);
+    }
+    report("digest precomputed", mono_ns() - start, iterations);
+
+    start = mono_ns();
+    for (size_t i = 0; i < iterations; i++) {
+        connection_id_for(i, connection_id);
+        digest_recompute(connection_id, digest);
+        hl_signer_sign_hash(signer, digest, sig_before);
+    }
+    report("sign recompute", mono_ns() - start, iterations);
+
+    start = mono_ns();
+    for (size_t i = 0; i < iterations; i++) {
+        connection_id_for(i, connection_id);
+        eip712_sign_agent_signer(signer, "Exchange", 1337, "a", connection_id, sig_after);
+    }
+    report("sign precomputed", mono_ns() - start, iterations);
+
+    hl_signer_destroy(signer);
+    return 0;
+}
@@ -0,0 +1,275 @@
+/**
+ * @file ws_io_bench.c
+ * @brief Compare WebSocket receive backends against a local replay server
+ *
+ * A server thread on 127.0.0.1 accepts the client's upgrade and replays
+ * l2Book-sized text frames stamped with the monotonic send time. For each
+ * backend the client first drains a burst as fast as it can (throughput),
+ * then receives a paced stream (per-message latency, send to callback).
+ *
+ * Usage: ws_io_bench [burst_messages] [paced_messages] [paced_interval_us]
+ */
+
+#define _GNU_SOURCE
+
+#include "hl_ws_client.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include <time.h>
+#include <unistd.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <openssl/sha.h>
+#include <openssl/evp.h>
+
+#define WS_GUID "258EAFA5-E914-47DA-95CA-C5AB0DC85B11"
+
+typedef struct {
+    int listen_fd;
+    int port;
+    size_t burst;
+    size_t paced;
+    long interval_ns;
+} bench_server_t;
+
+typedef struct {
+    atomic_size_t received;
+    size_t expected_burst;
+    uint64_t burst_done_ns;
+    uint64_t* latencies;                /**< Paced phase, indexed by sequence */
+    size_t latency_count;
+} bench_client_t;
+
+static uint64_t mono_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+static bool send_all(int fd, const char* data, size_t len) {
+    while (len > 0) {
+        ssize_t n = send(fd, data, len, MSG_NOSIGNAL);
+        if (n <= 0) return false;
+        data += n;
+        len -= (size_t)n;
+    }
+    return true;
+}
+
+/**
+ * @brief Build one unmasked server text frame; returns its size
+ */
+static size_t build_frame(char* out, size_t seq, int phase) {
+    char payload[512];
+    int len = snprintf(payload, sizeof(payload),
+                       "{\"channel\":\"l2Book\",\"data\":{\"coin\":\"BTC\",\"phase\":%d,\"seq\":%zu,"
+                       "\"t\":%llu,\"levels\":[[{\"px\":\"64250.0\",\"sz\":\"1.25\",\"n\":3},"
+                       "{\"px\":\"64249.0\",\"sz\":\"0.80\",\"n\":2}],[{\"px\":\"64251.0\","
+                       "\"sz\":\"2.10\",\"n\":4},{\"px\":\"64252.0\",\"sz\":\"0.35\",\"n\":1}]]}}",
+                       phase, seq, (unsigned long long)mono_ns());
+
+    out[0] = (char)0x81;
+    out[1] = 126;
+    out[2] = (char)((len >> 8) & 0xFF);
+    out[3] = (char)(len & 0xFF);
+    memcpy(out + 4, payload, (size_t)len);
+    return (size_t)len + 4;
+}
+
+static void* server_thread(void* arg) {
+    bench_server_t* server = (bench_server_t*)arg;
+
+    int fd = accept(server->listen_fd, NULL, NULL);
+    if (fd < 0) return NULL;
+    int one = 1;
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+
+    // Upgrade
+    char request[4096];
+    size_t request_len = 0;
+    while (request_len < sizeof(request) - 1) {
+        ssize_t n = recv(fd, request + request_len, sizeof(request) - 1 - request_len, 0);
+        if (n <= 0) {
+            close(fd);
+            return NULL;
+        }
+        request_len += (size_t)n;
+        request[request_len] = '\0';
+        if (strstr(request, "\r\n\r\n")) break;
+    }
+
+    const char* key = strcasestr(request, "Sec-WebSocket-Key:");
+    char accept_src[128] = "";
+    if (key) {
+        key += 18;
+        while (*key == ' ') key++;
+        size_t key_len = strcspn(key, "\r\n");
+        snprintf(accept_src, sizeof(accept_src), "%.*s%s", (int)key_len, key, WS_GUID);
+    }
+    unsigned char digest[SHA_DIGEST_LENGTH];
+    SHA1((const unsigned char*)accept_src, strlen(accept_src), digest);
+    char accept_key[32];
+    EVP_EncodeBlock((unsigned char*)accept_key, digest, SHA_DIGEST_LENGTH);
+
+    char response[256];
+    int response_len = snprintf(response, sizeof(response),
+                                "HTTP/1.1 101 Switching Protocols\r\n"
+                                "Upgrade: websocket\r\n"
+                                "Connection: Upgrade\r\n"
+                                "Sec-WebSocket-Accept: %s\r\n\r\n", accept_key);
+    if (!send_all(fd, response, (size_t)response_len)) {
+        close(fd);
+        return NULL;
+    }
+
+    // Burst: batch frames into large writes
+    char batch[64 * 1024];
+    size_t batch_len = 0;
+    for (size_t seq = 0; seq < server->burst; seq++) {
+        if (batch_len + 600 > sizeof(batch)) {
+            if (!send_all(fd, batch, batch_len)) break;
+            batch_len = 0;
+        }
+        batch_len += build_frame(batch + batch_len, seq, 0);
+    }
+    if (batch_len > 0) send_all(fd, batch, batch_len);
+
+    // Let the client finish the burst before timing single frames
+    usleep(200000);
+
+    uint64_t next = mono_ns();
+    for (size_t seq = 0; seq < server->paced; seq++) {
+        while (mono_ns() < next) {
+        }
+        next += (uint64_t)server->interval_ns;
+
+        char frame[600];
+        if (!send_all(fd, frame, build_frame(frame, seq, 1))) break;
+    }
+
+    // Hold the connection until the client closes it
+    char drain[256];
+    while (recv(fd, drain, sizeof(drain), 0) > 0) {
+    }
+    close(fd);
+    return NULL;
+}
+
+static void on_message(const char* message, size_t size, void* user_data) {
+    bench_client_t* client = (bench_client_t*)user_data;
+    uint64_t now = mono_ns();
+    (void)size;
+
+    const char* phase = strstr(message, "\"phase\":");
+    const char* seq = strstr(message, "\"seq\":");
+    const char* sent = strstr(message, "\"t\":");
+    if (!phase || !seq || !sent) return;
+
+    size_t count = atomic_fetch_add(&client->received, 1) + 1;
+    if (phase[8] == '0') {
+        if (count == client->expected_burst) client->burst_done_ns = now;
+        return;
+    }
+
+    size_t index = (size_t)strtoull(seq + 6, NULL, 10);
+    uint64_t sent_ns = strtoull(sent + 4, NULL, 10);
+    if (index < client->latency_count && now >= sent_ns) {
+        client->latencies[index] = now - sent_ns;
+    }
+}
+
+static int compare_u64(const void* a, const void* b) {
+    uint64_t x = *(const uint64_t*)a;
+    uint64_t y = *(const uint64_t*)b;
+    return (x > y) - (x < y);
+}
+
+static double percentile_us(const uint64_t* sorted, size_t count, double p) {
+    if (count == 0) return 0.0;
+    size_t index = (size_t)(p * (double)(count - 1));
+    return (double)sorted[index] / 1000.0;
+}
+
+static bool run_backend(hl_ws_io_backend_t backend, const char* name,
+                        size_t burst, size_t paced, long interval_ns) {
+    bench_server_t server = {.burst = burst, .paced = paced, .interval_ns = interval_ns};
+    server.listen_fd = socket(AF_INET, SOCK_STREAM, 0);
+    struct sockaddr_in addr = {.sin_family = AF_INET, .sin_port = 0};
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    socklen_t addr_len = sizeof(addr);
+    if (server.listen_fd < 0 ||
+        bind(server.listen_fd, (struct sockaddr*)&addr, sizeof(addr)) != 0 ||
+        listen(server.listen_fd, 1) != 0 ||
+        getsockname(server.listen_fd, (struct sockaddr*)&addr, &addr_len) != 0) {
+        fprintf(stderr, "cannot listen on loopback\n");
+        return false;
+    }
+    server.port = ntohs(addr.sin_port);
+
+    pthread_t thread;
+    pthread_create(&thread, NULL, server_thread, &server);
+
+    bench_client_t state = {.expected_burst = burst, .latency_count = paced};
+    atomic_init(&state.received, 0);
+    state.latencies = calloc(paced > 0 ? paced : 1, sizeof(uint64_t));
+
+    char url[64];
+    snprintf(url, sizeof(url), "ws://127.0.0.1:%d/ws", server.port);
+    hl_ws_config_t config;
+    hl_ws_config_default(&config, false);
+    config.url = url;
+    config.auto_reconnect = false;
+    config.io_backend = backend;
+
+    hl_ws_client_t* client = hl_ws_client_create(&config);
+    hl_ws_client_set_message_callback(client, on_message, &state);
+
+    uint64_t start = mono_ns();
+    bool ok = hl_ws_client_connect(client);
+    size_t total = burst + paced;
+    uint64_t deadline = start + 60ULL * 1000000000ULL;
+    while (ok && atomic_load(&state.received) < total && mono_ns() < deadline) {
+        usleep(1000);
+    }
+
+    hl_ws_client_disconnect(client);
+    hl_ws_client_destroy(client);
+    pthread_join(thread, NULL);
+    close(server.listen_fd);
+
+    if (!ok || atomic_load(&state.received) < total) {
+        fprintf(stderr, "%s: received %zu of %zu messages\n", name,
+                atomic_load(&state.received), total);
+        free(state.latencies);
+        return false;
+    }
+
+    double burst_s = (double)(state.burst_done_ns - start) / 1e9;
+    qsort(state.latencies, paced, sizeof(uint64_t), compare_u64);
+    printf("%-8s %12.0f msg/s   p50 %7.1f us   p99 %7.1f us   p99.9 %7.1f us   max %7.1f us\n",
+           name, burst_s > 0 ? (double)burst / burst_s : 0.0,
+           percentile_us(state.latencies, paced, 0.50),
+           percentile_us(state.latencies, paced, 0.99),
+           percentile_us(state.latencies, paced, 0.999),
+           percentile_us(state.latencies, paced, 1.0));
+
+    free(state.latencies);
+    return true;
+}
+
+int main(int argc, char** argv) {
+    size_t burst = argc > 1 ? (size_t)strtoull(argv[1], NULL, 10) : 500000;
+    size_t paced = argc > 2 ? (size_t)strtoull(argv[2], NULL, 10) : 20000;
+    long interval_us = argc > 3 ? strtol(argv[3], NULL, 10) : 50;
+
+    printf("burst %zu messages, then %zu messages every %ld us\n\n", burst, paced, interval_us);
+
+    bool ok = run_backend(HL_WS_IO_POLL, "poll", burst, paced, interval_us * 1000L);
+    ok = run_backend(HL_WS_IO_URING, "io_uring", burst, paced, interval_us * 1000L) && ok;
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,95 @@
+/**
+ * @file hl_bbo.h
+ * @brief Fixed-size top-of-book records
+ *
+ * hl_watch_bbo() delivers best bid and ask as a 48-byte hl_bbo_t, decoded
+ * straight from the message text without building a JSON tree or an
+ * hl_orderbook_t. Records live on the dispatching thread's stack and are
+ * only valid for the duration of the callback.
+ */
+
+#ifndef HL_BBO_H
+#define HL_BBO_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "hl_ws_client.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define HL_BBO_UNKNOWN_ASSET UINT32_MAX    /**< Coin not bound to an asset ID */
+
+/**
+ * @brief Best bid and ask of one asset
+ *
+ * A missing side has price and size 0. The exchange timestamp is stored as
+ * an offset from the receive time; use hl_bbo_exchange_time_ms().
+ */
+typedef struct {
+    uint32_t asset_id;                  /**< Asset ID, HL_BBO_UNKNOWN_ASSET if unbound */
+    int32_t exchange_offset_us;         /**< Exchange time minus receive time (µs) */
+    double bid_px;                      /**< Best bid price */
+    double bid_sz;                      /**< Best bid size */
+    double ask_px;                      /**< Best ask price */
+    double ask_sz;                      /**< Best ask size */
+    int64_t recv_time_ns;               /**< Wall clock when the bytes were read */
+} hl_bbo_t;
+
+/**
+ * @brief Feed used to produce bbo records
+ */
+typedef enum {
+    HL_BBO_SOURCE_BBO,                  /**< Exchange "bbo" channel */
+    HL_BBO_SOURCE_L2BOOK                /**< First level of each side of "l2Book" */
+} hl_bbo_source_t;
+
+/**
+ * @brief Exchange timestamp of a record in milliseconds
+ */
+static inline int64_t hl_bbo_exchange_time_ms(const hl_bbo_t* bbo) {
+    return (bbo->recv_time_ns / 1000 + bbo->exchange_offset_us) / 1000;
+}
+
+/**
+ * @brief Decode a bbo or l2Book message into a record
+ *
+ * Reads only the coin, time and first level of each side; deeper levels
+ * are skipped without being parsed. asset_id is left as
+ * HL_BBO_UNKNOWN_ASSET.
+ *
+ * @param message Raw message text (NUL-terminated)
+ * @param size Message length
+ * @param recv_time_ns Receive timestamp to store
+ * @param out Output record
+ * @param coin Output coin name
+ * @param coin_size Size of coin buffer
+ * @param source Optional output: channel the message came from
+ * @return true if the message is a well-formed bbo or l2Book update
+ */
+bool hl_bbo_decode(const char* message, size_t size, int64_t recv_time_ns,
+                   hl_bbo_t* out, char* coin, size_t coin_size, hl_bbo_source_t* source);
+
+/**
+ * @brief Watch best bid and ask
+ *
+ * The callback's @p data points to a const hl_bbo_t. Markets are loaded
+ * first if the client has none, so records carry asset IDs.
+ *
+ * @param client Client instance
+ * @param symbol Trading symbol
+ * @param source Exchange bbo channel, or l2Book for deployments without it
+ * @param callback Record callback
+ * @param user_data User data for callback
+ * @return Subscription ID or NULL on error
+ */
+const char* hl_watch_bbo(hl_client_t* client, const char* symbol, hl_bbo_source_t source,
+                         hl_ws_data_callback_t callback, void* user_data);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // HL_BBO_H
@@ -0,0 +1,112 @@
+/**
+ * @file hl_candle_series.h
+ * @brief Live candle series kept current from the candle stream
+ *
+ * A series holds the most recent candles of one (coin, interval). It is
+ * seeded with candleSnapshot, then follows the candle WebSocket channel:
+ * each update replaces the bar in progress or opens the next one. When the
+ * stream skips bars (a reconnect, a stalled connection) the missing range
+ * is requested again in the background and merged in, so the array stays
+ * gapless and indicators can run on it without refetching history.
+ */
+
+#ifndef HL_CANDLE_SERIES_H
+#define HL_CANDLE_SERIES_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "hl_error.h"
+#include "hl_ohlcv.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct hl_client hl_client_t;
+typedef struct hl_candle_series hl_candle_series_t;
+
+/**
+ * @brief Series update callback
+ *
+ * Runs after the series changed, from the WebSocket I/O thread for stream
+ * updates or from the series' backfill thread after a gap was filled.
+ * @p bar_closed is true when a new bar was opened or history was merged in.
+ * The series may be locked from the callback.
+ */
+typedef void (*hl_candle_series_callback_t)(hl_candle_series_t* series, bool bar_closed,
+                                            void* user_data);
+
+/**
+ * @brief Create a live series
+ *
+ * Fetches the last @p capacity candles, then subscribes to the candle
+ * channel. Once the series holds @p capacity candles the oldest is
+ * dropped for each new one. The exchange serves at most the 5000 most
+ * recent candles of an interval.
+ *
+ * @param client Client instance
+ * @param symbol Trading symbol
+ * @param timeframe Timeframe (e.g., "1m", "1h")
+ * @param capacity Number of candles to keep
+ * @param callback Optional update callback (may be NULL)
+ * @param user_data User data for callback
+ * @return Series or NULL if the timeframe is unknown, seeding or
+ *         subscribing failed
+ */
+hl_candle_series_t* hl_candle_series_create(hl_client_t* client, const char* symbol,
+                                            const char* timeframe, size_t capacity,
+                                            hl_candle_series_callback_t callback,
+                                            void* user_data);
+
+/**
+ * @brief Unsubscribe and free a series
+ *
+ * Waits for a running backfill request to finish.
+ */
+void hl_candle_series_destroy(hl_candle_series_t* series);
+
+/**
+ * @brief Lock the series and get its candles
+ *
+ * The returned view (oldest first) can be passed to the hl_ohlcvs_*
+ * helpers and stays valid until hl_candle_series_unlock(). Stream updates
+ * wait while the series is locked, so keep the section short.
+ *
+ * @param series Series
+ * @return Candles, or NULL if series is NULL
+ */
+const hl_ohlcvs_t* hl_candle_series_lock(hl_candle_series_t* series);
+
+/**
+ * @brief Release a lock taken with hl_candle_series_lock()
+ */
+void hl_candle_series_unlock(hl_candle_series_t* series);
+
+/**
+ * @brief Copy the candles out of the series
+ *
+ * @param series Series
+ * @param ohlcvs Output copy (caller must free with hl_ohlcvs_free)
+ * @return HL_SUCCESS, HL_ERROR_INVALID_PARAMS or HL_ERROR_MEMORY
+ */
+hl_error_t hl_candle_series_copy(hl_candle_series_t* series, hl_ohlcvs_t* ohlcvs);
+
+/**
+ * @brief Version counter, incremented on every change
+ *
+ * Lets readers skip recomputing indicators when nothing changed.
+ */
+uint64_t hl_candle_series_version(const hl_candle_series_t* series);
+
+/**
+ * @brief Check that no gap is waiting to be backfilled
+ * @return true if the series is known to be gapless
+ */
+bool hl_candle_series_is_complete(hl_candle_series_t* series);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // HL_CANDLE_SERIES_H
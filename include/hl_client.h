@@ -10,12 +10,15 @@
 #include "hl_types.h"
 #include "hl_error.h"
 #include <stdbool.h>
+#include <pthread.h>
 
 // Forward declarations
 typedef struct hl_client hl_client_t;
 typedef struct hl_options hl_options_t;
 typedef struct hl_http_client hl_http_client_t;
 typedef struct hl_ws_client hl_ws_client_t;
+typedef struct hl_mids_table hl_mids_table_t;
+typedef struct hl_signer hl_signer_t;
 
 // Callback types
 typedef void (*hl_callback_t)(void* data, size_t size);
@@ -41,8 +44,8 @@ struct hl_client {
 
     // Authentication
     char api_key[128];
-    char secret[128];
     char wallet_address[64];
+    hl_signer_t* signer;            /**< sole copy of the signing key (NULL if it was not valid) */
 
     // HTTP/WebSocket clients
     hl_http_client_t* http_client;
@@ -53,7 +56,9 @@ struct hl_client {
 
     // State
     hl_markets_t* markets;          /**< cached markets */
+    pthread_mutex_t markets_mutex; /**< guards markets (streamed fields change in place) */
     hl_balances_t* balances;        /**< cached balances */
+    hl_mids_table_t* mids;          /**< shared mid prices (lock-free reads) */
 
     // Options
     hl_options_t options;
@@ -68,6 +73,10 @@ struct hl_client {
 
 /**
  * @brief Create new Hyperliquid client
+ *
+ * The private key is parsed into the client's signer and not stored
+ * anywhere else; the caller's string is not referenced afterwards.
+ *
  * @param wallet_address Wallet address (required for trading)
  * @param private_key Private key (required for trading)
  * @param testnet Use testnet
@@ -97,11 +106,39 @@ const char* hl_client_get_wallet_address(const hl_client_t* client);
 
 /**
  * @brief Get private key
+ *
+ * @deprecated The client keeps its key only inside the signer, so this
+ * always returns NULL. Sign through hl_client_get_signer() instead.
+ *
  * @param client Client instance
- * @return Private key
+ * @return NULL
  */
 const char* hl_client_get_private_key(const hl_client_t* client);
 
+/**
+ * @brief Get signing key
+ * @param client Client instance
+ * @return Signer created with the client, or NULL without a valid private key
+ */
+hl_signer_t* hl_client_get_signer(const hl_client_t* client);
+
+/**
+ * @brief Allocate a nonce for the client's account
+ *
+ * Unique and increasing across threads (see hl_signer_next_nonce()),
+ * taken on the exchange clock as estimated by the WebSocket.
+ *
+ * @param client Client instance
+ * @return Nonce, or 0 without a signer
+ */
+uint64_t hl_client_next_nonce(hl_client_t* client);
+
+/**
+ * @brief Allocate @p count consecutive nonces for the client's account
+ * @return First nonce of the block, or 0 without a signer
+ */
+uint64_t hl_client_reserve_nonces(hl_client_t* client, size_t count);
+
 /**
  * @brief Get HTTP client
  * @param client Client instance
@@ -148,17 +185,48 @@ hl_error_t hl_client_load_markets(hl_client_t* client);
  * @brief Get cached markets
  * @param client Client instance
  * @return Markets or NULL if not loaded
+ *
+ * @warning Returns the live registry without locking. The activeAssetCtx
+ * stream rewrites its price fields in place, and hl_client_load_markets()
+ * frees it. Use it only while neither can run; otherwise use
+ * hl_client_copy_markets().
  */
 const hl_markets_t* hl_client_get_markets(const hl_client_t* client);
 
+/**
+ * @brief Copy the cached markets
+ *
+ * Thread-safe snapshot, taken under the registry lock.
+ *
+ * @param client Client instance
+ * @param out Receives the copy (free with hl_markets_free())
+ * @return HL_SUCCESS, or HL_ERROR_NOT_FOUND if markets are not loaded
+ */
+hl_error_t hl_client_copy_markets(hl_client_t* client, hl_markets_t* out);
+
 /**
  * @brief Get market by symbol
  * @param client Client instance
  * @param symbol Trading symbol
  * @return Market or NULL if not found
+ *
+ * @warning Points into the live registry; the same limits as
+ * hl_client_get_markets() apply. Use hl_client_copy_market() otherwise.
  */
 const hl_market_t* hl_client_get_market(const hl_client_t* client, const char* symbol);
 
+/**
+ * @brief Copy one market by symbol
+ *
+ * Thread-safe: the copy is taken under the registry lock.
+ *
+ * @param client Client instance
+ * @param symbol Trading symbol
+ * @param out Receives the market
+ * @return true if found
+ */
+bool hl_client_copy_market(hl_client_t* client, const char* symbol, hl_market_t* out);
+
 /**
  * @brief Check if exchange has specific capability
  * @param client Client instance
@@ -179,8 +247,9 @@ static inline const char* hl_client_get_wallet(const hl_client_t* client) {
 
 /**
  * @brief Legacy: Get private key accessor
+ * @deprecated Always NULL, see hl_client_get_private_key()
  * @param client Client instance
- * @return Private key
+ * @return NULL
  */
 static inline const char* hl_client_get_key(const hl_client_t* client) {
     return hl_client_get_private_key(client);
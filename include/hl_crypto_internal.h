@@ -4,6 +4,7 @@
 #include <stdint.h>
 #include <stddef.h>
 #include <stdbool.h>
+#include "hl_signer.h"
 
 /* -------------------------------------------------------------------------
  * Works when compiled for either 32-bit or 64-bit targets, optimized for 
@@ -72,6 +73,21 @@ sha3_return_t sha3_HashBuffer(
     const void *in, unsigned inBytes, 
     void *out, unsigned outBytes );     /* up to bitSize/8; truncation OK */
 
+/* Keccak-f[1600] permutations. The sponge uses the unrolled one unless
+ * built with -DHL_KECCAK_LOOP; both are exported for tests and benches. */
+void keccakf_loop(uint64_t s[25]);
+void keccakf_unrolled(uint64_t s[25]);
+extern const uint64_t keccakf_rndc[24];
+
+/* Multi-buffer keccak256 (keccak_mb.c). Independent inputs are hashed
+ * 8 (AVX-512) or 4 (AVX2) per permutation, picked at runtime; 1 means
+ * scalar. keccak256_batch_with fails if the CPU lacks the requested width. */
+size_t keccak256_batch_ways(void);
+int keccak256_batch(const uint8_t *const inputs[], const size_t lengths[], size_t count,
+                    uint8_t outputs[][32]);
+int keccak256_batch_with(size_t ways, const uint8_t *const inputs[], const size_t lengths[],
+                         size_t count, uint8_t outputs[][32]);
+
 /* Additional crypto functions from crypto_utils.c */
 int keccak256(const uint8_t *input, size_t input_len, uint8_t output[32]);
 int hex_to_bytes(const char *hex, uint8_t *bytes_out, size_t max_out_len);
@@ -81,6 +97,56 @@ int ecdsa_sign_secp256k1(const uint8_t hash[32], const char *private_key_hex, ui
 int eip712_domain_hash(const char *domain_name, uint64_t chain_id, uint8_t domain_hash_out[32]);
 int eip712_agent_struct_hash(const char *source, const uint8_t connection_id[32], uint8_t struct_hash_out[32]);
 int eip712_signing_hash(const uint8_t domain_hash[32], const uint8_t struct_hash[32], uint8_t signing_hash_out[32]);
+/* Digest eip712_sign_agent_signer signs; the exchange domain and the "a"/"b"
+ * sources come from precomputed hashes. */
+int eip712_agent_signing_hash(const char *domain_name, uint64_t chain_id, const char *source, const uint8_t connection_id[32], uint8_t signing_hash_out[32]);
 int eip712_sign_agent(const char *domain_name, uint64_t chain_id, const char *source, const uint8_t connection_id[32], const char *private_key_hex, uint8_t signature_out[65]);
+int eip712_sign_agent_signer(const hl_signer_t *signer, const char *domain_name, uint64_t chain_id, const char *source, const uint8_t connection_id[32], uint8_t signature_out[65]);
+/* Signs count agent actions; connection_ids holds 32 * count bytes and
+ * signatures_out receives 65 * count. Digests go through keccak256_batch. */
+int eip712_sign_agent_batch(const hl_signer_t *signer, const char *domain_name, uint64_t chain_id, const char *source, const uint8_t *connection_ids, size_t count, uint8_t *signatures_out);
+
+/* User-signed actions: EIP-712 structs in the HyperliquidSignTransaction
+ * domain, from a static registry with precompiled type hashes. The
+ * hyperliquidChain member comes first in every type and is implied by
+ * the testnet flag; values[] covers the remaining fields in order. */
+#define EIP712_MAX_FIELDS 4
+
+typedef enum {
+    EIP712_USD_SEND,
+    EIP712_WITHDRAW,
+    EIP712_SPOT_SEND,
+    EIP712_APPROVE_AGENT,
+    EIP712_USER_TYPE_COUNT
+} eip712_user_type_t;
+
+typedef enum {
+    EIP712_FIELD_STRING,
+    EIP712_FIELD_ADDRESS,
+    EIP712_FIELD_UINT64
+} eip712_field_kind_t;
+
+typedef struct {
+    const char *name;
+    eip712_field_kind_t kind;
+} eip712_field_t;
+
+typedef struct {
+    const char *type_string;          /* Canonical encodeType() string */
+    const char *action_type;          /* "type" of the JSON action */
+    uint8_t type_hash[32];            /* keccak256(type_string) */
+    size_t field_count;               /* Fields after hyperliquidChain */
+    eip712_field_t fields[EIP712_MAX_FIELDS];
+} eip712_user_type_def_t;
+
+typedef union {
+    const char *string;               /* NUL-terminated */
+    const uint8_t *address;           /* 20 bytes */
+    uint64_t uint64;
+} eip712_value_t;
+
+const eip712_user_type_def_t *eip712_user_type(eip712_user_type_t type);
+int eip712_user_struct_hash(eip712_user_type_t type, bool testnet, const eip712_value_t values[], uint8_t struct_hash_out[32]);
+int eip712_sign_user_action(const hl_signer_t *signer, eip712_user_type_t type, bool testnet, const eip712_value_t values[], uint8_t signature_out[65]);
 
 #endif
@@ -11,7 +11,11 @@
 
 #include "hyperliquid.h"
 #include "hl_http.h"
+#include "hl_ws_client.h"
+#include "hl_msgpack.h"
 #include <pthread.h>
+#include <semaphore.h>
+#include <stdatomic.h>
 #include <string.h>
 #include <stdlib.h>
 #include <sys/time.h>
@@ -50,11 +54,168 @@ struct exchange_trader {
 
 // Internal client accessors (used by trading/account/market modules)
 const char* hl_client_get_wallet_address_old(hl_client_t *client);
-const char* hl_client_get_private_key_old(hl_client_t *client);
 bool hl_client_is_testnet_old(hl_client_t *client);
 http_client_t* hl_client_get_http_old(hl_client_t *client);
 pthread_mutex_t* hl_client_get_mutex_old(hl_client_t *client);
 
+// Signed /exchange payloads (shared by REST and WebSocket order paths).
+// Builders expect the client mutex to be held by the caller.
+hl_error_t hl_build_order_payload(hl_client_t *client, const hl_order_request_api_t *request,
+                                  char *payload, size_t payload_size,
+                                  char *error, size_t error_size);
+hl_error_t hl_build_order_payload_for_asset(hl_client_t *client, uint32_t asset_id,
+                                            const hl_order_request_api_t *request,
+                                            char *payload, size_t payload_size,
+                                            char *error, size_t error_size);
+hl_error_t hl_build_cancel_payload(hl_client_t *client, const char *symbol, const char *order_id,
+                                   char *payload, size_t payload_size,
+                                   char *error, size_t error_size);
+
+// L1 actions outside the order path (leverage.c). Perp symbols resolve
+// through the mid table; the POST signs the action hash with the client's
+// signer and holds the client mutex.
+bool hl_resolve_perp_asset(hl_client_t *client, const char *symbol, uint32_t *asset_id);
+hl_error_t hl_post_l1_action(hl_client_t *client, const char *action_json,
+                             const uint8_t connection_id[32], uint64_t nonce);
+
+// Send a signed order payload as a WebSocket post; the callback gets the
+// parsed order result. HL_ERROR_INVALID_PARAMS without a WebSocket.
+hl_error_t hl_ws_post_order(hl_client_t *client, const char *payload,
+                            hl_ws_order_callback_t callback, void *user_data);
+hl_error_t hl_parse_order_response(const char *body, hl_order_result_t *result);
+hl_error_t hl_parse_cancel_response(const char *body, hl_cancel_result_t *result);
+
+// WebSocket timing statistics (ws_stats.c). Rolling windows of the most
+// recent samples, minimum tracked incrementally; callers lock.
+#define HL_WS_STATS_WINDOW 512
+
+typedef struct {
+    double values[HL_WS_STATS_WINDOW];
+    size_t count;
+    size_t next;
+    uint64_t total;
+    size_t min_index;                   /**< Index of the window minimum */
+} hl_ws_window_t;
+
+void hl_ws_window_add(hl_ws_window_t *window, double value);
+void hl_ws_window_summarize(const hl_ws_window_t *window, hl_ws_latency_t *out);
+
+// Server clock offset: the least delayed server timestamp, less half the
+// fastest round trip, is the local clock minus the server's
+typedef struct {
+    hl_ws_window_t rtt;
+    hl_ws_window_t delay;
+    double rtt_min_ms;                  /**< Lowest RTT ever observed */
+    double offset_ms;                   /**< Local minus server clock */
+    bool offset_valid;                  /**< A server timestamp was seen */
+} hl_ws_clock_t;
+
+void hl_ws_clock_add_rtt(hl_ws_clock_t *clock, double rtt_ms);
+// Returns the sample's age on the server's clock
+double hl_ws_clock_add_delay(hl_ws_clock_t *clock, double delay_ms);
+
+// Subscription sync (ws_sync.c). Server limits per connection.
+#define HL_WS_MESSAGES_PER_MINUTE 2000  /**< Messages sent */
+#define HL_WS_MAX_SUBSCRIPTIONS 1000    /**< Active subscriptions */
+#define HL_WS_SEND_BATCH 100            /**< Frames coalesced into one write */
+
+// One side of a diff. The diff sets changed on current entries no longer
+// wanted and on wanted entries not yet subscribed.
+typedef struct {
+    const char *subscription;           /**< Subscription object */
+    bool changed;
+} hl_ws_topic_ref_t;
+
+void hl_ws_topic_diff(hl_ws_topic_ref_t *current, size_t current_count,
+                      hl_ws_topic_ref_t *wanted, size_t wanted_count,
+                      size_t *added, size_t *removed);
+
+// Token bucket paced by the caller's monotonic clock; callers lock
+typedef struct {
+    double tokens;                      /**< Messages that may be sent right now */
+    int64_t refill_ns;                  /**< Time of the last refill */
+} hl_ws_bucket_t;
+
+void hl_ws_bucket_init(hl_ws_bucket_t *bucket, int64_t now_ns);
+size_t hl_ws_bucket_take(hl_ws_bucket_t *bucket, size_t wanted, int64_t now_ns,
+                         int64_t *wait_ns);
+
+// Dual-feed arbitration (ws_feed.c); callers lock
+#define HL_WS_FEED_SEEN_SLOTS 4096      /**< Recent message identities kept */
+
+// First copy of a message seen on either feed
+typedef struct {
+    uint64_t key;                       /**< Message identity, 0 = empty */
+    int64_t recv_time_ns;               /**< When the first copy was read */
+    uint8_t feed;                       /**< Feed that delivered it */
+} hl_ws_feed_seen_t;
+
+// Arbitration results of one feed
+typedef struct {
+    uint64_t messages;                  /**< Copies received */
+    uint64_t wins;                      /**< Copies delivered because they came first */
+    hl_ws_window_t lag;                 /**< Delay behind the other feed on lost races (ms) */
+} hl_ws_feed_tally_t;
+
+typedef struct {
+    hl_ws_feed_seen_t *seen;            /**< HL_WS_FEED_SEEN_SLOTS slots, by key */
+    hl_ws_feed_tally_t tally[2];        /**< Primary, backup */
+} hl_ws_feed_arbiter_t;
+
+bool hl_ws_feed_arbiter_init(hl_ws_feed_arbiter_t *arbiter);
+void hl_ws_feed_arbiter_free(hl_ws_feed_arbiter_t *arbiter);
+uint64_t hl_ws_feed_key(const char *channel, const char *coin, int64_t time, int64_t tid);
+bool hl_ws_feed_admit(hl_ws_feed_arbiter_t *arbiter, int feed, uint64_t key,
+                      int64_t recv_time_ns);
+
+// Kill switch (kill_switch.c). Hashes, signs and serializes one cancel
+// action for a set of orders; returns a heap-allocated /exchange body.
+char* hl_kill_switch_sign_cancels(const hl_signer_t *signer, bool testnet,
+                                  const hl_cancel_t *cancels, size_t count, uint64_t nonce);
+
+// Bounded MPMC queue of pointers (job_queue.c), used by the order pipeline.
+// Push never blocks: callers size the queue for every item in flight.
+typedef struct {
+    atomic_size_t sequence;
+    void *item;
+} hl_job_queue_cell_t;
+
+typedef struct {
+    hl_job_queue_cell_t *cells;
+    size_t mask;                        /**< Capacity - 1 */
+    _Alignas(64) atomic_size_t enqueue_pos;
+    _Alignas(64) atomic_size_t dequeue_pos;
+    sem_t items;                        /**< Published entries */
+} hl_job_queue_t;
+
+bool hl_job_queue_init(hl_job_queue_t *queue, size_t min_capacity);
+void hl_job_queue_free(hl_job_queue_t *queue);
+void hl_job_queue_push(hl_job_queue_t *queue, void *item);
+void* hl_job_queue_pop(hl_job_queue_t *queue);
+
+// Mid-price table writer shared by the allMids stream and hl_fetch_tickers().
+// Applies every bound coin of a {"BTC":"65000.5",...} object as one batch.
+struct cJSON;
+size_t hl_mids_table_apply_json(hl_mids_table_t *table, const struct cJSON *mids, int64_t update_ns);
+
+// Market registry. Dynamic fields of client->markets are updated in place by
+// the activeAssetCtx stream under client->markets_mutex.
+void hl_market_apply_ctx(hl_market_t *market, const struct cJSON *ctx);
+bool hl_client_update_market_ctx(hl_client_t *client, const char *coin, const struct cJSON *ctx,
+                                 int64_t update_ms);
+bool hl_client_live_market(hl_client_t *client, const char *symbol, hl_market_t *out);
+hl_market_t* hl_client_live_swap_markets(hl_client_t *client, size_t *count);
+
+// Candles. Parses a candleSnapshot entry or a candle stream update; the
+// snapshot request takes an exchange coin ("BTC") rather than a symbol.
+hl_error_t hl_parse_ohlcv_candle(const struct cJSON *candle_json, hl_ohlcv_t *candle);
+hl_error_t hl_fetch_candle_snapshot(hl_client_t *client, const char *coin, const char *interval,
+                                    uint64_t start_time, uint64_t end_time,
+                                    hl_ohlcv_t **candles, size_t *count);
+
+// Map a unified symbol to its exchange coin ("BTC/USDC:USDC" -> "BTC")
+void hl_symbol_to_coin(const char *symbol, char *coin, size_t size);
+
 // Utility functions
 static inline void lv3_string_copy(char *dest, const char *src, size_t dest_size) {
     if (!dest || !src || dest_size == 0) return;
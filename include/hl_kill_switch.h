@@ -0,0 +1,101 @@
+/**
+ * @file hl_kill_switch.h
+ * @brief Pre-signed cancel-everything action
+ *
+ * A kill switch tracks the account's open orders and keeps one cancel
+ * action covering all of them built, hashed, signed and serialized ahead
+ * of time. A background thread re-signs it whenever the set of orders
+ * changes and before its nonce ages out, so firing only writes the stored
+ * body to the WebSocket (or POSTs it to /exchange) - one request for every
+ * order instead of one signed round trip per order.
+ */
+
+#ifndef HL_KILL_SWITCH_H
+#define HL_KILL_SWITCH_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "hl_error.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct hl_client hl_client_t;
+typedef struct hl_kill_switch hl_kill_switch_t;
+
+/**
+ * @brief Create a kill switch
+ *
+ * With @p track_orders, the switch is seeded with hl_fetch_open_orders()
+ * and then follows the orderUpdates channel: resting orders are added,
+ * filled, canceled and rejected ones removed. Coins are resolved through
+ * hl_client_mids(), so markets must be loaded. Without it, orders are
+ * managed with hl_kill_switch_add() and hl_kill_switch_remove().
+ *
+ * The exchange rejects a nonce once 100 newer ones have been used by the
+ * account; @p refresh_ms should be shorter than the time the account
+ * takes to send 100 actions.
+ *
+ * @param client Client instance with a private key
+ * @param refresh_ms Maximum age of the stored action's nonce (0 for 10 s)
+ * @param track_orders Follow the account's open orders automatically
+ * @return Kill switch or NULL on error
+ */
+hl_kill_switch_t* hl_kill_switch_create(hl_client_t* client, uint32_t refresh_ms,
+                                        bool track_orders);
+
+/**
+ * @brief Unsubscribe, stop the signing thread and free the switch
+ */
+void hl_kill_switch_destroy(hl_kill_switch_t* ks);
+
+/**
+ * @brief Add an order to the set the switch cancels
+ *
+ * @param ks Kill switch
+ * @param asset_id Asset ID of the order's market
+ * @param oid Exchange order ID
+ * @return HL_SUCCESS, HL_ERROR_INVALID_PARAMS or HL_ERROR_MEMORY
+ */
+hl_error_t hl_kill_switch_add(hl_kill_switch_t* ks, uint32_t asset_id, uint64_t oid);
+
+/**
+ * @brief Remove an order from the set
+ * @return true if the order was in the set
+ */
+bool hl_kill_switch_remove(hl_kill_switch_t* ks, uint64_t oid);
+
+/**
+ * @brief Number of orders the switch would cancel
+ */
+size_t hl_kill_switch_count(hl_kill_switch_t* ks);
+
+/**
+ * @brief Check that the stored action covers the current set of orders
+ *
+ * False for a short time after every change, until the signing thread
+ * has caught up. An empty set is always armed.
+ */
+bool hl_kill_switch_is_armed(hl_kill_switch_t* ks);
+
+/**
+ * @brief Cancel every order in the set
+ *
+ * Sends the stored action as a WebSocket post when the client's
+ * WebSocket is connected and returns without waiting for the response;
+ * otherwise POSTs it to /exchange and waits. If the switch is not armed,
+ * the action is signed on the spot. Each action can be sent only once, so
+ * the switch re-signs after firing.
+ *
+ * @param ks Kill switch
+ * @return HL_SUCCESS if the action was sent (or the set is empty)
+ */
+hl_error_t hl_kill_switch_fire(hl_kill_switch_t* ks);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // HL_KILL_SWITCH_H
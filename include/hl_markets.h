@@ -56,11 +56,16 @@ struct hl_market {
     // Current prices (if available)
     double mark_price;         /**< Mark price */
     double oracle_price;       /**< Oracle price */
+    double mid_price;          /**< Mid price */
     double funding_rate;       /**< Current funding rate */
+    double premium;            /**< Funding premium */
+    double prev_day_price;     /**< Price 24h ago */
 
     // Volumes
     double day_volume;         /**< 24h volume */
     double open_interest;      /**< Open interest (for swaps) */
+
+    int64_t ctx_update_ms;     /**< Last activeAssetCtx update (0 = REST snapshot only) */
 };
 
 /**
@@ -0,0 +1,118 @@
+/**
+ * @file hl_mids.h
+ * @brief Shared mid-price table indexed by asset ID
+ *
+ * One table per client is filled from the allMids WebSocket stream (see
+ * hl_watch_all_mids()) or from hl_fetch_tickers(). Entries are published
+ * through per-entry sequence counters: any number of threads can read
+ * consistent prices without locks or syscalls, while a single update
+ * batch is applied under a writer lock.
+ *
+ * Asset IDs follow the exchange convention: perpetuals use their universe
+ * index, spot pairs use 10000 + spot index.
+ */
+
+#ifndef HL_MIDS_H
+#define HL_MIDS_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "hl_error.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define HL_MIDS_PERP_CAPACITY 1024      /**< Perp asset IDs 0 .. 1023 */
+#define HL_MIDS_SPOT_BASE 10000         /**< First spot asset ID */
+#define HL_MIDS_SPOT_CAPACITY 1024      /**< Spot asset IDs 10000 .. 11023 */
+
+typedef struct hl_client hl_client_t;
+typedef struct hl_markets hl_markets_t;
+typedef struct hl_mids_table hl_mids_table_t;
+
+/**
+ * @brief One consistent mid-price reading
+ */
+typedef struct {
+    double mid;                         /**< Mid price */
+    int64_t update_ns;                  /**< Wall-clock time the price was received */
+    uint64_t updates;                   /**< Times this entry has been written */
+} hl_mid_t;
+
+/**
+ * @brief Create an empty table
+ * @return Table or NULL on allocation failure
+ */
+hl_mids_table_t* hl_mids_table_create(void);
+
+/**
+ * @brief Destroy table
+ */
+void hl_mids_table_destroy(hl_mids_table_t* table);
+
+/**
+ * @brief Map allMids coin keys to asset IDs
+ *
+ * Perps are keyed by base coin ("BTC"); spot pairs by "@<index>" and by
+ * their pair name ("PURR/USDC"). Can be called again after markets are
+ * reloaded; existing prices are kept.
+ *
+ * @param table Table
+ * @param markets Markets from hl_fetch_markets()
+ * @return Number of coins bound
+ */
+size_t hl_mids_table_bind_markets(hl_mids_table_t* table, const hl_markets_t* markets);
+
+/**
+ * @brief Resolve an allMids coin key to an asset ID (lock-free)
+ * @param table Table
+ * @param coin Coin key ("BTC", "@107")
+ * @param asset_id Output asset ID
+ * @return true if the coin is bound
+ */
+bool hl_mids_table_lookup(const hl_mids_table_t* table, const char* coin, uint32_t* asset_id);
+
+/**
+ * @brief Read one mid price (lock-free)
+ * @param table Table
+ * @param asset_id Asset ID
+ * @param out Output reading
+ * @return true if a price has been published for this asset
+ */
+bool hl_mids_get(const hl_mids_table_t* table, uint32_t asset_id, hl_mid_t* out);
+
+/**
+ * @brief Read one mid price by coin key (lock-free)
+ */
+bool hl_mids_get_coin(const hl_mids_table_t* table, const char* coin, hl_mid_t* out);
+
+/**
+ * @brief Publish one price (takes the writer lock)
+ * @return false if the asset ID is outside the table
+ */
+bool hl_mids_set(hl_mids_table_t* table, uint32_t asset_id, double mid, int64_t update_ns);
+
+/**
+ * @brief Table-wide version, incremented after every applied batch
+ *
+ * Lets readers skip work when nothing changed since their last pass.
+ */
+uint64_t hl_mids_version(const hl_mids_table_t* table);
+
+/**
+ * @brief Shared mid table of a client
+ *
+ * Bound to the client's markets when hl_client_load_markets() succeeds.
+ *
+ * @param client Client instance
+ * @return Table (owned by client) or NULL
+ */
+hl_mids_table_t* hl_client_mids(hl_client_t* client);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // HL_MIDS_H
@@ -59,14 +59,34 @@ typedef struct {
     size_t cancels_count;     /**< Number of cancels */
 } hl_cancel_action_t;
 
+/**
+ * @brief Leverage update for one asset
+ */
+typedef struct {
+    uint32_t asset;     /**< Asset ID */
+    bool is_cross;      /**< Cross margin (false = isolated) */
+    uint32_t leverage;  /**< Leverage multiplier */
+} hl_update_leverage_t;
+
+/**
+ * @brief Isolated margin change for one asset
+ */
+typedef struct {
+    uint32_t asset;     /**< Asset ID */
+    bool is_buy;        /**< Position side */
+    int64_t ntli;       /**< Margin delta in USDC * 1e6 (negative removes) */
+} hl_update_isolated_margin_t;
+
 /**
  * @brief Build action hash (connection_id) for Hyperliquid
  * 
  * Serializes action to MessagePack, appends nonce and vault address,
- * then computes Keccak256 hash.
+ * then computes Keccak256 hash. The encoding goes through a fixed stack
+ * buffer into the hash state, so nothing is allocated.
  * 
- * @param action_type "order" or "cancel"
- * @param action_data Pointer to hl_order_action_t or hl_cancel_action_t
+ * @param action_type "order", "cancel", "updateLeverage" or "updateIsolatedMargin"
+ * @param action_data Pointer to hl_order_action_t, hl_cancel_action_t,
+ *                    hl_update_leverage_t or hl_update_isolated_margin_t
  * @param nonce Timestamp in milliseconds
  * @param vault_address Optional vault address (NULL for none)
  * @param connection_id_out Output buffer for 32-byte hash
@@ -78,6 +98,32 @@ int hl_build_action_hash(const char *action_type,
                          const char *vault_address,
                          uint8_t connection_id_out[32]);
 
+/**
+ * @brief One action to hash, as passed to hl_build_action_hash
+ */
+typedef struct {
+    const char *action_type;    /**< Any type hl_build_action_hash accepts */
+    const void *action_data;    /**< Matching action struct */
+    uint64_t nonce;             /**< Timestamp in milliseconds */
+    const char *vault_address;  /**< Optional vault address (NULL for none) */
+} hl_action_hash_request_t;
+
+/**
+ * @brief Build action hashes for several pending actions at once
+ * 
+ * Same result as calling hl_build_action_hash for each request, but the
+ * Keccak256 digests are computed together through keccak256_batch
+ * (4 or 8 per permutation on AVX2 or AVX-512 CPUs).
+ * 
+ * @param requests Actions to hash
+ * @param count Number of requests
+ * @param connection_ids_out One 32-byte hash per request, in order
+ * @return 0 on success, -1 on error
+ */
+int hl_build_action_hashes(const hl_action_hash_request_t *requests,
+                           size_t count,
+                           uint8_t connection_ids_out[][32]);
+
 /**
  * @brief Build order action hash
  * 
@@ -116,5 +162,33 @@ int hl_build_cancel_hash(const hl_cancel_t *cancels,
                          const char *vault_address,
                          uint8_t connection_id_out[32]);
 
+/**
+ * @brief Build updateLeverage action hash
+ * 
+ * @param update Leverage update
+ * @param nonce Timestamp in milliseconds
+ * @param vault_address Optional vault address (NULL for none)
+ * @param connection_id_out Output buffer for 32-byte hash
+ * @return 0 on success, -1 on error
+ */
+int hl_build_update_leverage_hash(const hl_update_leverage_t *update,
+                                  uint64_t nonce,
+                                  const char *vault_address,
+                                  uint8_t connection_id_out[32]);
+
+/**
+ * @brief Build updateIsolatedMargin action hash
+ * 
+ * @param update Margin change
+ * @param nonce Timestamp in milliseconds
+ * @param vault_address Optional vault address (NULL for none)
+ * @param connection_id_out Output buffer for 32-byte hash
+ * @return 0 on success, -1 on error
+ */
+int hl_build_update_isolated_margin_hash(const hl_update_isolated_margin_t *update,
+                                         uint64_t nonce,
+                                         const char *vault_address,
+                                         uint8_t connection_id_out[32]);
+
 #endif /* HYPERLIQUID_ACTION_H */
 
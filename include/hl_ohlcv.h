@@ -85,6 +85,14 @@ hl_error_t hl_fetch_ohlcv(hl_client_t* client, const char* symbol, const char* t
                          uint64_t* since, uint32_t* limit, uint64_t* until,
                          hl_ohlcvs_t* ohlcvs);
 
+/**
+ * @brief Length of one candle interval in milliseconds
+ *
+ * @param timeframe Timeframe (e.g., "1m", "1h"); "1M" counts as 30 days
+ * @return Interval length, or 0 for an unknown timeframe
+ */
+uint64_t hl_timeframe_ms(const char* timeframe);
+
 /**
  * @brief Free OHLCV data memory
  *
@@ -0,0 +1,68 @@
+/**
+ * @file hl_order_pipeline.h
+ * @brief Pipelined order placement
+ *
+ * hl_place_order() resolves the market, hashes, signs, builds the JSON
+ * body and waits for the HTTP response, all in turn under the client
+ * mutex. A pipeline splits that into stages on their own threads: one
+ * thread signs order N+1 while another has order N on the wire, so a
+ * steady stream of orders is limited by the slowest stage instead of the
+ * sum of all of them. Stages hand orders over through bounded lock-free
+ * queues.
+ */
+
+#ifndef HL_ORDER_PIPELINE_H
+#define HL_ORDER_PIPELINE_H
+
+#include <stddef.h>
+#include "hyperliquid.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct hl_order_pipeline hl_order_pipeline_t;
+
+/**
+ * @brief Create a pipeline for a client
+ *
+ * Markets are resolved through hl_client_mids(), so load them first
+ * (hl_client_load_markets()). Orders go out as WebSocket posts when the
+ * client has a WebSocket (see hl_ws_init_client()) and as /exchange POSTs
+ * otherwise.
+ *
+ * @param client Client instance with a private key
+ * @param depth Orders that can be queued or in progress at once (0 for 64)
+ * @return Pipeline or NULL on error
+ */
+hl_order_pipeline_t* hl_order_pipeline_create(hl_client_t* client, size_t depth);
+
+/**
+ * @brief Finish every submitted order, then stop the threads and free
+ */
+void hl_order_pipeline_destroy(hl_order_pipeline_t* pipeline);
+
+/**
+ * @brief Queue an order
+ *
+ * Copies the request and returns; blocks only while @p depth orders are
+ * already in the pipeline. Orders are signed and sent in submission
+ * order. The callback runs once per order: from the WebSocket I/O thread
+ * with the response to a post, or from a pipeline thread for HTTP
+ * responses and orders that failed before sending.
+ *
+ * @param pipeline Pipeline
+ * @param request Order request
+ * @param callback Completion callback
+ * @param user_data User data for callback
+ * @return HL_SUCCESS if the order was queued
+ */
+hl_error_t hl_order_pipeline_submit(hl_order_pipeline_t* pipeline,
+                                    const hl_order_request_api_t* request,
+                                    hl_ws_order_callback_t callback, void* user_data);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // HL_ORDER_PIPELINE_H
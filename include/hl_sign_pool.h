@@ -0,0 +1,79 @@
+/**
+ * @file hl_sign_pool.h
+ * @brief Sign many L1 actions at once on a pool of threads
+ *
+ * Processes that quote for many sub-accounts or vaults refresh all of them
+ * at the same moment. Each item carries its own signer, so one batch may
+ * mix accounts; items are split across the pool's threads and the calling
+ * thread, and results come back in input order. Action hashes are built
+ * in groups through the multi-buffer Keccak path.
+ */
+
+#ifndef HL_SIGN_POOL_H
+#define HL_SIGN_POOL_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "hl_error.h"
+#include "hl_signer.h"
+#include "hl_msgpack.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct hl_sign_pool hl_sign_pool_t;
+
+/**
+ * @brief One action to sign
+ */
+typedef struct {
+    const hl_signer_t* signer;          /**< Account (or agent) key */
+    hl_action_hash_request_t action;    /**< Action type, data, nonce and vault */
+    bool testnet;                       /**< Sign with the testnet source */
+} hl_sign_item_t;
+
+/**
+ * @brief Signature of one item
+ */
+typedef struct {
+    hl_error_t error;                   /**< HL_SUCCESS or why this item failed */
+    uint8_t signature[65];              /**< r || s || v */
+} hl_sign_result_t;
+
+/**
+ * @brief Create a signing pool
+ *
+ * @param threads Threads that sign, counting the caller of
+ *                hl_sign_pool_sign(); 0 for one per online CPU
+ * @return Pool or NULL on error
+ */
+hl_sign_pool_t* hl_sign_pool_create(size_t threads);
+
+/**
+ * @brief Stop the pool threads and free the pool
+ */
+void hl_sign_pool_destroy(hl_sign_pool_t* pool);
+
+/**
+ * @brief Sign every item, in parallel
+ *
+ * Blocks until all items are signed. Batches from several callers are
+ * run one after another.
+ *
+ * @param pool Pool
+ * @param items Actions to sign
+ * @param count Number of items
+ * @param results One result per item, in input order
+ * @return HL_SUCCESS if every item was signed, otherwise the first failing
+ *         item's error
+ */
+hl_error_t hl_sign_pool_sign(hl_sign_pool_t* pool, const hl_sign_item_t* items, size_t count,
+                             hl_sign_result_t* results);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // HL_SIGN_POOL_H
@@ -0,0 +1,96 @@
+/**
+ * @file hl_signer.h
+ * @brief Long-lived secp256k1 signing key
+ *
+ * A signer parses a private key once and keeps everything a signature
+ * needs: a randomized secp256k1 context, the 32-byte key in locked memory
+ * (wiped on destroy) and the derived address. Every client owns one,
+ * created with the client; order, cancel and leverage actions are signed
+ * through it.
+ */
+
+#ifndef HL_SIGNER_H
+#define HL_SIGNER_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include "hl_error.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct hl_signer hl_signer_t;
+
+/**
+ * @brief Create a signer from a hex private key
+ *
+ * @param private_key_hex 64 hex characters, with or without 0x prefix
+ * @return Signer, or NULL if the key is not a valid secp256k1 secret key
+ */
+hl_signer_t* hl_signer_create(const char* private_key_hex);
+
+/**
+ * @brief Wipe the key and free the signer
+ */
+void hl_signer_destroy(hl_signer_t* signer);
+
+/**
+ * @brief Address of the key ("0x" followed by 40 lowercase hex digits)
+ */
+const char* hl_signer_address(const hl_signer_t* signer);
+
+/**
+ * @brief Recover every signature and check it against the address
+ *
+ * The recovery id reported by the signing operation is trusted by default.
+ * Verify mode adds a public-key recovery per signature (roughly doubling
+ * its cost) and fails any signature that does not recover to this key.
+ * On by default in DEBUG builds. Set it before signing from other threads.
+ */
+void hl_signer_set_verify(hl_signer_t* signer, bool verify);
+
+/**
+ * @brief Allocate a nonce for an action signed with this key
+ *
+ * Nonces are unique and strictly increasing across every thread using
+ * the signer (lock-free). Each one is the current time unless an earlier
+ * call already took it; actions that share a millisecond then get the
+ * following values, running slightly ahead of the clock.
+ *
+ * @param signer Signer
+ * @param now_ms Current time on the exchange clock
+ * @return Nonce, or 0 if it would be more than an hour ahead of @p now_ms
+ */
+uint64_t hl_signer_next_nonce(hl_signer_t* signer, uint64_t now_ms);
+
+/**
+ * @brief Allocate @p count consecutive nonces
+ *
+ * For batches and pre-signed actions: the caller owns
+ * [first, first + count) and may use them in any order, as long as each
+ * is used once.
+ *
+ * @return First nonce of the block, or 0 as for hl_signer_next_nonce()
+ */
+uint64_t hl_signer_reserve_nonces(hl_signer_t* signer, uint64_t now_ms, size_t count);
+
+/**
+ * @brief Sign a 32-byte digest
+ *
+ * Deterministic (RFC 6979). Safe to call from several threads at once.
+ *
+ * @param signer Signer
+ * @param hash Digest to sign
+ * @param signature_out r || s || v, with v = 27 + recovery id
+ * @return HL_SUCCESS or HL_ERROR_SIGNATURE
+ */
+hl_error_t hl_signer_sign_hash(const hl_signer_t* signer, const uint8_t hash[32],
+                               uint8_t signature_out[65]);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // HL_SIGNER_H
@@ -7,25 +7,45 @@
 #define HL_WS_CLIENT_H
 
 #include <stdbool.h>
+#include <stddef.h>
 #include <stdint.h>
+#include "hl_error.h"
 
 // Forward declarations
 typedef struct hl_ws_client hl_ws_client_t;
 typedef struct hl_ws_config hl_ws_config_t;
+typedef struct hl_client hl_client_t;
 typedef void (*hl_ws_message_callback_t)(const char* message, size_t size, void* user_data);
 typedef void (*hl_ws_error_callback_t)(const char* error, void* user_data);
 typedef void (*hl_ws_connect_callback_t)(void* user_data);
+typedef void (*hl_ws_disconnect_callback_t)(const char* reason, void* user_data);
+
+/**
+ * @brief Receive loop of the I/O thread
+ */
+typedef enum {
+    HL_WS_IO_POLL = 0,                  /**< poll() and a read per wakeup */
+    HL_WS_IO_URING = 1                  /**< io_uring multishot receive (Linux; falls back to poll) */
+} hl_ws_io_backend_t;
 
 /**
  * @brief WebSocket client configuration
  */
 struct hl_ws_config {
-    const char* url;                    /**< WebSocket URL */
-    int reconnect_delay_ms;             /**< Delay between reconnection attempts */
+    const char* url;                    /**< WebSocket URL (ws:// or wss://) */
+    int reconnect_delay_ms;             /**< Initial delay between reconnection attempts */
+    int reconnect_max_delay_ms;         /**< Upper bound for the backoff delay */
     int ping_interval_ms;               /**< Ping interval */
     int timeout_ms;                     /**< Connection timeout */
     bool auto_reconnect;                /**< Auto reconnect on disconnect */
-    int max_reconnect_attempts;         /**< Maximum reconnection attempts */
+    int max_reconnect_attempts;         /**< Maximum consecutive attempts (0 = unlimited) */
+    bool enable_compression;            /**< Offer permessage-deflate */
+    bool compression_no_context_takeover; /**< Ask server to reset its compressor per message */
+    bool busy_poll;                     /**< Spin on non-blocking reads instead of poll() */
+    int busy_poll_cpu;                  /**< CPU to pin the I/O thread to in busy-poll mode (-1 = none) */
+    int busy_poll_us;                   /**< SO_BUSY_POLL value in microseconds (0 = leave unset) */
+    int address_index;                  /**< Resolved address to try first (others follow in order) */
+    hl_ws_io_backend_t io_backend;      /**< Receive loop when not busy-polling */
 };
 
 /**
@@ -39,6 +59,7 @@ struct hl_ws_client {
     hl_ws_message_callback_t on_message;
     hl_ws_error_callback_t on_error;
     hl_ws_connect_callback_t on_connect;
+    hl_ws_disconnect_callback_t on_disconnect;
     void* user_data;                    /**< User data for callbacks */
 
     // State
@@ -61,6 +82,14 @@ void hl_ws_client_destroy(hl_ws_client_t* client);
 
 /**
  * @brief Connect to WebSocket server
+ *
+ * Performs the TCP/TLS connect and the WebSocket handshake on the calling
+ * thread, then starts the background I/O thread. If the connection drops
+ * later and auto_reconnect is set, the I/O thread reconnects on its own with
+ * jittered exponential backoff and invokes the connect callback again.
+ * Once the I/O thread stops (a drop without auto_reconnect, or reconnect
+ * attempts exhausted), the client is idle and may be connected again.
+ *
  * @param client Client instance
  * @return true on success
  */
@@ -69,6 +98,7 @@ bool hl_ws_client_connect(hl_ws_client_t* client);
 /**
  * @brief Disconnect from WebSocket server
  * @param client Client instance
+ * @note Must not be called from inside a client callback
  */
 void hl_ws_client_disconnect(hl_ws_client_t* client);
 
@@ -89,6 +119,19 @@ bool hl_ws_client_send(hl_ws_client_t* client, const char* message, size_t size)
  */
 bool hl_ws_client_send_text(hl_ws_client_t* client, const char* message);
 
+/**
+ * @brief Send several text messages in a single socket write
+ *
+ * All frames are encoded into one buffer and written back to back, so a
+ * batch of subscriptions costs one write instead of one per message.
+ *
+ * @param client Client instance
+ * @param messages Array of null-terminated strings
+ * @param count Number of messages
+ * @return true on success
+ */
+bool hl_ws_client_send_batch(hl_ws_client_t* client, const char* const* messages, size_t count);
+
 /**
  * @brief Check if client is connected
  * @param client Client instance
@@ -118,6 +161,9 @@ void hl_ws_client_set_error_callback(hl_ws_client_t* client,
 
 /**
  * @brief Set connect callback
+ *
+ * Invoked after the initial connect and after every successful reconnect.
+ *
  * @param client Client instance
  * @param callback Connect callback
  * @param user_data User data for callback
@@ -126,6 +172,142 @@ void hl_ws_client_set_connect_callback(hl_ws_client_t* client,
                                       hl_ws_connect_callback_t callback,
                                       void* user_data);
 
+/**
+ * @brief Set disconnect callback
+ *
+ * Invoked from the I/O thread when an established connection is lost,
+ * before any reconnection attempt is made.
+ *
+ * @param client Client instance
+ * @param callback Disconnect callback
+ * @param user_data User data for callback
+ */
+void hl_ws_client_set_disconnect_callback(hl_ws_client_t* client,
+                                         hl_ws_disconnect_callback_t callback,
+                                         void* user_data);
+
+/**
+ * @brief Configure busy-poll receive mode
+ *
+ * Takes effect when the I/O thread next starts (hl_ws_client_connect()).
+ * The thread is pinned to @p cpu and spins on non-blocking reads, so a
+ * whole core is consumed for as long as the client is connected.
+ *
+ * @param client Client instance
+ * @param enable Spin instead of sleeping in poll()
+ * @param cpu CPU to pin the I/O thread to (-1 = don't pin)
+ * @param busy_poll_us SO_BUSY_POLL budget in microseconds (0 = don't set)
+ */
+void hl_ws_client_set_busy_poll(hl_ws_client_t* client, bool enable, int cpu, int busy_poll_us);
+
+/**
+ * @brief Select the receive loop of the I/O thread
+ *
+ * Takes effect when the I/O thread next starts (hl_ws_client_connect()).
+ * With HL_WS_IO_URING, plain ws:// sockets are read by one multishot
+ * receive into a registered buffer pool, and wss:// sockets are driven by
+ * multishot poll. If the kernel lacks io_uring support, the thread falls
+ * back to poll(). Busy-poll mode takes precedence.
+ *
+ * @param client Client instance
+ * @param backend Receive loop
+ */
+void hl_ws_client_set_io_backend(hl_ws_client_t* client, hl_ws_io_backend_t backend);
+
+/**
+ * @brief Wall-clock receive time of the message being dispatched
+ *
+ * Taken as the read that delivered the message's last bytes returned.
+ * Only meaningful from inside the message callback.
+ *
+ * @param client Client instance
+ * @return Nanoseconds since the Unix epoch
+ */
+int64_t hl_ws_client_last_rx_time_ns(const hl_ws_client_t* client);
+
+/**
+ * @brief Rolling distribution of a latency measurement (milliseconds)
+ *
+ * Computed over the most recent samples; total_samples counts every sample
+ * since the client was created.
+ */
+typedef struct {
+    uint64_t total_samples;             /**< Samples observed since creation */
+    size_t window_samples;              /**< Samples in the rolling window */
+    double last;                        /**< Most recent sample */
+    double min;                         /**< Window minimum */
+    double mean;                        /**< Window mean */
+    double p50;                         /**< Window median */
+    double p90;                         /**< Window 90th percentile */
+    double p99;                         /**< Window 99th percentile */
+    double max;                         /**< Window maximum */
+} hl_ws_latency_t;
+
+/**
+ * @brief Live connection timing statistics
+ */
+typedef struct {
+    hl_ws_latency_t rtt;                /**< Ping/pong round-trip time */
+    hl_ws_latency_t delay;              /**< Receive time minus server timestamp (uncorrected) */
+    double clock_offset_ms;             /**< Estimated local minus server clock */
+    bool clock_offset_valid;            /**< At least one server timestamp was seen */
+    char peer_address[64];              /**< Numeric address of the current connection */
+
+    // Traffic counters (since creation)
+    bool compression_active;            /**< permessage-deflate negotiated on current connection */
+    uint64_t rx_wire_bytes;             /**< Bytes read from the socket (after TLS) */
+    uint64_t rx_payload_bytes;          /**< Data message payload bytes as received */
+    uint64_t rx_decoded_bytes;          /**< Data message bytes after inflation */
+    uint64_t rx_messages;               /**< Data messages received */
+    uint64_t rx_compressed_messages;    /**< Data messages that arrived compressed */
+} hl_ws_stats_t;
+
+/**
+ * @brief Get connection timing statistics
+ *
+ * RTT comes from ping/pong frames carrying a send timestamp. The clock
+ * offset is the minimum observed delay (the least queued message in the
+ * window) minus half the minimum RTT.
+ *
+ * @param client Client instance
+ * @param stats Output statistics
+ * @return true on success
+ */
+bool hl_ws_client_get_stats(const hl_ws_client_t* client, hl_ws_stats_t* stats);
+
+/**
+ * @brief Feed a server timestamp from the message being dispatched
+ *
+ * Must be called from the message callback: the sample is paired with the
+ * receive time of the read that produced the message.
+ *
+ * @param client Client instance
+ * @param server_time_ms Server timestamp carried by the message
+ * @return Message age in ms, corrected for the clock offset
+ */
+double hl_ws_client_note_server_time(hl_ws_client_t* client, int64_t server_time_ms);
+
+/**
+ * @brief Current time on the server's clock
+ * @param client Client instance
+ * @return Local wall clock in ms minus the estimated clock offset
+ */
+int64_t hl_ws_client_server_time_ms(const hl_ws_client_t* client);
+
+/**
+ * @brief Configure permessage-deflate for subsequent connections
+ *
+ * Takes effect at the next connect or reconnect. With context takeover
+ * (the default) the server keeps its compression window across messages,
+ * which compresses repetitive streams far better at the cost of memory on
+ * both ends; no_context_takeover trades ratio for a fresh window each time.
+ *
+ * @param client Client instance
+ * @param enable Offer permessage-deflate in the handshake
+ * @param no_context_takeover Request server_no_context_takeover
+ */
+void hl_ws_client_set_compression(hl_ws_client_t* client, bool enable, bool no_context_takeover);
+
 /**
  * @brief Get default WebSocket configuration
  * @param config Output configuration
@@ -133,4 +315,405 @@ void hl_ws_client_set_connect_callback(hl_ws_client_t* client,
  */
 void hl_ws_config_default(hl_ws_config_t* config, bool testnet);
 
+// ============================================================================
+// Subscription API (CCXT watch_* methods)
+// ============================================================================
+
+/**
+ * @brief Data callback for subscriptions
+ *
+ * @p data points to an hl_ws_message_t that is only valid for the duration
+ * of the callback.
+ */
+typedef void (*hl_ws_data_callback_t)(void* data, void* user_data);
+
+/**
+ * @brief Message delivered to subscription callbacks
+ */
+typedef struct {
+    const char* channel;                /**< Channel name (e.g. "l2Book") */
+    const char* coin;                   /**< Coin the update refers to (NULL if none) */
+    const char* raw;                    /**< Raw message text */
+    size_t raw_size;                    /**< Raw message length */
+    void* json;                         /**< Parsed "data" payload (cJSON*) */
+    bool is_snapshot;                   /**< First message after (re)subscribing */
+    int64_t server_time_ms;             /**< Server timestamp ("time" field), 0 if absent */
+    int64_t recv_time_ns;               /**< Wall clock when the bytes were read */
+    double age_ms;                      /**< Offset-corrected age at receipt (0 if no timestamp) */
+} hl_ws_message_t;
+
+/**
+ * @brief What a subscription callback's @p data points to
+ */
+typedef enum {
+    HL_WS_PAYLOAD_MESSAGE,              /**< hl_ws_message_t */
+    HL_WS_PAYLOAD_BBO                   /**< hl_bbo_t (see hl_bbo.h) */
+} hl_ws_payload_t;
+
+/**
+ * @brief Subscription registry entry
+ */
+typedef struct {
+    char subscription_id[37];           /**< UUID returned by hl_watch_* */
+    char channel[32];                   /**< Channel type (e.g. "l2Book") */
+    char symbol[64];                    /**< Symbol as passed by the caller */
+    char coin[32];                      /**< Exchange coin name (e.g. "BTC"), empty for user channels */
+    char interval[8];                   /**< Candle interval, empty for other channels */
+    char subscription[256];             /**< Subscription object JSON sent to the server */
+    hl_ws_data_callback_t callback;     /**< Data callback */
+    void* user_data;                    /**< User data for callback */
+    hl_ws_payload_t payload;            /**< Type passed to callback */
+    uint64_t message_count;             /**< Messages delivered since (re)subscribing */
+    bool active;                        /**< Subscription is active */
+    bool stale;                         /**< Waiting for a fresh snapshot after reconnect */
+    bool shared;                        /**< Carried by the attached hub's connection */
+    bool redundant;                     /**< Also carried by the backup connection */
+    bool set_member;                    /**< Owned by a subscription set, freed once inactive */
+} hl_ws_subscription_t;
+
+/**
+ * @brief Resync events reported for subscriptions
+ */
+typedef enum {
+    HL_WS_RESYNC_STALE,                 /**< Connection lost, local state is stale */
+    HL_WS_RESYNC_RESUBSCRIBED,          /**< Subscription replayed after reconnect */
+    HL_WS_RESYNC_RECOVERED              /**< Fresh snapshot received, state is current */
+} hl_ws_resync_event_t;
+
+/**
+ * @brief Resync callback, invoked once per subscription and event
+ */
+typedef void (*hl_ws_resync_callback_t)(const hl_ws_subscription_t* subscription,
+                                        hl_ws_resync_event_t event,
+                                        void* user_data);
+
+/**
+ * @brief Initialize WebSocket for client
+ * @param client Client instance
+ * @param testnet Use testnet URLs
+ * @return true on success
+ */
+bool hl_ws_init_client(hl_client_t* client, bool testnet);
+
+/**
+ * @brief Cleanup WebSocket for client
+ * @param client Client instance
+ */
+void hl_ws_cleanup_client(hl_client_t* client);
+
+/**
+ * @brief Set resync callback
+ *
+ * Reports when subscriptions go stale on disconnect, are replayed after a
+ * reconnect and recover once a fresh snapshot arrives.
+ *
+ * @param client Client instance
+ * @param callback Resync callback
+ * @param user_data User data for callback
+ */
+void hl_ws_set_resync_callback(hl_client_t* client,
+                               hl_ws_resync_callback_t callback,
+                               void* user_data);
+
+/**
+ * @brief Check whether a subscription is waiting for a fresh snapshot
+ *
+ * For a group ID, true if any of its topics is stale.
+ *
+ * @param client Client instance
+ * @param subscription_id Subscription ID
+ * @return true if the subscription's data is stale
+ */
+bool hl_ws_is_stale(hl_client_t* client, const char* subscription_id);
+
+/**
+ * @brief Get connection timing statistics (RTT, delay, clock offset)
+ * @param client Client instance
+ * @param stats Output statistics
+ * @return true on success
+ */
+bool hl_ws_get_stats(hl_client_t* client, hl_ws_stats_t* stats);
+
+/**
+ * @brief Enable permessage-deflate for the client's WebSocket
+ *
+ * Call before the first hl_watch_* (or reconnect to apply).
+ *
+ * @param client Client instance
+ * @param enable Offer permessage-deflate
+ * @param no_context_takeover Request server_no_context_takeover
+ */
+void hl_ws_set_compression(hl_client_t* client, bool enable, bool no_context_takeover);
+
+/**
+ * @brief Enable busy-poll receive mode for the client's WebSocket
+ *
+ * Call before the first hl_watch_* so the I/O thread starts pinned.
+ *
+ * @param client Client instance
+ * @param enable Spin on non-blocking reads
+ * @param cpu CPU to pin the I/O thread to (-1 = don't pin)
+ * @param busy_poll_us SO_BUSY_POLL budget in microseconds (0 = don't set)
+ */
+void hl_ws_set_busy_poll(hl_client_t* client, bool enable, int cpu, int busy_poll_us);
+
+/**
+ * @brief Select the receive loop of the client's WebSocket
+ *
+ * Call before the first hl_watch_* so the I/O thread starts with it.
+ *
+ * @param client Client instance
+ * @param backend Receive loop
+ */
+void hl_ws_set_io_backend(hl_client_t* client, hl_ws_io_backend_t backend);
+
+/**
+ * @brief Current time on the exchange clock, as estimated from the stream
+ *
+ * Falls back to the local wall clock before any server timestamp was seen.
+ *
+ * @param client Client instance
+ * @return Server time in milliseconds
+ */
+int64_t hl_ws_server_time_ms(hl_client_t* client);
+
+const char* hl_watch_ticker(hl_client_t* client, const char* symbol,
+                           hl_ws_data_callback_t callback, void* user_data);
+/**
+ * @brief Watch tickers of several symbols
+ *
+ * The symbols are subscribed as one group under a single ID: hl_unwatch()
+ * on it drops every symbol. With no symbols, all tickers are watched.
+ *
+ * @param client Client instance
+ * @param symbols Trading symbols (NULL or empty for all)
+ * @param symbols_count Number of symbols
+ * @param callback Data callback
+ * @param user_data User data for callback
+ * @return Subscription ID or NULL on error
+ */
+const char* hl_watch_tickers(hl_client_t* client, const char** symbols, size_t symbols_count,
+                            hl_ws_data_callback_t callback, void* user_data);
+/**
+ * @brief Stream mid prices of all assets into the client's shared table
+ *
+ * Every allMids message updates hl_client_mids(client) before callbacks
+ * run, so any number of threads can read prices with hl_mids_get()
+ * instead of polling and parsing allMids themselves. Markets are loaded
+ * first if the client has none, so coins can be mapped to asset IDs.
+ *
+ * @param client Client instance
+ * @param callback Optional per-message callback (may be NULL)
+ * @param user_data User data for callback
+ * @return Subscription ID or NULL on error
+ */
+const char* hl_watch_all_mids(hl_client_t* client, hl_ws_data_callback_t callback, void* user_data);
+/**
+ * @brief Stream a perpetual's asset context into the cached markets
+ *
+ * Each activeAssetCtx update rewrites the dynamic fields of the cached
+ * hl_market_t (mark, oracle and mid price, funding, premium, open interest,
+ * volume) in place. Once a market is streamed, hl_get_ticker() reads it
+ * from memory instead of downloading metaAndAssetCtxs.
+ *
+ * @param client Client instance
+ * @param symbol Trading symbol
+ * @param callback Optional per-message callback (may be NULL)
+ * @param user_data User data for callback
+ * @return Subscription ID or NULL on error
+ */
+const char* hl_watch_asset_ctx(hl_client_t* client, const char* symbol,
+                               hl_ws_data_callback_t callback, void* user_data);
+
+/**
+ * @brief Stream asset contexts of every perpetual market
+ *
+ * With all perps streamed, hl_fetch_funding_rates() is served from memory.
+ *
+ * @return Number of markets subscribed
+ */
+size_t hl_watch_asset_ctxs(hl_client_t* client, hl_ws_data_callback_t callback, void* user_data);
+const char* hl_watch_order_book(hl_client_t* client, const char* symbol, uint32_t depth,
+                               hl_ws_data_callback_t callback, void* user_data);
+const char* hl_watch_ohlcv(hl_client_t* client, const char* symbol, const char* timeframe,
+                          hl_ws_data_callback_t callback, void* user_data);
+const char* hl_watch_trades(hl_client_t* client, const char* symbol,
+                           hl_ws_data_callback_t callback, void* user_data);
+const char* hl_watch_orders(hl_client_t* client, const char* symbol,
+                           hl_ws_data_callback_t callback, void* user_data);
+const char* hl_watch_my_trades(hl_client_t* client, const char* symbol,
+                              hl_ws_data_callback_t callback, void* user_data);
+
+/**
+ * @brief Unwatch subscription
+ *
+ * Removes every entry registered under the ID. A server subscription still
+ * used by another watch stays subscribed; otherwise its full subscription
+ * object is unsubscribed.
+ *
+ * @param client Client instance
+ * @param subscription_id Subscription ID returned by hl_watch_*
+ * @return true if the ID was active
+ */
+bool hl_unwatch(hl_client_t* client, const char* subscription_id);
+
+// ============================================================================
+// Subscription sets
+// ============================================================================
+
+/**
+ * @brief One topic of a subscription set
+ */
+typedef struct {
+    const char* channel;                /**< Channel type (e.g. "l2Book", "trades", "candle") */
+    const char* symbol;                 /**< Trading symbol, NULL for channels without a coin */
+    const char* interval;               /**< Candle interval, NULL for other channels */
+} hl_ws_topic_t;
+
+typedef struct hl_ws_sub_set hl_ws_sub_set_t;
+
+/**
+ * @brief Create an empty subscription set
+ *
+ * A set holds the topics a strategy wants to stream. Each
+ * hl_ws_sub_set_apply() replaces them with a new desired list and sends
+ * only the difference, so rebalancing a universe of coins costs one
+ * message per coin that changed instead of a full resubscribe.
+ *
+ * @param client Client instance
+ * @param callback Data callback for every topic of the set
+ * @param user_data User data for callback
+ * @return Set or NULL on error
+ */
+hl_ws_sub_set_t* hl_ws_sub_set_create(hl_client_t* client, hl_ws_data_callback_t callback,
+                                      void* user_data);
+
+/**
+ * @brief Make the set's subscriptions match @p topics
+ *
+ * Topics no longer listed are unsubscribed and new ones subscribed; topics
+ * already in the set are untouched. Messages go out in batched writes,
+ * unsubscribes first, paced to stay under the server's message rate. A
+ * server subscription used by another watch is neither sent twice nor
+ * dropped. Not safe to call concurrently on the same set.
+ *
+ * @param set Subscription set
+ * @param topics Desired topics (duplicates are ignored)
+ * @param count Number of topics, 0 to unsubscribe everything
+ * @param subscribed Optional output for the number of topics added
+ * @param unsubscribed Optional output for the number of topics removed
+ * @return HL_SUCCESS, HL_ERROR_INVALID_PARAMS, HL_ERROR_MEMORY or
+ *         HL_ERROR_NETWORK if the connection could not be opened
+ */
+hl_error_t hl_ws_sub_set_apply(hl_ws_sub_set_t* set, const hl_ws_topic_t* topics, size_t count,
+                               size_t* subscribed, size_t* unsubscribed);
+
+/**
+ * @brief Number of topics currently in the set
+ */
+size_t hl_ws_sub_set_size(hl_ws_sub_set_t* set);
+
+/**
+ * @brief Subscription ID shared by the set's topics
+ *
+ * Can be passed to hl_ws_is_stale() and hl_unwatch().
+ */
+const char* hl_ws_sub_set_id(const hl_ws_sub_set_t* set);
+
+/**
+ * @brief Unsubscribe every topic and free the set
+ */
+void hl_ws_sub_set_destroy(hl_ws_sub_set_t* set);
+
+// ============================================================================
+// Redundant feeds
+// ============================================================================
+
+/**
+ * @brief Arbitration statistics of one feed
+ */
+typedef struct {
+    bool connected;                     /**< Connection is up */
+    char peer_address[64];              /**< Numeric address of the current connection */
+    uint64_t messages;                  /**< Copies of redundant messages received */
+    uint64_t wins;                      /**< Copies delivered because they came first */
+    double win_rate;                    /**< Share of delivered messages that came from this feed */
+    hl_ws_latency_t lag;                /**< Delay behind the other feed on lost races (ms) */
+} hl_ws_feed_stats_t;
+
+/**
+ * @brief Open a backup connection for redundant subscriptions
+ *
+ * The backup uses the same settings as the client's connection. Without
+ * @p backup_url it connects to the same host but tries the next resolved
+ * address first, so the two connections land on different endpoints when
+ * the host resolves to several.
+ *
+ * @param client Client instance
+ * @param backup_url URL for the backup connection, NULL for the same URL
+ * @return true on success (or if already enabled)
+ */
+bool hl_ws_enable_dual_feed(hl_client_t* client, const char* backup_url);
+
+/**
+ * @brief Carry a subscription on both connections
+ *
+ * Each message of a redundant topic arrives twice. Copies are matched by
+ * channel, coin and exchange time (first trade id for trades) and the first
+ * one processed is delivered; the other is dropped and counted in the
+ * losing feed's lag. Supported for l2Book, bbo and trades subscriptions
+ * on the client's own connection. hl_unwatch() also removes the backup
+ * subscription.
+ *
+ * @param client Client instance with dual feed enabled
+ * @param subscription_id Subscription ID returned by hl_watch_*
+ * @param redundant true to mirror on the backup, false to stop
+ * @return true if a supported subscription was found and updated
+ */
+bool hl_ws_set_redundant(hl_client_t* client, const char* subscription_id, bool redundant);
+
+/**
+ * @brief Get arbitration statistics of both feeds
+ *
+ * @param client Client instance
+ * @param primary Output for the client's own connection (may be NULL)
+ * @param backup Output for the backup connection (may be NULL)
+ * @return false if dual feed is not enabled
+ */
+bool hl_ws_get_feed_stats(hl_client_t* client, hl_ws_feed_stats_t* primary,
+                          hl_ws_feed_stats_t* backup);
+
+// ============================================================================
+// Post API (request/response over the WebSocket)
+// ============================================================================
+
+/**
+ * @brief Completion callback for post requests
+ *
+ * @p response is the response payload JSON (the same body /exchange or /info
+ * would return over HTTP), or the error text when status is not HL_SUCCESS.
+ * Invoked from the I/O thread; the string is only valid during the call.
+ */
+typedef void (*hl_ws_post_callback_t)(uint64_t request_id, hl_error_t status,
+                                      const char* response, void* user_data);
+
+/**
+ * @brief Send a post request and route its response to a callback
+ *
+ * Requests are tagged with a client-side id and correlated with the
+ * server's "post" channel responses. Pending requests fail with
+ * HL_ERROR_NETWORK when the connection drops.
+ *
+ * @param client Client instance
+ * @param type Request type ("action" or "info")
+ * @param payload Payload JSON (signed action body or info request)
+ * @param callback Completion callback
+ * @param user_data User data for callback
+ * @param request_id Optional output for the assigned request id
+ * @return HL_SUCCESS if the request was sent
+ */
+hl_error_t hl_ws_post(hl_client_t* client, const char* type, const char* payload,
+                      hl_ws_post_callback_t callback, void* user_data,
+                      uint64_t* request_id);
+
 #endif // HL_WS_CLIENT_H
@@ -0,0 +1,74 @@
+/**
+ * @file hl_ws_hub.h
+ * @brief Process-wide hub for public WebSocket data
+ *
+ * Processes that run many clients (for example one per sub-account) would
+ * otherwise open one socket per client and subscribe to the same books and
+ * trades on each. Clients attached to a hub send their public
+ * subscriptions through the hub's single connection instead. Identical
+ * subscriptions are sent to the server once, and every received message is
+ * decoded once and routed to the subscriptions of all attached clients.
+ * Per-account channels (order updates, fills) and post requests stay on
+ * each client's own connection.
+ */
+
+#ifndef HL_WS_HUB_H
+#define HL_WS_HUB_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include "hl_ws_client.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct hl_ws_hub hl_ws_hub_t;
+
+/**
+ * @brief Create a hub
+ *
+ * The connection is opened by the first shared subscription and
+ * reconnects automatically, replaying every shared subscription.
+ *
+ * @param testnet Use testnet
+ * @return Hub or NULL on error
+ */
+hl_ws_hub_t* hl_ws_hub_create(bool testnet);
+
+/**
+ * @brief Close the hub connection and free the hub
+ *
+ * Call after every attached client was freed or cleaned up.
+ */
+void hl_ws_hub_destroy(hl_ws_hub_t* hub);
+
+/**
+ * @brief Route a client's public subscriptions through a hub
+ *
+ * Applies to subscriptions made after this call; call it right after
+ * hl_ws_init_client(). Subscriptions made while the client is offline
+ * (hl_ws_set_offline()) are not shared. The client detaches when its
+ * WebSocket is cleaned up.
+ *
+ * @param client Client instance with WebSocket initialized
+ * @param hub Hub for the same network
+ * @return true on success
+ */
+bool hl_ws_attach_hub(hl_client_t* client, hl_ws_hub_t* hub);
+
+/**
+ * @brief Attached clients and distinct server subscriptions of a hub
+ */
+void hl_ws_hub_get_counts(hl_ws_hub_t* hub, size_t* clients, size_t* subscriptions);
+
+/**
+ * @brief Connection timing statistics of the hub connection
+ */
+bool hl_ws_hub_get_stats(hl_ws_hub_t* hub, hl_ws_stats_t* stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // HL_WS_HUB_H
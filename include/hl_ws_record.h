@@ -0,0 +1,174 @@
+/**
+ * @file hl_ws_record.h
+ * @brief Capture and replay of raw WebSocket streams
+ *
+ * File layout (host byte order):
+ *   header  : "HLWSREC1" | uint32 version | uint32 flags | 16 reserved bytes
+ *   record  : uint32 stored_len | uint32 raw_len | int64 recv_time_ns | data
+ *
+ * Each record is padded with zeros to an 8-byte boundary (always at least
+ * one zero byte), so uncompressed messages can be read straight out of an
+ * mmap'd file as NUL-terminated strings. Compressed files deflate each
+ * record on its own, which keeps records independently decodable.
+ */
+
+#ifndef HL_WS_RECORD_H
+#define HL_WS_RECORD_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "hl_error.h"
+#include "hl_ws_client.h"
+
+#define HL_WS_RECORD_MAGIC "HLWSREC1"
+#define HL_WS_RECORD_VERSION 1
+#define HL_WS_RECORD_FLAG_COMPRESSED 0x1u
+
+typedef struct hl_ws_recorder hl_ws_recorder_t;
+typedef struct hl_ws_replay hl_ws_replay_t;
+
+// ============================================================================
+// Recorder
+// ============================================================================
+
+/**
+ * @brief Create a capture file (truncates existing file)
+ * @param path Output path
+ * @param compress Deflate each record
+ * @return Recorder or NULL on error
+ */
+hl_ws_recorder_t* hl_ws_recorder_open(const char* path, bool compress);
+
+/**
+ * @brief Append one message
+ * @param recorder Recorder
+ * @param message Raw message bytes
+ * @param size Message length
+ * @param recv_time_ns Wall-clock receive time
+ * @return true on success
+ */
+bool hl_ws_recorder_write(hl_ws_recorder_t* recorder, const char* message, size_t size,
+                          int64_t recv_time_ns);
+
+/**
+ * @brief Number of messages written so far
+ */
+uint64_t hl_ws_recorder_count(const hl_ws_recorder_t* recorder);
+
+/**
+ * @brief Flush and close capture file
+ */
+void hl_ws_recorder_close(hl_ws_recorder_t* recorder);
+
+/**
+ * @brief Tee every message received by a transport into a recorder
+ *
+ * Messages are written from the I/O thread, after decompression and with
+ * the receive timestamp of the read that delivered them.
+ *
+ * @param client WebSocket client
+ * @param recorder Recorder, or NULL to stop recording
+ */
+void hl_ws_client_set_recorder(hl_ws_client_t* client, hl_ws_recorder_t* recorder);
+
+// ============================================================================
+// Replay
+// ============================================================================
+
+/**
+ * @brief Open a capture file for reading (memory-mapped)
+ * @param path Capture file
+ * @return Replay handle or NULL on error
+ */
+hl_ws_replay_t* hl_ws_replay_open(const char* path);
+
+/**
+ * @brief Read the next message
+ *
+ * The returned string is NUL-terminated and valid until the next call.
+ *
+ * @param replay Replay handle
+ * @param message Output message pointer
+ * @param size Output message length
+ * @param recv_time_ns Output receive timestamp
+ * @return true if a message was returned, false at end of file or on corruption
+ */
+bool hl_ws_replay_next(hl_ws_replay_t* replay, const char** message, size_t* size,
+                       int64_t* recv_time_ns);
+
+/**
+ * @brief Recorded receive time of the message last returned
+ *
+ * Lets a hl_ws_replay_run() callback see the same timestamp that
+ * hl_ws_client_last_rx_time_ns() gives live handlers.
+ */
+int64_t hl_ws_replay_time_ns(const hl_ws_replay_t* replay);
+
+/**
+ * @brief Rewind to the first message
+ */
+void hl_ws_replay_rewind(hl_ws_replay_t* replay);
+
+/**
+ * @brief Feed every message to a callback, paced by recorded timestamps
+ *
+ * @param replay Replay handle
+ * @param speed 1.0 = original pace, N = N times faster, <= 0 = as fast as possible
+ * @param callback Receives each message (same signature as live transport)
+ * @param user_data User data for callback
+ * @return Number of messages delivered
+ */
+uint64_t hl_ws_replay_run(hl_ws_replay_t* replay, double speed,
+                          hl_ws_message_callback_t callback, void* user_data);
+
+/**
+ * @brief Close replay handle
+ */
+void hl_ws_replay_close(hl_ws_replay_t* replay);
+
+// ============================================================================
+// Client integration
+// ============================================================================
+
+/**
+ * @brief Start recording the client's WebSocket stream
+ * @param client Client instance (hl_ws_init_client() called)
+ * @param path Output path
+ * @param compress Deflate each record
+ * @return HL_SUCCESS on success
+ */
+hl_error_t hl_ws_record_start(hl_client_t* client, const char* path, bool compress);
+
+/**
+ * @brief Stop recording and close the capture file
+ */
+void hl_ws_record_stop(hl_client_t* client);
+
+/**
+ * @brief Register subscriptions without connecting
+ *
+ * While offline, hl_watch_* only adds registry entries, so a replay can
+ * drive the same callbacks without any network.
+ *
+ * @param client Client instance
+ * @param offline true to stay offline
+ */
+void hl_ws_set_offline(hl_client_t* client, bool offline);
+
+/**
+ * @brief Replay a capture file through the client's dispatch
+ *
+ * Messages go through the same routing, snapshot tracking and callbacks as
+ * live traffic. Timing statistics of the live connection are not touched;
+ * message ages are computed against the recorded receive times.
+ *
+ * @param client Client instance
+ * @param path Capture file
+ * @param speed 1.0 = original pace, N = N times faster, <= 0 = as fast as possible
+ * @param delivered Optional output for the number of messages replayed
+ * @return HL_SUCCESS on success
+ */
+hl_error_t hl_ws_replay(hl_client_t* client, const char* path, double speed, uint64_t* delivered);
+
+#endif // HL_WS_RECORD_H
@@ -0,0 +1,77 @@
+/**
+ * @file hl_ws_uring.h
+ * @brief io_uring receive loop for WebSocket connections
+ *
+ * This header is NOT part of the public API. It backs the
+ * HL_WS_IO_URING backend of the WebSocket client.
+ */
+
+#ifndef HL_WS_URING_H
+#define HL_WS_URING_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <sys/types.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct hl_ws_uring hl_ws_uring_t;
+
+/**
+ * @brief Completion handler
+ *
+ * For a receive, @p data holds @p len bytes (len 0 = peer closed, negative
+ * = -errno). For a readiness watch, @p data is NULL and @p len carries the
+ * poll events. Return false to stop processing the current batch.
+ */
+typedef bool (*hl_ws_uring_handler_t)(void* ctx, const uint8_t* data, ssize_t len);
+
+/**
+ * @brief Set up a ring with a provided-buffer pool
+ *
+ * @param buffer_size Size of each receive buffer
+ * @param buffer_count Number of buffers (power of two)
+ * @return Ring, or NULL if io_uring is unavailable
+ */
+hl_ws_uring_t* hl_ws_uring_create(size_t buffer_size, unsigned buffer_count);
+
+void hl_ws_uring_destroy(hl_ws_uring_t* ring);
+
+/**
+ * @brief Stream a socket through multishot receive into the buffer pool
+ *
+ * Replaces any previous watch; completions of the old socket are dropped.
+ */
+bool hl_ws_uring_watch_recv(hl_ws_uring_t* ring, int fd);
+
+/**
+ * @brief Report readiness of a socket through multishot poll
+ *
+ * Used for TLS sockets, where records must go through the TLS library.
+ */
+bool hl_ws_uring_watch_poll(hl_ws_uring_t* ring, int fd);
+
+/**
+ * @brief Cancel the current watch before its socket is closed
+ */
+void hl_ws_uring_unwatch(hl_ws_uring_t* ring);
+
+/**
+ * @brief Submit pending requests, wait up to @p timeout_ms and handle completions
+ *
+ * Re-arms a watch the kernel ended (for example when the buffer pool ran
+ * dry) in the same call.
+ *
+ * @return Number of completions handled, or -1 on ring failure
+ */
+int hl_ws_uring_wait(hl_ws_uring_t* ring, int timeout_ms, hl_ws_uring_handler_t handler,
+                     void* ctx);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // HL_WS_URING_H
@@ -249,6 +249,90 @@ int hl_modify_order(hl_client_t *client,
                     const hl_order_request_api_t *new_order,
                     hl_order_result_t *result);
 
+/***************************************************************************
+ * WEBSOCKET TRADING
+ ***************************************************************************/
+
+/**
+ * @brief Completion callback for WebSocket order placement
+ *
+ * Invoked from the WebSocket I/O thread. The result (including order_id)
+ * is only valid for the duration of the callback.
+ */
+typedef void (*hl_ws_order_callback_t)(hl_error_t status,
+                                       const hl_order_result_t *result,
+                                       void *user_data);
+
+/**
+ * @brief Completion callback for WebSocket order cancellation
+ */
+typedef void (*hl_ws_cancel_callback_t)(hl_error_t status,
+                                        const hl_cancel_result_t *result,
+                                        void *user_data);
+
+/**
+ * @brief Place order over the WebSocket post channel (blocking)
+ *
+ * Sends the same signed action as hl_place_order() as a WebSocket "post"
+ * request on the client's socket (see hl_ws_init_client()) and waits for
+ * the matching response.
+ *
+ * @param client Client handle
+ * @param request Order request
+ * @param result Order result (output, caller frees order_id)
+ * @return HL_SUCCESS on success, HL_ERROR_TIMEOUT if no response arrived
+ */
+hl_error_t hl_create_order_ws(hl_client_t *client,
+                              const hl_order_request_api_t *request,
+                              hl_order_result_t *result);
+
+/**
+ * @brief Cancel order over the WebSocket post channel (blocking)
+ *
+ * @param client Client handle
+ * @param symbol Trading symbol
+ * @param order_id Order ID to cancel (string)
+ * @param result Cancel result (output)
+ * @return HL_SUCCESS on success, error code otherwise
+ */
+hl_error_t hl_cancel_order_ws(hl_client_t *client,
+                              const char *symbol,
+                              const char *order_id,
+                              hl_cancel_result_t *result);
+
+/**
+ * @brief Place order over the WebSocket post channel (non-blocking)
+ *
+ * Returns once the request is on the wire; the callback receives the
+ * correlated response, or HL_ERROR_NETWORK if the connection drops first.
+ *
+ * @param client Client handle
+ * @param request Order request
+ * @param callback Completion callback
+ * @param user_data User data for callback
+ * @return HL_SUCCESS if the request was sent, error code otherwise
+ */
+hl_error_t hl_create_order_ws_async(hl_client_t *client,
+                                    const hl_order_request_api_t *request,
+                                    hl_ws_order_callback_t callback,
+                                    void *user_data);
+
+/**
+ * @brief Cancel order over the WebSocket post channel (non-blocking)
+ *
+ * @param client Client handle
+ * @param symbol Trading symbol
+ * @param order_id Order ID to cancel (string)
+ * @param callback Completion callback
+ * @param user_data User data for callback
+ * @return HL_SUCCESS if the request was sent, error code otherwise
+ */
+hl_error_t hl_cancel_order_ws_async(hl_client_t *client,
+                                    const char *symbol,
+                                    const char *order_id,
+                                    hl_ws_cancel_callback_t callback,
+                                    void *user_data);
+
 /***************************************************************************
  * ACCOUNT INFORMATION
  ***************************************************************************/
@@ -444,15 +528,86 @@ hl_error_t hl_fetch_tickers(hl_client_t* client,
 /**
  * @brief Set leverage for symbol
  *
+ * Always selects cross margin; use hl_set_margin_mode() for isolated.
+ *
  * @param client Client instance
  * @param leverage Leverage value (1-50)
- * @param symbol Trading symbol (NULL for all)
- * @return HL_SUCCESS on success, error code otherwise
+ * @param symbol Perp symbol ("BTC/USDC:USDC") or coin ("BTC")
+ * @return HL_SUCCESS on success, HL_ERROR_INVALID_SYMBOL if the symbol is
+ *         not a known perp, error code otherwise
  */
 hl_error_t hl_set_leverage(hl_client_t* client,
                           int leverage,
                           const char* symbol);
 
+/**
+ * @brief Set margin mode and leverage for symbol
+ *
+ * The exchange sets both in one updateLeverage action, so a leverage is
+ * required when switching modes.
+ *
+ * @param client Client instance
+ * @param symbol Perp symbol ("BTC/USDC:USDC") or coin ("BTC")
+ * @param mode HL_MARGIN_CROSS or HL_MARGIN_ISOLATED
+ * @param leverage Leverage value (1-50)
+ * @return HL_SUCCESS on success, HL_ERROR_INVALID_SYMBOL if the symbol is
+ *         not a known perp, error code otherwise
+ */
+hl_error_t hl_set_margin_mode(hl_client_t* client,
+                             const char* symbol,
+                             hl_margin_mode_t mode,
+                             int leverage);
+
+/***************************************************************************
+ * TRANSFERS & AGENTS
+ ***************************************************************************/
+
+/**
+ * @brief Send USDC from the perp balance to another account
+ *
+ * Transfers and agent approval are signed with the account key itself, so
+ * the client must be created with the account's key rather than an agent's.
+ *
+ * @param client Client instance
+ * @param destination Recipient address (0x-prefixed hex)
+ * @param amount Amount of USDC
+ * @return HL_SUCCESS on success, error code otherwise
+ */
+hl_error_t hl_usd_send(hl_client_t* client, const char* destination, double amount);
+
+/**
+ * @brief Withdraw USDC to an address on Arbitrum
+ *
+ * @param client Client instance
+ * @param destination Recipient address (0x-prefixed hex)
+ * @param amount Amount of USDC, including the withdrawal fee
+ * @return HL_SUCCESS on success, error code otherwise
+ */
+hl_error_t hl_withdraw(hl_client_t* client, const char* destination, double amount);
+
+/**
+ * @brief Send a spot token to another account
+ *
+ * @param client Client instance
+ * @param destination Recipient address (0x-prefixed hex)
+ * @param token Token as "NAME:tokenId", e.g. "PURR:0xc4bf3f870c0e9465323c0b6ed28096c2"
+ * @param amount Amount of the token
+ * @return HL_SUCCESS on success, error code otherwise
+ */
+hl_error_t hl_spot_send(hl_client_t* client, const char* destination,
+                        const char* token, double amount);
+
+/**
+ * @brief Approve an agent key to trade for the account
+ *
+ * @param client Client instance
+ * @param agent_address Agent address (0x-prefixed hex)
+ * @param agent_name Name for the agent, or NULL for the unnamed agent
+ * @return HL_SUCCESS on success, error code otherwise
+ */
+hl_error_t hl_approve_agent(hl_client_t* client, const char* agent_address,
+                            const char* agent_name);
+
 /***************************************************************************
  * CURRENCY & FUNDING DATA
  ***************************************************************************/
@@ -576,24 +731,27 @@ hl_error_t hl_edit_order(hl_client_t* client,
                         hl_order_result_t* result);
 
 /**
- * @brief Add margin to a position
+ * @brief Add margin to an isolated position
+ *
+ * Sent as an updateIsolatedMargin action signed by the client's signer.
  *
  * @param client Client instance
  * @param symbol Trading symbol
- * @param amount Amount of margin to add
- * @return HL_SUCCESS on success, error code otherwise
+ * @param amount USDC to add (positive)
+ * @return HL_SUCCESS, HL_ERROR_INVALID_SYMBOL for an unknown or spot symbol,
+ *         or another error code
  */
 hl_error_t hl_add_margin(hl_client_t* client,
                         const char* symbol,
                         double amount);
 
 /**
- * @brief Reduce margin from a position
+ * @brief Reduce margin from an isolated position
  *
  * @param client Client instance
  * @param symbol Trading symbol
- * @param amount Amount of margin to reduce
- * @return HL_SUCCESS on success, error code otherwise
+ * @param amount USDC to remove (positive)
+ * @return HL_SUCCESS on success, error code otherwise, as hl_add_margin()
  */
 hl_error_t hl_reduce_margin(hl_client_t* client,
                            const char* symbol,
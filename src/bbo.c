@@ -0,0 +1,142 @@
+/**
+ * @file bbo.c
+ * @brief Top-of-book decoding
+ *
+ * A narrow scanner over the message text: it locates the coin, the
+ * timestamp and the first level of each side, and never materializes the
+ * remaining levels. Book levels contain no brackets, so the end of the bid
+ * side is the first ']' after it starts.
+ */
+
+#include "hl_bbo.h"
+#include <stdlib.h>
+#include <string.h>
+
+_Static_assert(sizeof(hl_bbo_t) == 48, "hl_bbo_t must stay 48 bytes");
+
+static const char* bbo_skip_ws(const char* p) {
+    while (*p == ' ' || *p == '\t' || *p == '\n' || *p == '\r') p++;
+    return p;
+}
+
+/**
+ * @brief Position just past `"key":`, searching from p
+ */
+static const char* bbo_find_key(const char* p, const char* key) {
+    const char* found = strstr(p, key);
+    return found ? bbo_skip_ws(found + strlen(key)) : NULL;
+}
+
+/**
+ * @brief Parse a number that may be quoted ("65000.5" or 65000.5)
+ */
+static const char* bbo_number(const char* p, double* out) {
+    if (*p == '"') p++;
+    char* end;
+    *out = strtod(p, &end);
+    return end == p ? NULL : end;
+}
+
+/**
+ * @brief Parse one level object, or null; returns position after it
+ */
+static const char* bbo_level(const char* p, double* px, double* sz) {
+    *px = 0.0;
+    *sz = 0.0;
+
+    if (strncmp(p, "null", 4) == 0) return p + 4;
+    if (*p != '{') return NULL;
+
+    const char* close = strchr(p, '}');
+    if (!close) return NULL;
+
+    const char* px_pos = bbo_find_key(p, "\"px\":");
+    const char* sz_pos = bbo_find_key(p, "\"sz\":");
+    if (!px_pos || !sz_pos || px_pos > close || sz_pos > close) return NULL;
+    if (!bbo_number(px_pos, px) || !bbo_number(sz_pos, sz)) return NULL;
+
+    return close + 1;
+}
+
+/**
+ * @brief Decode a bbo or l2Book message into a record
+ */
+bool hl_bbo_decode(const char* message, size_t size, int64_t recv_time_ns,
+                   hl_bbo_t* out, char* coin, size_t coin_size, hl_bbo_source_t* source) {
+    if (!message || size == 0 || !out || !coin || coin_size == 0) return false;
+
+    const char* channel = bbo_find_key(message, "\"channel\":");
+    if (!channel || *channel != '"') return false;
+    channel++;
+
+    bool is_bbo;
+    if (strncmp(channel, "bbo\"", 4) == 0) {
+        is_bbo = true;
+    } else if (strncmp(channel, "l2Book\"", 7) == 0) {
+        is_bbo = false;
+    } else {
+        return false;
+    }
+
+    const char* data = bbo_find_key(channel, "\"data\":");
+    if (!data) return false;
+
+    // Coin
+    const char* coin_pos = bbo_find_key(data, "\"coin\":");
+    if (!coin_pos || *coin_pos != '"') return false;
+    coin_pos++;
+    const char* coin_end = strchr(coin_pos, '"');
+    if (!coin_end || (size_t)(coin_end - coin_pos) >= coin_size) return false;
+    memcpy(coin, coin_pos, (size_t)(coin_end - coin_pos));
+    coin[coin_end - coin_pos] = '\0';
+
+    // Exchange time, stored relative to receipt
+    int64_t time_ms = 0;
+    const char* time_pos = bbo_find_key(data, "\"time\":");
+    if (time_pos) {
+        time_ms = strtoll(time_pos, NULL, 10);
+    }
+    int64_t offset_us = time_ms > 0 ? time_ms * 1000 - recv_time_ns / 1000 : 0;
+    if (offset_us > INT32_MAX) offset_us = INT32_MAX;
+    if (offset_us < INT32_MIN) offset_us = INT32_MIN;
+
+    out->asset_id = HL_BBO_UNKNOWN_ASSET;
+    out->exchange_offset_us = (int32_t)offset_us;
+    out->recv_time_ns = recv_time_ns;
+    if (source) *source = is_bbo ? HL_BBO_SOURCE_BBO : HL_BBO_SOURCE_L2BOOK;
+
+    const char* p;
+    if (is_bbo) {
+        // "bbo":[bid|null, ask|null]
+        p = bbo_find_key(data, "\"bbo\":");
+        if (!p || *p != '[') return false;
+        p = bbo_level(bbo_skip_ws(p + 1), &out->bid_px, &out->bid_sz);
+        if (!p) return false;
+        p = bbo_skip_ws(p);
+        if (*p != ',') return false;
+        return bbo_level(bbo_skip_ws(p + 1), &out->ask_px, &out->ask_sz) != NULL;
+    }
+
+    // "levels":[[bids...],[asks...]]
+    p = bbo_find_key(data, "\"levels\":");
+    if (!p || *p != '[') return false;
+    p = bbo_skip_ws(p + 1);
+    if (*p != '[') return false;
+
+    const char* bids = bbo_skip_ws(p + 1);
+    out->bid_px = out->bid_sz = 0.0;
+    if (*bids == '{' && !bbo_level(bids, &out->bid_px, &out->bid_sz)) return false;
+
+    const char* bids_end = strchr(bids, ']');
+    if (!bids_end) return false;
+    p = bbo_skip_ws(bids_end + 1);
+    if (*p != ',') return false;
+    p = bbo_skip_ws(p + 1);
+    if (*p != '[') return false;
+
+    const char* asks = bbo_skip_ws(p + 1);
+    out->ask_px = out->ask_sz = 0.0;
+    if (*asks == '{' && !bbo_level(asks, &out->ask_px, &out->ask_sz)) return false;
+
+    return true;
+}
@@ -0,0 +1,423 @@
+/**
+ * @file candle_series.c
+ * @brief Live candle series
+ *
+ * Candles are kept oldest first in a buffer twice the series capacity. The
+ * visible window slides forward as bars are appended and is moved back to
+ * the start of the buffer only when it reaches the end, so appending is
+ * amortized O(1) and the window is always one contiguous hl_ohlcvs_t.
+ *
+ * Gaps are filled by a per-series thread so candleSnapshot requests never
+ * block the WebSocket I/O thread. Requested ranges are coalesced; a failed
+ * request is retried until it succeeds or the series is destroyed.
+ */
+
+#define _GNU_SOURCE
+
+#include "hl_candle_series.h"
+#include "hl_internal.h"
+#include "hl_ws_client.h"
+#include "hl_logger.h"
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <time.h>
+#include <errno.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <cjson/cJSON.h>
+
+#define SERIES_RETRY_MS 1000
+
+struct hl_candle_series {
+    hl_client_t* client;
+    char symbol[64];
+    char coin[32];
+    char timeframe[16];
+    char subscription_id[64];
+    uint64_t interval_ms;
+
+    hl_ohlcv_t* buffer;                 /**< 2 * capacity candles */
+    size_t capacity;
+    size_t start;                       /**< First visible candle in buffer */
+    hl_ohlcvs_t view;                   /**< Visible window, handed to readers */
+    pthread_mutex_t mutex;
+    atomic_uint_least64_t version;
+
+    hl_candle_series_callback_t callback;
+    void* user_data;
+
+    // Backfill, guarded by mutex
+    pthread_t worker;
+    pthread_cond_t wake;
+    bool worker_started;
+    bool stop;
+    bool backfill_pending;
+    bool backfill_running;
+    uint64_t backfill_from;
+    uint64_t backfill_to;
+};
+
+static uint64_t series_now_ms(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_REALTIME, &ts);
+    return (uint64_t)ts.tv_sec * 1000 + (uint64_t)ts.tv_nsec / 1000000;
+}
+
+/**
+ * @brief Index of the first visible candle at or after timestamp (lock held)
+ */
+static size_t series_lower_bound(const hl_candle_series_t* series, uint64_t timestamp) {
+    const hl_ohlcv_t* candles = series->view.candles;
+    size_t lo = 0;
+    size_t hi = series->view.count;
+    while (lo < hi) {
+        size_t mid = lo + (hi - lo) / 2;
+        if (candles[mid].timestamp < timestamp) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    return lo;
+}
+
+/**
+ * @brief Make room for one more candle at the end of the window (lock held)
+ */
+static void series_reserve_tail(hl_candle_series_t* series) {
+    if (series->start + series->view.count < 2 * series->capacity) return;
+
+    memmove(series->buffer, series->buffer + series->start,
+            series->view.count * sizeof(hl_ohlcv_t));
+    series->start = 0;
+    series->view.candles = series->buffer;
+}
+
+/**
+ * @brief Drop the oldest candle if the window is over capacity (lock held)
+ */
+static void series_trim(hl_candle_series_t* series) {
+    if (series->view.count <= series->capacity) return;
+
+    series->start++;
+    series->view.count--;
+    series->view.candles = series->buffer + series->start;
+}
+
+/**
+ * @brief Insert or replace one candle in timestamp order (lock held)
+ *
+ * @param keep_latest Leave the newest bar alone; it belongs to the stream
+ *        and is more recent than anything a snapshot request returned
+ */
+static void series_merge_one(hl_candle_series_t* series, const hl_ohlcv_t* candle,
+                             bool keep_latest) {
+    size_t count = series->view.count;
+    size_t pos = series_lower_bound(series, candle->timestamp);
+
+    if (pos < count && series->view.candles[pos].timestamp == candle->timestamp) {
+        if (!(keep_latest && pos == count - 1)) {
+            series->view.candles[pos] = *candle;
+        }
+        return;
+    }
+
+    // Older than everything in a full window: it would be dropped at once
+    if (pos == 0 && count >= series->capacity) return;
+
+    series_reserve_tail(series);
+    hl_ohlcv_t* candles = series->view.candles;
+    memmove(&candles[pos + 1], &candles[pos], (count - pos) * sizeof(hl_ohlcv_t));
+    candles[pos] = *candle;
+    series->view.count++;
+    series_trim(series);
+}
+
+/**
+ * @brief Queue a candleSnapshot request for [from, to] (lock held)
+ */
+static void series_request_backfill(hl_candle_series_t* series, uint64_t from, uint64_t to) {
+    if (series->backfill_pending) {
+        if (from < series->backfill_from) series->backfill_from = from;
+        if (to > series->backfill_to) series->backfill_to = to;
+    } else {
+        series->backfill_from = from;
+        series->backfill_to = to;
+        series->backfill_pending = true;
+    }
+    pthread_cond_signal(&series->wake);
+}
+
+/**
+ * @brief Backfill thread: fetch queued ranges and merge them
+ */
+static void* series_backfill_thread(void* arg) {
+    hl_candle_series_t* series = (hl_candle_series_t*)arg;
+
+    pthread_mutex_lock(&series->mutex);
+    while (!series->stop) {
+        if (!series->backfill_pending) {
+            pthread_cond_wait(&series->wake, &series->mutex);
+            continue;
+        }
+
+        uint64_t from = series->backfill_from;
+        uint64_t to = series->backfill_to;
+        series->backfill_pending = false;
+        series->backfill_running = true;
+        pthread_mutex_unlock(&series->mutex);
+
+        hl_ohlcv_t* candles = NULL;
+        size_t count = 0;
+        hl_error_t err = hl_fetch_candle_snapshot(series->client, series->coin, series->timeframe,
+                                                  from, to, &candles, &count);
+
+        pthread_mutex_lock(&series->mutex);
+        series->backfill_running = false;
+
+        if (err != HL_SUCCESS) {
+            HL_LOG_WARN("Candle backfill %s %s failed (error %d), retrying",
+                        series->coin, series->timeframe, err);
+            series_request_backfill(series, from, to);
+
+            struct timespec deadline;
+            clock_gettime(CLOCK_REALTIME, &deadline);
+            deadline.tv_sec += SERIES_RETRY_MS / 1000;
+            while (!series->stop &&
+                   pthread_cond_timedwait(&series->wake, &series->mutex, &deadline) != ETIMEDOUT) {
+            }
+            continue;
+        }
+
+        for (size_t i = 0; i < count; i++) {
+            series_merge_one(series, &candles[i], true);
+        }
+        atomic_fetch_add_explicit(&series->version, 1, memory_order_release);
+        HL_LOG_DEBUG("Candle backfill %s %s merged %zu candles", series->coin,
+                     series->timeframe, count);
+        pthread_mutex_unlock(&series->mutex);
+
+        free(candles);
+        if (series->callback) {
+            series->callback(series, true, series->user_data);
+        }
+
+        pthread_mutex_lock(&series->mutex);
+    }
+    pthread_mutex_unlock(&series->mutex);
+
+    return NULL;
+}
+
+/**
+ * @brief Candle stream callback
+ *
+ * A bar with the newest timestamp replaces the bar in progress, a later
+ * one opens the next bar. Bars are missing when the stream jumps more than
+ * one interval ahead, or when a (re)subscription snapshot arrives after the
+ * newest bar closed, in which case that bar's final values were missed too.
+ */
+static void series_on_candle(void* data, void* user_data) {
+    const hl_ws_message_t* msg = (const hl_ws_message_t*)data;
+    hl_candle_series_t* series = (hl_candle_series_t*)user_data;
+
+    hl_ohlcv_t candle;
+    if (hl_parse_ohlcv_candle((const cJSON*)msg->json, &candle) != HL_SUCCESS) return;
+
+    bool bar_closed = false;
+
+    pthread_mutex_lock(&series->mutex);
+    size_t count = series->view.count;
+    const hl_ohlcv_t* latest = count ? &series->view.candles[count - 1] : NULL;
+
+    if (latest && candle.timestamp > latest->timestamp) {
+        uint64_t step = candle.timestamp - latest->timestamp;
+        // Half an interval of slack keeps 28-31 day months from looking like gaps
+        if (msg->is_snapshot || step > series->interval_ms + series->interval_ms / 2) {
+            series_request_backfill(series, latest->timestamp, candle.timestamp);
+        }
+
+        series_reserve_tail(series);
+        series->view.candles[series->view.count++] = candle;
+        series_trim(series);
+        bar_closed = true;
+    } else {
+        series_merge_one(series, &candle, false);
+    }
+
+    atomic_fetch_add_explicit(&series->version, 1, memory_order_release);
+    pthread_mutex_unlock(&series->mutex);
+
+    if (series->callback) {
+        series->callback(series, bar_closed, series->user_data);
+    }
+}
+
+/**
+ * @brief Create a live series
+ */
+hl_candle_series_t* hl_candle_series_create(hl_client_t* client, const char* symbol,
+                                            const char* timeframe, size_t capacity,
+                                            hl_candle_series_callback_t callback,
+                                            void* user_data) {
+    if (!client || !symbol || !timeframe || capacity == 0) return NULL;
+
+    uint64_t interval_ms = hl_timeframe_ms(timeframe);
+    if (interval_ms == 0) return NULL;
+
+    hl_candle_series_t* series = calloc(1, sizeof(hl_candle_series_t));
+    if (!series) return NULL;
+
+    series->buffer = calloc(2 * capacity, sizeof(hl_ohlcv_t));
+    if (!series->buffer) {
+        free(series);
+        return NULL;
+    }
+
+    series->client = client;
+    series->capacity = capacity;
+    series->interval_ms = interval_ms;
+    series->callback = callback;
+    series->user_data = user_data;
+    lv3_string_copy(series->symbol, symbol, sizeof(series->symbol));
+    lv3_string_copy(series->timeframe, timeframe, sizeof(series->timeframe));
+    hl_symbol_to_coin(symbol, series->coin, sizeof(series->coin));
+
+    series->view.candles = series->buffer;
+    lv3_string_copy(series->view.symbol, symbol, sizeof(series->view.symbol));
+    lv3_string_copy(series->view.timeframe, timeframe, sizeof(series->view.timeframe));
+
+    pthread_mutex_init(&series->mutex, NULL);
+    pthread_cond_init(&series->wake, NULL);
+    atomic_init(&series->version, 0);
+
+    // Seed
+    uint64_t now = series_now_ms();
+    uint64_t span = (uint64_t)capacity * interval_ms;
+    hl_ohlcv_t* candles = NULL;
+    size_t count = 0;
+    hl_error_t err = hl_fetch_candle_snapshot(client, series->coin, timeframe,
+                                              now > span ? now - span : 0, now,
+                                              &candles, &count);
+    if (err != HL_SUCCESS) {
+        HL_LOG_ERROR("Cannot seed candle series %s %s (error %d)", series->coin, timeframe, err);
+        hl_candle_series_destroy(series);
+        return NULL;
+    }
+
+    size_t first = count > capacity ? count - capacity : 0;
+    for (size_t i = first; i < count; i++) {
+        series_merge_one(series, &candles[i], false);
+    }
+    free(candles);
+
+    if (pthread_create(&series->worker, NULL, series_backfill_thread, series) != 0) {
+        hl_candle_series_destroy(series);
+        return NULL;
+    }
+    series->worker_started = true;
+
+    // Bars that closed between the snapshot and the subscription are picked
+    // up by the first stream message, which is a snapshot
+    const char* subscription_id = hl_watch_ohlcv(client, symbol, timeframe,
+                                                 series_on_candle, series);
+    if (!subscription_id) {
+        hl_candle_series_destroy(series);
+        return NULL;
+    }
+    lv3_string_copy(series->subscription_id, subscription_id, sizeof(series->subscription_id));
+
+    return series;
+}
+
+/**
+ * @brief Unsubscribe and free a series
+ */
+void hl_candle_series_destroy(hl_candle_series_t* series) {
+    if (!series) return;
+
+    // No stream callback runs once hl_unwatch() has returned
+    if (series->subscription_id[0]) {
+        hl_unwatch(series->client, series->subscription_id);
+    }
+
+    if (series->worker_started) {
+        pthread_mutex_lock(&series->mutex);
+        series->stop = true;
+        pthread_cond_signal(&series->wake);
+        pthread_mutex_unlock(&series->mutex);
+        pthread_join(series->worker, NULL);
+    }
+
+    pthread_cond_destroy(&series->wake);
+    pthread_mutex_destroy(&series->mutex);
+    free(series->buffer);
+    free(series);
+}
+
+/**
+ * @brief Lock the series and get its candles
+ */
+const hl_ohlcvs_t* hl_candle_series_lock(hl_candle_series_t* series) {
+    if (!series) return NULL;
+
+    pthread_mutex_lock(&series->mutex);
+    return &series->view;
+}
+
+/**
+ * @brief Release a lock taken with hl_candle_series_lock()
+ */
+void hl_candle_series_unlock(hl_candle_series_t* series) {
+    if (!series) return;
+
+    pthread_mutex_unlock(&series->mutex);
+}
+
+/**
+ * @brief Copy the candles out of the series
+ */
+hl_error_t hl_candle_series_copy(hl_candle_series_t* series, hl_ohlcvs_t* ohlcvs) {
+    if (!series || !ohlcvs) return HL_ERROR_INVALID_PARAMS;
+
+    memset(ohlcvs, 0, sizeof(hl_ohlcvs_t));
+
+    pthread_mutex_lock(&series->mutex);
+    size_t count = series->view.count;
+    hl_ohlcv_t* candles = count ? malloc(count * sizeof(hl_ohlcv_t)) : NULL;
+    if (count && !candles) {
+        pthread_mutex_unlock(&series->mutex);
+        return HL_ERROR_MEMORY;
+    }
+    if (count) {
+        memcpy(candles, series->view.candles, count * sizeof(hl_ohlcv_t));
+    }
+    pthread_mutex_unlock(&series->mutex);
+
+    ohlcvs->candles = candles;
+    ohlcvs->count = count;
+    snprintf(ohlcvs->symbol, sizeof(ohlcvs->symbol), "%s", series->symbol);
+    snprintf(ohlcvs->timeframe, sizeof(ohlcvs->timeframe), "%s", series->timeframe);
+    return HL_SUCCESS;
+}
+
+/**
+ * @brief Version counter, incremented on every change
+ */
+uint64_t hl_candle_series_version(const hl_candle_series_t* series) {
+    if (!series) return 0;
+    return atomic_load_explicit(&((hl_candle_series_t*)series)->version, memory_order_acquire);
+}
+
+/**
+ * @brief Check that no gap is waiting to be backfilled
+ */
+bool hl_candle_series_is_complete(hl_candle_series_t* series) {
+    if (!series) return false;
+
+    pthread_mutex_lock(&series->mutex);
+    bool complete = !series->backfill_pending && !series->backfill_running;
+    pthread_mutex_unlock(&series->mutex);
+    return complete;
+}
@@ -5,10 +5,14 @@
 
 #include "hl_client.h"
 #include "hl_internal.h"
+#include "hl_mids.h"
+#include "hl_signer.h"
+#include "hl_ws_client.h"
 #include <stdlib.h>
 #include <string.h>
 #include <pthread.h>
 #include <stdio.h>
+#include <cjson/cJSON.h>
 
 // Forward declarations for internal functions
 static hl_http_client_t* http_client_create_internal(void);
@@ -35,9 +39,12 @@ hl_client_t* hl_client_new(const char* wallet_address, const char* private_key,
 
     // Copy authentication data
     strncpy(client->api_key, wallet_address, sizeof(client->api_key) - 1);
-    strncpy(client->secret, private_key, sizeof(client->secret) - 1);
     strncpy(client->wallet_address, wallet_address, sizeof(client->wallet_address) - 1);
 
+    // Parse the key once; the signer holds the only copy and every signed
+    // action goes through it
+    client->signer = hl_signer_create(private_key);
+
     // Initialize options
     client->options.testnet = testnet;
     client->options.timeout = 30000; // 30 seconds
@@ -48,6 +55,7 @@ hl_client_t* hl_client_new(const char* wallet_address, const char* private_key,
     // Create HTTP client
     client->http_client = http_client_create_internal();
     if (!client->http_client) {
+        hl_signer_destroy(client->signer);
         free(client);
         return NULL;
     }
@@ -57,10 +65,26 @@ hl_client_t* hl_client_new(const char* wallet_address, const char* private_key,
 
     // Initialize markets cache
     client->markets = NULL;
+    if (pthread_mutex_init(&client->markets_mutex, NULL) != 0) {
+        hl_signer_destroy(client->signer);
+        http_client_free_internal(client->http_client);
+        free(client);
+        return NULL;
+    }
 
     // Initialize balances cache
     client->balances = NULL;
 
+    // Shared mid-price table, bound to asset IDs once markets are loaded
+    client->mids = hl_mids_table_create();
+    if (!client->mids) {
+        pthread_mutex_destroy(&client->markets_mutex);
+        hl_signer_destroy(client->signer);
+        http_client_free_internal(client->http_client);
+        free(client);
+        return NULL;
+    }
+
     // Initialize callbacks
     client->on_error = NULL;
     client->on_message = NULL;
@@ -103,6 +127,12 @@ void hl_client_free(hl_client_t* client) {
         free(client->balances);
     }
 
+    hl_mids_table_destroy(client->mids);
+    pthread_mutex_destroy(&client->markets_mutex);
+
+    // Wipes the key material
+    hl_signer_destroy(client->signer);
+
     free(client);
 }
 
@@ -115,7 +145,24 @@ const char* hl_client_get_wallet_address(const hl_client_t* client) {
 }
 
 const char* hl_client_get_private_key(const hl_client_t* client) {
-    return client ? client->secret : NULL;
+    (void)client;
+    return NULL;
+}
+
+hl_signer_t* hl_client_get_signer(const hl_client_t* client) {
+    return client ? client->signer : NULL;
+}
+
+uint64_t hl_client_reserve_nonces(hl_client_t* client, size_t count) {
+    if (!client || !client->signer) return 0;
+
+    // Offset-corrected when the WebSocket has seen server timestamps
+    int64_t now_ms = hl_ws_server_time_ms(client);
+    return hl_signer_reserve_nonces(client->signer, now_ms > 0 ? (uint64_t)now_ms : 0, count);
+}
+
+uint64_t hl_client_next_nonce(hl_client_t* client) {
+    return hl_client_reserve_nonces(client, 1);
 }
 
 hl_http_client_t* hl_client_get_http_client(hl_client_t* client) {
@@ -155,46 +202,189 @@ bool hl_client_test_connection(hl_client_t* client) {
 hl_error_t hl_client_load_markets(hl_client_t* client) {
     if (!client) return -1;
 
+    // Load markets using existing function (outside the lock, this is HTTP)
+    hl_markets_t markets = {0};
+    hl_error_t err = hl_fetch_markets(client, &markets);
+    if (err != 0) {
+        return err;
+    }
+
+    hl_markets_t* loaded = malloc(sizeof(hl_markets_t));
+    if (!loaded) {
+        hl_markets_free(&markets);
+        return HL_ERROR_MEMORY;
+    }
+    *loaded = markets;
+
+    // Swap in the new registry; streamed updates wait for the lock
+    pthread_mutex_lock(&client->markets_mutex);
+    hl_markets_t* previous = client->markets;
+    client->markets = loaded;
+    hl_mids_table_bind_markets(client->mids, client->markets);
+    pthread_mutex_unlock(&client->markets_mutex);
+
     // Free existing markets
-    if (client->markets) {
-        if (client->markets->markets) {
-            for (size_t i = 0; i < client->markets->count; i++) {
-                hl_market_free(&client->markets->markets[i]);
+    if (previous) {
+        if (previous->markets) {
+            for (size_t i = 0; i < previous->count; i++) {
+                hl_market_free(&previous->markets[i]);
             }
-            free(client->markets->markets);
+            free(previous->markets);
         }
-        free(client->markets);
-        client->markets = NULL;
+        free(previous);
     }
 
-    // Load markets using existing function
-    hl_markets_t markets = {0};
-    hl_error_t err = hl_fetch_markets(client, &markets);
+    return err;
+}
 
-    if (err == 0) {
-        client->markets = malloc(sizeof(hl_markets_t));
-        if (client->markets) {
-            *client->markets = markets;
+/**
+ * @brief Find a swap market by coin (markets_mutex held)
+ *
+ * Perps are stored in universe order, so the asset ID is tried as an index
+ * before falling back to a scan.
+ */
+static hl_market_t* find_swap_market(hl_client_t* client, const char* coin) {
+    hl_markets_t* markets = client->markets;
+    uint32_t asset_id;
+
+    if (hl_mids_table_lookup(client->mids, coin, &asset_id) && asset_id < markets->count) {
+        hl_market_t* market = &markets->markets[asset_id];
+        if (market->type == HL_MARKET_SWAP && strcmp(market->base, coin) == 0) {
+            return market;
         }
     }
 
-    return err;
+    for (size_t i = 0; i < markets->count; i++) {
+        hl_market_t* market = &markets->markets[i];
+        if (market->type == HL_MARKET_SWAP && strcmp(market->base, coin) == 0) {
+            return market;
+        }
+    }
+    return NULL;
+}
+
+bool hl_client_update_market_ctx(hl_client_t* client, const char* coin, const cJSON* ctx,
+                                 int64_t update_ms) {
+    if (!client || !coin || !ctx) return false;
+
+    pthread_mutex_lock(&client->markets_mutex);
+    hl_market_t* market = client->markets ? find_swap_market(client, coin) : NULL;
+    if (market) {
+        hl_market_apply_ctx(market, ctx);
+        market->ctx_update_ms = update_ms;
+    }
+    pthread_mutex_unlock(&client->markets_mutex);
+
+    return market != NULL;
+}
+
+/**
+ * @brief Find a market by unified symbol (markets_mutex held)
+ */
+static const hl_market_t* find_market(const hl_markets_t* markets, const char* symbol) {
+    if (!markets) return NULL;
+
+    for (size_t i = 0; i < markets->count; i++) {
+        if (strcmp(markets->markets[i].symbol, symbol) == 0) {
+            return &markets->markets[i];
+        }
+    }
+    return NULL;
+}
+
+bool hl_client_live_market(hl_client_t* client, const char* symbol, hl_market_t* out) {
+    if (!client || !symbol || !out) return false;
+
+    pthread_mutex_lock(&client->markets_mutex);
+    const hl_market_t* market = find_market(client->markets, symbol);
+    bool found = market && market->ctx_update_ms > 0;
+    if (found) *out = *market;
+    pthread_mutex_unlock(&client->markets_mutex);
+
+    return found;
+}
+
+hl_market_t* hl_client_live_swap_markets(hl_client_t* client, size_t* count) {
+    if (!client || !count) return NULL;
+
+    *count = 0;
+    hl_market_t* copy = NULL;
+
+    pthread_mutex_lock(&client->markets_mutex);
+    if (client->markets && client->markets->count > 0) {
+        // Only answer from memory when every perp is being streamed
+        size_t swaps = 0;
+        bool all_live = true;
+        for (size_t i = 0; i < client->markets->count; i++) {
+            const hl_market_t* market = &client->markets->markets[i];
+            if (market->type != HL_MARKET_SWAP) continue;
+            swaps++;
+            all_live = all_live && market->ctx_update_ms > 0;
+        }
+
+        if (swaps > 0 && all_live) {
+            copy = malloc(swaps * sizeof(hl_market_t));
+        }
+        if (copy) {
+            for (size_t i = 0; i < client->markets->count; i++) {
+                if (client->markets->markets[i].type == HL_MARKET_SWAP) {
+                    copy[(*count)++] = client->markets->markets[i];
+                }
+            }
+        }
+    }
+    pthread_mutex_unlock(&client->markets_mutex);
+
+    return copy;
 }
 
 const hl_markets_t* hl_client_get_markets(const hl_client_t* client) {
     return client ? client->markets : NULL;
 }
 
-const hl_market_t* hl_client_get_market(const hl_client_t* client, const char* symbol) {
-    if (!client || !client->markets || !symbol) return NULL;
-
-    for (size_t i = 0; i < client->markets->count; i++) {
-        if (strcmp(client->markets->markets[i].symbol, symbol) == 0) {
-            return &client->markets->markets[i];
+hl_error_t hl_client_copy_markets(hl_client_t* client, hl_markets_t* out) {
+    if (!client || !out) return HL_ERROR_INVALID_PARAMS;
+
+    out->markets = NULL;
+    out->count = 0;
+
+    hl_error_t err = HL_ERROR_NOT_FOUND;
+    pthread_mutex_lock(&client->markets_mutex);
+    if (client->markets && client->markets->count > 0) {
+        size_t count = client->markets->count;
+        out->markets = malloc(count * sizeof(hl_market_t));
+        if (out->markets) {
+            memcpy(out->markets, client->markets->markets, count * sizeof(hl_market_t));
+            out->count = count;
+            err = HL_SUCCESS;
+        } else {
+            err = HL_ERROR_MEMORY;
         }
     }
+    pthread_mutex_unlock(&client->markets_mutex);
 
-    return NULL;
+    return err;
+}
+
+bool hl_client_copy_market(hl_client_t* client, const char* symbol, hl_market_t* out) {
+    if (!client || !symbol || !out) return false;
+
+    pthread_mutex_lock(&client->markets_mutex);
+    const hl_market_t* market = find_market(client->markets, symbol);
+    if (market) *out = *market;
+    pthread_mutex_unlock(&client->markets_mutex);
+
+    return market != NULL;
+}
+
+hl_mids_table_t* hl_client_mids(hl_client_t* client) {
+    return client ? client->mids : NULL;
+}
+
+const hl_market_t* hl_client_get_market(const hl_client_t* client, const char* symbol) {
+    if (!client || !symbol) return NULL;
+
+    return find_market(client->markets, symbol);
 }
 
 bool hl_client_has_capability(const hl_client_t* client, const char* capability) {
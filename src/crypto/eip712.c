@@ -5,10 +5,6 @@
 #include <ctype.h>
 #include <stdio.h>
 
-// Use libsecp256k1 for production-grade ECDSA with correct recovery ID
-#include <secp256k1.h>
-#include <secp256k1_recovery.h>
-
 // Keccak256 using SHA3IUF library
 #include "hl_crypto_internal.h"
 
@@ -89,94 +85,20 @@ int parse_eth_address(const char *address_hex, uint8_t address_out[20]) {
 int ecdsa_sign_secp256k1(const uint8_t hash[32], 
                          const char *private_key_hex,
                          uint8_t signature_out[65]) {
-    // Parse private key
-    uint8_t priv_bytes[32];
-    if (hex_to_bytes(private_key_hex, priv_bytes, 32) != 32) {
+    // One-shot path; long-lived callers keep an hl_signer_t instead
+    hl_signer_t *signer = hl_signer_create(private_key_hex);
+    if (!signer) {
         fprintf(stderr, "Failed to parse private key\n");
         return -1;
     }
     
-    // Create secp256k1 context
-    secp256k1_context *ctx = secp256k1_context_create(
-        SECP256K1_CONTEXT_SIGN | SECP256K1_CONTEXT_VERIFY
-    );
-    if (!ctx) {
-        fprintf(stderr, "Failed to create secp256k1 context\n");
-        return -1;
-    }
+    hl_error_t err = hl_signer_sign_hash(signer, hash, signature_out);
+    hl_signer_destroy(signer);
     
-    // Sign with recovery ID (RFC 6979 deterministic)
-    secp256k1_ecdsa_recoverable_signature sig;
-    if (!secp256k1_ecdsa_sign_recoverable(ctx, &sig, hash, priv_bytes, NULL, NULL)) {
+    if (err != HL_SUCCESS) {
         fprintf(stderr, "Failed to sign with secp256k1\n");
-        secp256k1_context_destroy(ctx);
-        return -1;
-    }
-    
-    // Serialize signature
-    int recovery_id;
-    uint8_t compact_sig[64];
-    secp256k1_ecdsa_recoverable_signature_serialize_compact(ctx, compact_sig, &recovery_id, &sig);
-    
-    // Copy r and s
-    memcpy(signature_out, compact_sig, 64);
-    
-    // Get the actual public key from private key
-    secp256k1_pubkey actual_pubkey;
-    if (!secp256k1_ec_pubkey_create(ctx, &actual_pubkey, priv_bytes)) {
-        fprintf(stderr, "Failed to compute public key\n");
-        secp256k1_context_destroy(ctx);
-        return -1;
-    }
-    
-    // Convert to uncompressed format to get Ethereum address
-    uint8_t actual_pubkey_bytes[65];
-    size_t actual_pubkey_len = 65;
-    secp256k1_ec_pubkey_serialize(ctx, actual_pubkey_bytes, &actual_pubkey_len, 
-                                  &actual_pubkey, SECP256K1_EC_UNCOMPRESSED);
-    
-    // Compute actual Ethereum address (last 20 bytes of keccak256(pubkey[1:]))
-    uint8_t actual_addr_hash[32];
-    keccak256(actual_pubkey_bytes + 1, 64, actual_addr_hash);
-    
-    // Now try all 4 recovery IDs and find which one matches our actual address
-    int correct_recovery_id = -1;
-    for (int recid = 0; recid < 4; recid++) {
-        secp256k1_ecdsa_recoverable_signature test_sig;
-        if (!secp256k1_ecdsa_recoverable_signature_parse_compact(ctx, &test_sig, compact_sig, recid)) {
-            continue;
-        }
-        
-        secp256k1_pubkey recovered_pubkey;
-        if (!secp256k1_ecdsa_recover(ctx, &recovered_pubkey, &test_sig, hash)) {
-            continue;
-        }
-        
-        uint8_t recovered_pubkey_bytes[65];
-        size_t recovered_pubkey_len = 65;
-        secp256k1_ec_pubkey_serialize(ctx, recovered_pubkey_bytes, &recovered_pubkey_len,
-                                      &recovered_pubkey, SECP256K1_EC_UNCOMPRESSED);
-        
-        uint8_t recovered_addr_hash[32];
-        keccak256(recovered_pubkey_bytes + 1, 64, recovered_addr_hash);
-        
-        // Compare last 20 bytes (Ethereum address)
-        if (memcmp(actual_addr_hash + 12, recovered_addr_hash + 12, 20) == 0) {
-            correct_recovery_id = recid;
-            break;
-        }
-    }
-    
-    if (correct_recovery_id == -1) {
-        fprintf(stderr, "Failed to find correct recovery ID\n");
-        secp256k1_context_destroy(ctx);
         return -1;
     }
-    
-    // Set v = correct_recovery_id + 27 (Ethereum style)
-    signature_out[64] = (uint8_t)(correct_recovery_id + 27);
-    
-    secp256k1_context_destroy(ctx);
     return 0;
 }
 
@@ -220,29 +142,61 @@ int eip712_domain_hash(const char *domain_name,
     return keccak256(data, 160, domain_hash_out);
 }
 
+// keccak256("Agent(string source,bytes32 connectionId)")
+static const uint8_t AGENT_TYPEHASH[32] = {
+    0x26, 0xf0, 0x5c, 0x2f, 0x72, 0x39, 0xb6, 0x98,
+    0x30, 0x75, 0xe5, 0x83, 0x21, 0x29, 0x2d, 0x77,
+    0xb3, 0xaa, 0x17, 0x3d, 0x19, 0xb2, 0x72, 0x57,
+    0xac, 0x96, 0xab, 0x36, 0x25, 0x70, 0xf5, 0x08
+};
+
+// eip712_domain_hash("Exchange", 1337), shared by mainnet and testnet
+static const uint8_t EXCHANGE_DOMAIN_HASH[32] = {
+    0xd7, 0x92, 0x97, 0xfc, 0xdf, 0x2f, 0xfc, 0xd4,
+    0xae, 0x22, 0x3d, 0x01, 0xed, 0xaa, 0x2b, 0xa2,
+    0x14, 0xff, 0x8f, 0x40, 0x1d, 0x7c, 0x93, 0x00,
+    0xd9, 0x95, 0xd1, 0x7c, 0x82, 0xaa, 0x40, 0x40
+};
+
+// keccak256("a"), the mainnet agent source
+static const uint8_t SOURCE_MAINNET_HASH[32] = {
+    0x3a, 0xc2, 0x25, 0x16, 0x8d, 0xf5, 0x42, 0x12,
+    0xa2, 0x5c, 0x1c, 0x01, 0xfd, 0x35, 0xbe, 0xbf,
+    0xea, 0x40, 0x8f, 0xda, 0xc2, 0xe3, 0x1d, 0xdd,
+    0x6f, 0x80, 0xa4, 0xbb, 0xf9, 0xa5, 0xf1, 0xcb
+};
+
+// keccak256("b"), the testnet agent source
+static const uint8_t SOURCE_TESTNET_HASH[32] = {
+    0xb5, 0x55, 0x3d, 0xe3, 0x15, 0xe0, 0xed, 0xf5,
+    0x04, 0xd9, 0x15, 0x0a, 0xf8, 0x2d, 0xaf, 0xa5,
+    0xc4, 0x66, 0x7f, 0xa6, 0x18, 0xed, 0x0a, 0x6f,
+    0x19, 0xc6, 0x9b, 0x41, 0x16, 0x6c, 0x55, 0x10
+};
+
+/**
+ * @brief Agent struct hash from an already hashed source string
+ */
+static int agent_struct_hash(const uint8_t source_hash[32],
+                             const uint8_t connection_id[32],
+                             uint8_t struct_hash_out[32]) {
+    // Concatenate: typehash || source_hash || connection_id
+    uint8_t data[96];
+    memcpy(data, AGENT_TYPEHASH, 32);
+    memcpy(data + 32, source_hash, 32);
+    memcpy(data + 64, connection_id, 32);
+    
+    return keccak256(data, 96, struct_hash_out);
+}
+
 int eip712_agent_struct_hash(const char *source,
                               const uint8_t connection_id[32],
                               uint8_t struct_hash_out[32]) {
-    // Agent type hash
-    // keccak256("Agent(string source,bytes32 connectionId)")
-    const uint8_t agent_typehash[] = {
-        0x26, 0xf0, 0x5c, 0x2f, 0x72, 0x39, 0xb6, 0x98,
-        0x30, 0x75, 0xe5, 0x83, 0x21, 0x29, 0x2d, 0x77,
-        0xb3, 0xaa, 0x17, 0x3d, 0x19, 0xb2, 0x72, 0x57,
-        0xac, 0x96, 0xab, 0x36, 0x25, 0x70, 0xf5, 0x08
-    };
-    
     // Hash source string
     uint8_t source_hash[32];
     keccak256((const uint8_t *)source, strlen(source), source_hash);
     
-    // Concatenate: typehash || source_hash || connection_id
-    uint8_t data[96];
-    memcpy(data, agent_typehash, 32);
-    memcpy(data + 32, source_hash, 32);
-    memcpy(data + 64, connection_id, 32);
-    
-    return keccak256(data, 96, struct_hash_out);
+    return agent_struct_hash(source_hash, connection_id, struct_hash_out);
 }
 
 int eip712_signing_hash(const uint8_t domain_hash[32],
@@ -258,40 +212,368 @@ int eip712_signing_hash(const uint8_t domain_hash[32],
     return keccak256(data, 66, signing_hash_out);
 }
 
+/**
+ * @brief Domain and source hashes, from the constants when they apply
+ */
+static int agent_fixed_hashes(const char *domain_name,
+                              uint64_t chain_id,
+                              const char *source,
+                              uint8_t domain_hash[32],
+                              uint8_t source_hash[32]) {
+    // Compute domain hash, unless it is the exchange domain every action uses
+    if (chain_id == 1337 && strcmp(domain_name, "Exchange") == 0) {
+        memcpy(domain_hash, EXCHANGE_DOMAIN_HASH, 32);
+    } else if (eip712_domain_hash(domain_name, chain_id, domain_hash) != 0) {
+        fprintf(stderr, "Failed to compute domain hash\n");
+        return -1;
+    }
+    
+    // Same for the source: "a" on mainnet, "b" on testnet
+    if (strcmp(source, "a") == 0) {
+        memcpy(source_hash, SOURCE_MAINNET_HASH, 32);
+    } else if (strcmp(source, "b") == 0) {
+        memcpy(source_hash, SOURCE_TESTNET_HASH, 32);
+    } else if (keccak256((const uint8_t *)source, strlen(source), source_hash) != 0) {
+        fprintf(stderr, "Failed to hash source\n");
+        return -1;
+    }
+    
+    return 0;
+}
+
+int eip712_agent_signing_hash(const char *domain_name,
+                              uint64_t chain_id,
+                              const char *source,
+                              const uint8_t connection_id[32],
+                              uint8_t signing_hash_out[32]) {
+    uint8_t domain_hash[32];
+    uint8_t source_hash[32];
+    uint8_t struct_hash[32];
+    
+    if (agent_fixed_hashes(domain_name, chain_id, source, domain_hash, source_hash) != 0) {
+        return -1;
+    }
+    
+    // Compute struct hash (the only per-action part)
+    if (agent_struct_hash(source_hash, connection_id, struct_hash) != 0) {
+        fprintf(stderr, "Failed to compute struct hash\n");
+        return -1;
+    }
+    
+    // Compute signing hash
+    if (eip712_signing_hash(domain_hash, struct_hash, signing_hash_out) != 0) {
+        fprintf(stderr, "Failed to compute signing hash\n");
+        return -1;
+    }
+    
+    return 0;
+}
+
+int eip712_sign_agent_signer(const hl_signer_t *signer,
+                             const char *domain_name,
+                             uint64_t chain_id,
+                             const char *source,
+                             const uint8_t connection_id[32],
+                             uint8_t signature_out[65]) {
+    uint8_t signing_hash[32];
+    
+    if (eip712_agent_signing_hash(domain_name, chain_id, source, connection_id,
+                                  signing_hash) != 0) {
+        return -1;
+    }
+    
+    // Sign the hash (v is set to recovery_id + 27 by the signer)
+    if (hl_signer_sign_hash(signer, signing_hash, signature_out) != HL_SUCCESS) {
+        fprintf(stderr, "Failed to sign hash\n");
+        return -1;
+    }
+    
+    return 0;
+}
+
+// Actions hashed together per keccak256_batch call
+#define AGENT_BATCH_CHUNK 8
+
+int eip712_sign_agent_batch(const hl_signer_t *signer,
+                            const char *domain_name,
+                            uint64_t chain_id,
+                            const char *source,
+                            const uint8_t *connection_ids,
+                            size_t count,
+                            uint8_t *signatures_out) {
+    if (count == 1) {
+        return eip712_sign_agent_signer(signer, domain_name, chain_id, source,
+                                        connection_ids, signatures_out);
+    }
+    
+    uint8_t domain_hash[32];
+    uint8_t source_hash[32];
+    if (agent_fixed_hashes(domain_name, chain_id, source, domain_hash, source_hash) != 0) {
+        return -1;
+    }
+    
+    for (size_t base = 0; base < count; base += AGENT_BATCH_CHUNK) {
+        size_t n = count - base < AGENT_BATCH_CHUNK ? count - base : AGENT_BATCH_CHUNK;
+        uint8_t struct_data[AGENT_BATCH_CHUNK][96];
+        uint8_t envelope[AGENT_BATCH_CHUNK][66];
+        uint8_t hashes[AGENT_BATCH_CHUNK][32];
+        const uint8_t *inputs[AGENT_BATCH_CHUNK];
+        size_t lengths[AGENT_BATCH_CHUNK];
+        
+        // typehash || source_hash || connection_id, hashed side by side
+        for (size_t i = 0; i < n; i++) {
+            memcpy(struct_data[i], AGENT_TYPEHASH, 32);
+            memcpy(struct_data[i] + 32, source_hash, 32);
+            memcpy(struct_data[i] + 64, connection_ids + 32 * (base + i), 32);
+            inputs[i] = struct_data[i];
+            lengths[i] = sizeof(struct_data[i]);
+        }
+        if (keccak256_batch(inputs, lengths, n, hashes) != 0) {
+            fprintf(stderr, "Failed to compute struct hash\n");
+            return -1;
+        }
+        
+        // 0x19 0x01 || domain_hash || struct_hash, likewise
+        for (size_t i = 0; i < n; i++) {
+            envelope[i][0] = 0x19;
+            envelope[i][1] = 0x01;
+            memcpy(envelope[i] + 2, domain_hash, 32);
+            memcpy(envelope[i] + 34, hashes[i], 32);
+            inputs[i] = envelope[i];
+            lengths[i] = sizeof(envelope[i]);
+        }
+        if (keccak256_batch(inputs, lengths, n, hashes) != 0) {
+            fprintf(stderr, "Failed to compute signing hash\n");
+            return -1;
+        }
+        
+        for (size_t i = 0; i < n; i++) {
+            if (hl_signer_sign_hash(signer, hashes[i], signatures_out + 65 * (base + i)) != HL_SUCCESS) {
+                fprintf(stderr, "Failed to sign hash\n");
+                return -1;
+            }
+        }
+    }
+    
+    return 0;
+}
+
 int eip712_sign_agent(const char *domain_name,
                       uint64_t chain_id,
                       const char *source,
                       const uint8_t connection_id[32],
                       const char *private_key_hex,
                       uint8_t signature_out[65]) {
-    uint8_t domain_hash[32];
-    uint8_t struct_hash[32];
-    uint8_t signing_hash[32];
+    hl_signer_t *signer = hl_signer_create(private_key_hex);
+    if (!signer) {
+        fprintf(stderr, "Failed to parse private key\n");
+        return -1;
+    }
     
-    // Compute domain hash
-    if (eip712_domain_hash(domain_name, chain_id, domain_hash) != 0) {
-        fprintf(stderr, "Failed to compute domain hash\n");
+    int result = eip712_sign_agent_signer(signer, domain_name, chain_id, source,
+                                          connection_id, signature_out);
+    hl_signer_destroy(signer);
+    return result;
+}
+
+/*
+ * User-signed actions
+ *
+ * Transfers and agent approvals are signed by the account key as EIP-712
+ * typed data in the HyperliquidSignTransaction domain. Each struct is
+ * "HyperliquidTransaction:<Name>(string hyperliquidChain, ...)" over
+ * strings, addresses and a uint64 nonce, so every member encodes to one
+ * 32-byte word and the whole struct fits a fixed buffer.
+ */
+
+// eip712_domain_hash("HyperliquidSignTransaction", 0x66eee), the chain id
+// the exchange expects in signatureChainId on mainnet and testnet
+static const uint8_t SIGN_TRANSACTION_DOMAIN_HASH[32] = {
+    0xfe, 0xb1, 0x39, 0x3c, 0xa4, 0x41, 0x2a, 0x4c,
+    0xa5, 0x77, 0xbd, 0x51, 0xd0, 0x4f, 0x0a, 0x77,
+    0x03, 0x35, 0x14, 0xc6, 0x02, 0xf4, 0xd0, 0xa1,
+    0x14, 0x90, 0xfb, 0x95, 0xf7, 0x42, 0x8d, 0xf6
+};
+
+// keccak256("Mainnet"), the hyperliquidChain member on mainnet
+static const uint8_t CHAIN_MAINNET_HASH[32] = {
+    0x8d, 0x64, 0x6f, 0x55, 0x6e, 0x5d, 0x9d, 0x6f,
+    0x1e, 0xdc, 0xf7, 0xa3, 0x9b, 0x77, 0xf5, 0xac,
+    0x25, 0x37, 0x76, 0xeb, 0x34, 0xef, 0xcf, 0xd6,
+    0x88, 0xaa, 0xcb, 0xee, 0x51, 0x8e, 0xfc, 0x26
+};
+
+// keccak256("Testnet")
+static const uint8_t CHAIN_TESTNET_HASH[32] = {
+    0x8a, 0xfe, 0xb2, 0xef, 0xbc, 0xe9, 0x04, 0x9d,
+    0x0c, 0x9b, 0xb8, 0xcb, 0x99, 0x89, 0x81, 0x93,
+    0x14, 0x8e, 0x2e, 0xff, 0xc2, 0x39, 0x47, 0x86,
+    0xb9, 0xa6, 0x52, 0x1e, 0xd7, 0x0d, 0x8b, 0x83
+};
+
+// Type hashes are keccak256 of the type string, checked by test_eip712
+static const eip712_user_type_def_t USER_TYPES[EIP712_USER_TYPE_COUNT] = {
+    [EIP712_USD_SEND] = {
+        .type_string = "HyperliquidTransaction:UsdSend(string hyperliquidChain,"
+                       "string destination,string amount,uint64 time)",
+        .action_type = "usdSend",
+        .type_hash = {
+            0xc7, 0x41, 0x09, 0x64, 0x73, 0x7e, 0x21, 0x80,
+            0xe2, 0x58, 0xd6, 0x49, 0xf2, 0x3f, 0x74, 0xa4,
+            0x94, 0x60, 0x43, 0x2f, 0xec, 0xbd, 0x94, 0x68,
+            0x81, 0x03, 0xec, 0xc6, 0x3f, 0xb6, 0x6b, 0x4c
+        },
+        .field_count = 3,
+        .fields = {
+            {"destination", EIP712_FIELD_STRING},
+            {"amount", EIP712_FIELD_STRING},
+            {"time", EIP712_FIELD_UINT64}
+        }
+    },
+    [EIP712_WITHDRAW] = {
+        .type_string = "HyperliquidTransaction:Withdraw(string hyperliquidChain,"
+                       "string destination,string amount,uint64 time)",
+        .action_type = "withdraw3",
+        .type_hash = {
+            0xdb, 0xde, 0x95, 0x2f, 0xa0, 0xde, 0x88, 0x15,
+            0x8f, 0xc7, 0x13, 0x36, 0xe4, 0x4c, 0x61, 0x87,
+            0x66, 0x11, 0xa2, 0xa6, 0x55, 0x53, 0xbe, 0xbd,
+            0x4d, 0x52, 0xb4, 0x4a, 0x2a, 0x00, 0x0d, 0x9a
+        },
+        .field_count = 3,
+        .fields = {
+            {"destination", EIP712_FIELD_STRING},
+            {"amount", EIP712_FIELD_STRING},
+            {"time", EIP712_FIELD_UINT64}
+        }
+    },
+    [EIP712_SPOT_SEND] = {
+        .type_string = "HyperliquidTransaction:SpotSend(string hyperliquidChain,"
+                       "string destination,string token,string amount,uint64 time)",
+        .action_type = "spotSend",
+        .type_hash = {
+            0xd6, 0xd9, 0x47, 0x2f, 0x42, 0x9b, 0x5d, 0xeb,
+            0xb4, 0xcc, 0x47, 0x02, 0xfa, 0x99, 0x25, 0xe6,
+            0x21, 0x49, 0x84, 0x72, 0xa9, 0x79, 0xf2, 0x58,
+            0x15, 0x53, 0xdd, 0x00, 0x7e, 0x27, 0x39, 0x83
+        },
+        .field_count = 4,
+        .fields = {
+            {"destination", EIP712_FIELD_STRING},
+            {"token", EIP712_FIELD_STRING},
+            {"amount", EIP712_FIELD_STRING},
+            {"time", EIP712_FIELD_UINT64}
+        }
+    },
+    [EIP712_APPROVE_AGENT] = {
+        .type_string = "HyperliquidTransaction:ApproveAgent(string hyperliquidChain,"
+                       "address agentAddress,string agentName,uint64 nonce)",
+        .action_type = "approveAgent",
+        .type_hash = {
+            0x44, 0x64, 0xab, 0xf6, 0x14, 0x8f, 0x11, 0x5d,
+            0x79, 0x36, 0x2d, 0x98, 0x32, 0x00, 0x81, 0xaa,
+            0x2a, 0xe8, 0xa5, 0xc8, 0x40, 0x08, 0x3c, 0xb6,
+            0x58, 0x20, 0xbf, 0xfc, 0x21, 0x39, 0x43, 0x78
+        },
+        .field_count = 3,
+        .fields = {
+            {"agentAddress", EIP712_FIELD_ADDRESS},
+            {"agentName", EIP712_FIELD_STRING},
+            {"nonce", EIP712_FIELD_UINT64}
+        }
+    }
+};
+
+const eip712_user_type_def_t *eip712_user_type(eip712_user_type_t type) {
+    if ((unsigned)type >= EIP712_USER_TYPE_COUNT) {
+        return NULL;
+    }
+    return &USER_TYPES[type];
+}
+
+int eip712_user_struct_hash(eip712_user_type_t type,
+                            bool testnet,
+                            const eip712_value_t values[],
+                            uint8_t struct_hash_out[32]) {
+    const eip712_user_type_def_t *def = eip712_user_type(type);
+    if (!def || !values || def->field_count > EIP712_MAX_FIELDS) {
+        return -1;
+    }
+    size_t field_count = def->field_count;
+    
+    // typehash || hyperliquidChain || one word per field
+    uint8_t data[32 * (2 + EIP712_MAX_FIELDS)];
+    memcpy(data, def->type_hash, 32);
+    memcpy(data + 32, testnet ? CHAIN_TESTNET_HASH : CHAIN_MAINNET_HASH, 32);
+    
+    // Strings are encoded as their hash; hash them side by side
+    const uint8_t *inputs[EIP712_MAX_FIELDS];
+    size_t lengths[EIP712_MAX_FIELDS];
+    uint8_t string_hashes[EIP712_MAX_FIELDS][32];
+    size_t string_count = 0;
+    
+    for (size_t i = 0; i < field_count; i++) {
+        uint8_t *word = data + 64 + 32 * i;
+        memset(word, 0, 32);
+        
+        switch (def->fields[i].kind) {
+            case EIP712_FIELD_STRING:
+                if (!values[i].string) {
+                    return -1;
+                }
+                inputs[string_count] = (const uint8_t *)values[i].string;
+                lengths[string_count] = strlen(values[i].string);
+                string_count++;
+                break;
+            case EIP712_FIELD_ADDRESS:
+                if (!values[i].address) {
+                    return -1;
+                }
+                memcpy(word + 12, values[i].address, 20);
+                break;
+            case EIP712_FIELD_UINT64:
+                for (int b = 0; b < 8; b++) {
+                    word[24 + b] = (uint8_t)(values[i].uint64 >> (56 - b * 8));
+                }
+                break;
+        }
+    }
+    
+    if (string_count > 0 &&
+        keccak256_batch(inputs, lengths, string_count, string_hashes) != 0) {
         return -1;
     }
+    for (size_t i = 0, s = 0; i < field_count; i++) {
+        if (def->fields[i].kind == EIP712_FIELD_STRING) {
+            memcpy(data + 64 + 32 * i, string_hashes[s++], 32);
+        }
+    }
     
-    // Compute struct hash
-    if (eip712_agent_struct_hash(source, connection_id, struct_hash) != 0) {
+    return keccak256(data, 32 * (2 + field_count), struct_hash_out);
+}
+
+int eip712_sign_user_action(const hl_signer_t *signer,
+                            eip712_user_type_t type,
+                            bool testnet,
+                            const eip712_value_t values[],
+                            uint8_t signature_out[65]) {
+    uint8_t struct_hash[32];
+    uint8_t signing_hash[32];
+    
+    if (eip712_user_struct_hash(type, testnet, values, struct_hash) != 0) {
         fprintf(stderr, "Failed to compute struct hash\n");
         return -1;
     }
     
-    // Compute signing hash
-    if (eip712_signing_hash(domain_hash, struct_hash, signing_hash) != 0) {
+    if (eip712_signing_hash(SIGN_TRANSACTION_DOMAIN_HASH, struct_hash, signing_hash) != 0) {
         fprintf(stderr, "Failed to compute signing hash\n");
         return -1;
     }
     
-    // Sign the hash (v is already set to recovery_id + 27 inside ecdsa_sign_secp256k1)
-    if (ecdsa_sign_secp256k1(signing_hash, private_key_hex, signature_out) != 0) {
+    if (hl_signer_sign_hash(signer, signing_hash, signature_out) != HL_SUCCESS) {
         fprintf(stderr, "Failed to sign hash\n");
         return -1;
     }
     
     return 0;
 }
-
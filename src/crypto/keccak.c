@@ -44,7 +44,7 @@
 	(((x) << (y)) | ((x) >> ((sizeof(uint64_t)*8) - (y))))
 #endif
 
-static const uint64_t keccakf_rndc[24] = {
+const uint64_t keccakf_rndc[24] = {
     SHA3_CONST(0x0000000000000001UL), SHA3_CONST(0x0000000000008082UL),
     SHA3_CONST(0x800000000000808aUL), SHA3_CONST(0x8000000080008000UL),
     SHA3_CONST(0x000000000000808bUL), SHA3_CONST(0x0000000080000001UL),
@@ -69,11 +69,12 @@ static const unsigned keccakf_piln[24] = {
     14, 22, 9, 6, 1
 };
 
-/* generally called after SHA3_KECCAK_SPONGE_WORDS-ctx->capacityWords words 
- * are XORed into the state s 
+/* Textbook permutation, one loop per step. Kept as the reference the
+ * unrolled version is tested against; build with -DHL_KECCAK_LOOP to
+ * hash with it.
  */
-static void
-keccakf(uint64_t s[25])
+void
+keccakf_loop(uint64_t s[25])
 {
     int i, j, round;
     uint64_t t, bc[5];
@@ -113,6 +114,129 @@ keccakf(uint64_t s[25])
     }
 }
 
+/*
+ * Unrolled permutation with lane complementing (the "bebigokimisa"
+ * transform from the Keccak team's implementation overview). Lanes
+ * be, bi, go, ki, mi and sa are held complemented between rounds, which
+ * lets chi use a single NOT per row instead of five. Rho and pi are folded
+ * into fixed rotations and lane names, so no table is read. Rounds
+ * alternate between the A and E lane sets.
+ */
+#define KECCAK_ROUND(i, A, E) \
+    Ca = A##ba ^ A##ga ^ A##ka ^ A##ma ^ A##sa; \
+    Ce = A##be ^ A##ge ^ A##ke ^ A##me ^ A##se; \
+    Ci = A##bi ^ A##gi ^ A##ki ^ A##mi ^ A##si; \
+    Co = A##bo ^ A##go ^ A##ko ^ A##mo ^ A##so; \
+    Cu = A##bu ^ A##gu ^ A##ku ^ A##mu ^ A##su; \
+    Da = Cu ^ SHA3_ROTL64(Ce, 1); \
+    De = Ca ^ SHA3_ROTL64(Ci, 1); \
+    Di = Ce ^ SHA3_ROTL64(Co, 1); \
+    Do = Ci ^ SHA3_ROTL64(Cu, 1); \
+    Du = Co ^ SHA3_ROTL64(Ca, 1); \
+    \
+    Bba = A##ba ^ Da; \
+    Bbe = SHA3_ROTL64(A##ge ^ De, 44); \
+    Bbi = SHA3_ROTL64(A##ki ^ Di, 43); \
+    Bbo = SHA3_ROTL64(A##mo ^ Do, 21); \
+    Bbu = SHA3_ROTL64(A##su ^ Du, 14); \
+    E##ba = Bba ^ (Bbe | Bbi) ^ keccakf_rndc[i]; \
+    E##be = Bbe ^ ((~Bbi) | Bbo); \
+    E##bi = Bbi ^ (Bbo & Bbu); \
+    E##bo = Bbo ^ (Bbu | Bba); \
+    E##bu = Bbu ^ (Bba & Bbe); \
+    \
+    Bga = SHA3_ROTL64(A##bo ^ Do, 28); \
+    Bge = SHA3_ROTL64(A##gu ^ Du, 20); \
+    Bgi = SHA3_ROTL64(A##ka ^ Da, 3); \
+    Bgo = SHA3_ROTL64(A##me ^ De, 45); \
+    Bgu = SHA3_ROTL64(A##si ^ Di, 61); \
+    E##ga = Bga ^ (Bge | Bgi); \
+    E##ge = Bge ^ (Bgi & Bgo); \
+    E##gi = Bgi ^ (Bgo | (~Bgu)); \
+    E##go = Bgo ^ (Bgu | Bga); \
+    E##gu = Bgu ^ (Bga & Bge); \
+    \
+    Bka = SHA3_ROTL64(A##be ^ De, 1); \
+    Bke = SHA3_ROTL64(A##gi ^ Di, 6); \
+    Bki = SHA3_ROTL64(A##ko ^ Do, 25); \
+    Bko = SHA3_ROTL64(A##mu ^ Du, 8); \
+    Bku = SHA3_ROTL64(A##sa ^ Da, 18); \
+    E##ka = Bka ^ (Bke | Bki); \
+    E##ke = Bke ^ (Bki & Bko); \
+    E##ki = Bki ^ ((~Bko) & Bku); \
+    E##ko = (~Bko) ^ (Bku | Bka); \
+    E##ku = Bku ^ (Bka & Bke); \
+    \
+    Bma = SHA3_ROTL64(A##bu ^ Du, 27); \
+    Bme = SHA3_ROTL64(A##ga ^ Da, 36); \
+    Bmi = SHA3_ROTL64(A##ke ^ De, 10); \
+    Bmo = SHA3_ROTL64(A##mi ^ Di, 15); \
+    Bmu = SHA3_ROTL64(A##so ^ Do, 56); \
+    E##ma = Bma ^ (Bme & Bmi); \
+    E##me = Bme ^ (Bmi | Bmo); \
+    E##mi = Bmi ^ ((~Bmo) | Bmu); \
+    E##mo = (~Bmo) ^ (Bmu & Bma); \
+    E##mu = Bmu ^ (Bma | Bme); \
+    \
+    Bsa = SHA3_ROTL64(A##bi ^ Di, 62); \
+    Bse = SHA3_ROTL64(A##go ^ Do, 55); \
+    Bsi = SHA3_ROTL64(A##ku ^ Du, 39); \
+    Bso = SHA3_ROTL64(A##ma ^ Da, 41); \
+    Bsu = SHA3_ROTL64(A##se ^ De, 2); \
+    E##sa = Bsa ^ ((~Bse) & Bsi); \
+    E##se = (~Bse) ^ (Bsi | Bso); \
+    E##si = Bsi ^ (Bso & Bsu); \
+    E##so = Bso ^ (Bsu | Bsa); \
+    E##su = Bsu ^ (Bsa & Bse);
+
+void
+keccakf_unrolled(uint64_t s[25])
+{
+    uint64_t Aba, Abe, Abi, Abo, Abu, Aga, Age, Agi, Ago, Agu;
+    uint64_t Aka, Ake, Aki, Ako, Aku, Ama, Ame, Ami, Amo, Amu;
+    uint64_t Asa, Ase, Asi, Aso, Asu;
+    uint64_t Eba, Ebe, Ebi, Ebo, Ebu, Ega, Ege, Egi, Ego, Egu;
+    uint64_t Eka, Eke, Eki, Eko, Eku, Ema, Eme, Emi, Emo, Emu;
+    uint64_t Esa, Ese, Esi, Eso, Esu;
+    uint64_t Bba, Bbe, Bbi, Bbo, Bbu, Bga, Bge, Bgi, Bgo, Bgu;
+    uint64_t Bka, Bke, Bki, Bko, Bku, Bma, Bme, Bmi, Bmo, Bmu;
+    uint64_t Bsa, Bse, Bsi, Bso, Bsu;
+    uint64_t Ca, Ce, Ci, Co, Cu, Da, De, Di, Do, Du;
+
+    Aba = s[0];   Abe = ~s[1];  Abi = ~s[2];  Abo = s[3];   Abu = s[4];
+    Aga = s[5];   Age = s[6];   Agi = s[7];   Ago = ~s[8];  Agu = s[9];
+    Aka = s[10];  Ake = s[11];  Aki = ~s[12]; Ako = s[13];  Aku = s[14];
+    Ama = s[15];  Ame = s[16];  Ami = ~s[17]; Amo = s[18];  Amu = s[19];
+    Asa = ~s[20]; Ase = s[21];  Asi = s[22];  Aso = s[23];  Asu = s[24];
+
+    KECCAK_ROUND(0, A, E)  KECCAK_ROUND(1, E, A)
+    KECCAK_ROUND(2, A, E)  KECCAK_ROUND(3, E, A)
+    KECCAK_ROUND(4, A, E)  KECCAK_ROUND(5, E, A)
+    KECCAK_ROUND(6, A, E)  KECCAK_ROUND(7, E, A)
+    KECCAK_ROUND(8, A, E)  KECCAK_ROUND(9, E, A)
+    KECCAK_ROUND(10, A, E) KECCAK_ROUND(11, E, A)
+    KECCAK_ROUND(12, A, E) KECCAK_ROUND(13, E, A)
+    KECCAK_ROUND(14, A, E) KECCAK_ROUND(15, E, A)
+    KECCAK_ROUND(16, A, E) KECCAK_ROUND(17, E, A)
+    KECCAK_ROUND(18, A, E) KECCAK_ROUND(19, E, A)
+    KECCAK_ROUND(20, A, E) KECCAK_ROUND(21, E, A)
+    KECCAK_ROUND(22, A, E) KECCAK_ROUND(23, E, A)
+
+    s[0] = Aba;   s[1] = ~Abe;  s[2] = ~Abi;  s[3] = Abo;   s[4] = Abu;
+    s[5] = Aga;   s[6] = Age;   s[7] = Agi;   s[8] = ~Ago;  s[9] = Agu;
+    s[10] = Aka;  s[11] = Ake;  s[12] = ~Aki; s[13] = Ako;  s[14] = Aku;
+    s[15] = Ama;  s[16] = Ame;  s[17] = ~Ami; s[18] = Amo;  s[19] = Amu;
+    s[20] = ~Asa; s[21] = Ase;  s[22] = Asi;  s[23] = Aso;  s[24] = Asu;
+}
+
+#undef KECCAK_ROUND
+
+#ifdef HL_KECCAK_LOOP
+#define keccakf keccakf_loop
+#else
+#define keccakf keccakf_unrolled
+#endif
+
 /* *************************** Public Inteface ************************ */
 
 /* For Init or Reset call these: */
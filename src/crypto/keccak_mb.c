@@ -0,0 +1,235 @@
+/**
+ * @file keccak_mb.c
+ * @brief Multi-buffer Keccak-256 for batches of short, independent inputs
+ *
+ * Inputs are interleaved lane by lane so that one vector permutation
+ * advances 4 states (AVX2) or 8 states (AVX-512) at once. The widest path
+ * the CPU supports is picked at runtime; elsewhere each input goes through
+ * the scalar keccak256.
+ */
+
+#include "hl_crypto_internal.h"
+#include <string.h>
+
+#if defined(__x86_64__) && defined(__GNUC__)
+#define KECCAK_MB_X86 1
+#include <immintrin.h>
+#endif
+
+#define KECCAK256_RATE 136
+#define KECCAK256_RATE_WORDS (KECCAK256_RATE / 8)
+#define KECCAK_MB_MAX_WAYS 8
+
+#ifdef KECCAK_MB_X86
+
+/* Rho and pi for lane x + 5y: B[y + 5((2x + 3y) mod 5)] = ROL(A[x + 5y] ^ D[x]) */
+#define KECCAK_MB_RHO_PI(B, A, D, XOR, ROL) \
+    B[0] = XOR(A[0], D[0]); \
+    B[10] = ROL(XOR(A[1], D[1]), 1); \
+    B[20] = ROL(XOR(A[2], D[2]), 62); \
+    B[5] = ROL(XOR(A[3], D[3]), 28); \
+    B[15] = ROL(XOR(A[4], D[4]), 27); \
+    B[16] = ROL(XOR(A[5], D[0]), 36); \
+    B[1] = ROL(XOR(A[6], D[1]), 44); \
+    B[11] = ROL(XOR(A[7], D[2]), 6); \
+    B[21] = ROL(XOR(A[8], D[3]), 55); \
+    B[6] = ROL(XOR(A[9], D[4]), 20); \
+    B[7] = ROL(XOR(A[10], D[0]), 3); \
+    B[17] = ROL(XOR(A[11], D[1]), 10); \
+    B[2] = ROL(XOR(A[12], D[2]), 43); \
+    B[12] = ROL(XOR(A[13], D[3]), 25); \
+    B[22] = ROL(XOR(A[14], D[4]), 39); \
+    B[23] = ROL(XOR(A[15], D[0]), 41); \
+    B[8] = ROL(XOR(A[16], D[1]), 45); \
+    B[18] = ROL(XOR(A[17], D[2]), 15); \
+    B[3] = ROL(XOR(A[18], D[3]), 21); \
+    B[13] = ROL(XOR(A[19], D[4]), 8); \
+    B[14] = ROL(XOR(A[20], D[0]), 18); \
+    B[24] = ROL(XOR(A[21], D[1]), 2); \
+    B[9] = ROL(XOR(A[22], D[2]), 61); \
+    B[19] = ROL(XOR(A[23], D[3]), 56); \
+    B[4] = ROL(XOR(A[24], D[4]), 14);
+
+/* All 24 rounds over a vector state A[25], one Keccak instance per element */
+#define KECCAK_MB_ROUNDS(T, A, XOR, XOR5, CHI, ROL, SET1) do { \
+    T B[25], C[5], D[5]; \
+    for (int round = 0; round < 24; round++) { \
+        for (int x = 0; x < 5; x++) \
+            C[x] = XOR5(A[x], A[x + 5], A[x + 10], A[x + 15], A[x + 20]); \
+        for (int x = 0; x < 5; x++) \
+            D[x] = XOR(C[(x + 4) % 5], ROL(C[(x + 1) % 5], 1)); \
+        KECCAK_MB_RHO_PI(B, A, D, XOR, ROL); \
+        for (int y = 0; y < 25; y += 5) \
+            for (int x = 0; x < 5; x++) \
+                A[y + x] = CHI(B[y + x], B[y + (x + 1) % 5], B[y + (x + 2) % 5]); \
+        A[0] = XOR(A[0], SET1(keccakf_rndc[round])); \
+    } \
+} while (0)
+
+#define X4_XOR(a, b) _mm256_xor_si256((a), (b))
+#define X4_XOR5(a, b, c, d, e) X4_XOR(X4_XOR(X4_XOR((a), (b)), X4_XOR((c), (d))), (e))
+#define X4_CHI(a, b, c) X4_XOR((a), _mm256_andnot_si256((b), (c)))
+#define X4_ROL(v, n) _mm256_or_si256(_mm256_slli_epi64((v), (n)), _mm256_srli_epi64((v), 64 - (n)))
+#define X4_SET1(c) _mm256_set1_epi64x((long long)(c))
+
+/**
+ * @brief Four interleaved permutations; lanes[4 * i + k] is lane i of state k
+ */
+__attribute__((target("avx2")))
+static void keccakf_x4(uint64_t *lanes) {
+    __m256i A[25];
+    for (int i = 0; i < 25; i++) {
+        A[i] = _mm256_load_si256((const __m256i *)(lanes + 4 * i));
+    }
+    KECCAK_MB_ROUNDS(__m256i, A, X4_XOR, X4_XOR5, X4_CHI, X4_ROL, X4_SET1);
+    for (int i = 0; i < 25; i++) {
+        _mm256_store_si256((__m256i *)(lanes + 4 * i), A[i]);
+    }
+}
+
+/* Ternary logic: 0x96 is a ^ b ^ c, 0xD2 is a ^ (~b & c) */
+#define X8_XOR(a, b) _mm512_xor_si512((a), (b))
+#define X8_XOR5(a, b, c, d, e) \
+    _mm512_ternarylogic_epi64(_mm512_ternarylogic_epi64((a), (b), (c), 0x96), (d), (e), 0x96)
+#define X8_CHI(a, b, c) _mm512_ternarylogic_epi64((a), (b), (c), 0xD2)
+#define X8_ROL(v, n) _mm512_rol_epi64((v), (n))
+#define X8_SET1(c) _mm512_set1_epi64((long long)(c))
+
+/**
+ * @brief Eight interleaved permutations; lanes[8 * i + k] is lane i of state k
+ */
+__attribute__((target("avx512f")))
+static void keccakf_x8(uint64_t *lanes) {
+    __m512i A[25];
+    for (int i = 0; i < 25; i++) {
+        A[i] = _mm512_load_si512((const void *)(lanes + 8 * i));
+    }
+    KECCAK_MB_ROUNDS(__m512i, A, X8_XOR, X8_XOR5, X8_CHI, X8_ROL, X8_SET1);
+    for (int i = 0; i < 25; i++) {
+        _mm512_store_si512((void *)(lanes + 8 * i), A[i]);
+    }
+}
+
+static uint64_t load_le64(const uint8_t *p) {
+    uint64_t v = 0;
+    for (int i = 7; i >= 0; i--) {
+        v = (v << 8) | p[i];
+    }
+    return v;
+}
+
+static void absorb_block(uint64_t *lanes, size_t ways, size_t slot, const uint8_t *block) {
+    for (size_t i = 0; i < KECCAK256_RATE_WORDS; i++) {
+        lanes[i * ways + slot] ^= load_le64(block + 8 * i);
+    }
+}
+
+/**
+ * @brief Hash up to `ways` inputs through one interleaved state
+ *
+ * Inputs may differ in length. A state whose input is done keeps being
+ * permuted with the others, but its digest was squeezed right after its
+ * last block.
+ */
+static void hash_group(size_t ways, void (*permute)(uint64_t *),
+                       const uint8_t *const inputs[], const size_t lengths[],
+                       size_t count, uint8_t outputs[][32]) {
+    _Alignas(64) uint64_t lanes[25 * KECCAK_MB_MAX_WAYS];
+    size_t blocks[KECCAK_MB_MAX_WAYS];
+    size_t max_blocks = 0;
+
+    memset(lanes, 0, 25 * ways * sizeof(uint64_t));
+    for (size_t j = 0; j < count; j++) {
+        blocks[j] = lengths[j] / KECCAK256_RATE + 1;
+        if (blocks[j] > max_blocks) {
+            max_blocks = blocks[j];
+        }
+    }
+
+    for (size_t b = 0; b < max_blocks; b++) {
+        for (size_t j = 0; j < count; j++) {
+            if (b + 1 < blocks[j]) {
+                absorb_block(lanes, ways, j, inputs[j] + b * KECCAK256_RATE);
+            } else if (b + 1 == blocks[j]) {
+                // Keccak padding: 0x01 ... 0x80
+                uint8_t last[KECCAK256_RATE] = {0};
+                size_t tail = lengths[j] - b * KECCAK256_RATE;
+                if (tail > 0) {
+                    memcpy(last, inputs[j] + b * KECCAK256_RATE, tail);
+                }
+                last[tail] ^= 0x01;
+                last[KECCAK256_RATE - 1] ^= 0x80;
+                absorb_block(lanes, ways, j, last);
+            }
+        }
+
+        permute(lanes);
+
+        for (size_t j = 0; j < count; j++) {
+            if (b + 1 == blocks[j]) {
+                for (size_t i = 0; i < 32; i++) {
+                    outputs[j][i] = (uint8_t)(lanes[(i / 8) * ways + j] >> (8 * (i % 8)));
+                }
+            }
+        }
+    }
+}
+
+#endif /* KECCAK_MB_X86 */
+
+size_t keccak256_batch_ways(void) {
+#ifdef KECCAK_MB_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f")) {
+        return 8;
+    }
+    if (__builtin_cpu_supports("avx2")) {
+        return 4;
+    }
+#endif
+    return 1;
+}
+
+int keccak256_batch_with(size_t ways,
+                         const uint8_t *const inputs[],
+                         const size_t lengths[],
+                         size_t count,
+                         uint8_t outputs[][32]) {
+    if (count > 0 && (!inputs || !lengths || !outputs)) {
+        return -1;
+    }
+    if (ways != 1 && ways != 4 && ways != 8) {
+        return -1;
+    }
+    if (ways > keccak256_batch_ways()) {
+        return -1;
+    }
+
+    size_t done = 0;
+#ifdef KECCAK_MB_X86
+    // Partial groups still pay for a full-width permutation, so a tail of
+    // five or more goes eight-wide and a tail of two to four four-wide
+    while (count - done >= 2 && ways >= 4) {
+        size_t remaining = count - done;
+        size_t width = (ways == 8 && remaining > 4) ? 8 : 4;
+        size_t group = remaining < width ? remaining : width;
+        hash_group(width, width == 8 ? keccakf_x8 : keccakf_x4, inputs + done, lengths + done,
+                   group, outputs + done);
+        done += group;
+    }
+#endif
+
+    for (; done < count; done++) {
+        if (keccak256(inputs[done], lengths[done], outputs[done]) != 0) {
+            return -1;
+        }
+    }
+    return 0;
+}
+
+int keccak256_batch(const uint8_t *const inputs[],
+                    const size_t lengths[],
+                    size_t count,
+                    uint8_t outputs[][32]) {
+    return keccak256_batch_with(keccak256_batch_ways(), inputs, lengths, count, outputs);
+}
@@ -0,0 +1,223 @@
+/**
+ * @file signer.c
+ * @brief Long-lived secp256k1 signing key
+ *
+ * Creating a secp256k1 context costs far more than a signature, so the
+ * context is built and randomized once per key. The parsed key lives on
+ * its own locked page, excluded from core dumps, and is wiped before the
+ * page is released.
+ */
+
+#define _DEFAULT_SOURCE
+
+#include "hl_signer.h"
+#include "hl_crypto_internal.h"
+#include "hl_logger.h"
+#include <stdlib.h>
+#include <string.h>
+#include <stdatomic.h>
+#include <errno.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <openssl/rand.h>
+
+#include <secp256k1.h>
+#include <secp256k1_recovery.h>
+
+struct hl_signer {
+    secp256k1_context* ctx;             /**< Randomized; read-only after create */
+    uint8_t* key;                       /**< 32-byte secret key on the locked page */
+    size_t key_page_size;
+    uint8_t address_bytes[20];
+    char address[43];                   /**< 0x + 40 hex + null */
+    bool verify;                        /**< Recover each signature and compare */
+    _Atomic uint64_t last_nonce;        /**< Highest nonce handed out */
+};
+
+// The exchange takes nonces up to a day ahead of its clock; stay well inside
+#define NONCE_MAX_LEAD_MS (60ULL * 60 * 1000)
+
+/**
+ * @brief Zero memory in a way the compiler cannot drop
+ */
+static void secure_wipe(void* data, size_t size) {
+    volatile uint8_t* bytes = (volatile uint8_t*)data;
+    while (size--) {
+        *bytes++ = 0;
+    }
+}
+
+/**
+ * @brief Map a page for the key, locked in RAM and kept out of core dumps
+ */
+static uint8_t* alloc_key_page(size_t* page_size) {
+    long page = sysconf(_SC_PAGESIZE);
+    *page_size = page > 0 ? (size_t)page : 4096;
+
+    void* mem = mmap(NULL, *page_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (mem == MAP_FAILED) {
+        return NULL;
+    }
+
+    // Best effort: RLIMIT_MEMLOCK may be tight in containers
+    if (mlock(mem, *page_size) != 0) {
+        HL_LOG_DEBUG("signer: mlock failed (errno %d), key page may be swapped", errno);
+    }
+#ifdef MADV_DONTDUMP
+    madvise(mem, *page_size, MADV_DONTDUMP);
+#endif
+    return mem;
+}
+
+hl_signer_t* hl_signer_create(const char* private_key_hex) {
+    if (!private_key_hex) {
+        return NULL;
+    }
+
+    hl_signer_t* signer = calloc(1, sizeof(hl_signer_t));
+    if (!signer) {
+        return NULL;
+    }
+
+    atomic_init(&signer->last_nonce, 0);
+    signer->key = alloc_key_page(&signer->key_page_size);
+    signer->ctx = secp256k1_context_create(SECP256K1_CONTEXT_SIGN | SECP256K1_CONTEXT_VERIFY);
+    if (!signer->key || !signer->ctx) {
+        hl_signer_destroy(signer);
+        return NULL;
+    }
+
+    if (hex_to_bytes(private_key_hex, signer->key, 32) != 32 ||
+        !secp256k1_ec_seckey_verify(signer->ctx, signer->key)) {
+        hl_signer_destroy(signer);
+        return NULL;
+    }
+
+    // Blind the context against timing and power side channels
+    uint8_t seed[32];
+    if (RAND_bytes(seed, sizeof(seed)) != 1 || !secp256k1_context_randomize(signer->ctx, seed)) {
+        secure_wipe(seed, sizeof(seed));
+        hl_signer_destroy(signer);
+        return NULL;
+    }
+    secure_wipe(seed, sizeof(seed));
+
+    // Address = last 20 bytes of keccak256(uncompressed pubkey without prefix)
+    secp256k1_pubkey pubkey;
+    uint8_t pubkey_bytes[65];
+    size_t pubkey_len = sizeof(pubkey_bytes);
+    uint8_t pubkey_hash[32];
+    if (!secp256k1_ec_pubkey_create(signer->ctx, &pubkey, signer->key) ||
+        !secp256k1_ec_pubkey_serialize(signer->ctx, pubkey_bytes, &pubkey_len, &pubkey,
+                                       SECP256K1_EC_UNCOMPRESSED) ||
+        keccak256(pubkey_bytes + 1, 64, pubkey_hash) != 0) {
+        hl_signer_destroy(signer);
+        return NULL;
+    }
+    memcpy(signer->address_bytes, pubkey_hash + 12, 20);
+    bytes_to_hex(signer->address_bytes, 20, signer->address, true);
+
+#ifdef DEBUG
+    signer->verify = true;
+#endif
+    return signer;
+}
+
+void hl_signer_destroy(hl_signer_t* signer) {
+    if (!signer) {
+        return;
+    }
+
+    if (signer->key) {
+        secure_wipe(signer->key, 32);
+        munlock(signer->key, signer->key_page_size);
+        munmap(signer->key, signer->key_page_size);
+    }
+    if (signer->ctx) {
+        secp256k1_context_destroy(signer->ctx);
+    }
+    free(signer);
+}
+
+const char* hl_signer_address(const hl_signer_t* signer) {
+    return signer ? signer->address : NULL;
+}
+
+/**
+ * @brief Check that a signature recovers to the signer's own address
+ */
+static bool recovers_own_address(const hl_signer_t* signer,
+                                 const secp256k1_ecdsa_recoverable_signature* sig,
+                                 const uint8_t hash[32]) {
+    secp256k1_pubkey recovered;
+    if (!secp256k1_ecdsa_recover(signer->ctx, &recovered, sig, hash)) {
+        return false;
+    }
+
+    uint8_t recovered_bytes[65];
+    size_t recovered_len = sizeof(recovered_bytes);
+    uint8_t recovered_hash[32];
+    secp256k1_ec_pubkey_serialize(signer->ctx, recovered_bytes, &recovered_len, &recovered,
+                                  SECP256K1_EC_UNCOMPRESSED);
+    keccak256(recovered_bytes + 1, 64, recovered_hash);
+    return memcmp(recovered_hash + 12, signer->address_bytes, 20) == 0;
+}
+
+uint64_t hl_signer_reserve_nonces(hl_signer_t* signer, uint64_t now_ms, size_t count) {
+    if (!signer || count == 0) {
+        return 0;
+    }
+
+    uint64_t last = atomic_load_explicit(&signer->last_nonce, memory_order_relaxed);
+    for (;;) {
+        uint64_t first = last + 1 > now_ms ? last + 1 : now_ms;
+        if (first + count - 1 > now_ms + NONCE_MAX_LEAD_MS) {
+            return 0;
+        }
+        if (atomic_compare_exchange_weak_explicit(&signer->last_nonce, &last, first + count - 1,
+                                                  memory_order_relaxed, memory_order_relaxed)) {
+            return first;
+        }
+    }
+}
+
+uint64_t hl_signer_next_nonce(hl_signer_t* signer, uint64_t now_ms) {
+    return hl_signer_reserve_nonces(signer, now_ms, 1);
+}
+
+void hl_signer_set_verify(hl_signer_t* signer, bool verify) {
+    if (signer) {
+        signer->verify = verify;
+    }
+}
+
+hl_error_t hl_signer_sign_hash(const hl_signer_t* signer, const uint8_t hash[32],
+                               uint8_t signature_out[65]) {
+    if (!signer || !hash || !signature_out) {
+        return HL_ERROR_INVALID_PARAMS;
+    }
+
+    // RFC 6979 deterministic nonce
+    secp256k1_ecdsa_recoverable_signature sig;
+    if (!secp256k1_ecdsa_sign_recoverable(signer->ctx, &sig, hash, signer->key, NULL, NULL)) {
+        return HL_ERROR_SIGNATURE;
+    }
+
+    // The recovery id comes straight from the signing operation
+    int recovery_id;
+    uint8_t compact_sig[64];
+    secp256k1_ecdsa_recoverable_signature_serialize_compact(signer->ctx, compact_sig,
+                                                            &recovery_id, &sig);
+    if (recovery_id < 0 || recovery_id > 3) {
+        return HL_ERROR_SIGNATURE;
+    }
+
+    if (signer->verify && !recovers_own_address(signer, &sig, hash)) {
+        HL_LOG_ERROR("signer: signature does not recover %s", signer->address);
+        return HL_ERROR_SIGNATURE;
+    }
+
+    memcpy(signature_out, compact_sig, 64);
+    signature_out[64] = (uint8_t)(recovery_id + 27);
+    return HL_SUCCESS;
+}
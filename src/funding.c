@@ -8,6 +8,7 @@
 #include <stdlib.h>
 #include <string.h>
 #include <stdio.h>
+#include <time.h>
 
 // Forward declarations
 typedef struct hl_funding_rate hl_funding_rate_t;
@@ -40,6 +41,39 @@ hl_error_t hl_fetch_funding_rates(hl_client_t* client, hl_funding_rates_t* rates
     // Clear output
     memset(rates, 0, sizeof(hl_funding_rates_t));
 
+    // Every perp streamed (hl_watch_asset_ctxs): answer from memory
+    size_t live_count = 0;
+    hl_market_t* live = hl_client_live_swap_markets(client, &live_count);
+    if (live) {
+        rates->rates = calloc(live_count, sizeof(hl_funding_rate_t));
+        if (!rates->rates) {
+            free(live);
+            return HL_ERROR_MEMORY;
+        }
+
+        for (size_t i = 0; i < live_count; i++) {
+            hl_funding_rate_t* rate = &rates->rates[i];
+            lv3_string_copy(rate->symbol, live[i].symbol, sizeof(rate->symbol));
+            rate->funding_rate = live[i].funding_rate;
+            rate->mark_price = live[i].mark_price;
+            rate->index_price = live[i].oracle_price;
+            rate->open_interest = live[i].open_interest;
+            rate->premium = live[i].premium;
+            snprintf(rate->timestamp, sizeof(rate->timestamp), "%lld",
+                     (long long)live[i].ctx_update_ms);
+
+            time_t seconds = (time_t)(live[i].ctx_update_ms / 1000);
+            struct tm* tm_info = gmtime(&seconds);
+            if (tm_info) {
+                strftime(rate->datetime, sizeof(rate->datetime), "%Y-%m-%dT%H:%M:%SZ", tm_info);
+            }
+        }
+        rates->count = live_count;
+
+        free(live);
+        return HL_SUCCESS;
+    }
+
     // Prepare request - use metaAndAssetCtxs endpoint
     char request_body[256] = "{\"type\":\"metaAndAssetCtxs\"}";
 
@@ -0,0 +1,111 @@
+/**
+ * @file job_queue.c
+ * @brief Bounded MPMC queue of pointers
+ *
+ * Vyukov's sequence-numbered ring. Each cell's sequence says whether it
+ * is free for the producer at that position or published for the
+ * consumer; handing an item over is a CAS on the position and a release
+ * store of the sequence. A semaphore counts published entries so that
+ * idle consumers can sleep.
+ */
+
+#define _GNU_SOURCE
+
+#include "hl_internal.h"
+#include <errno.h>
+#include <sched.h>
+
+/**
+ * @brief Allocate a ring of at least @p min_capacity cells
+ *
+ * The capacity is rounded up to a power of two, at least two.
+ */
+bool hl_job_queue_init(hl_job_queue_t* queue, size_t min_capacity) {
+    size_t capacity = 2;
+    while (capacity < min_capacity) {
+        capacity <<= 1;
+    }
+
+    queue->cells = calloc(capacity, sizeof(hl_job_queue_cell_t));
+    if (!queue->cells) return false;
+
+    for (size_t i = 0; i < capacity; i++) {
+        atomic_init(&queue->cells[i].sequence, i);
+    }
+    queue->mask = capacity - 1;
+    atomic_init(&queue->enqueue_pos, 0);
+    atomic_init(&queue->dequeue_pos, 0);
+    sem_init(&queue->items, 0, 0);
+    return true;
+}
+
+void hl_job_queue_free(hl_job_queue_t* queue) {
+    if (!queue->cells) return;
+
+    sem_destroy(&queue->items);
+    free(queue->cells);
+    queue->cells = NULL;
+}
+
+/**
+ * @brief Publish an item (NULL is allowed, e.g. as a stop marker)
+ *
+ * The caller sizes the queue for every item that can be in it at once,
+ * so this cannot fail.
+ */
+void hl_job_queue_push(hl_job_queue_t* queue, void* item) {
+    size_t pos = atomic_load_explicit(&queue->enqueue_pos, memory_order_relaxed);
+    hl_job_queue_cell_t* cell;
+    for (;;) {
+        cell = &queue->cells[pos & queue->mask];
+        size_t sequence = atomic_load_explicit(&cell->sequence, memory_order_acquire);
+        intptr_t diff = (intptr_t)sequence - (intptr_t)pos;
+        if (diff == 0) {
+            if (atomic_compare_exchange_weak_explicit(&queue->enqueue_pos, &pos, pos + 1,
+                                                      memory_order_relaxed,
+                                                      memory_order_relaxed)) {
+                break;
+            }
+        } else {
+            pos = atomic_load_explicit(&queue->enqueue_pos, memory_order_relaxed);
+        }
+    }
+
+    cell->item = item;
+    atomic_store_explicit(&cell->sequence, pos + 1, memory_order_release);
+    sem_post(&queue->items);
+}
+
+/**
+ * @brief Take the oldest item, sleeping while the queue is empty
+ */
+void* hl_job_queue_pop(hl_job_queue_t* queue) {
+    while (sem_wait(&queue->items) != 0 && errno == EINTR) {
+    }
+
+    // The semaphore guarantees an entry, but an earlier slot may still be
+    // between its claim and its publish
+    size_t pos = atomic_load_explicit(&queue->dequeue_pos, memory_order_relaxed);
+    hl_job_queue_cell_t* cell;
+    for (;;) {
+        cell = &queue->cells[pos & queue->mask];
+        size_t sequence = atomic_load_explicit(&cell->sequence, memory_order_acquire);
+        intptr_t diff = (intptr_t)sequence - (intptr_t)(pos + 1);
+        if (diff == 0) {
+            if (atomic_compare_exchange_weak_explicit(&queue->dequeue_pos, &pos, pos + 1,
+                                                      memory_order_relaxed,
+                                                      memory_order_relaxed)) {
+                break;
+            }
+        } else if (diff < 0) {
+            sched_yield();
+            pos = atomic_load_explicit(&queue->dequeue_pos, memory_order_relaxed);
+        } else {
+            pos = atomic_load_explicit(&queue->dequeue_pos, memory_order_relaxed);
+        }
+    }
+
+    void* item = cell->item;
+    atomic_store_explicit(&cell->sequence, pos + queue->mask + 1, memory_order_release);
+    return item;
+}
@@ -0,0 +1,502 @@
+/**
+ * @file kill_switch.c
+ * @brief Pre-signed cancel-everything action
+ *
+ * The order set is a flat array guarded by the switch mutex, with a version
+ * bumped on every change. The signing thread copies the set, signs outside
+ * the lock and installs the body only if the set did not change meanwhile;
+ * otherwise it goes around again. Firing takes the installed body out
+ * under the lock, so a nonce is never sent twice.
+ */
+
+#define _GNU_SOURCE
+
+#include "hl_kill_switch.h"
+#include "hl_internal.h"
+#include "hl_ws_client.h"
+#include "hl_crypto_internal.h"
+#include "hl_msgpack.h"
+#include "hl_mids.h"
+#include "hl_logger.h"
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <time.h>
+#include <errno.h>
+#include <pthread.h>
+#include <cjson/cJSON.h>
+
+#define KILL_SWITCH_DEFAULT_REFRESH_MS 10000
+
+// Longest {"a":...,"o":...} entry with its separator
+#define KILL_SWITCH_CANCEL_JSON 48
+
+struct hl_kill_switch {
+    hl_client_t* client;
+    const hl_signer_t* signer;
+    bool testnet;
+    uint64_t refresh_ms;
+    char subscription_id[64];
+
+    pthread_mutex_t mutex;
+    pthread_cond_t wake;
+    pthread_t worker;
+    bool worker_started;
+    bool stop;
+
+    // Orders to cancel, guarded by mutex
+    hl_cancel_t* cancels;
+    size_t count;
+    size_t capacity;
+    uint64_t version;                   /**< Incremented on every change */
+
+    // Signed action, guarded by mutex
+    char* payload;                      /**< NULL when none is stored */
+    uint64_t payload_version;           /**< Set version the payload covers */
+    uint64_t payload_nonce;
+};
+
+static uint64_t ks_now_ms(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_REALTIME, &ts);
+    return (uint64_t)ts.tv_sec * 1000 + (uint64_t)ts.tv_nsec / 1000000;
+}
+
+/**
+ * @brief Hash, sign and serialize one cancel action for a set of orders
+ *
+ * @return Heap-allocated /exchange body or NULL on error
+ */
+char* hl_kill_switch_sign_cancels(const hl_signer_t* signer, bool testnet,
+                                  const hl_cancel_t* cancels, size_t count, uint64_t nonce) {
+    uint8_t connection_id[32];
+    if (hl_build_cancel_hash(cancels, count, nonce, NULL, connection_id) != 0) {
+        HL_LOG_ERROR("Kill switch: cannot hash cancel of %zu orders", count);
+        return NULL;
+    }
+
+    uint8_t signature[65];
+    if (eip712_sign_agent_signer(signer, "Exchange", 1337, testnet ? "b" : "a",
+                                 connection_id, signature) != 0) {
+        HL_LOG_ERROR("Kill switch: cannot sign cancel of %zu orders", count);
+        return NULL;
+    }
+
+    char sig_r[67], sig_s[67];
+    bytes_to_hex(signature, 32, sig_r, true);
+    bytes_to_hex(signature + 32, 32, sig_s, true);
+
+    size_t size = 256 + count * KILL_SWITCH_CANCEL_JSON;
+    char* payload = malloc(size);
+    if (!payload) return NULL;
+
+    size_t len = (size_t)snprintf(payload, size, "{\"action\":{\"type\":\"cancel\",\"cancels\":[");
+    for (size_t i = 0; i < count; i++) {
+        len += (size_t)snprintf(payload + len, size - len, "%s{\"a\":%u,\"o\":%llu}",
+                                i ? "," : "", cancels[i].a, (unsigned long long)cancels[i].o);
+    }
+    snprintf(payload + len, size - len,
+             "]},\"nonce\":%llu,"
+             "\"signature\":{\"r\":\"%s\",\"s\":\"%s\",\"v\":%d},"
+             "\"vaultAddress\":null}",
+             (unsigned long long)nonce, sig_r, sig_s, signature[64]);
+
+    return payload;
+}
+
+/**
+ * @brief Allocate a nonce and sign a cancel action with it
+ */
+static char* ks_sign(hl_kill_switch_t* ks, const hl_cancel_t* cancels, size_t count,
+                     uint64_t* nonce_out) {
+    uint64_t nonce = hl_client_next_nonce(ks->client);
+    if (nonce == 0) return NULL;
+
+    char* payload = hl_kill_switch_sign_cancels(ks->signer, ks->testnet, cancels, count, nonce);
+    if (payload) *nonce_out = nonce;
+    return payload;
+}
+
+/**
+ * @brief Whether the stored action is missing, outdated or too old (lock held)
+ */
+static bool ks_needs_signing(const hl_kill_switch_t* ks, uint64_t now_ms) {
+    if (ks->count == 0) return false;
+    if (!ks->payload || ks->payload_version != ks->version) return true;
+    // Allocated nonces can run ahead of the clock
+    return now_ms >= ks->payload_nonce + ks->refresh_ms;
+}
+
+/**
+ * @brief Signing thread: keep the stored action current
+ */
+static void* ks_signing_thread(void* arg) {
+    hl_kill_switch_t* ks = (hl_kill_switch_t*)arg;
+    hl_cancel_t* snapshot = NULL;
+    size_t snapshot_capacity = 0;
+
+    pthread_mutex_lock(&ks->mutex);
+    while (!ks->stop) {
+        uint64_t now = ks_now_ms();
+        if (!ks_needs_signing(ks, now)) {
+            if (ks->payload) {
+                uint64_t deadline_ms = ks->payload_nonce + ks->refresh_ms;
+                struct timespec deadline = {
+                    .tv_sec = (time_t)(deadline_ms / 1000),
+                    .tv_nsec = (long)(deadline_ms % 1000) * 1000000L
+                };
+                pthread_cond_timedwait(&ks->wake, &ks->mutex, &deadline);
+            } else {
+                pthread_cond_wait(&ks->wake, &ks->mutex);
+            }
+            continue;
+        }
+
+        if (snapshot_capacity < ks->count) {
+            hl_cancel_t* grown = realloc(snapshot, ks->capacity * sizeof(hl_cancel_t));
+            if (!grown) {
+                HL_LOG_ERROR("Kill switch: out of memory for %zu orders", ks->count);
+                break;
+            }
+            snapshot = grown;
+            snapshot_capacity = ks->capacity;
+        }
+        size_t count = ks->count;
+        uint64_t version = ks->version;
+        memcpy(snapshot, ks->cancels, count * sizeof(hl_cancel_t));
+        pthread_mutex_unlock(&ks->mutex);
+
+        uint64_t nonce = 0;
+        char* payload = ks_sign(ks, snapshot, count, &nonce);
+
+        pthread_mutex_lock(&ks->mutex);
+        if (!payload) {
+            // Retry once the set changes or the old action ages out
+            struct timespec deadline;
+            clock_gettime(CLOCK_REALTIME, &deadline);
+            deadline.tv_sec += 1;
+            while (!ks->stop && ks->version == version &&
+                   pthread_cond_timedwait(&ks->wake, &ks->mutex, &deadline) != ETIMEDOUT) {
+            }
+            continue;
+        }
+        if (ks->version != version) {
+            // The set moved on while signing; this action would miss orders
+            free(payload);
+            continue;
+        }
+        free(ks->payload);
+        ks->payload = payload;
+        ks->payload_version = version;
+        ks->payload_nonce = nonce;
+    }
+    pthread_mutex_unlock(&ks->mutex);
+
+    free(snapshot);
+    return NULL;
+}
+
+/**
+ * @brief Record a change to the set and wake the signing thread (lock held)
+ */
+static void ks_changed(hl_kill_switch_t* ks) {
+    ks->version++;
+    pthread_cond_signal(&ks->wake);
+}
+
+/**
+ * @brief Position of an order in the set (lock held)
+ */
+static size_t ks_find(const hl_kill_switch_t* ks, uint64_t oid) {
+    for (size_t i = 0; i < ks->count; i++) {
+        if (ks->cancels[i].o == oid) return i;
+    }
+    return ks->count;
+}
+
+/**
+ * @brief Add an order to the set
+ */
+hl_error_t hl_kill_switch_add(hl_kill_switch_t* ks, uint32_t asset_id, uint64_t oid) {
+    if (!ks) return HL_ERROR_INVALID_PARAMS;
+
+    pthread_mutex_lock(&ks->mutex);
+    if (ks_find(ks, oid) < ks->count) {
+        pthread_mutex_unlock(&ks->mutex);
+        return HL_SUCCESS;
+    }
+    if (ks->count == ks->capacity) {
+        size_t capacity = ks->capacity ? 2 * ks->capacity : 16;
+        hl_cancel_t* grown = realloc(ks->cancels, capacity * sizeof(hl_cancel_t));
+        if (!grown) {
+            pthread_mutex_unlock(&ks->mutex);
+            return HL_ERROR_MEMORY;
+        }
+        ks->cancels = grown;
+        ks->capacity = capacity;
+    }
+    ks->cancels[ks->count].a = asset_id;
+    ks->cancels[ks->count].o = oid;
+    ks->count++;
+    ks_changed(ks);
+    pthread_mutex_unlock(&ks->mutex);
+
+    return HL_SUCCESS;
+}
+
+/**
+ * @brief Remove an order from the set
+ */
+bool hl_kill_switch_remove(hl_kill_switch_t* ks, uint64_t oid) {
+    if (!ks) return false;
+
+    pthread_mutex_lock(&ks->mutex);
+    size_t pos = ks_find(ks, oid);
+    bool found = pos < ks->count;
+    if (found) {
+        ks->cancels[pos] = ks->cancels[--ks->count];
+        ks_changed(ks);
+    }
+    pthread_mutex_unlock(&ks->mutex);
+
+    return found;
+}
+
+/**
+ * @brief orderUpdates callback: follow the account's resting orders
+ *
+ * "open" and "triggered" orders rest on the book; every other status
+ * (filled, canceled, rejected, marginCanceled, ...) is terminal.
+ */
+static void ks_on_orders(void* data, void* user_data) {
+    const hl_ws_message_t* msg = (const hl_ws_message_t*)data;
+    hl_kill_switch_t* ks = (hl_kill_switch_t*)user_data;
+    const cJSON* updates = (const cJSON*)msg->json;
+    if (!cJSON_IsArray(updates)) return;
+
+    hl_mids_table_t* mids = hl_client_mids(ks->client);
+
+    const cJSON* update = NULL;
+    cJSON_ArrayForEach(update, updates) {
+        const cJSON* order = cJSON_GetObjectItem(update, "order");
+        const cJSON* status = cJSON_GetObjectItem(update, "status");
+        const cJSON* coin = cJSON_GetObjectItem(order, "coin");
+        const cJSON* oid = cJSON_GetObjectItem(order, "oid");
+        if (!cJSON_IsString(status) || !cJSON_IsString(coin) || !cJSON_IsNumber(oid)) continue;
+
+        uint64_t order_id = (uint64_t)oid->valuedouble;
+        if (strcmp(status->valuestring, "open") != 0 &&
+            strcmp(status->valuestring, "triggered") != 0) {
+            hl_kill_switch_remove(ks, order_id);
+            continue;
+        }
+
+        uint32_t asset_id = 0;
+        if (!mids || !hl_mids_table_lookup(mids, coin->valuestring, &asset_id)) {
+            HL_LOG_WARN("Kill switch: unknown coin %s, order %llu not covered",
+                        coin->valuestring, (unsigned long long)order_id);
+            continue;
+        }
+        hl_kill_switch_add(ks, asset_id, order_id);
+    }
+}
+
+/**
+ * @brief Add the account's current open orders to the set
+ */
+static hl_error_t ks_seed(hl_kill_switch_t* ks) {
+    hl_mids_table_t* mids = hl_client_mids(ks->client);
+    if (!mids) return HL_ERROR_INVALID_PARAMS;
+
+    hl_orders_t orders = {0};
+    hl_error_t err = hl_fetch_open_orders(ks->client, NULL, NULL, 0, &orders);
+    if (err != HL_SUCCESS) return err;
+
+    for (size_t i = 0; i < orders.count && err == HL_SUCCESS; i++) {
+        char coin[32];
+        uint32_t asset_id = 0;
+        hl_symbol_to_coin(orders.orders[i].symbol, coin, sizeof(coin));
+        if (!hl_mids_table_lookup(mids, coin, &asset_id)) {
+            HL_LOG_WARN("Kill switch: unknown coin %s, order %s not covered",
+                        coin, orders.orders[i].id);
+            continue;
+        }
+        err = hl_kill_switch_add(ks, asset_id, strtoull(orders.orders[i].id, NULL, 10));
+    }
+
+    hl_free_orders(&orders);
+    return err;
+}
+
+/**
+ * @brief Create a kill switch
+ */
+hl_kill_switch_t* hl_kill_switch_create(hl_client_t* client, uint32_t refresh_ms,
+                                        bool track_orders) {
+    if (!client) return NULL;
+
+    const hl_signer_t* signer = hl_client_get_signer(client);
+    if (!signer) return NULL;
+
+    hl_kill_switch_t* ks = calloc(1, sizeof(hl_kill_switch_t));
+    if (!ks) return NULL;
+
+    ks->client = client;
+    ks->signer = signer;
+    ks->testnet = hl_client_is_testnet_old(client);
+    ks->refresh_ms = refresh_ms ? refresh_ms : KILL_SWITCH_DEFAULT_REFRESH_MS;
+    pthread_mutex_init(&ks->mutex, NULL);
+    pthread_cond_init(&ks->wake, NULL);
+
+    if (pthread_create(&ks->worker, NULL, ks_signing_thread, ks) != 0) {
+        hl_kill_switch_destroy(ks);
+        return NULL;
+    }
+    ks->worker_started = true;
+
+    if (track_orders) {
+        // Subscribe before seeding so no order placed in between is missed
+        const char* subscription_id = hl_watch_orders(client, NULL, ks_on_orders, ks);
+        if (!subscription_id) {
+            hl_kill_switch_destroy(ks);
+            return NULL;
+        }
+        lv3_string_copy(ks->subscription_id, subscription_id, sizeof(ks->subscription_id));
+
+        hl_error_t err = ks_seed(ks);
+        if (err != HL_SUCCESS) {
+            HL_LOG_ERROR("Kill switch: cannot fetch open orders (error %d)", err);
+            hl_kill_switch_destroy(ks);
+            return NULL;
+        }
+    }
+
+    return ks;
+}
+
+/**
+ * @brief Unsubscribe, stop the signing thread and free the switch
+ */
+void hl_kill_switch_destroy(hl_kill_switch_t* ks) {
+    if (!ks) return;
+
+    // No stream callback runs once hl_unwatch() has returned
+    if (ks->subscription_id[0]) {
+        hl_unwatch(ks->client, ks->subscription_id);
+    }
+
+    if (ks->worker_started) {
+        pthread_mutex_lock(&ks->mutex);
+        ks->stop = true;
+        pthread_cond_signal(&ks->wake);
+        pthread_mutex_unlock(&ks->mutex);
+        pthread_join(ks->worker, NULL);
+    }
+
+    pthread_cond_destroy(&ks->wake);
+    pthread_mutex_destroy(&ks->mutex);
+    free(ks->payload);
+    free(ks->cancels);
+    free(ks);
+}
+
+/**
+ * @brief Number of orders the switch would cancel
+ */
+size_t hl_kill_switch_count(hl_kill_switch_t* ks) {
+    if (!ks) return 0;
+
+    pthread_mutex_lock(&ks->mutex);
+    size_t count = ks->count;
+    pthread_mutex_unlock(&ks->mutex);
+    return count;
+}
+
+/**
+ * @brief Check that the stored action covers the current set of orders
+ */
+bool hl_kill_switch_is_armed(hl_kill_switch_t* ks) {
+    if (!ks) return false;
+
+    pthread_mutex_lock(&ks->mutex);
+    bool armed = ks->count == 0 || (ks->payload && ks->payload_version == ks->version);
+    pthread_mutex_unlock(&ks->mutex);
+    return armed;
+}
+
+/**
+ * @brief Log cancel failures reported on the post channel
+ */
+static void ks_on_response(uint64_t request_id, hl_error_t status, const char* response,
+                           void* user_data) {
+    (void)user_data;
+    if (status != HL_SUCCESS || !response || !strstr(response, "\"status\":\"ok\"")) {
+        HL_LOG_WARN("Kill switch: cancel request %llu failed: %s",
+                    (unsigned long long)request_id, response ? response : "no response");
+    }
+}
+
+/**
+ * @brief POST a signed action to /exchange
+ */
+static hl_error_t ks_post_http(hl_kill_switch_t* ks, const char* payload) {
+    http_client_t* http = hl_client_get_http_old(ks->client);
+    pthread_mutex_t* mutex = hl_client_get_mutex_old(ks->client);
+    if (!http || !mutex) return HL_ERROR_INVALID_PARAMS;
+
+    const char* url = ks->testnet ? "https://api.hyperliquid-testnet.xyz/exchange"
+                                  : "https://api.hyperliquid.xyz/exchange";
+    http_response_t response = {0};
+
+    pthread_mutex_lock(mutex);
+    lv3_error_t err = http_client_post(http, url, payload, "Content-Type: application/json",
+                                       &response);
+    pthread_mutex_unlock(mutex);
+
+    hl_error_t result = HL_SUCCESS;
+    if (err != LV3_SUCCESS || response.status_code != 200) {
+        HL_LOG_ERROR("Kill switch: /exchange request failed (HTTP %d)", response.status_code);
+        result = HL_ERROR_NETWORK;
+    } else if (!response.body || !strstr(response.body, "\"status\":\"ok\"")) {
+        HL_LOG_ERROR("Kill switch: cancel rejected: %s",
+                     response.body ? response.body : "empty response");
+        result = HL_ERROR_API;
+    }
+    http_response_free(&response);
+    return result;
+}
+
+/**
+ * @brief Cancel every order in the set
+ */
+hl_error_t hl_kill_switch_fire(hl_kill_switch_t* ks) {
+    if (!ks) return HL_ERROR_INVALID_PARAMS;
+
+    // Take the stored action: its nonce is spent once it is sent
+    pthread_mutex_lock(&ks->mutex);
+    char* payload = NULL;
+    size_t count = ks->count;
+    if (ks->payload && ks->payload_version == ks->version) {
+        payload = ks->payload;
+        ks->payload = NULL;
+        pthread_cond_signal(&ks->wake);
+    } else if (count > 0) {
+        HL_LOG_WARN("Kill switch fired before %zu orders were signed, signing now", count);
+        uint64_t nonce = 0;
+        payload = ks_sign(ks, ks->cancels, count, &nonce);
+        if (!payload) {
+            pthread_mutex_unlock(&ks->mutex);
+            return HL_ERROR_SIGNATURE;
+        }
+    }
+    pthread_mutex_unlock(&ks->mutex);
+
+    if (!payload) return HL_SUCCESS;
+
+    hl_error_t err = hl_ws_post(ks->client, "action", payload, ks_on_response, NULL, NULL);
+    if (err != HL_SUCCESS) {
+        err = ks_post_http(ks, payload);
+    }
+    free(payload);
+    return err;
+}
@@ -5,122 +5,165 @@
 
 #include "hyperliquid.h"
 #include "hl_internal.h"
+#include "hl_crypto_internal.h"
+#include "hl_msgpack.h"
+#include "hl_mids.h"
 #include <stdlib.h>
 #include <string.h>
 #include <stdio.h>
 
 /**
- * @brief Set leverage for symbol
+ * @brief Resolve a perp symbol or coin to its asset ID
+ *
+ * Looks the coin up in the client's mid table. On a miss the market
+ * registry is (re)loaded, which binds the table again, and the lookup is
+ * retried once. Spot assets are refused: leverage and isolated margin
+ * apply to perps only.
  */
-hl_error_t hl_set_leverage(hl_client_t* client,
-                          int leverage,
-                          const char* symbol) {
-    if (!client || leverage < 1 || leverage > 50) {
-        return HL_ERROR_INVALID_PARAMS;
+bool hl_resolve_perp_asset(hl_client_t* client, const char* symbol, uint32_t* asset_id) {
+    hl_mids_table_t* mids = hl_client_mids(client);
+    if (!mids) return false;
+
+    char coin[32];
+    hl_symbol_to_coin(symbol, coin, sizeof(coin));
+
+    bool found = hl_mids_table_lookup(mids, coin, asset_id);
+    if (!found && hl_client_load_markets(client) == HL_SUCCESS) {
+        found = hl_mids_table_lookup(mids, coin, asset_id);
     }
+    return found && *asset_id < HL_MIDS_SPOT_BASE;
+}
 
-    // Prepare request
-    char request_body[2048];
-    const char* wallet_address = hl_client_get_wallet_address_old(client);
-    const char* private_key = hl_client_get_private_key_old(client);
+/**
+ * @brief Sign an L1 action hash with the client's signer and POST it
+ */
+hl_error_t hl_post_l1_action(hl_client_t* client, const char* action_json,
+                             const uint8_t connection_id[32], uint64_t nonce) {
+    const hl_signer_t* signer = hl_client_get_signer(client);
     bool testnet = hl_client_is_testnet_old(client);
+    http_client_t* http = hl_client_get_http_old(client);
+    pthread_mutex_t* mutex = hl_client_get_mutex_old(client);
 
-    if (!wallet_address || !private_key) {
+    if (!signer) {
         return HL_ERROR_AUTH;
     }
-
-    // Get asset ID if symbol is specified
-    uint32_t asset_id = 0;
-    if (symbol) {
-        // Extract coin name from symbol (e.g., "BTC/USDC:USDC" -> "BTC")
-        char coin[32] = {0};
-        const char* separator = strchr(symbol, '/');
-        if (separator) {
-            size_t coin_len = separator - symbol;
-            if (coin_len < sizeof(coin)) {
-                memcpy(coin, symbol, coin_len);
-            }
-        } else {
-            // Assume symbol is just the coin name
-            strncpy(coin, symbol, sizeof(coin) - 1);
-        }
-
-        // Get asset ID from coin name
-        // For simplicity, use a basic mapping (in production, this would query the API)
-        if (strcmp(coin, "BTC") == 0) asset_id = 1;
-        else if (strcmp(coin, "ETH") == 0) asset_id = 2;
-        else if (strcmp(coin, "SOL") == 0) asset_id = 3;
-        else if (strcmp(coin, "USDC") == 0) asset_id = 0;
-        else {
-            // Try to get from markets (simplified approach)
-            hl_markets_t markets = {0};
-            if (hl_fetch_markets(client, &markets) == HL_SUCCESS) {
-                for (size_t i = 0; i < markets.count; i++) {
-                    if (strcmp(markets.markets[i].base, coin) == 0) {
-                        asset_id = markets.markets[i].asset_id;
-                        break;
-                    }
-                }
-                hl_markets_free(&markets);
-            }
-        }
+    if (!http || !mutex) {
+        return HL_ERROR_INVALID_PARAMS;
     }
 
-    // Create leverage action
-    char action_json[1024];
-    if (symbol && asset_id > 0) {
-        // Set leverage for specific asset
-        snprintf(action_json, sizeof(action_json),
-                 "[{\"type\":\"updateLeverage\",\"leverage\":%d,\"asset\":%u}]",
-                 leverage, asset_id);
-    } else {
-        // Set default leverage
-        snprintf(action_json, sizeof(action_json),
-                 "[{\"type\":\"updateLeverage\",\"leverage\":%d}]",
-                 leverage);
+    // L1 actions are signed as an agent over the msgpack hash
+    uint8_t signature[65];
+    const char* source = testnet ? "b" : "a";
+    if (eip712_sign_agent_signer(signer, "Exchange", 1337, source, connection_id, signature) != 0) {
+        return HL_ERROR_SIGNATURE;
     }
 
-    // Build exchange request
-    unsigned long long nonce = get_timestamp_ms();
-    char exchange_request[1536];
-    snprintf(exchange_request, sizeof(exchange_request),
-             "{\"action\":{\"type\":\"batchModify\",\"modifies\":%s},\"nonce\":%llu}",
-             action_json, nonce);
+    char sig_r[67], sig_s[67];
+    bytes_to_hex(signature, 32, sig_r, true);
+    bytes_to_hex(signature + 32, 32, sig_s, true);
 
-    // Create EIP-712 signature
-    char signature[132] = {0};
-    if (hl_build_exchange_signature(exchange_request, private_key, signature, sizeof(signature)) != HL_SUCCESS) {
-        return HL_ERROR_SIGNATURE;
+    // Build request
+    char request_body[1024];
+    int body_len = snprintf(request_body, sizeof(request_body),
+             "{\"action\":%s,"
+             "\"nonce\":%llu,"
+             "\"signature\":{\"r\":\"%s\",\"s\":\"%s\",\"v\":%d},"
+             "\"vaultAddress\":null}",
+             action_json, (unsigned long long)nonce, sig_r, sig_s, signature[64]);
+    if (body_len < 0 || (size_t)body_len >= sizeof(request_body)) {
+        return HL_ERROR_INVALID_PARAMS;
     }
 
-    // Build final request with signature
-    snprintf(request_body, sizeof(request_body),
-             "%s,\"signature\":\"%s\"}", exchange_request, signature);
+    const char* base_url = testnet ? "https://api.hyperliquid-testnet.xyz" : "https://api.hyperliquid.xyz";
+    char url[256];
+    snprintf(url, sizeof(url), "%s/exchange", base_url);
 
-    // Make request
-    http_response_t* response = NULL;
-    lv3_error_t err = http_client_post_old(client, "/exchange", request_body, NULL, &response);
+    // Make request; the HTTP handle is shared with the rest of the client
+    http_response_t response = {0};
+    pthread_mutex_lock(mutex);
+    lv3_error_t err = http_client_post(http, url, request_body, "Content-Type: application/json", &response);
+    pthread_mutex_unlock(mutex);
 
-    if (err != LV3_SUCCESS || !response) {
-        if (response) {
-            http_response_free(response);
-        }
+    if (err != LV3_SUCCESS) {
+        http_response_free(&response);
         return HL_ERROR_NETWORK;
     }
 
     // Check response
     hl_error_t result = HL_SUCCESS;
-    if (response->status_code != 200) {
+    if (response.status_code != 200) {
         // Parse error response
-        if (strstr(response->body, "error")) {
+        if (response.body && strstr(response.body, "error")) {
             result = HL_ERROR_API;
         } else {
             result = HL_ERROR_NETWORK;
         }
-    } else if (strstr(response->body, "\"status\":\"ok\"") == NULL) {
+    } else if (!response.body || strstr(response.body, "\"status\":\"ok\"") == NULL) {
         result = HL_ERROR_API;
     }
 
-    http_response_free(response);
+    http_response_free(&response);
     return result;
 }
+
+/**
+ * @brief Sign and send an updateLeverage action
+ */
+static hl_error_t update_leverage(hl_client_t* client, const char* symbol, int leverage,
+                                  bool is_cross) {
+    if (!client || !symbol || leverage < 1 || leverage > 50) {
+        return HL_ERROR_INVALID_PARAMS;
+    }
+    if (!hl_client_get_signer(client)) {
+        return HL_ERROR_AUTH;
+    }
+
+    uint32_t asset_id = 0;
+    if (!hl_resolve_perp_asset(client, symbol, &asset_id)) {
+        return HL_ERROR_INVALID_SYMBOL;
+    }
+
+    hl_update_leverage_t update = {
+        .asset = asset_id,
+        .is_cross = is_cross,
+        .leverage = (uint32_t)leverage
+    };
+    uint64_t nonce = hl_client_next_nonce(client);
+    if (nonce == 0) {
+        return HL_ERROR_SIGNATURE;
+    }
+
+    uint8_t connection_id[32];
+    if (hl_build_update_leverage_hash(&update, nonce, NULL, connection_id) != 0) {
+        return HL_ERROR_SIGNATURE;
+    }
+
+    char action_json[128];
+    snprintf(action_json, sizeof(action_json),
+             "{\"type\":\"updateLeverage\",\"asset\":%u,\"isCross\":%s,\"leverage\":%d}",
+             asset_id, is_cross ? "true" : "false", leverage);
+
+    return hl_post_l1_action(client, action_json, connection_id, nonce);
+}
+
+/**
+ * @brief Set leverage for symbol (cross margin)
+ */
+hl_error_t hl_set_leverage(hl_client_t* client,
+                          int leverage,
+                          const char* symbol) {
+    return update_leverage(client, symbol, leverage, true);
+}
+
+/**
+ * @brief Set margin mode and leverage for symbol
+ */
+hl_error_t hl_set_margin_mode(hl_client_t* client,
+                             const char* symbol,
+                             hl_margin_mode_t mode,
+                             int leverage) {
+    if (mode != HL_MARGIN_CROSS && mode != HL_MARGIN_ISOLATED) {
+        return HL_ERROR_INVALID_PARAMS;
+    }
+    return update_leverage(client, symbol, leverage, mode == HL_MARGIN_CROSS);
+}
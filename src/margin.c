@@ -5,108 +5,67 @@
 
 #include "hyperliquid.h"
 #include "hl_internal.h"
+#include "hl_msgpack.h"
+#include <math.h>
 #include <stdlib.h>
 #include <string.h>
 #include <stdio.h>
 
 /**
- * @brief Add margin to a position
+ * @brief Sign and send an updateIsolatedMargin action
+ *
+ * @param amount USDC to add (positive) or remove (negative)
  */
-hl_error_t hl_add_margin(hl_client_t* client,
-                        const char* symbol,
-                        double amount) {
-    if (!client || !symbol || amount <= 0) {
-        return HL_ERROR_INVALID_PARAMS;
-    }
-
-    // Prepare request
-    char request_body[2048];
-    const char* wallet_address = hl_client_get_wallet_address_old(client);
-    const char* private_key = hl_client_get_private_key_old(client);
-
-    if (!wallet_address || !private_key) {
+static hl_error_t update_isolated_margin(hl_client_t* client, const char* symbol, double amount) {
+    if (!hl_client_get_signer(client)) {
         return HL_ERROR_AUTH;
     }
 
-    // Get asset ID from symbol
     uint32_t asset_id = 0;
-    char coin[32] = {0};
-    const char* separator = strchr(symbol, '/');
-    if (separator) {
-        size_t coin_len = separator - symbol;
-        if (coin_len < sizeof(coin)) {
-            memcpy(coin, symbol, coin_len);
-        }
-    } else {
-        strncpy(coin, symbol, sizeof(coin) - 1);
+    if (!hl_resolve_perp_asset(client, symbol, &asset_id)) {
+        return HL_ERROR_INVALID_SYMBOL;
     }
 
-    // Basic asset mapping
-    if (strcmp(coin, "BTC") == 0) asset_id = 1;
-    else if (strcmp(coin, "ETH") == 0) asset_id = 2;
-    else if (strcmp(coin, "SOL") == 0) asset_id = 3;
-    else {
-        // Try to get from markets
-        hl_markets_t markets = {0};
-        if (hl_fetch_markets(client, &markets) == HL_SUCCESS) {
-            for (size_t i = 0; i < markets.count; i++) {
-                if (strcmp(markets.markets[i].base, coin) == 0) {
-                    asset_id = markets.markets[i].asset_id;
-                    break;
-                }
-            }
-            hl_markets_free(&markets);
-        }
+    // Margin travels as an integer number of micro-USDC. The exchange
+    // applies it to the open position whichever side it is on.
+    hl_update_isolated_margin_t update = {
+        .asset = asset_id,
+        .is_buy = true,
+        .ntli = (int64_t)llround(amount * 1e6)
+    };
+    if (update.ntli == 0) {
+        return HL_ERROR_INVALID_PARAMS;
     }
 
-    if (asset_id == 0) {
-        return HL_ERROR_INVALID_PARAMS; // Asset not found
+    uint64_t nonce = hl_client_next_nonce(client);
+    if (nonce == 0) {
+        return HL_ERROR_SIGNATURE;
     }
 
-    // Create margin action
-    char action_json[256];
-    snprintf(action_json, sizeof(action_json),
-             "[{\"type\":\"updateMargin\",\"asset\":%u,\"margin\":%.8f}]",
-             asset_id, amount);
-
-    // Build exchange request
-    unsigned long long nonce = get_timestamp_ms();
-    char exchange_request[1024];
-    snprintf(exchange_request, sizeof(exchange_request),
-             "{\"action\":{\"type\":\"batchModify\",\"modifies\":%s},\"nonce\":%llu}",
-             action_json, nonce);
-
-    // Create EIP-712 signature
-    char signature[132] = {0};
-    if (hl_build_exchange_signature(exchange_request, private_key, signature, sizeof(signature)) != HL_SUCCESS) {
+    uint8_t connection_id[32];
+    if (hl_build_update_isolated_margin_hash(&update, nonce, NULL, connection_id) != 0) {
         return HL_ERROR_SIGNATURE;
     }
 
-    // Build final request with signature
-    snprintf(request_body, sizeof(request_body),
-             "%s,\"signature\":\"%s\"}", exchange_request, signature);
-
-    // Make request
-    http_response_t* response = NULL;
-    lv3_error_t err = http_client_post_old(client, "/exchange", request_body, NULL, &response);
+    char action_json[128];
+    snprintf(action_json, sizeof(action_json),
+             "{\"type\":\"updateIsolatedMargin\",\"asset\":%u,\"isBuy\":true,\"ntli\":%lld}",
+             asset_id, (long long)update.ntli);
 
-    if (err != LV3_SUCCESS || !response) {
-        if (response) {
-            http_response_free(response);
-        }
-        return HL_ERROR_NETWORK;
-    }
+    return hl_post_l1_action(client, action_json, connection_id, nonce);
+}
 
-    // Check response
-    hl_error_t result = HL_SUCCESS;
-    if (response->status_code != 200) {
-        result = HL_ERROR_API;
-    } else if (strstr(response->body, "\"status\":\"ok\"") == NULL) {
-        result = HL_ERROR_API;
+/**
+ * @brief Add margin to a position
+ */
+hl_error_t hl_add_margin(hl_client_t* client,
+                        const char* symbol,
+                        double amount) {
+    if (!client || !symbol || !(amount > 0)) {
+        return HL_ERROR_INVALID_PARAMS;
     }
 
-    http_response_free(response);
-    return result;
+    return update_isolated_margin(client, symbol, amount);
 }
 
 /**
@@ -115,10 +74,10 @@ hl_error_t hl_add_margin(hl_client_t* client,
 hl_error_t hl_reduce_margin(hl_client_t* client,
                            const char* symbol,
                            double amount) {
-    if (!client || !symbol || amount <= 0) {
+    if (!client || !symbol || !(amount > 0)) {
         return HL_ERROR_INVALID_PARAMS;
     }
 
     // For reduce margin, we use negative amount
-    return hl_add_margin(client, symbol, -amount);
+    return update_isolated_margin(client, symbol, -amount);
 }
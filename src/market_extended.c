@@ -5,9 +5,14 @@
 
 #include "hyperliquid.h"
 #include "hl_internal.h"
+#include "hl_mids.h"
 #include <stdlib.h>
 #include <string.h>
 #include <stdio.h>
+#include <cjson/cJSON.h>
+
+// Internal client accessor (from client.c)
+extern void* hl_client_get_http(hl_client_t* client);
 
 /**
  * @brief Fetch multiple tickers
@@ -34,58 +39,78 @@ hl_error_t hl_fetch_tickers(hl_client_t* client,
     }
 
     // Make request
-    http_response_t* response = NULL;
-    lv3_error_t err = http_client_post_old(client, "/info", request_body, NULL, &response);
+    http_client_t* http = (http_client_t*)hl_client_get_http(client);
+    if (!http) {
+        return HL_ERROR_INVALID_PARAMS;
+    }
 
-    if (err != LV3_SUCCESS || !response || response->status_code != 200) {
-        if (response) {
-            http_response_free(response);
-        }
+    char url[256];
+    snprintf(url, sizeof(url), "%s/info",
+             hl_client_is_testnet(client) ? "https://api.hyperliquid-testnet.xyz"
+                                          : "https://api.hyperliquid.xyz");
+
+    http_response_t response = {0};
+    lv3_error_t err = http_client_post(http, url, request_body, "Content-Type: application/json", &response);
+
+    if (err != LV3_SUCCESS || response.status_code != 200) {
+        http_response_free(&response);
         return HL_ERROR_NETWORK;
     }
 
     // Parse JSON response
-    cJSON* json = cJSON_Parse(response->body);
+    cJSON* json = cJSON_Parse(response.body);
+    http_response_free(&response);
     if (!json) {
-        http_response_free(response);
         return HL_ERROR_JSON;
     }
 
-    // Response is an array of [coin, mid_price] pairs
-    if (!cJSON_IsArray(json)) {
+    // Response is an object {"BTC":"65000.5",...}; older gateways sent [coin, mid] pairs
+    bool is_object = cJSON_IsObject(json);
+    if (!is_object && !cJSON_IsArray(json)) {
         cJSON_Delete(json);
-        http_response_free(response);
         return HL_ERROR_JSON;
     }
 
+    // Refresh the shared table so other threads can read these mids lock-free
+    if (is_object && client->mids) {
+        hl_mids_table_apply_json(client->mids, json, 0);
+    }
+
     int array_size = cJSON_GetArraySize(json);
     if (array_size == 0) {
         cJSON_Delete(json);
-        http_response_free(response);
         return HL_SUCCESS;
     }
 
     // Allocate tickers array
-    size_t max_tickers = (symbols_count > 0) ? symbols_count : array_size;
+    size_t max_tickers = (symbols_count > 0) ? symbols_count : (size_t)array_size;
     tickers->tickers = calloc(max_tickers, sizeof(hl_ticker_t));
     if (!tickers->tickers) {
         cJSON_Delete(json);
-        http_response_free(response);
         return HL_ERROR_MEMORY;
     }
 
     // Parse tickers
     size_t valid_tickers = 0;
-    for (int i = 0; i < array_size && valid_tickers < max_tickers; i++) {
-        cJSON* item = cJSON_GetArrayItem(json, i);
-        if (!cJSON_IsArray(item) || cJSON_GetArraySize(item) != 2) {
-            continue;
+    cJSON* item = NULL;
+    cJSON_ArrayForEach(item, json) {
+        if (valid_tickers >= max_tickers) break;
+
+        const char* coin;
+        cJSON* mid_price;
+        if (is_object) {
+            coin = item->string;
+            mid_price = item;
+        } else {
+            if (!cJSON_IsArray(item) || cJSON_GetArraySize(item) != 2) {
+                continue;
+            }
+            cJSON* coin_item = cJSON_GetArrayItem(item, 0);
+            coin = cJSON_IsString(coin_item) ? coin_item->valuestring : NULL;
+            mid_price = cJSON_GetArrayItem(item, 1);
         }
 
-        cJSON* coin = cJSON_GetArrayItem(item, 0);
-        cJSON* mid_price = cJSON_GetArrayItem(item, 1);
-
-        if (!coin || !cJSON_IsString(coin) || !mid_price) {
+        if (!coin || !mid_price) {
             continue;
         }
 
@@ -93,7 +118,7 @@ hl_error_t hl_fetch_tickers(hl_client_t* client,
         bool want_symbol = (symbols_count == 0);
         if (!want_symbol && symbols) {
             for (size_t j = 0; j < symbols_count; j++) {
-                if (symbols[j] && strcmp(symbols[j], coin->valuestring) == 0) {
+                if (symbols[j] && strcmp(symbols[j], coin) == 0) {
                     want_symbol = true;
                     break;
                 }
@@ -106,7 +131,7 @@ hl_error_t hl_fetch_tickers(hl_client_t* client,
         hl_ticker_t* ticker = &tickers->tickers[valid_tickers];
 
         // Set symbol
-        snprintf(ticker->symbol, sizeof(ticker->symbol), "%s/USDC:USDC", coin->valuestring);
+        snprintf(ticker->symbol, sizeof(ticker->symbol), "%s/USDC:USDC", coin);
 
         // Set last price (mid)
         if (cJSON_IsString(mid_price)) {
@@ -130,7 +155,6 @@ hl_error_t hl_fetch_tickers(hl_client_t* client,
     tickers->count = valid_tickers;
 
     cJSON_Delete(json);
-    http_response_free(response);
 
     return HL_SUCCESS;
 }
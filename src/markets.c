@@ -5,6 +5,7 @@
 
 #include "hyperliquid.h"
 #include "hl_http.h"
+#include "hl_internal.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -25,6 +26,41 @@ static const char* get_base_url(hl_client_t* client) {
         "https://api.hyperliquid.xyz";
 }
 
+/**
+ * @brief Read one numeric context field (string or number)
+ */
+static bool ctx_number(const cJSON* ctx, const char* key, double* out) {
+    const cJSON* item = cJSON_GetObjectItem(ctx, key);
+    if (cJSON_IsString(item)) {
+        *out = atof(item->valuestring);
+        return true;
+    }
+    if (cJSON_IsNumber(item)) {
+        *out = item->valuedouble;
+        return true;
+    }
+    return false;
+}
+
+/**
+ * @brief Update dynamic market fields from an asset context object
+ *
+ * Shared by metaAndAssetCtxs parsing and the activeAssetCtx stream; fields
+ * missing from the context keep their previous value.
+ */
+void hl_market_apply_ctx(hl_market_t* market, const cJSON* ctx) {
+    if (!market || !cJSON_IsObject(ctx)) return;
+
+    ctx_number(ctx, "markPx", &market->mark_price);
+    ctx_number(ctx, "oraclePx", &market->oracle_price);
+    ctx_number(ctx, "midPx", &market->mid_price);
+    ctx_number(ctx, "funding", &market->funding_rate);
+    ctx_number(ctx, "premium", &market->premium);
+    ctx_number(ctx, "prevDayPx", &market->prev_day_price);
+    ctx_number(ctx, "dayNtlVlm", &market->day_volume);
+    ctx_number(ctx, "openInterest", &market->open_interest);
+}
+
 /**
  * @brief Parse single swap market from JSON
  */
@@ -75,38 +111,7 @@ hl_error_t parse_swap_market(cJSON* universe_item, cJSON* context_item, int base
     market->min_cost = 10.0; // Default minimum cost
 
     // Parse context data (dynamic info)
-    cJSON* mark_px = cJSON_GetObjectItem(context_item, "markPx");
-    cJSON* oracle_px = cJSON_GetObjectItem(context_item, "oraclePx");
-    cJSON* funding = cJSON_GetObjectItem(context_item, "funding");
-    cJSON* day_ntl_vlm = cJSON_GetObjectItem(context_item, "dayNtlVlm");
-    cJSON* open_interest = cJSON_GetObjectItem(context_item, "openInterest");
-
-    // Set prices
-    if (mark_px) {
-        market->mark_price = cJSON_IsString(mark_px) ?
-            atof(mark_px->valuestring) : mark_px->valuedouble;
-    }
-
-    if (oracle_px) {
-        market->oracle_price = cJSON_IsString(oracle_px) ?
-            atof(oracle_px->valuestring) : oracle_px->valuedouble;
-    }
-
-    if (funding) {
-        market->funding_rate = cJSON_IsString(funding) ?
-            atof(funding->valuestring) : funding->valuedouble;
-    }
-
-    // Set volumes
-    if (day_ntl_vlm) {
-        market->day_volume = cJSON_IsString(day_ntl_vlm) ?
-            atof(day_ntl_vlm->valuestring) : day_ntl_vlm->valuedouble;
-    }
-
-    if (open_interest) {
-        market->open_interest = cJSON_IsString(open_interest) ?
-            atof(open_interest->valuestring) : open_interest->valuedouble;
-    }
+    hl_market_apply_ctx(market, context_item);
 
     return HL_SUCCESS;
 }
@@ -0,0 +1,295 @@
+/**
+ * @file mids.c
+ * @brief Shared mid-price table
+ *
+ * Each entry carries a sequence counter that is odd while a write is in
+ * progress. Readers retry until they see the same even value before and
+ * after copying the entry, so a reading never mixes two updates. Coin keys
+ * are resolved through an insert-only open-addressing index whose slots are
+ * published with release stores, which keeps lookups lock-free as well.
+ */
+
+#define _GNU_SOURCE
+
+#include "hl_mids.h"
+#include "hl_markets.h"
+#include "hl_internal.h"
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <time.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <cjson/cJSON.h>
+
+#define MIDS_SLOTS (HL_MIDS_PERP_CAPACITY + HL_MIDS_SPOT_CAPACITY)
+#define MIDS_INDEX_SIZE 4096            /**< Power of two, > 2 * MIDS_SLOTS */
+#define MIDS_COIN_LEN 24
+
+// One price, 32 bytes so two share a cache line
+typedef struct {
+    atomic_uint_least64_t seq;          /**< Odd while being written */
+    atomic_uint_least64_t mid_bits;     /**< IEEE-754 bits of the mid */
+    atomic_int_least64_t update_ns;
+    atomic_uint_least64_t updates;
+} mids_entry_t;
+
+// Coin key -> asset ID
+typedef struct {
+    char coin[MIDS_COIN_LEN];
+    atomic_uint_least32_t asset_plus1;  /**< 0 = empty, published last */
+} mids_key_t;
+
+struct hl_mids_table {
+    mids_entry_t entries[MIDS_SLOTS];
+    mids_key_t index[MIDS_INDEX_SIZE];
+    atomic_uint_least64_t version;
+    pthread_mutex_t write_mutex;        /**< Serializes writers; readers never take it */
+};
+
+/**
+ * @brief Entry slot for an asset ID, or -1 if outside the table
+ */
+static int mids_slot(uint32_t asset_id) {
+    if (asset_id < HL_MIDS_PERP_CAPACITY) {
+        return (int)asset_id;
+    }
+    if (asset_id >= HL_MIDS_SPOT_BASE && asset_id - HL_MIDS_SPOT_BASE < HL_MIDS_SPOT_CAPACITY) {
+        return HL_MIDS_PERP_CAPACITY + (int)(asset_id - HL_MIDS_SPOT_BASE);
+    }
+    return -1;
+}
+
+/**
+ * @brief FNV-1a hash of a coin key
+ */
+static uint32_t mids_hash(const char* coin) {
+    uint32_t hash = 2166136261u;
+    while (*coin) {
+        hash ^= (uint8_t)*coin++;
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+static int64_t mids_wall_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_REALTIME, &ts);
+    return (int64_t)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+/**
+ * @brief Insert or rebind a coin key (writer lock held)
+ */
+static bool mids_bind(hl_mids_table_t* table, const char* coin, uint32_t asset_id) {
+    if (!coin[0] || strlen(coin) >= MIDS_COIN_LEN || mids_slot(asset_id) < 0) return false;
+
+    uint32_t mask = MIDS_INDEX_SIZE - 1;
+    for (uint32_t i = mids_hash(coin) & mask, probes = 0; probes < MIDS_INDEX_SIZE;
+         i = (i + 1) & mask, probes++) {
+        mids_key_t* key = &table->index[i];
+        uint32_t current = atomic_load_explicit(&key->asset_plus1, memory_order_relaxed);
+        if (current == 0) {
+            // Name is written before the slot becomes visible to readers
+            memcpy(key->coin, coin, strlen(coin) + 1);
+            atomic_store_explicit(&key->asset_plus1, asset_id + 1, memory_order_release);
+            return true;
+        }
+        if (strcmp(key->coin, coin) == 0) {
+            atomic_store_explicit(&key->asset_plus1, asset_id + 1, memory_order_release);
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Write one entry (writer lock held)
+ */
+static void mids_publish(hl_mids_table_t* table, int slot, double mid, int64_t update_ns) {
+    mids_entry_t* entry = &table->entries[slot];
+    uint64_t bits;
+    memcpy(&bits, &mid, sizeof(bits));
+
+    uint64_t seq = atomic_load_explicit(&entry->seq, memory_order_relaxed);
+    atomic_store_explicit(&entry->seq, seq + 1, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+
+    atomic_store_explicit(&entry->mid_bits, bits, memory_order_relaxed);
+    atomic_store_explicit(&entry->update_ns, update_ns, memory_order_relaxed);
+    atomic_store_explicit(&entry->updates,
+                          atomic_load_explicit(&entry->updates, memory_order_relaxed) + 1,
+                          memory_order_relaxed);
+
+    atomic_store_explicit(&entry->seq, seq + 2, memory_order_release);
+}
+
+/**
+ * @brief Create an empty table
+ */
+hl_mids_table_t* hl_mids_table_create(void) {
+    hl_mids_table_t* table = calloc(1, sizeof(hl_mids_table_t));
+    if (!table) return NULL;
+
+    if (pthread_mutex_init(&table->write_mutex, NULL) != 0) {
+        free(table);
+        return NULL;
+    }
+    return table;
+}
+
+/**
+ * @brief Destroy table
+ */
+void hl_mids_table_destroy(hl_mids_table_t* table) {
+    if (!table) return;
+
+    pthread_mutex_destroy(&table->write_mutex);
+    free(table);
+}
+
+/**
+ * @brief Map allMids coin keys to asset IDs
+ */
+size_t hl_mids_table_bind_markets(hl_mids_table_t* table, const hl_markets_t* markets) {
+    if (!table || !markets || !markets->markets) return 0;
+
+    size_t bound = 0;
+    char key[MIDS_COIN_LEN];
+
+    pthread_mutex_lock(&table->write_mutex);
+    for (size_t i = 0; i < markets->count; i++) {
+        const hl_market_t* market = &markets->markets[i];
+
+        if (market->type == HL_MARKET_SWAP) {
+            bound += mids_bind(table, market->base, market->asset_id);
+        } else {
+            // Spot mids are keyed by "@<index>", except for a few legacy pair names
+            uint32_t asset_id = HL_MIDS_SPOT_BASE + market->asset_id;
+            snprintf(key, sizeof(key), "@%u", market->asset_id);
+            bound += mids_bind(table, key, asset_id);
+            mids_bind(table, market->symbol, asset_id);
+        }
+    }
+    pthread_mutex_unlock(&table->write_mutex);
+
+    return bound;
+}
+
+/**
+ * @brief Resolve an allMids coin key to an asset ID
+ */
+bool hl_mids_table_lookup(const hl_mids_table_t* table, const char* coin, uint32_t* asset_id) {
+    if (!table || !coin || !asset_id) return false;
+
+    uint32_t mask = MIDS_INDEX_SIZE - 1;
+    for (uint32_t i = mids_hash(coin) & mask, probes = 0; probes < MIDS_INDEX_SIZE;
+         i = (i + 1) & mask, probes++) {
+        const mids_key_t* key = &table->index[i];
+        uint32_t current = atomic_load_explicit(&key->asset_plus1, memory_order_acquire);
+        if (current == 0) return false;
+        if (strcmp(key->coin, coin) == 0) {
+            *asset_id = current - 1;
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Read one mid price
+ */
+bool hl_mids_get(const hl_mids_table_t* table, uint32_t asset_id, hl_mid_t* out) {
+    if (!table || !out) return false;
+
+    int slot = mids_slot(asset_id);
+    if (slot < 0) return false;
+
+    mids_entry_t* entry = (mids_entry_t*)&table->entries[slot];
+    uint64_t before, after, bits;
+    int64_t update_ns;
+    uint64_t updates;
+
+    do {
+        before = atomic_load_explicit(&entry->seq, memory_order_acquire);
+        bits = atomic_load_explicit(&entry->mid_bits, memory_order_relaxed);
+        update_ns = atomic_load_explicit(&entry->update_ns, memory_order_relaxed);
+        updates = atomic_load_explicit(&entry->updates, memory_order_relaxed);
+        atomic_thread_fence(memory_order_acquire);
+        after = atomic_load_explicit(&entry->seq, memory_order_relaxed);
+    } while ((before & 1) || before != after);
+
+    if (updates == 0) return false;
+
+    memcpy(&out->mid, &bits, sizeof(bits));
+    out->update_ns = update_ns;
+    out->updates = updates;
+    return true;
+}
+
+/**
+ * @brief Read one mid price by coin key
+ */
+bool hl_mids_get_coin(const hl_mids_table_t* table, const char* coin, hl_mid_t* out) {
+    uint32_t asset_id;
+    return hl_mids_table_lookup(table, coin, &asset_id) && hl_mids_get(table, asset_id, out);
+}
+
+/**
+ * @brief Publish one price
+ */
+bool hl_mids_set(hl_mids_table_t* table, uint32_t asset_id, double mid, int64_t update_ns) {
+    if (!table) return false;
+
+    int slot = mids_slot(asset_id);
+    if (slot < 0) return false;
+
+    pthread_mutex_lock(&table->write_mutex);
+    mids_publish(table, slot, mid, update_ns ? update_ns : mids_wall_ns());
+    atomic_fetch_add_explicit(&table->version, 1, memory_order_release);
+    pthread_mutex_unlock(&table->write_mutex);
+    return true;
+}
+
+/**
+ * @brief Table-wide version
+ */
+uint64_t hl_mids_version(const hl_mids_table_t* table) {
+    if (!table) return 0;
+    return atomic_load_explicit(&((hl_mids_table_t*)table)->version, memory_order_acquire);
+}
+
+/**
+ * @brief Apply an allMids "mids" object
+ */
+size_t hl_mids_table_apply_json(hl_mids_table_t* table, const struct cJSON* mids, int64_t update_ns) {
+    if (!table || !cJSON_IsObject(mids)) return 0;
+
+    if (update_ns == 0) update_ns = mids_wall_ns();
+    size_t applied = 0;
+
+    pthread_mutex_lock(&table->write_mutex);
+    const cJSON* item = NULL;
+    cJSON_ArrayForEach(item, mids) {
+        uint32_t asset_id;
+        if (!item->string || !hl_mids_table_lookup(table, item->string, &asset_id)) continue;
+
+        double mid;
+        if (cJSON_IsString(item)) {
+            mid = strtod(item->valuestring, NULL);
+        } else if (cJSON_IsNumber(item)) {
+            mid = item->valuedouble;
+        } else {
+            continue;
+        }
+
+        mids_publish(table, mids_slot(asset_id), mid, update_ns);
+        applied++;
+    }
+    if (applied > 0) {
+        atomic_fetch_add_explicit(&table->version, 1, memory_order_release);
+    }
+    pthread_mutex_unlock(&table->write_mutex);
+
+    return applied;
+}
@@ -1,217 +1,423 @@
 #include "hl_msgpack.h"
 #include "hl_crypto_internal.h"
-#include <msgpack.h>
 #include <string.h>
 #include <stdio.h>
-#include <stdlib.h>
+
+/*
+ * An action hash covers msgpack(action) || nonce || vault flag [|| vault].
+ * Actions only use maps, arrays, strings, unsigned ints and booleans, so
+ * they are encoded here, byte for byte as msgpack-c would, into a fixed
+ * buffer. A single hash streams the buffer into the Keccak sponge whenever
+ * it fills up, so no action is too large and nothing is allocated.
+ */
+
+// Holds a limit order with room to spare; multiple of the word size
+#define PACK_BUFFER_SIZE 512
+
+// Actions hashed together per keccak256_batch call
+#define ACTION_BATCH_CHUNK 8
+
+typedef struct {
+    uint8_t buf[PACK_BUFFER_SIZE];
+    size_t len;
+    sha3_context *sponge;   /**< Absorbs full buffers; NULL fails instead */
+    bool failed;
+} packer_t;
+
+static void packer_init(packer_t *pk, sha3_context *sponge) {
+    pk->len = 0;
+    pk->sponge = sponge;
+    pk->failed = false;
+}
+
+// Room for n more bytes, n small; NULL once a buffer without a sponge is full
+static uint8_t *pack_reserve(packer_t *pk, size_t n) {
+    if (n > PACK_BUFFER_SIZE - pk->len) {
+        if (!pk->sponge) {
+            pk->failed = true;
+            return NULL;
+        }
+        sha3_Update(pk->sponge, pk->buf, pk->len);
+        pk->len = 0;
+    }
+    
+    uint8_t *out = pk->buf + pk->len;
+    pk->len += n;
+    return out;
+}
+
+static void pack_raw(packer_t *pk, const void *data, size_t len) {
+    const uint8_t *bytes = (const uint8_t *)data;
+    
+    // Keys and most values are a few bytes; skip the memcpy call for them
+    if (len <= 16) {
+        uint8_t *out = pack_reserve(pk, len);
+        if (out) {
+            for (size_t i = 0; i < len; i++) {
+                out[i] = bytes[i];
+            }
+        }
+        return;
+    }
+    
+    while (len > 0) {
+        if (pk->len == PACK_BUFFER_SIZE) {
+            if (!pk->sponge) {
+                pk->failed = true;
+                return;
+            }
+            sha3_Update(pk->sponge, pk->buf, pk->len);
+            pk->len = 0;
+        }
+        
+        size_t n = PACK_BUFFER_SIZE - pk->len;
+        if (n > len) {
+            n = len;
+        }
+        memcpy(pk->buf + pk->len, bytes, n);
+        pk->len += n;
+        bytes += n;
+        len -= n;
+    }
+}
+
+// Type byte followed by a big-endian value of width bytes
+static void pack_tagged(packer_t *pk, uint8_t tag, uint64_t value, int width) {
+    uint8_t *out = pack_reserve(pk, 1 + (size_t)width);
+    if (!out) {
+        return;
+    }
+    
+    out[0] = tag;
+    for (int i = 0; i < width; i++) {
+        out[1 + i] = (uint8_t)(value >> (8 * (width - 1 - i)));
+    }
+}
+
+static void pack_map(packer_t *pk, size_t n) {
+    if (n < 16) {
+        pack_tagged(pk, (uint8_t)(0x80 | n), 0, 0);
+    } else if (n < 0x10000) {
+        pack_tagged(pk, 0xde, n, 2);
+    } else {
+        pack_tagged(pk, 0xdf, n, 4);
+    }
+}
+
+static void pack_array(packer_t *pk, size_t n) {
+    if (n < 16) {
+        pack_tagged(pk, (uint8_t)(0x90 | n), 0, 0);
+    } else if (n < 0x10000) {
+        pack_tagged(pk, 0xdc, n, 2);
+    } else {
+        pack_tagged(pk, 0xdd, n, 4);
+    }
+}
+
+static void pack_str(packer_t *pk, const char *str) {
+    size_t len = strlen(str);
+    if (len < 32) {
+        pack_tagged(pk, (uint8_t)(0xa0 | len), 0, 0);
+    } else if (len < 0x100) {
+        pack_tagged(pk, 0xd9, len, 1);
+    } else if (len < 0x10000) {
+        pack_tagged(pk, 0xda, len, 2);
+    } else {
+        pack_tagged(pk, 0xdb, len, 4);
+    }
+    pack_raw(pk, str, len);
+}
+
+// Smallest encoding, as msgpack_pack_uint32/uint64 choose it
+static void pack_uint(packer_t *pk, uint64_t value) {
+    if (value < 0x80) {
+        pack_tagged(pk, (uint8_t)value, 0, 0);
+    } else if (value < 0x100) {
+        pack_tagged(pk, 0xcc, value, 1);
+    } else if (value < 0x10000) {
+        pack_tagged(pk, 0xcd, value, 2);
+    } else if (value < 0x100000000ULL) {
+        pack_tagged(pk, 0xce, value, 4);
+    } else {
+        pack_tagged(pk, 0xcf, value, 8);
+    }
+}
+
+// Negative values in the smallest signed encoding, as msgpack_pack_int64 does
+static void pack_int(packer_t *pk, int64_t value) {
+    if (value >= 0) {
+        pack_uint(pk, (uint64_t)value);
+    } else if (value >= -32) {
+        pack_tagged(pk, (uint8_t)value, 0, 0);
+    } else if (value >= INT8_MIN) {
+        pack_tagged(pk, 0xd0, (uint64_t)value, 1);
+    } else if (value >= INT16_MIN) {
+        pack_tagged(pk, 0xd1, (uint64_t)value, 2);
+    } else if (value >= INT32_MIN) {
+        pack_tagged(pk, 0xd2, (uint64_t)value, 4);
+    } else {
+        pack_tagged(pk, 0xd3, (uint64_t)value, 8);
+    }
+}
+
+static void pack_bool(packer_t *pk, bool value) {
+    pack_tagged(pk, value ? 0xc3 : 0xc2, 0, 0);
+}
 
 // Pack order limit type
-static void pack_limit(msgpack_packer *pk, const hl_limit_t *limit) {
+static void pack_limit(packer_t *pk, const hl_limit_t *limit) {
     // {"limit": {"tif": "Gtc"}}
-    msgpack_pack_map(pk, 1);
-    msgpack_pack_str(pk, 5);
-    msgpack_pack_str_body(pk, "limit", 5);
-    
-    msgpack_pack_map(pk, 1);
-    msgpack_pack_str(pk, 3);
-    msgpack_pack_str_body(pk, "tif", 3);
+    pack_map(pk, 1);
+    pack_str(pk, "limit");
     
-    size_t tif_len = strlen(limit->tif);
-    msgpack_pack_str(pk, tif_len);
-    msgpack_pack_str_body(pk, limit->tif, tif_len);
+    pack_map(pk, 1);
+    pack_str(pk, "tif");
+    pack_str(pk, limit->tif);
 }
 
 // Pack single order
 // Keys must be in alphabetical order: a, b, p, r, s, t
-static void pack_order(msgpack_packer *pk, const hl_order_t *order) {
-    msgpack_pack_map(pk, 6);
+static void pack_order(packer_t *pk, const hl_order_request_t *order) {
+    pack_map(pk, 6);
     
     // "a": asset_id
-    msgpack_pack_str(pk, 1);
-    msgpack_pack_str_body(pk, "a", 1);
-    msgpack_pack_uint32(pk, order->a);
+    pack_str(pk, "a");
+    pack_uint(pk, order->a);
     
     // "b": is_buy
-    msgpack_pack_str(pk, 1);
-    msgpack_pack_str_body(pk, "b", 1);
-    if (order->b) {
-        msgpack_pack_true(pk);
-    } else {
-        msgpack_pack_false(pk);
-    }
+    pack_str(pk, "b");
+    pack_bool(pk, order->b);
     
     // "p": price (string)
-    msgpack_pack_str(pk, 1);
-    msgpack_pack_str_body(pk, "p", 1);
-    size_t p_len = strlen(order->p);
-    msgpack_pack_str(pk, p_len);
-    msgpack_pack_str_body(pk, order->p, p_len);
+    pack_str(pk, "p");
+    pack_str(pk, order->p);
     
     // "s": size (string) - BEFORE "r" to match Go SDK!
-    msgpack_pack_str(pk, 1);
-    msgpack_pack_str_body(pk, "s", 1);
-    size_t s_len = strlen(order->s);
-    msgpack_pack_str(pk, s_len);
-    msgpack_pack_str_body(pk, order->s, s_len);
+    pack_str(pk, "s");
+    pack_str(pk, order->s);
     
     // "r": reduce_only - AFTER "s" to match Go SDK!
-    msgpack_pack_str(pk, 1);
-    msgpack_pack_str_body(pk, "r", 1);
-    if (order->r) {
-        msgpack_pack_true(pk);
-    } else {
-        msgpack_pack_false(pk);
-    }
+    pack_str(pk, "r");
+    pack_bool(pk, order->r);
     
     // "t": order type (limit)
-    msgpack_pack_str(pk, 1);
-    msgpack_pack_str_body(pk, "t", 1);
+    pack_str(pk, "t");
     pack_limit(pk, &order->limit);
 }
 
 // Pack order action  
 // CCXT format: flat map {type, orders, grouping} (in dict insertion order)
-static int pack_order_action(msgpack_packer *pk, const hl_order_action_t *action) {
-    msgpack_pack_map(pk, 3);
+static void pack_order_action(packer_t *pk, const hl_order_action_t *action) {
+    pack_map(pk, 3);
     
     // "type": "order" (first!)
-    msgpack_pack_str(pk, 4);
-    msgpack_pack_str_body(pk, "type", 4);
-    msgpack_pack_str(pk, 5);
-    msgpack_pack_str_body(pk, "order", 5);
+    pack_str(pk, "type");
+    pack_str(pk, "order");
     
     // "orders": [...] (second!)
-    msgpack_pack_str(pk, 6);
-    msgpack_pack_str_body(pk, "orders", 6);
-    msgpack_pack_array(pk, action->orders_count);
+    pack_str(pk, "orders");
+    pack_array(pk, action->orders_count);
     for (size_t i = 0; i < action->orders_count; i++) {
         pack_order(pk, &action->orders[i]);
     }
     
     // "grouping": "na" (third!)
-    msgpack_pack_str(pk, 8);
-    msgpack_pack_str_body(pk, "grouping", 8);
-    size_t g_len = strlen(action->grouping);
-    msgpack_pack_str(pk, g_len);
-    msgpack_pack_str_body(pk, action->grouping, g_len);
-    
-    return 0;
+    pack_str(pk, "grouping");
+    pack_str(pk, action->grouping);
 }
 
 // Pack cancel action
 // CCXT format: flat map {type, cancels} (in dict insertion order)
-static int pack_cancel_action(msgpack_packer *pk, const hl_cancel_action_t *action) {
-    msgpack_pack_map(pk, 2);
+static void pack_cancel_action(packer_t *pk, const hl_cancel_action_t *action) {
+    pack_map(pk, 2);
     
     // "type": "cancel" (first!)
-    msgpack_pack_str(pk, 4);
-    msgpack_pack_str_body(pk, "type", 4);
-    msgpack_pack_str(pk, 6);
-    msgpack_pack_str_body(pk, "cancel", 6);
+    pack_str(pk, "type");
+    pack_str(pk, "cancel");
     
     // "cancels": [...] (second!)
-    msgpack_pack_str(pk, 7);
-    msgpack_pack_str_body(pk, "cancels", 7);
-    msgpack_pack_array(pk, action->cancels_count);
+    pack_str(pk, "cancels");
+    pack_array(pk, action->cancels_count);
     for (size_t i = 0; i < action->cancels_count; i++) {
         // Each cancel has 2 fields: a, o (already alphabetical)
-        msgpack_pack_map(pk, 2);
+        pack_map(pk, 2);
         
         // "a": asset_id
-        msgpack_pack_str(pk, 1);
-        msgpack_pack_str_body(pk, "a", 1);
-        msgpack_pack_uint32(pk, action->cancels[i].a);
+        pack_str(pk, "a");
+        pack_uint(pk, action->cancels[i].a);
         
         // "o": order_id
-        msgpack_pack_str(pk, 1);
-        msgpack_pack_str_body(pk, "o", 1);
-        msgpack_pack_uint64(pk, action->cancels[i].o);
+        pack_str(pk, "o");
+        pack_uint(pk, action->cancels[i].o);
     }
+}
+
+// Pack updateLeverage action
+// CCXT format: flat map {type, asset, isCross, leverage} (in dict insertion order)
+static void pack_update_leverage_action(packer_t *pk, const hl_update_leverage_t *update) {
+    pack_map(pk, 4);
     
-    return 0;
+    pack_str(pk, "type");
+    pack_str(pk, "updateLeverage");
+    
+    pack_str(pk, "asset");
+    pack_uint(pk, update->asset);
+    
+    pack_str(pk, "isCross");
+    pack_bool(pk, update->is_cross);
+    
+    pack_str(pk, "leverage");
+    pack_uint(pk, update->leverage);
 }
 
-int hl_build_action_hash(const char *action_type,
-                         const void *action_data,
-                         uint64_t nonce,
-                         const char *vault_address,
-                         uint8_t connection_id_out[32]) {
-    msgpack_sbuffer sbuf;
-    msgpack_packer pk;
-    int result = -1;
+// Pack updateIsolatedMargin action: {type, asset, isBuy, ntli}
+static void pack_update_isolated_margin_action(packer_t *pk,
+                                               const hl_update_isolated_margin_t *update) {
+    pack_map(pk, 4);
     
-    // Initialize MessagePack buffer
-    msgpack_sbuffer_init(&sbuf);
-    msgpack_packer_init(&pk, &sbuf, msgpack_sbuffer_write);
+    pack_str(pk, "type");
+    pack_str(pk, "updateIsolatedMargin");
     
+    pack_str(pk, "asset");
+    pack_uint(pk, update->asset);
+    
+    pack_str(pk, "isBuy");
+    pack_bool(pk, update->is_buy);
+    
+    pack_str(pk, "ntli");
+    pack_int(pk, update->ntli);
+}
+
+/**
+ * @brief Serialize the bytes an action hash covers
+ *
+ * msgpack(action) || nonce (big-endian u64) || 0x00, or 0x01 || vault
+ * address when one is given.
+ */
+static int pack_action_preimage(packer_t *pk,
+                                const char *action_type,
+                                const void *action_data,
+                                uint64_t nonce,
+                                const char *vault_address) {
     // Pack action based on type
     if (strcmp(action_type, "order") == 0) {
-        if (pack_order_action(&pk, (const hl_order_action_t *)action_data) != 0) {
-            goto cleanup;
-        }
+        pack_order_action(pk, (const hl_order_action_t *)action_data);
     } else if (strcmp(action_type, "cancel") == 0) {
-        if (pack_cancel_action(&pk, (const hl_cancel_action_t *)action_data) != 0) {
-            goto cleanup;
-        }
+        pack_cancel_action(pk, (const hl_cancel_action_t *)action_data);
+    } else if (strcmp(action_type, "updateLeverage") == 0) {
+        pack_update_leverage_action(pk, (const hl_update_leverage_t *)action_data);
+    } else if (strcmp(action_type, "updateIsolatedMargin") == 0) {
+        pack_update_isolated_margin_action(pk, (const hl_update_isolated_margin_t *)action_data);
     } else {
         fprintf(stderr, "Unknown action type: %s\n", action_type);
-        goto cleanup;
+        return -1;
     }
     
-    // Append nonce (timestamp) as big-endian uint64
-    size_t data_len = sbuf.size + 8;
-    uint8_t *data = malloc(data_len + (vault_address ? 21 : 1));
-    if (!data) {
-        fprintf(stderr, "Failed to allocate memory for action hash\n");
-        goto cleanup;
-    }
-    
-    memcpy(data, sbuf.data, sbuf.size);
-    
     // Append nonce in big-endian
+    uint8_t tail[1 + 8 + 20];
     for (int i = 0; i < 8; i++) {
-        data[sbuf.size + i] = (nonce >> (56 - i * 8)) & 0xFF;
+        tail[i] = (nonce >> (56 - i * 8)) & 0xFF;
     }
+    size_t tail_len = 8;
     
     // Append vault address or 0x00
     if (vault_address && vault_address[0] != '\0') {
-        data[data_len] = 0x01;
-        uint8_t addr_bytes[20];
-        if (parse_eth_address(vault_address, addr_bytes) != 0) {
+        tail[tail_len++] = 0x01;
+        if (parse_eth_address(vault_address, tail + tail_len) != 0) {
             fprintf(stderr, "Failed to parse vault address\n");
-            free(data);
-            goto cleanup;
+            return -1;
         }
-        memcpy(data + data_len + 1, addr_bytes, 20);
-        data_len += 21;
+        tail_len += 20;
     } else {
-        data[data_len] = 0x00;
-        data_len += 1;
+        tail[tail_len++] = 0x00;
     }
     
-    // Compute Keccak256 hash
-    if (keccak256(data, data_len, connection_id_out) != 0) {
-        fprintf(stderr, "Failed to compute Keccak256\n");
-        free(data);
-        goto cleanup;
+    pack_raw(pk, tail, tail_len);
+    return pk->failed ? -1 : 0;
+}
+
+int hl_build_action_hash(const char *action_type,
+                         const void *action_data,
+                         uint64_t nonce,
+                         const char *vault_address,
+                         uint8_t connection_id_out[32]) {
+    sha3_context sponge;
+    packer_t pk;
+    
+    sha3_Init256(&sponge);
+    sha3_SetFlags(&sponge, SHA3_FLAGS_KECCAK);
+    packer_init(&pk, &sponge);
+    
+    if (pack_action_preimage(&pk, action_type, action_data, nonce, vault_address) != 0) {
+        return -1;
     }
     
-    free(data);
-    result = 0;
+    // Absorb what is left in the buffer and squeeze the hash
+    sha3_Update(&sponge, pk.buf, pk.len);
+    memcpy(connection_id_out, sha3_Finalize(&sponge), 32);
+    return 0;
+}
+
+int hl_build_action_hashes(const hl_action_hash_request_t *requests,
+                           size_t count,
+                           uint8_t connection_ids_out[][32]) {
+    if (count == 0) {
+        return 0;
+    }
+    if (!requests || !connection_ids_out) {
+        return -1;
+    }
+    
+    for (size_t base = 0; base < count; base += ACTION_BATCH_CHUNK) {
+        size_t n = count - base < ACTION_BATCH_CHUNK ? count - base : ACTION_BATCH_CHUNK;
+        packer_t packers[ACTION_BATCH_CHUNK];
+        const uint8_t *inputs[ACTION_BATCH_CHUNK];
+        size_t lengths[ACTION_BATCH_CHUNK];
+        size_t indices[ACTION_BATCH_CHUNK];
+        uint8_t hashes[ACTION_BATCH_CHUNK][32];
+        size_t batched = 0;
+        
+        // The multi-buffer path needs whole preimages, so these have no
+        // sponge; an action that outgrows its buffer is hashed on its own
+        for (size_t i = base; i < base + n; i++) {
+            const hl_action_hash_request_t *request = &requests[i];
+            packer_t *pk = &packers[batched];
+            
+            packer_init(pk, NULL);
+            if (pack_action_preimage(pk, request->action_type, request->action_data,
+                                     request->nonce, request->vault_address) == 0) {
+                inputs[batched] = pk->buf;
+                lengths[batched] = pk->len;
+                indices[batched] = i;
+                batched++;
+            } else if (!pk->failed ||
+                       hl_build_action_hash(request->action_type, request->action_data,
+                                            request->nonce, request->vault_address,
+                                            connection_ids_out[i]) != 0) {
+                return -1;
+            }
+        }
+        
+        if (batched > 0 && keccak256_batch(inputs, lengths, batched, hashes) != 0) {
+            fprintf(stderr, "Failed to compute Keccak256\n");
+            return -1;
+        }
+        for (size_t j = 0; j < batched; j++) {
+            memcpy(connection_ids_out[indices[j]], hashes[j], 32);
+        }
+    }
     
-cleanup:
-    msgpack_sbuffer_destroy(&sbuf);
-    return result;
+    return 0;
 }
 
-int hl_build_order_hash(const hl_order_t *orders,
+int hl_build_order_hash(const hl_order_request_t *orders,
                         size_t orders_count,
                         const char *grouping,
                         uint64_t nonce,
                         const char *vault_address,
                         uint8_t connection_id_out[32]) {
     hl_order_action_t action = {
-        .orders = (hl_order_t *)orders,
+        .orders = (hl_order_request_t *)orders,
         .orders_count = orders_count,
         .grouping = grouping
     };
@@ -232,3 +438,17 @@ int hl_build_cancel_hash(const hl_cancel_t *cancels,
     return hl_build_action_hash("cancel", &action, nonce, vault_address, connection_id_out);
 }
 
+int hl_build_update_leverage_hash(const hl_update_leverage_t *update,
+                                  uint64_t nonce,
+                                  const char *vault_address,
+                                  uint8_t connection_id_out[32]) {
+    return hl_build_action_hash("updateLeverage", update, nonce, vault_address, connection_id_out);
+}
+
+int hl_build_update_isolated_margin_hash(const hl_update_isolated_margin_t *update,
+                                         uint64_t nonce,
+                                         const char *vault_address,
+                                         uint8_t connection_id_out[32]) {
+    return hl_build_action_hash("updateIsolatedMargin", update, nonce, vault_address,
+                                connection_id_out);
+}
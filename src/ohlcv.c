@@ -4,6 +4,7 @@
  */
 
 #include "hyperliquid.h"
+#include "hl_internal.h"
 #include "hl_http.h"
 #include <stdio.h>
 #include <stdlib.h>
@@ -26,54 +27,48 @@ static const char* get_base_url(hl_client_t* client) {
 }
 
 /**
- * @brief Parse single OHLCV candle from JSON
+ * @brief Read a candle field that may be a string or a number
  */
-static hl_error_t parse_ohlcv_candle(cJSON* candle_json, hl_ohlcv_t* candle) {
-    if (!candle_json || !candle) {
-        return HL_ERROR_INVALID_PARAMS;
+static bool candle_number(const cJSON* candle_json, const char* key, double* out) {
+    const cJSON* item = cJSON_GetObjectItem(candle_json, key);
+    if (cJSON_IsString(item)) {
+        *out = atof(item->valuestring);
+        return true;
     }
-
-    // Parse timestamp (t field)
-    cJSON* t_json = cJSON_GetObjectItem(candle_json, "t");
-    if (!t_json || !cJSON_IsString(t_json)) {
-        return HL_ERROR_PARSE;
+    if (cJSON_IsNumber(item)) {
+        *out = item->valuedouble;
+        return true;
     }
-    candle->timestamp = strtoull(t_json->valuestring, NULL, 10);
-
-    // Parse open price (o field)
-    cJSON* o_json = cJSON_GetObjectItem(candle_json, "o");
-    if (!o_json || !cJSON_IsString(o_json)) {
-        return HL_ERROR_PARSE;
-    }
-    candle->open = atof(o_json->valuestring);
-
-    // Parse high price (h field)
-    cJSON* h_json = cJSON_GetObjectItem(candle_json, "h");
-    if (!h_json || !cJSON_IsString(h_json)) {
-        return HL_ERROR_PARSE;
-    }
-    candle->high = atof(h_json->valuestring);
+    return false;
+}
 
-    // Parse low price (l field)
-    cJSON* l_json = cJSON_GetObjectItem(candle_json, "l");
-    if (!l_json || !cJSON_IsString(l_json)) {
-        return HL_ERROR_PARSE;
+/**
+ * @brief Parse single OHLCV candle from JSON
+ *
+ * Shared by candleSnapshot responses and candle stream updates, which
+ * carry the open time "t" as a number and prices as strings.
+ */
+hl_error_t hl_parse_ohlcv_candle(const cJSON* candle_json, hl_ohlcv_t* candle) {
+    if (!candle_json || !candle) {
+        return HL_ERROR_INVALID_PARAMS;
     }
-    candle->low = atof(l_json->valuestring);
 
-    // Parse close price (c field)
-    cJSON* c_json = cJSON_GetObjectItem(candle_json, "c");
-    if (!c_json || !cJSON_IsString(c_json)) {
+    const cJSON* t_json = cJSON_GetObjectItem(candle_json, "t");
+    if (cJSON_IsString(t_json)) {
+        candle->timestamp = strtoull(t_json->valuestring, NULL, 10);
+    } else if (cJSON_IsNumber(t_json)) {
+        candle->timestamp = (uint64_t)t_json->valuedouble;
+    } else {
         return HL_ERROR_PARSE;
     }
-    candle->close = atof(c_json->valuestring);
 
-    // Parse volume (v field)
-    cJSON* v_json = cJSON_GetObjectItem(candle_json, "v");
-    if (!v_json || !cJSON_IsString(v_json)) {
+    if (!candle_number(candle_json, "o", &candle->open) ||
+        !candle_number(candle_json, "h", &candle->high) ||
+        !candle_number(candle_json, "l", &candle->low) ||
+        !candle_number(candle_json, "c", &candle->close) ||
+        !candle_number(candle_json, "v", &candle->volume)) {
         return HL_ERROR_PARSE;
     }
-    candle->volume = atof(v_json->valuestring);
 
     return HL_SUCCESS;
 }
@@ -102,6 +97,32 @@ static hl_error_t validate_timeframe(const char* timeframe) {
     return HL_ERROR_INVALID_PARAMS;
 }
 
+/**
+ * @brief Length of one candle interval in milliseconds
+ */
+uint64_t hl_timeframe_ms(const char* timeframe) {
+    if (!timeframe) return 0;
+
+    static const struct {
+        const char* name;
+        uint64_t ms;
+    } intervals[] = {
+        {"1m", 60ULL * 1000}, {"3m", 3ULL * 60 * 1000}, {"5m", 5ULL * 60 * 1000},
+        {"15m", 15ULL * 60 * 1000}, {"30m", 30ULL * 60 * 1000},
+        {"1h", 3600ULL * 1000}, {"2h", 2ULL * 3600 * 1000}, {"4h", 4ULL * 3600 * 1000},
+        {"8h", 8ULL * 3600 * 1000}, {"12h", 12ULL * 3600 * 1000},
+        {"1d", 86400ULL * 1000}, {"3d", 3ULL * 86400 * 1000}, {"1w", 7ULL * 86400 * 1000},
+        {"1M", 30ULL * 86400 * 1000}
+    };
+
+    for (size_t i = 0; i < sizeof(intervals) / sizeof(intervals[0]); i++) {
+        if (strcmp(timeframe, intervals[i].name) == 0) {
+            return intervals[i].ms;
+        }
+    }
+    return 0;
+}
+
 /**
  * @brief Calculate start time based on limit and timeframe
  */
@@ -111,24 +132,80 @@ static uint64_t calculate_start_time(uint64_t end_time, uint32_t limit, const ch
         return end_time - (30LL * 24LL * 60LL * 60LL * 1000LL);
     }
 
-    // Convert timeframe to milliseconds
-    uint64_t timeframe_ms = 0;
-    if (strcmp(timeframe, "1m") == 0) timeframe_ms = 60 * 1000;
-    else if (strcmp(timeframe, "3m") == 0) timeframe_ms = 3 * 60 * 1000;
-    else if (strcmp(timeframe, "5m") == 0) timeframe_ms = 5 * 60 * 1000;
-    else if (strcmp(timeframe, "15m") == 0) timeframe_ms = 15 * 60 * 1000;
-    else if (strcmp(timeframe, "30m") == 0) timeframe_ms = 30 * 60 * 1000;
-    else if (strcmp(timeframe, "1h") == 0) timeframe_ms = 60 * 60 * 1000;
-    else if (strcmp(timeframe, "2h") == 0) timeframe_ms = 2 * 60 * 60 * 1000;
-    else if (strcmp(timeframe, "4h") == 0) timeframe_ms = 4 * 60 * 60 * 1000;
-    else if (strcmp(timeframe, "8h") == 0) timeframe_ms = 8 * 60 * 60 * 1000;
-    else if (strcmp(timeframe, "12h") == 0) timeframe_ms = 12 * 60 * 60 * 1000;
-    else if (strcmp(timeframe, "1d") == 0) timeframe_ms = 24 * 60 * 60 * 1000;
-    else if (strcmp(timeframe, "3d") == 0) timeframe_ms = 3 * 24 * 60 * 60 * 1000;
-    else if (strcmp(timeframe, "1w") == 0) timeframe_ms = 7 * 24 * 60 * 60 * 1000;
-    else if (strcmp(timeframe, "1M") == 0) timeframe_ms = 30LL * 24LL * 60LL * 60LL * 1000LL;
-
-    return end_time - (uint64_t)limit * timeframe_ms;
+    return end_time - (uint64_t)limit * hl_timeframe_ms(timeframe);
+}
+
+/**
+ * @brief Request candleSnapshot for an exchange coin
+ */
+hl_error_t hl_fetch_candle_snapshot(hl_client_t* client, const char* coin, const char* interval,
+                                    uint64_t start_time, uint64_t end_time,
+                                    hl_ohlcv_t** candles, size_t* count) {
+    if (!client || !coin || !interval || !candles || !count) {
+        return HL_ERROR_INVALID_PARAMS;
+    }
+
+    *candles = NULL;
+    *count = 0;
+
+    http_client_t* http = (http_client_t*)hl_client_get_http(client);
+    if (!http) {
+        return HL_ERROR_INVALID_PARAMS;
+    }
+
+    char url[256];
+    snprintf(url, sizeof(url), "%s/info", get_base_url(client));
+
+    char body[512];
+    snprintf(body, sizeof(body),
+            "{\"type\":\"candleSnapshot\",\"req\":{\"coin\":\"%s\",\"interval\":\"%s\",\"startTime\":%llu,\"endTime\":%llu}}",
+            coin, interval, (unsigned long long)start_time, (unsigned long long)end_time);
+
+    http_response_t response = {0};
+    lv3_error_t http_err = http_client_post(http, url, body, "Content-Type: application/json", &response);
+
+    if (http_err != LV3_SUCCESS) {
+        http_response_free(&response);
+        return HL_ERROR_NETWORK;
+    }
+
+    if (response.status_code != 200) {
+        http_response_free(&response);
+        return HL_ERROR_API;
+    }
+
+    cJSON* json = cJSON_Parse(response.body);
+    http_response_free(&response);
+
+    if (!json || !cJSON_IsArray(json)) {
+        cJSON_Delete(json);
+        return HL_ERROR_PARSE;
+    }
+
+    size_t num_candles = cJSON_GetArraySize(json);
+    if (num_candles == 0) {
+        cJSON_Delete(json);
+        return HL_SUCCESS;
+    }
+
+    hl_ohlcv_t* parsed = calloc(num_candles, sizeof(hl_ohlcv_t));
+    if (!parsed) {
+        cJSON_Delete(json);
+        return HL_ERROR_MEMORY;
+    }
+
+    size_t valid_candles = 0;
+    const cJSON* candle_json = NULL;
+    cJSON_ArrayForEach(candle_json, json) {
+        if (hl_parse_ohlcv_candle(candle_json, &parsed[valid_candles]) == HL_SUCCESS) {
+            valid_candles++;
+        }
+    }
+
+    cJSON_Delete(json);
+    *candles = parsed;
+    *count = valid_candles;
+    return HL_SUCCESS;
 }
 
 /**
@@ -172,17 +249,6 @@ hl_error_t hl_fetch_ohlcv(hl_client_t* client, const char* symbol, const char* t
         return err;
     }
 
-    // Prepare request
-    http_client_t* http = (http_client_t*)hl_client_get_http(client);
-    if (!http) {
-        hl_markets_free(&markets);
-        return HL_ERROR_INVALID_PARAMS;
-    }
-
-    const char* base_url = get_base_url(client);
-    char url[256];
-    snprintf(url, sizeof(url), "%s/info", base_url);
-
     // Calculate timestamps
     uint64_t end_time = until ? *until : (uint64_t)time(NULL) * 1000;
     uint64_t start_time = since ? *since : 0;
@@ -195,56 +261,21 @@ hl_error_t hl_fetch_ohlcv(hl_client_t* client, const char* symbol, const char* t
         start_time = end_time - (24LL * 60LL * 60LL * 1000LL);
     }
 
-    // Build request body
-    char body[512];
+    // Swaps are requested by coin name (baseName), spots by asset ID
+    char coin[64];
     if (market_info->type == HL_MARKET_SWAP) {
-        // For swaps, use coin name (baseName)
-        snprintf(body, sizeof(body),
-                "{\"type\":\"candleSnapshot\",\"req\":{\"coin\":\"%s\",\"interval\":\"%s\",\"startTime\":%llu,\"endTime\":%llu}}",
-                market_info->base, timeframe, start_time, end_time);
+        snprintf(coin, sizeof(coin), "%s", market_info->base);
     } else {
-        // For spots, use asset ID
-        snprintf(body, sizeof(body),
-                "{\"type\":\"candleSnapshot\",\"req\":{\"coin\":\"%u\",\"interval\":\"%s\",\"startTime\":%llu,\"endTime\":%llu}}",
-                asset_id, timeframe, start_time, end_time);
-    }
-
-    // Make request
-    http_response_t response = {0};
-    lv3_error_t http_err = http_client_post(http, url, body, "Content-Type: application/json", &response);
-
-    if (http_err != LV3_SUCCESS) {
-        http_response_free(&response);
-        hl_markets_free(&markets);
-        return HL_ERROR_NETWORK;
-    }
-
-    if (response.status_code != 200) {
-        http_response_free(&response);
-        hl_markets_free(&markets);
-        return HL_ERROR_API;
-    }
-
-    // Parse response
-    cJSON* json = cJSON_Parse(response.body);
-    http_response_free(&response);
-
-    if (!json) {
-        hl_markets_free(&markets);
-        return HL_ERROR_PARSE;
-    }
-
-    if (!cJSON_IsArray(json)) {
-        cJSON_Delete(json);
-        hl_markets_free(&markets);
-        return HL_ERROR_PARSE;
+        snprintf(coin, sizeof(coin), "%u", asset_id);
     }
+    hl_markets_free(&markets);
 
-    size_t num_candles = cJSON_GetArraySize(json);
-    if (num_candles == 0) {
-        cJSON_Delete(json);
-        hl_markets_free(&markets);
-        return HL_SUCCESS;
+    hl_ohlcv_t* candles = NULL;
+    size_t num_candles = 0;
+    err = hl_fetch_candle_snapshot(client, coin, timeframe, start_time, end_time,
+                                   &candles, &num_candles);
+    if (err != HL_SUCCESS) {
+        return err;
     }
 
     // Limit candles if specified
@@ -252,34 +283,12 @@ hl_error_t hl_fetch_ohlcv(hl_client_t* client, const char* symbol, const char* t
         num_candles = *limit;
     }
 
-    // Allocate memory for candles
-    hl_ohlcv_t* candles = calloc(num_candles, sizeof(hl_ohlcv_t));
-    if (!candles) {
-        cJSON_Delete(json);
-        hl_markets_free(&markets);
-        return HL_ERROR_MEMORY;
-    }
-
-    // Parse each candle
-    size_t valid_candles = 0;
-    for (size_t i = 0; i < num_candles; i++) {
-        cJSON* candle_json = cJSON_GetArrayItem(json, i);
-        if (candle_json) {
-            hl_error_t parse_err = parse_ohlcv_candle(candle_json, &candles[valid_candles]);
-            if (parse_err == HL_SUCCESS) {
-                valid_candles++;
-            }
-        }
-    }
-
     // Copy metadata
     strncpy(ohlcvs->symbol, symbol, sizeof(ohlcvs->symbol) - 1);
     strncpy(ohlcvs->timeframe, timeframe, sizeof(ohlcvs->timeframe) - 1);
     ohlcvs->candles = candles;
-    ohlcvs->count = valid_candles;
+    ohlcvs->count = num_candles;
 
-    cJSON_Delete(json);
-    hl_markets_free(&markets);
     return HL_SUCCESS;
 }
 
@@ -0,0 +1,248 @@
+/**
+ * @file order_pipeline.c
+ * @brief Pipelined order placement
+ *
+ * A fixed set of jobs cycles through three bounded MPMC queues (job_queue.c):
+ * free -> sign -> send -> free. Idle threads sleep on a queue's semaphore;
+ * handing a job over is a CAS and a release store. The signing thread
+ * never takes the client mutex. The sending thread takes it only around an
+ * HTTP POST, since the HTTP handle is shared with the rest of the client.
+ */
+
+#define _GNU_SOURCE
+
+#include "hl_order_pipeline.h"
+#include "hl_internal.h"
+#include "hl_mids.h"
+#include "hl_logger.h"
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <pthread.h>
+
+#define PIPELINE_DEFAULT_DEPTH 64
+#define PIPELINE_PAYLOAD_SIZE 1024
+
+typedef struct {
+    hl_order_request_api_t request;
+    char symbol[64];                    /**< request.symbol points here */
+    hl_ws_order_callback_t callback;
+    void* user_data;
+    char payload[PIPELINE_PAYLOAD_SIZE];
+} pipeline_job_t;
+
+struct hl_order_pipeline {
+    hl_client_t* client;
+    bool testnet;
+    pipeline_job_t* jobs;
+
+    hl_job_queue_t free_jobs;
+    hl_job_queue_t to_sign;
+    hl_job_queue_t to_send;
+
+    pthread_t signer;
+    pthread_t sender;
+    bool signer_started;
+    bool sender_started;
+};
+
+/**
+ * @brief Complete an order that never reached the exchange
+ */
+static void fail_job(hl_order_pipeline_t* pipeline, pipeline_job_t* job, hl_error_t status,
+                     const char* error) {
+    hl_order_result_t result;
+    memset(&result, 0, sizeof(result));
+    snprintf(result.error, sizeof(result.error), "%s", error);
+    job->callback(status, &result, job->user_data);
+    hl_job_queue_push(&pipeline->free_jobs, job);
+}
+
+/**
+ * @brief Signing stage: resolve the market, hash, sign and build the body
+ */
+static void* pipeline_signer_thread(void* arg) {
+    hl_order_pipeline_t* pipeline = (hl_order_pipeline_t*)arg;
+    hl_mids_table_t* mids = hl_client_mids(pipeline->client);
+
+    for (;;) {
+        pipeline_job_t* job = hl_job_queue_pop(&pipeline->to_sign);
+        if (!job) {
+            hl_job_queue_push(&pipeline->to_send, NULL);
+            break;
+        }
+
+        char coin[32];
+        char error[256];
+        uint32_t asset_id = 0;
+        hl_symbol_to_coin(job->symbol, coin, sizeof(coin));
+        if (!mids || !hl_mids_table_lookup(mids, coin, &asset_id)) {
+            snprintf(error, sizeof(error), "Unknown symbol: %s", job->symbol);
+            fail_job(pipeline, job, HL_ERROR_INVALID_SYMBOL, error);
+            continue;
+        }
+
+        hl_error_t err = hl_build_order_payload_for_asset(pipeline->client, asset_id,
+                                                          &job->request, job->payload,
+                                                          sizeof(job->payload),
+                                                          error, sizeof(error));
+        if (err != HL_SUCCESS) {
+            fail_job(pipeline, job, err, error);
+            continue;
+        }
+
+        hl_job_queue_push(&pipeline->to_send, job);
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief POST a signed order and complete it with the parsed response
+ */
+static void send_http(hl_order_pipeline_t* pipeline, pipeline_job_t* job) {
+    http_client_t* http = hl_client_get_http_old(pipeline->client);
+    pthread_mutex_t* mutex = hl_client_get_mutex_old(pipeline->client);
+    if (!http || !mutex) {
+        fail_job(pipeline, job, HL_ERROR_INVALID_PARAMS, "Invalid client state");
+        return;
+    }
+
+    const char* url = pipeline->testnet ? "https://api.hyperliquid-testnet.xyz/exchange"
+                                        : "https://api.hyperliquid.xyz/exchange";
+    http_response_t response = {0};
+
+    pthread_mutex_lock(mutex);
+    lv3_error_t err = http_client_post(http, url, job->payload, "Content-Type: application/json",
+                                       &response);
+    pthread_mutex_unlock(mutex);
+
+    hl_order_result_t result;
+    memset(&result, 0, sizeof(result));
+    hl_error_t status;
+    if (err != LV3_SUCCESS || response.status_code != 200) {
+        snprintf(result.error, sizeof(result.error), "HTTP request failed: %d",
+                 response.status_code);
+        status = err == LV3_ERROR_TIMEOUT ? HL_ERROR_TIMEOUT : HL_ERROR_NETWORK;
+    } else {
+        status = hl_parse_order_response(response.body, &result);
+    }
+    http_response_free(&response);
+
+    job->callback(status, &result, job->user_data);
+    free(result.order_id);
+    hl_job_queue_push(&pipeline->free_jobs, job);
+}
+
+/**
+ * @brief Sending stage: put signed orders on the wire
+ */
+static void* pipeline_sender_thread(void* arg) {
+    hl_order_pipeline_t* pipeline = (hl_order_pipeline_t*)arg;
+
+    for (;;) {
+        pipeline_job_t* job = hl_job_queue_pop(&pipeline->to_send);
+        if (!job) break;
+
+        // The post keeps its own copy of the callback, so the job is free
+        // as soon as the request is written
+        if (hl_ws_post_order(pipeline->client, job->payload, job->callback,
+                             job->user_data) == HL_SUCCESS) {
+            hl_job_queue_push(&pipeline->free_jobs, job);
+            continue;
+        }
+        send_http(pipeline, job);
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief Create a pipeline for a client
+ */
+hl_order_pipeline_t* hl_order_pipeline_create(hl_client_t* client, size_t depth) {
+    if (!client || !hl_client_get_signer(client)) return NULL;
+    if (depth == 0) depth = PIPELINE_DEFAULT_DEPTH;
+
+    hl_order_pipeline_t* pipeline = calloc(1, sizeof(hl_order_pipeline_t));
+    if (!pipeline) return NULL;
+
+    pipeline->client = client;
+    pipeline->testnet = hl_client_is_testnet_old(client);
+    pipeline->jobs = calloc(depth, sizeof(pipeline_job_t));
+
+    // Room for every job plus the stop marker
+    if (!pipeline->jobs ||
+        !hl_job_queue_init(&pipeline->free_jobs, depth + 1) ||
+        !hl_job_queue_init(&pipeline->to_sign, depth + 1) ||
+        !hl_job_queue_init(&pipeline->to_send, depth + 1)) {
+        hl_order_pipeline_destroy(pipeline);
+        return NULL;
+    }
+    for (size_t i = 0; i < depth; i++) {
+        hl_job_queue_push(&pipeline->free_jobs, &pipeline->jobs[i]);
+    }
+
+    if (pthread_create(&pipeline->sender, NULL, pipeline_sender_thread, pipeline) != 0) {
+        hl_order_pipeline_destroy(pipeline);
+        return NULL;
+    }
+    pipeline->sender_started = true;
+
+    if (pthread_create(&pipeline->signer, NULL, pipeline_signer_thread, pipeline) != 0) {
+        hl_order_pipeline_destroy(pipeline);
+        return NULL;
+    }
+    pipeline->signer_started = true;
+
+    return pipeline;
+}
+
+/**
+ * @brief Finish every submitted order, then stop the threads and free
+ */
+void hl_order_pipeline_destroy(hl_order_pipeline_t* pipeline) {
+    if (!pipeline) return;
+
+    // The marker follows every queued order through both stages
+    if (pipeline->signer_started) {
+        hl_job_queue_push(&pipeline->to_sign, NULL);
+        pthread_join(pipeline->signer, NULL);
+    } else if (pipeline->sender_started) {
+        hl_job_queue_push(&pipeline->to_send, NULL);
+    }
+    if (pipeline->sender_started) {
+        pthread_join(pipeline->sender, NULL);
+    }
+
+    hl_job_queue_free(&pipeline->to_send);
+    hl_job_queue_free(&pipeline->to_sign);
+    hl_job_queue_free(&pipeline->free_jobs);
+    free(pipeline->jobs);
+    free(pipeline);
+}
+
+/**
+ * @brief Queue an order
+ */
+hl_error_t hl_order_pipeline_submit(hl_order_pipeline_t* pipeline,
+                                    const hl_order_request_api_t* request,
+                                    hl_ws_order_callback_t callback, void* user_data) {
+    if (!pipeline || !request || !request->symbol || !callback) {
+        return HL_ERROR_INVALID_PARAMS;
+    }
+    if (strlen(request->symbol) >= sizeof(((pipeline_job_t*)0)->symbol)) {
+        return HL_ERROR_INVALID_SYMBOL;
+    }
+
+    pipeline_job_t* job = hl_job_queue_pop(&pipeline->free_jobs);
+    job->request = *request;
+    lv3_string_copy(job->symbol, request->symbol, sizeof(job->symbol));
+    job->request.symbol = job->symbol;
+    job->callback = callback;
+    job->user_data = user_data;
+
+    hl_job_queue_push(&pipeline->to_sign, job);
+    return HL_SUCCESS;
+}
@@ -0,0 +1,246 @@
+/**
+ * @file sign_pool.c
+ * @brief Parallel signing of independent L1 actions
+ *
+ * A batch is a job on the caller's stack. Threads, the caller included,
+ * claim fixed-size chunks of it through an atomic cursor, so results land
+ * in input order without any reordering. The caller returns once every
+ * chunk is done and no pool thread still holds the job.
+ */
+
+#define _DEFAULT_SOURCE
+
+#include "hl_sign_pool.h"
+#include "hl_crypto_internal.h"
+#include "hl_logger.h"
+#include <stdlib.h>
+#include <string.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include <unistd.h>
+
+// Items per claim; also the width of one batched hashing call
+#define SIGN_POOL_CHUNK 8
+
+typedef struct {
+    const hl_sign_item_t* items;
+    hl_sign_result_t* results;
+    size_t count;
+    atomic_size_t next;                 /**< Next unclaimed item */
+    size_t done;                        /**< Items finished (pool mutex) */
+    size_t active;                      /**< Pool threads holding the job (pool mutex) */
+} sign_job_t;
+
+struct hl_sign_pool {
+    pthread_t* threads;
+    size_t thread_count;
+
+    pthread_mutex_t submit_mutex;       /**< One batch at a time */
+    pthread_mutex_t mutex;
+    pthread_cond_t work_cond;
+    pthread_cond_t done_cond;
+    sign_job_t* job;                    /**< Current batch, NULL when idle */
+    uint64_t generation;                /**< Incremented per batch */
+    bool stopping;
+};
+
+/**
+ * @brief Hash and sign items [first, first + n) of a job
+ */
+static void sign_chunk(sign_job_t* job, size_t first, size_t n) {
+    const hl_sign_item_t* items = job->items + first;
+    hl_sign_result_t* results = job->results + first;
+    hl_action_hash_request_t requests[SIGN_POOL_CHUNK];
+    uint8_t connection_ids[SIGN_POOL_CHUNK][32];
+    bool hashed[SIGN_POOL_CHUNK];
+
+    for (size_t i = 0; i < n; i++) {
+        requests[i] = items[i].action;
+    }
+
+    // One batched call for the chunk; redo one by one to find a bad action
+    if (hl_build_action_hashes(requests, n, connection_ids) == 0) {
+        for (size_t i = 0; i < n; i++) {
+            hashed[i] = true;
+        }
+    } else {
+        for (size_t i = 0; i < n; i++) {
+            hashed[i] = hl_build_action_hash(requests[i].action_type, requests[i].action_data,
+                                             requests[i].nonce, requests[i].vault_address,
+                                             connection_ids[i]) == 0;
+        }
+    }
+
+    for (size_t i = 0; i < n; i++) {
+        if (!items[i].signer) {
+            results[i].error = HL_ERROR_AUTH;
+        } else if (!hashed[i]) {
+            results[i].error = HL_ERROR_INVALID_PARAMS;
+        } else if (eip712_sign_agent_signer(items[i].signer, "Exchange", 1337,
+                                            items[i].testnet ? "b" : "a",
+                                            connection_ids[i], results[i].signature) != 0) {
+            results[i].error = HL_ERROR_SIGNATURE;
+        } else {
+            results[i].error = HL_SUCCESS;
+        }
+    }
+}
+
+/**
+ * @brief Claim and sign chunks until the job has none left
+ */
+static void run_job(hl_sign_pool_t* pool, sign_job_t* job) {
+    for (;;) {
+        size_t first = atomic_fetch_add(&job->next, SIGN_POOL_CHUNK);
+        if (first >= job->count) {
+            return;
+        }
+        size_t n = job->count - first < SIGN_POOL_CHUNK ? job->count - first : SIGN_POOL_CHUNK;
+        sign_chunk(job, first, n);
+
+        pthread_mutex_lock(&pool->mutex);
+        job->done += n;
+        if (job->done == job->count) {
+            pthread_cond_broadcast(&pool->done_cond);
+        }
+        pthread_mutex_unlock(&pool->mutex);
+    }
+}
+
+static void* sign_pool_thread(void* arg) {
+    hl_sign_pool_t* pool = arg;
+    uint64_t seen = 0;
+
+    pthread_mutex_lock(&pool->mutex);
+    for (;;) {
+        while (!pool->stopping && (!pool->job || pool->generation == seen)) {
+            pthread_cond_wait(&pool->work_cond, &pool->mutex);
+        }
+        if (pool->stopping) {
+            break;
+        }
+
+        seen = pool->generation;
+        sign_job_t* job = pool->job;
+        job->active++;
+        pthread_mutex_unlock(&pool->mutex);
+
+        run_job(pool, job);
+
+        pthread_mutex_lock(&pool->mutex);
+        job->active--;
+        if (job->active == 0 && job->done == job->count) {
+            pthread_cond_broadcast(&pool->done_cond);
+        }
+    }
+    pthread_mutex_unlock(&pool->mutex);
+    return NULL;
+}
+
+hl_sign_pool_t* hl_sign_pool_create(size_t threads) {
+    if (threads == 0) {
+        long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+        threads = cpus > 0 ? (size_t)cpus : 1;
+    }
+
+    hl_sign_pool_t* pool = calloc(1, sizeof(hl_sign_pool_t));
+    if (!pool) {
+        return NULL;
+    }
+
+    pthread_mutex_init(&pool->submit_mutex, NULL);
+    pthread_mutex_init(&pool->mutex, NULL);
+    pthread_cond_init(&pool->work_cond, NULL);
+    pthread_cond_init(&pool->done_cond, NULL);
+
+    // The caller of hl_sign_pool_sign() is one of the signing threads
+    if (threads > 1) {
+        pool->threads = calloc(threads - 1, sizeof(pthread_t));
+        if (!pool->threads) {
+            hl_sign_pool_destroy(pool);
+            return NULL;
+        }
+        for (size_t i = 0; i < threads - 1; i++) {
+            if (pthread_create(&pool->threads[i], NULL, sign_pool_thread, pool) != 0) {
+                HL_LOG_ERROR("sign pool: cannot start thread %zu of %zu", i + 1, threads - 1);
+                hl_sign_pool_destroy(pool);
+                return NULL;
+            }
+            pool->thread_count++;
+        }
+    }
+
+    return pool;
+}
+
+void hl_sign_pool_destroy(hl_sign_pool_t* pool) {
+    if (!pool) {
+        return;
+    }
+
+    pthread_mutex_lock(&pool->mutex);
+    pool->stopping = true;
+    pthread_cond_broadcast(&pool->work_cond);
+    pthread_mutex_unlock(&pool->mutex);
+
+    for (size_t i = 0; i < pool->thread_count; i++) {
+        pthread_join(pool->threads[i], NULL);
+    }
+    free(pool->threads);
+
+    pthread_cond_destroy(&pool->done_cond);
+    pthread_cond_destroy(&pool->work_cond);
+    pthread_mutex_destroy(&pool->mutex);
+    pthread_mutex_destroy(&pool->submit_mutex);
+    free(pool);
+}
+
+hl_error_t hl_sign_pool_sign(hl_sign_pool_t* pool, const hl_sign_item_t* items, size_t count,
+                             hl_sign_result_t* results) {
+    if (!pool || (count > 0 && (!items || !results))) {
+        return HL_ERROR_INVALID_PARAMS;
+    }
+    if (count == 0) {
+        return HL_SUCCESS;
+    }
+
+    sign_job_t job = {
+        .items = items,
+        .results = results,
+        .count = count
+    };
+    atomic_init(&job.next, 0);
+
+    pthread_mutex_lock(&pool->submit_mutex);
+
+    // Small batches are not worth waking anyone
+    bool shared = pool->thread_count > 0 && count > SIGN_POOL_CHUNK;
+    if (shared) {
+        pthread_mutex_lock(&pool->mutex);
+        pool->job = &job;
+        pool->generation++;
+        pthread_cond_broadcast(&pool->work_cond);
+        pthread_mutex_unlock(&pool->mutex);
+    }
+
+    run_job(pool, &job);
+
+    if (shared) {
+        // The job lives on this stack: wait until no thread can touch it
+        pthread_mutex_lock(&pool->mutex);
+        while (job.done < job.count || job.active > 0) {
+            pthread_cond_wait(&pool->done_cond, &pool->mutex);
+        }
+        pool->job = NULL;
+        pthread_mutex_unlock(&pool->mutex);
+    }
+
+    pthread_mutex_unlock(&pool->submit_mutex);
+
+    for (size_t i = 0; i < count; i++) {
+        if (results[i].error != HL_SUCCESS) {
+            return results[i].error;
+        }
+    }
+    return HL_SUCCESS;
+}
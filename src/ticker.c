@@ -5,6 +5,7 @@
 
 #include "hyperliquid.h"
 #include "hl_http.h"
+#include "hl_internal.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -193,6 +194,12 @@ hl_error_t hl_get_ticker(hl_client_t* client, const char* symbol, hl_ticker_t* t
 
     memset(ticker, 0, sizeof(hl_ticker_t));
 
+    // Streamed markets (hl_watch_asset_ctx) are already current
+    hl_market_t live;
+    if (hl_client_live_market(client, symbol, &live)) {
+        return parse_ticker_from_market(&live, ticker);
+    }
+
     // Fetch fresh market data
     hl_markets_t markets = {0};
     hl_error_t err = fetch_fresh_market_data(client, &markets);
@@ -21,7 +21,7 @@
 
 typedef struct {
     char wallet_address[256];        // Main wallet address (0x...)
-    char private_key[256];           // API private key for signing
+    hl_signer_t *signer;             // Parsed API key for signing
     char base_url[256];              // API base URL
     http_client_t *http_client;      // HTTP client instance
     bool testnet;                    // True if using testnet
@@ -261,8 +261,12 @@ static lv3_error_t hyperliquid_place_limit_order(exchange_trader_t *trader,
         .limit = { .tif = "Gtc" }
     };
     
-    // Get current timestamp
-    uint64_t nonce = get_timestamp_ms();
+    // Unique even when another thread signs in the same millisecond
+    uint64_t nonce = hl_signer_next_nonce(data->signer, get_timestamp_ms());
+    if (nonce == 0) {
+        LV3_LOG_ERROR("No nonce available for %s", trading_symbol);
+        return LV3_ERROR_EXCHANGE;
+    }
     
     // Build action hash (connection_id)
     uint8_t connection_id[32];
@@ -274,8 +278,8 @@ static lv3_error_t hyperliquid_place_limit_order(exchange_trader_t *trader,
     // Sign with EIP-712
     uint8_t signature[65];
     const char *source = data->testnet ? "b" : "a";
-    if (eip712_sign_agent("Exchange", 1337, source, connection_id, 
-                          data->private_key, signature) != 0) {
+    if (eip712_sign_agent_signer(data->signer, "Exchange", 1337, source, connection_id,
+                                 signature) != 0) {
         LV3_LOG_ERROR("Failed to sign order");
         return LV3_ERROR_EXCHANGE;
     }
@@ -419,8 +423,12 @@ static lv3_error_t hyperliquid_cancel_order(exchange_trader_t *trader,
         .o = oid
     };
     
-    // Get current timestamp
-    uint64_t nonce = get_timestamp_ms();
+    // Unique even when another thread signs in the same millisecond
+    uint64_t nonce = hl_signer_next_nonce(data->signer, get_timestamp_ms());
+    if (nonce == 0) {
+        LV3_LOG_ERROR("No nonce available for %s", trading_symbol);
+        return LV3_ERROR_EXCHANGE;
+    }
     
     // Build action hash
     uint8_t connection_id[32];
@@ -432,8 +440,8 @@ static lv3_error_t hyperliquid_cancel_order(exchange_trader_t *trader,
     // Sign with EIP-712
     uint8_t signature[65];
     const char *source = data->testnet ? "b" : "a";
-    if (eip712_sign_agent("Exchange", 1337, source, connection_id,
-                          data->private_key, signature) != 0) {
+    if (eip712_sign_agent_signer(data->signer, "Exchange", 1337, source, connection_id,
+                                 signature) != 0) {
         LV3_LOG_ERROR("Failed to sign cancel");
         return LV3_ERROR_EXCHANGE;
     }
@@ -774,7 +782,12 @@ lv3_error_t hyperliquid_trader_create(const char *wallet_address,
     
     // Initialize data
     lv3_string_copy(data->wallet_address, wallet_address, sizeof(data->wallet_address));
-    lv3_string_copy(data->private_key, private_key, sizeof(data->private_key));
+    data->signer = hl_signer_create(private_key);
+    if (!data->signer) {
+        lv3_free(data);
+        lv3_free(trader);
+        return LV3_ERROR_INVALID_PARAMS;
+    }
     data->testnet = testnet;
     
     if (testnet) {
@@ -788,6 +801,7 @@ lv3_error_t hyperliquid_trader_create(const char *wallet_address,
     // Create HTTP client
     lv3_error_t result = http_client_create(NULL, &data->http_client);
     if (result != LV3_SUCCESS) {
+        hl_signer_destroy(data->signer);
         lv3_free(data);
         lv3_free(trader);
         return result;
@@ -811,3 +825,20 @@ lv3_error_t hyperliquid_trader_create(const char *wallet_address,
     return LV3_SUCCESS;
 }
 
+/**
+ * @brief Destroy Hyperliquid trader, wiping its signing key
+ */
+void hyperliquid_trader_destroy(void *trader_ptr) {
+    exchange_trader_t *trader = (exchange_trader_t *)trader_ptr;
+    if (!trader) return;
+    
+    hyperliquid_data_t *data = (hyperliquid_data_t *)trader->exchange_data;
+    if (data) {
+        hl_signer_destroy(data->signer);
+        if (data->http_client) {
+            http_client_destroy(data->http_client);
+        }
+        lv3_free(data);
+    }
+    lv3_free(trader);
+}
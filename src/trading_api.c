@@ -6,6 +6,8 @@
  * internal trading functions.
  */
 
+#define _POSIX_C_SOURCE 200809L
+
 #include "hyperliquid.h"
 #include "hl_internal.h"
 #include "hl_http.h"
@@ -15,16 +17,6 @@
 #include <stdlib.h>
 #include <string.h>
 #include <pthread.h>
-#include <sys/time.h>
-
-/**
- * @brief Get current timestamp in milliseconds
- */
-static uint64_t get_timestamp_ms(void) {
-    struct timeval tv;
-    gettimeofday(&tv, NULL);
-    return (uint64_t)tv.tv_sec * 1000 + (uint64_t)tv.tv_usec / 1000;
-}
 
 /**
  * @brief Get asset ID for a symbol (fetches from markets API)
@@ -75,86 +67,102 @@ static hl_error_t lv3_to_hl_error(lv3_error_t err) {
 }
 
 /**
- * @brief Place limit order on Hyperliquid (new public API)
+ * @brief Map time in force to wire string
  */
-hl_error_t hl_place_order(hl_client_t* client, 
-                          const hl_order_request_t* request, 
-                          hl_order_result_t* result) {
-    if (!client || !request || !result) {
-        return HL_ERROR_INVALID_PARAMS;
+static const char* tif_to_string(hl_time_in_force_t tif) {
+    switch (tif) {
+        case HL_TIF_IOC: return "Ioc";
+        case HL_TIF_ALO: return "Alo";
+        case HL_TIF_GTC:
+        default: return "Gtc";
     }
-    
-    // Clear result
-    memset(result, 0, sizeof(hl_order_result_t));
-    result->order_id = NULL;
-    
-    // Extract client data using accessors
-    const char* wallet = hl_client_get_wallet_address_old(client);
-    const char* key = hl_client_get_private_key_old(client);
-    bool testnet = hl_client_is_testnet_old(client);
-    http_client_t* http = hl_client_get_http_old(client);
-    pthread_mutex_t* mutex = hl_client_get_mutex_old(client);
-    
-    if (!wallet || !key || !http || !mutex) {
-        snprintf(result->error, sizeof(result->error), "Invalid client state");
-        return HL_ERROR_INVALID_PARAMS;
+}
+
+/**
+ * @brief Build signed /exchange payload for a single limit order
+ *
+ * Caller holds the client mutex.
+ */
+hl_error_t hl_build_order_payload(hl_client_t* client,
+                                  const hl_order_request_api_t* request,
+                                  char* payload, size_t payload_size,
+                                  char* error, size_t error_size) {
+    if (!hl_client_get_signer(client)) {
+        snprintf(error, error_size, "No valid private key");
+        return HL_ERROR_AUTH;
     }
-    
-    // Lock mutex for thread safety
-    pthread_mutex_lock(mutex);
-    
+
     // Get asset ID
     uint32_t asset_id = get_asset_id(client, request->symbol);
     if (asset_id == 0 && strcmp(request->symbol, "SOL") != 0) {
-        pthread_mutex_unlock(mutex);
-        snprintf(result->error, sizeof(result->error), "Unknown symbol: %s", request->symbol);
+        snprintf(error, error_size, "Unknown symbol: %s", request->symbol);
         return HL_ERROR_INVALID_SYMBOL;
     }
-    
+
+    return hl_build_order_payload_for_asset(client, asset_id, request, payload, payload_size,
+                                            error, error_size);
+}
+
+/**
+ * @brief Build signed /exchange payload for an order on a resolved asset
+ *
+ * Needs no lock: signing and nonce allocation are thread-safe.
+ */
+hl_error_t hl_build_order_payload_for_asset(hl_client_t* client, uint32_t asset_id,
+                                            const hl_order_request_api_t* request,
+                                            char* payload, size_t payload_size,
+                                            char* error, size_t error_size) {
+    const hl_signer_t* signer = hl_client_get_signer(client);
+    bool testnet = hl_client_is_testnet_old(client);
+    if (!signer) {
+        snprintf(error, error_size, "No valid private key");
+        return HL_ERROR_AUTH;
+    }
+
     // Format price and size as strings
     char price_str[64], size_str[64];
     snprintf(price_str, sizeof(price_str), "%g", request->price);
     snprintf(size_str, sizeof(size_str), "%g", request->quantity);
-    
+
     // Build order structure
-    hl_order_t order = {
+    hl_order_request_t order = {
         .a = asset_id,
         .b = (request->side == HL_SIDE_BUY),
         .p = price_str,
         .s = size_str,
         .r = request->reduce_only,
-        .limit = {.tif = "Gtc"} // Good Till Cancel
+        .limit = {.tif = tif_to_string(request->time_in_force)}
     };
-    
-    // Get current timestamp for nonce
-    uint64_t nonce = get_timestamp_ms();
-    
+
+    uint64_t nonce = hl_client_next_nonce(client);
+    if (nonce == 0) {
+        snprintf(error, error_size, "No nonce available");
+        return HL_ERROR_SIGNATURE;
+    }
+
     // Build action hash
     uint8_t connection_id[32];
     if (hl_build_order_hash(&order, 1, "na", nonce, NULL, connection_id) != 0) {
-        pthread_mutex_unlock(mutex);
-        snprintf(result->error, sizeof(result->error), "Failed to build order hash");
+        snprintf(error, error_size, "Failed to build order hash");
         return HL_ERROR_SIGNATURE;
     }
-    
+
     // Sign with EIP-712
     uint8_t signature[65];
     const char *source = testnet ? "b" : "a";
-    if (eip712_sign_agent("Exchange", 1337, source, connection_id, key, signature) != 0) {
-        pthread_mutex_unlock(mutex);
-        snprintf(result->error, sizeof(result->error), "Failed to sign order");
+    if (eip712_sign_agent_signer(signer, "Exchange", 1337, source, connection_id, signature) != 0) {
+        snprintf(error, error_size, "Failed to sign order");
         return HL_ERROR_SIGNATURE;
     }
-    
+
     // Convert signature to hex
     char sig_r[67], sig_s[67];
     bytes_to_hex(signature, 32, sig_r, true);
     bytes_to_hex(signature + 32, 32, sig_s, true);
-    
+
     // Build JSON request
-    char json_body[4096];
-    snprintf(json_body, sizeof(json_body),
-             "{\"action\":{\"type\":\"order\",\"orders\":[{\"a\":%u,\"b\":%s,\"p\":\"%s\",\"s\":\"%s\",\"r\":%s,\"t\":{\"limit\":{\"tif\":\"Gtc\"}}}],\"grouping\":\"na\"},"
+    int written = snprintf(payload, payload_size,
+             "{\"action\":{\"type\":\"order\",\"orders\":[{\"a\":%u,\"b\":%s,\"p\":\"%s\",\"s\":\"%s\",\"r\":%s,\"t\":{\"limit\":{\"tif\":\"%s\"}}}],\"grouping\":\"na\"},"
              "\"nonce\":%llu,"
              "\"signature\":{\"r\":\"%s\",\"s\":\"%s\",\"v\":%d},"
              "\"vaultAddress\":null}",
@@ -163,10 +171,183 @@ hl_error_t hl_place_order(hl_client_t* client,
              order.p,
              order.s,
              order.r ? "true" : "false",
+             order.limit.tif,
+             (unsigned long long)nonce,
+             sig_r,
+             sig_s,
+             signature[64]);
+    if (written < 0 || (size_t)written >= payload_size) {
+        snprintf(error, error_size, "Order payload too large");
+        return HL_ERROR_MEMORY;
+    }
+
+    return HL_SUCCESS;
+}
+
+/**
+ * @brief Build signed /exchange payload for a single cancel
+ *
+ * Caller holds the client mutex.
+ */
+hl_error_t hl_build_cancel_payload(hl_client_t* client,
+                                   const char* symbol,
+                                   const char* order_id,
+                                   char* payload, size_t payload_size,
+                                   char* error, size_t error_size) {
+    const hl_signer_t* signer = hl_client_get_signer(client);
+    bool testnet = hl_client_is_testnet_old(client);
+    if (!signer) {
+        snprintf(error, error_size, "No valid private key");
+        return HL_ERROR_AUTH;
+    }
+
+    // Get asset ID
+    uint32_t asset_id = get_asset_id(client, symbol);
+    if (asset_id == 0 && strcmp(symbol, "SOL") != 0) {
+        snprintf(error, error_size, "Unknown symbol: %s", symbol);
+        return HL_ERROR_INVALID_SYMBOL;
+    }
+
+    // Parse order ID
+    uint64_t oid = strtoull(order_id, NULL, 10);
+
+    // Build cancel structure
+    hl_cancel_t cancel = {
+        .a = asset_id,
+        .o = oid
+    };
+
+    uint64_t nonce = hl_client_next_nonce(client);
+    if (nonce == 0) {
+        snprintf(error, error_size, "No nonce available");
+        return HL_ERROR_SIGNATURE;
+    }
+
+    // Build action hash
+    uint8_t connection_id[32];
+    if (hl_build_cancel_hash(&cancel, 1, nonce, NULL, connection_id) != 0) {
+        snprintf(error, error_size, "Failed to build cancel hash");
+        return HL_ERROR_SIGNATURE;
+    }
+
+    // Sign with EIP-712
+    uint8_t signature[65];
+    const char *source = testnet ? "b" : "a";
+    if (eip712_sign_agent_signer(signer, "Exchange", 1337, source, connection_id, signature) != 0) {
+        snprintf(error, error_size, "Failed to sign cancel");
+        return HL_ERROR_SIGNATURE;
+    }
+
+    // Convert signature to hex
+    char sig_r[67], sig_s[67];
+    bytes_to_hex(signature, 32, sig_r, true);
+    bytes_to_hex(signature + 32, 32, sig_s, true);
+
+    // Build JSON request
+    int written = snprintf(payload, payload_size,
+             "{\"action\":{\"type\":\"cancel\",\"cancels\":[{\"a\":%u,\"o\":%llu}]},"
+             "\"nonce\":%llu,"
+             "\"signature\":{\"r\":\"%s\",\"s\":\"%s\",\"v\":%d},"
+             "\"vaultAddress\":null}",
+             asset_id,
+             (unsigned long long)oid,
              (unsigned long long)nonce,
              sig_r,
              sig_s,
              signature[64]);
+    if (written < 0 || (size_t)written >= payload_size) {
+        snprintf(error, error_size, "Cancel payload too large");
+        return HL_ERROR_MEMORY;
+    }
+
+    return HL_SUCCESS;
+}
+
+/**
+ * @brief Parse /exchange order response into result
+ */
+hl_error_t hl_parse_order_response(const char* body, hl_order_result_t* result) {
+    if (!body) {
+        snprintf(result->error, sizeof(result->error), "Empty response");
+        return HL_ERROR_API;
+    }
+
+    // Simple JSON parsing to extract order ID
+    // Response format: {"status":"ok","response":{"data":{"statuses":[{"resting":{"oid":123}}]}}}
+    const char *oid_str = strstr(body, "\"oid\":");
+    if (oid_str) {
+        oid_str += 6; // Skip "\"oid\":"
+        char order_id_buf[64];
+        unsigned long long oid = 0;
+        if (sscanf(oid_str, "%llu", &oid) == 1) {
+            snprintf(order_id_buf, sizeof(order_id_buf), "%llu", oid);
+            result->order_id = strdup(order_id_buf);
+            result->status = strstr(body, "\"filled\"") ? HL_ORDER_STATUS_FILLED : HL_ORDER_STATUS_OPEN;
+            result->filled_quantity = 0.0;
+            result->average_price = 0.0;
+        }
+    }
+
+    if (!result->order_id) {
+        snprintf(result->error, sizeof(result->error), "Failed to parse order ID from response");
+        return HL_ERROR_API;
+    }
+
+    return HL_SUCCESS;
+}
+
+/**
+ * @brief Parse /exchange cancel response into result
+ */
+hl_error_t hl_parse_cancel_response(const char* body, hl_cancel_result_t* result) {
+    // Check response
+    if (body && strstr(body, "\"status\":\"ok\"") && !strstr(body, "\"error\"")) {
+        result->cancelled = true;
+    } else {
+        snprintf(result->error, sizeof(result->error), "Cancel failed: %s",
+                 body ? body : "unknown error");
+    }
+
+    return result->cancelled ? HL_SUCCESS : HL_ERROR_API;
+}
+
+/**
+ * @brief Place limit order on Hyperliquid (new public API)
+ */
+hl_error_t hl_place_order(hl_client_t* client, 
+                          const hl_order_request_api_t* request, 
+                          hl_order_result_t* result) {
+    if (!client || !request || !result) {
+        return HL_ERROR_INVALID_PARAMS;
+    }
+    
+    // Clear result
+    memset(result, 0, sizeof(hl_order_result_t));
+    result->order_id = NULL;
+    
+    // Extract client data using accessors
+    const char* wallet = hl_client_get_wallet_address_old(client);
+    const hl_signer_t* signer = hl_client_get_signer(client);
+    bool testnet = hl_client_is_testnet_old(client);
+    http_client_t* http = hl_client_get_http_old(client);
+    pthread_mutex_t* mutex = hl_client_get_mutex_old(client);
+    
+    if (!wallet || !signer || !http || !mutex) {
+        snprintf(result->error, sizeof(result->error), "Invalid client state");
+        return HL_ERROR_INVALID_PARAMS;
+    }
+    
+    // Lock mutex for thread safety
+    pthread_mutex_lock(mutex);
+    
+    // Build signed request
+    char json_body[4096];
+    hl_error_t build_err = hl_build_order_payload(client, request, json_body, sizeof(json_body),
+                                                  result->error, sizeof(result->error));
+    if (build_err != HL_SUCCESS) {
+        pthread_mutex_unlock(mutex);
+        return build_err;
+    }
     
     // Build URL
     const char *base_url = testnet ? "https://api.hyperliquid-testnet.xyz" : "https://api.hyperliquid.xyz";
@@ -187,37 +368,10 @@ hl_error_t hl_place_order(hl_client_t* client,
         return lv3_to_hl_error(err);
     }
     
-    // Parse response JSON
-    if (!response.body) {
-        http_response_free(&response);
-        snprintf(result->error, sizeof(result->error), "Empty response");
-        return HL_ERROR_API;
-    }
-    
-    // Simple JSON parsing to extract order ID
-    // Response format: {"status":"ok","response":{"data":{"statuses":[{"resting":{"oid":123}}]}}}
-    char *oid_str = strstr(response.body, "\"oid\":");
-    if (oid_str) {
-        oid_str += 6; // Skip "\"oid\":"
-        char order_id_buf[64];
-        int oid_int = 0;
-        if (sscanf(oid_str, "%d", &oid_int) == 1) {
-            snprintf(order_id_buf, sizeof(order_id_buf), "%d", oid_int);
-            result->order_id = strdup(order_id_buf);
-            result->status = HL_ORDER_STATUS_OPEN;
-            result->filled_quantity = 0.0;
-            result->average_price = 0.0;
-        }
-    }
-    
+    hl_error_t parse_err = hl_parse_order_response(response.body, result);
     http_response_free(&response);
     
-    if (!result->order_id) {
-        snprintf(result->error, sizeof(result->error), "Failed to parse order ID from response");
-        return HL_ERROR_API;
-    }
-    
-    return HL_SUCCESS;
+    return parse_err;
 }
 
 /**
@@ -237,12 +391,12 @@ hl_error_t hl_cancel_order(hl_client_t* client,
     
     // Extract client data using accessors
     const char* wallet = hl_client_get_wallet_address_old(client);
-    const char* key = hl_client_get_private_key_old(client);
+    const hl_signer_t* signer = hl_client_get_signer(client);
     bool testnet = hl_client_is_testnet_old(client);
     http_client_t* http = hl_client_get_http_old(client);
     pthread_mutex_t* mutex = hl_client_get_mutex_old(client);
     
-    if (!wallet || !key || !http || !mutex) {
+    if (!wallet || !signer || !http || !mutex) {
         snprintf(result->error, sizeof(result->error), "Invalid client state");
         return HL_ERROR_INVALID_PARAMS;
     }
@@ -250,62 +404,16 @@ hl_error_t hl_cancel_order(hl_client_t* client,
     // Lock mutex for thread safety
     pthread_mutex_lock(mutex);
     
-    // Get asset ID
-    uint32_t asset_id = get_asset_id(client, symbol);
-    if (asset_id == 0 && strcmp(symbol, "SOL") != 0) {
-        pthread_mutex_unlock(mutex);
-        snprintf(result->error, sizeof(result->error), "Unknown symbol: %s", symbol);
-        return HL_ERROR_INVALID_SYMBOL;
-    }
-    
-    // Parse order ID
-    uint64_t oid = strtoull(order_id, NULL, 10);
-    
-    // Build cancel structure
-    hl_cancel_t cancel = {
-        .a = asset_id,
-        .o = oid
-    };
-    
-    // Get current timestamp
-    uint64_t nonce = get_timestamp_ms();
-    
-    // Build action hash
-    uint8_t connection_id[32];
-    if (hl_build_cancel_hash(&cancel, 1, nonce, NULL, connection_id) != 0) {
-        pthread_mutex_unlock(mutex);
-        snprintf(result->error, sizeof(result->error), "Failed to build cancel hash");
-        return HL_ERROR_SIGNATURE;
-    }
-    
-    // Sign with EIP-712
-    uint8_t signature[65];
-    const char *source = testnet ? "b" : "a";
-    if (eip712_sign_agent("Exchange", 1337, source, connection_id, key, signature) != 0) {
+    // Build signed request
+    char json_body[2048];
+    hl_error_t build_err = hl_build_cancel_payload(client, symbol, order_id,
+                                                   json_body, sizeof(json_body),
+                                                   result->error, sizeof(result->error));
+    if (build_err != HL_SUCCESS) {
         pthread_mutex_unlock(mutex);
-        snprintf(result->error, sizeof(result->error), "Failed to sign cancel");
-        return HL_ERROR_SIGNATURE;
+        return build_err;
     }
     
-    // Convert signature to hex
-    char sig_r[67], sig_s[67];
-    bytes_to_hex(signature, 32, sig_r, true);
-    bytes_to_hex(signature + 32, 32, sig_s, true);
-    
-    // Build JSON request
-    char json_body[2048];
-    snprintf(json_body, sizeof(json_body),
-             "{\"action\":{\"type\":\"cancel\",\"cancels\":[{\"a\":%u,\"o\":%llu}]},"
-             "\"nonce\":%llu,"
-             "\"signature\":{\"r\":\"%s\",\"s\":\"%s\",\"v\":%d},"
-             "\"vaultAddress\":null}",
-             asset_id,
-             (unsigned long long)oid,
-             (unsigned long long)nonce,
-             sig_r,
-             sig_s,
-             signature[64]);
-    
     // Build URL
     const char *base_url = testnet ? "https://api.hyperliquid-testnet.xyz" : "https://api.hyperliquid.xyz";
     char url[512];
@@ -325,16 +433,8 @@ hl_error_t hl_cancel_order(hl_client_t* client,
         return lv3_to_hl_error(err);
     }
     
-    // Check response
-    if (response.body && strstr(response.body, "\"status\":\"ok\"")) {
-        result->cancelled = true;
-    } else {
-        snprintf(result->error, sizeof(result->error), "Cancel failed: %s", 
-                 response.body ? response.body : "unknown error");
-    }
-    
+    hl_error_t parse_err = hl_parse_cancel_response(response.body, result);
     http_response_free(&response);
     
-    return result->cancelled ? HL_SUCCESS : HL_ERROR_API;
+    return parse_err;
 }
-
@@ -0,0 +1,265 @@
+/**
+ * @file user_actions.c
+ * @brief Transfers, withdrawals and agent approval
+ *
+ * These actions are signed by the account key itself as EIP-712 typed
+ * data instead of as an agent over a msgpack hash. Every one goes through
+ * post_user_action(): the struct is encoded from the registry in
+ * eip712.c and the request body is written into a stack buffer.
+ */
+
+#include "hyperliquid.h"
+#include "hl_internal.h"
+#include "hl_crypto_internal.h"
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <stdarg.h>
+#include <math.h>
+
+#define USER_ACTION_BODY_SIZE 1024
+
+/**
+ * @brief Format an amount as a plain decimal string ("1.5", not "1.5e+00")
+ */
+static bool format_amount(double amount, char* out, size_t out_size) {
+    if (!isfinite(amount) || amount <= 0) {
+        return false;
+    }
+
+    int written = snprintf(out, out_size, "%.8f", amount);
+    if (written < 0 || (size_t)written >= out_size) {
+        return false;
+    }
+
+    // Drop trailing zeros, and the point if nothing follows it
+    char* end = out + written - 1;
+    while (*end == '0') {
+        *end-- = '\0';
+    }
+    if (*end == '.') {
+        *end = '\0';
+    }
+    return strcmp(out, "0") != 0;
+}
+
+/**
+ * @brief Check that a string can go into the JSON body as is
+ */
+static bool is_plain_string(const char* s) {
+    for (; *s; s++) {
+        if (*s == '"' || *s == '\\' || (unsigned char)*s < 0x20) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief snprintf onto the end of the request body
+ */
+static bool body_append(char* body, size_t size, size_t* len, const char* format, ...) {
+    va_list args;
+    va_start(args, format);
+    int written = vsnprintf(body + *len, size - *len, format, args);
+    va_end(args);
+
+    if (written < 0 || (size_t)written >= size - *len) {
+        return false;
+    }
+    *len += (size_t)written;
+    return true;
+}
+
+/**
+ * @brief Sign a user action and POST it to /exchange
+ *
+ * The last field of every registered type is its nonce and is filled in
+ * here; values[] must have room for it.
+ */
+static hl_error_t post_user_action(hl_client_t* client, eip712_user_type_t type,
+                                   eip712_value_t values[]) {
+    const hl_signer_t* signer = hl_client_get_signer(client);
+    http_client_t* http = hl_client_get_http_old(client);
+    pthread_mutex_t* mutex = hl_client_get_mutex_old(client);
+    bool testnet = hl_client_is_testnet_old(client);
+    const eip712_user_type_def_t* def = eip712_user_type(type);
+
+    if (!signer) {
+        return HL_ERROR_AUTH;
+    }
+    if (!http || !mutex || !def) {
+        return HL_ERROR_INVALID_PARAMS;
+    }
+
+    uint64_t nonce = hl_client_next_nonce(client);
+    if (nonce == 0) {
+        return HL_ERROR_SIGNATURE;
+    }
+    values[def->field_count - 1].uint64 = nonce;
+
+    uint8_t signature[65];
+    if (eip712_sign_user_action(signer, type, testnet, values, signature) != 0) {
+        return HL_ERROR_SIGNATURE;
+    }
+
+    char sig_r[67], sig_s[67];
+    bytes_to_hex(signature, 32, sig_r, true);
+    bytes_to_hex(signature + 32, 32, sig_s, true);
+
+    // The action carries the same fields that were signed
+    char body[USER_ACTION_BODY_SIZE];
+    size_t len = 0;
+    bool ok = body_append(body, sizeof(body), &len,
+                          "{\"action\":{\"type\":\"%s\",\"signatureChainId\":\"0x66eee\","
+                          "\"hyperliquidChain\":\"%s\"",
+                          def->action_type, testnet ? "Testnet" : "Mainnet");
+    for (size_t i = 0; ok && i < def->field_count; i++) {
+        const char* name = def->fields[i].name;
+        char address[43];
+
+        switch (def->fields[i].kind) {
+            case EIP712_FIELD_STRING:
+                // An empty agent name is signed as "" but left out of the action
+                if (values[i].string[0] != '\0') {
+                    ok = body_append(body, sizeof(body), &len, ",\"%s\":\"%s\"",
+                                     name, values[i].string);
+                }
+                break;
+            case EIP712_FIELD_ADDRESS:
+                bytes_to_hex(values[i].address, 20, address, true);
+                ok = body_append(body, sizeof(body), &len, ",\"%s\":\"%s\"", name, address);
+                break;
+            case EIP712_FIELD_UINT64:
+                ok = body_append(body, sizeof(body), &len, ",\"%s\":%llu",
+                                 name, (unsigned long long)values[i].uint64);
+                break;
+        }
+    }
+    ok = ok && body_append(body, sizeof(body), &len,
+                           "},\"nonce\":%llu,"
+                           "\"signature\":{\"r\":\"%s\",\"s\":\"%s\",\"v\":%d},"
+                           "\"vaultAddress\":null}",
+                           (unsigned long long)nonce, sig_r, sig_s, signature[64]);
+    if (!ok) {
+        return HL_ERROR_INVALID_PARAMS;
+    }
+
+    const char* url = testnet ? "https://api.hyperliquid-testnet.xyz/exchange"
+                              : "https://api.hyperliquid.xyz/exchange";
+    http_response_t response = {0};
+
+    pthread_mutex_lock(mutex);
+    lv3_error_t err = http_client_post(http, url, body, "Content-Type: application/json",
+                                       &response);
+    pthread_mutex_unlock(mutex);
+
+    if (err != LV3_SUCCESS) {
+        http_response_free(&response);
+        return err == LV3_ERROR_TIMEOUT ? HL_ERROR_TIMEOUT : HL_ERROR_NETWORK;
+    }
+
+    // Check response
+    hl_error_t result = HL_SUCCESS;
+    if (response.status_code != 200) {
+        if (response.body && strstr(response.body, "error")) {
+            result = HL_ERROR_API;
+        } else {
+            result = HL_ERROR_NETWORK;
+        }
+    } else if (!response.body || strstr(response.body, "\"status\":\"ok\"") == NULL) {
+        result = HL_ERROR_API;
+    }
+
+    http_response_free(&response);
+    return result;
+}
+
+/**
+ * @brief Shared body of usdSend and withdraw3
+ */
+static hl_error_t send_usdc(hl_client_t* client, eip712_user_type_t type,
+                            const char* destination, double amount) {
+    if (!client || !destination) {
+        return HL_ERROR_INVALID_PARAMS;
+    }
+
+    uint8_t address[20];
+    char amount_str[64];
+    if (parse_eth_address(destination, address) != 0 ||
+        !format_amount(amount, amount_str, sizeof(amount_str))) {
+        return HL_ERROR_INVALID_PARAMS;
+    }
+
+    // Signed and sent in one canonical form
+    char canonical[43];
+    bytes_to_hex(address, 20, canonical, true);
+
+    eip712_value_t values[3];
+    values[0].string = canonical;
+    values[1].string = amount_str;
+    return post_user_action(client, type, values);
+}
+
+/**
+ * @brief Send USDC to another account
+ */
+hl_error_t hl_usd_send(hl_client_t* client, const char* destination, double amount) {
+    return send_usdc(client, EIP712_USD_SEND, destination, amount);
+}
+
+/**
+ * @brief Withdraw USDC to an address on Arbitrum
+ */
+hl_error_t hl_withdraw(hl_client_t* client, const char* destination, double amount) {
+    return send_usdc(client, EIP712_WITHDRAW, destination, amount);
+}
+
+/**
+ * @brief Send a spot token to another account
+ */
+hl_error_t hl_spot_send(hl_client_t* client, const char* destination,
+                        const char* token, double amount) {
+    if (!client || !destination || !token || !*token || !is_plain_string(token)) {
+        return HL_ERROR_INVALID_PARAMS;
+    }
+
+    uint8_t address[20];
+    char amount_str[64];
+    if (parse_eth_address(destination, address) != 0 ||
+        !format_amount(amount, amount_str, sizeof(amount_str))) {
+        return HL_ERROR_INVALID_PARAMS;
+    }
+
+    char canonical[43];
+    bytes_to_hex(address, 20, canonical, true);
+
+    eip712_value_t values[4];
+    values[0].string = canonical;
+    values[1].string = token;
+    values[2].string = amount_str;
+    return post_user_action(client, EIP712_SPOT_SEND, values);
+}
+
+/**
+ * @brief Approve an agent key to trade for the account
+ */
+hl_error_t hl_approve_agent(hl_client_t* client, const char* agent_address,
+                            const char* agent_name) {
+    if (!client || !agent_address) {
+        return HL_ERROR_INVALID_PARAMS;
+    }
+    if (!agent_name) {
+        agent_name = "";
+    }
+
+    uint8_t address[20];
+    if (parse_eth_address(agent_address, address) != 0 || !is_plain_string(agent_name)) {
+        return HL_ERROR_INVALID_PARAMS;
+    }
+
+    eip712_value_t values[3];
+    values[0].address = address;
+    values[1].string = agent_name;
+    return post_user_action(client, EIP712_APPROVE_AGENT, values);
+}
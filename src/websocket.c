@@ -3,48 +3,190 @@
  * @brief WebSocket API implementation
  */
 
+#define _GNU_SOURCE
+
 #include "hyperliquid.h"
 #include "hl_internal.h"
+#include "hl_ws_client.h"
+#include "hl_ws_record.h"
+#include "hl_ws_hub.h"
+#include "hl_mids.h"
+#include "hl_bbo.h"
+#include "hl_logger.h"
 #include <stdlib.h>
 #include <string.h>
 #include <stdio.h>
+#include <pthread.h>
 #include <uuid/uuid.h>
+#include <cjson/cJSON.h>
+#include <errno.h>
+#include <time.h>
+#include <stdatomic.h>
+
+#define HL_WS_MAX_PENDING_POSTS 256
+#define WS_REQUEST_SIZE 320             /**< Subscription object plus method envelope */
+
+// Token bucket shared by everything sent on one connection
+typedef struct {
+    pthread_mutex_t mutex;
+    hl_ws_bucket_t bucket;
+} ws_pacer_t;
+
+// Subscribe/unsubscribe messages (or bare subscription objects) collected
+// under the registry lock and sent after it is released
+typedef struct {
+    char (*items)[WS_REQUEST_SIZE];
+    size_t count;
+    size_t capacity;
+} ws_requests_t;
+
+typedef enum {
+    WS_POST_RAW,
+    WS_POST_ORDER,
+    WS_POST_CANCEL
+} ws_post_kind_t;
+
+// In-flight post request
+typedef struct {
+    uint64_t id;                        /**< Request id sent to the server */
+    bool in_use;                        /**< Slot holds a pending request */
+    ws_post_kind_t kind;                /**< Which callback member is set */
+    union {
+        hl_ws_post_callback_t raw;
+        hl_ws_order_callback_t order;
+        hl_ws_cancel_callback_t cancel;
+    } callback;
+    void* user_data;                    /**< User data for callback */
+} ws_post_slot_t;
 
 // Internal client extension for WebSocket
 typedef struct {
+    hl_client_t* client;                /**< Owning client */
     hl_ws_client_t* ws_client;          /**< WebSocket client */
-    hl_ws_subscription_t* subscriptions; /**< Active subscriptions */
+    hl_ws_subscription_t** subscriptions; /**< Subscriptions (entries never move) */
     size_t subscription_count;          /**< Number of subscriptions */
     size_t subscription_capacity;       /**< Subscription array capacity */
+    pthread_mutex_t mutex;              /**< Guards registry (recursive, callbacks may unwatch) */
+    unsigned walkers;                   /**< Callback loops running over the registry */
+    bool compact_pending;               /**< Inactive set entries left for the last walker */
+    hl_ws_resync_callback_t on_resync;  /**< Resync callback */
+    void* resync_user_data;             /**< User data for resync callback */
+    bool offline;                       /**< Register subscriptions without connecting */
+    hl_ws_recorder_t* recorder;         /**< Active capture, if any */
+    hl_ws_hub_t* hub;                   /**< Carries public subscriptions, if attached */
+    ws_pacer_t pacer;                   /**< Paces sends on the client's own connection */
+
+    // Redundant feed (under mutex)
+    hl_ws_client_t* backup;             /**< Second connection for redundant subscriptions */
+    ws_pacer_t backup_pacer;            /**< Paces sends on the backup connection */
+    atomic_bool dual_feed;              /**< backup is set, arbitrate redundant channels */
+    hl_ws_feed_arbiter_t feed;          /**< Seen messages and per-feed tallies */
+
+    // Post requests, slot = id % HL_WS_MAX_PENDING_POSTS
+    ws_post_slot_t posts[HL_WS_MAX_PENDING_POSTS];
+    uint64_t next_post_id;              /**< Next request id */
+    pthread_mutex_t post_mutex;         /**< Guards post slots */
+    pthread_cond_t post_cond;           /**< Signals blocking waiters */
 } hl_client_ws_extension_t;
 
 /**
  * @brief Generate unique subscription ID
  */
 static void generate_subscription_id(char* buffer, size_t size) {
+    (void)size;
     uuid_t uuid;
     uuid_generate(uuid);
     uuid_unparse_lower(uuid, buffer);
 }
 
 /**
- * @brief Add subscription to client
+ * @brief Map unified symbol to exchange coin ("BTC/USDC:USDC" -> "BTC")
+ *
+ * Swap symbols carry a ":settle" suffix and trade under their base name;
+ * anything else (plain coins, spot pairs) is passed through unchanged.
  */
-static const char* add_subscription(hl_client_t* client, const char* channel,
-                                   const char* symbol, hl_ws_data_callback_t callback,
-                                   void* user_data) {
-    if (!client) return NULL;
+void hl_symbol_to_coin(const char* symbol, char* coin, size_t size) {
+    const char* slash = strchr(symbol, '/');
+    size_t len = strlen(symbol);
 
-    hl_client_ws_extension_t* ws_ext = (hl_client_ws_extension_t*)client->ws_extension;
-    if (!ws_ext) return NULL;
+    if (slash && strchr(slash, ':')) {
+        len = (size_t)(slash - symbol);
+    }
+    if (len >= size) {
+        len = size - 1;
+    }
+
+    memcpy(coin, symbol, len);
+    coin[len] = '\0';
+}
+
+/**
+ * @brief Fire resync callback for one subscription (registry lock held)
+ */
+static void notify_resync(hl_client_ws_extension_t* ws_ext, const hl_ws_subscription_t* sub,
+                          hl_ws_resync_event_t event) {
+    if (ws_ext->on_resync) {
+        ws_ext->on_resync(sub, event, ws_ext->resync_user_data);
+    }
+}
+
+/**
+ * @brief Free inactive set entries and close the gaps (registry lock held)
+ *
+ * Other entries stay: their IDs were handed out by hl_watch_* and may
+ * still be passed to hl_unwatch(). While a callback loop walks the array
+ * the work is left to registry_walk_end().
+ */
+static void compact_subscriptions(hl_client_ws_extension_t* ws_ext) {
+    if (ws_ext->walkers > 0) {
+        ws_ext->compact_pending = true;
+        return;
+    }
+
+    size_t kept = 0;
+    for (size_t i = 0; i < ws_ext->subscription_count; i++) {
+        hl_ws_subscription_t* sub = ws_ext->subscriptions[i];
+        if (!sub->active && sub->set_member) {
+            free(sub);
+        } else {
+            ws_ext->subscriptions[kept++] = sub;
+        }
+    }
+    ws_ext->subscription_count = kept;
+    ws_ext->compact_pending = false;
+}
+
+/**
+ * @brief Bracket a loop that calls back into user code (registry lock held)
+ *
+ * A callback may apply or destroy a subscription set; the array must not
+ * shift under the loop, so compaction waits for the outermost walker.
+ */
+static void registry_walk_begin(hl_client_ws_extension_t* ws_ext) {
+    ws_ext->walkers++;
+}
 
+static void registry_walk_end(hl_client_ws_extension_t* ws_ext) {
+    if (--ws_ext->walkers == 0 && ws_ext->compact_pending) {
+        compact_subscriptions(ws_ext);
+    }
+}
+
+/**
+ * @brief Add subscription to client
+ */
+static hl_ws_subscription_t* add_subscription(hl_client_ws_extension_t* ws_ext, const char* channel,
+                                              const char* symbol, const char* coin,
+                                              const char* interval, const char* subscription,
+                                              hl_ws_payload_t payload,
+                                              hl_ws_data_callback_t callback, void* user_data) {
     // Expand subscription array if needed
     if (ws_ext->subscription_count >= ws_ext->subscription_capacity) {
         size_t new_capacity = ws_ext->subscription_capacity * 2;
         if (new_capacity == 0) new_capacity = 8;
 
-        hl_ws_subscription_t* new_subs = realloc(ws_ext->subscriptions,
-                                                new_capacity * sizeof(hl_ws_subscription_t));
+        hl_ws_subscription_t** new_subs = realloc(ws_ext->subscriptions,
+                                                 new_capacity * sizeof(hl_ws_subscription_t*));
         if (!new_subs) return NULL;
 
         ws_ext->subscriptions = new_subs;
@@ -52,347 +194,2575 @@ static const char* add_subscription(hl_client_t* client, const char* channel,
     }
 
     // Create subscription
-    hl_ws_subscription_t* sub = &ws_ext->subscriptions[ws_ext->subscription_count];
+    hl_ws_subscription_t* sub = calloc(1, sizeof(hl_ws_subscription_t));
+    if (!sub) return NULL;
+
     generate_subscription_id(sub->subscription_id, sizeof(sub->subscription_id));
-    strncpy(sub->channel, channel, sizeof(sub->channel) - 1);
+    lv3_string_copy(sub->channel, channel, sizeof(sub->channel));
     if (symbol) {
-        strncpy(sub->symbol, symbol, sizeof(sub->symbol) - 1);
+        lv3_string_copy(sub->symbol, symbol, sizeof(sub->symbol));
+    }
+    if (coin) {
+        lv3_string_copy(sub->coin, coin, sizeof(sub->coin));
     }
+    if (interval) {
+        lv3_string_copy(sub->interval, interval, sizeof(sub->interval));
+    }
+    lv3_string_copy(sub->subscription, subscription, sizeof(sub->subscription));
     sub->callback = callback;
     sub->user_data = user_data;
+    sub->payload = payload;
     sub->active = true;
 
-    ws_ext->subscription_count++;
+    ws_ext->subscriptions[ws_ext->subscription_count++] = sub;
 
-    return sub->subscription_id;
+    return sub;
 }
 
 /**
- * @brief WebSocket message handler
+ * @brief Check whether an active subscription other than @p except needs
+ *        the same server subscription on the client's own connection
+ *        (registry lock held)
  */
-static void ws_message_handler(const char* message, size_t size, void* user_data) {
-    hl_client_t* client = (hl_client_t*)user_data;
-    if (!client) return;
-
-    // Parse WebSocket message and dispatch to appropriate callbacks
-    // This is a placeholder - real implementation would parse JSON
-    printf("WS MESSAGE: %.*s\n", (int)size, message);
+static bool own_subscription_in_use(const hl_client_ws_extension_t* ws_ext, const char* subscription,
+                                    const hl_ws_subscription_t* except) {
+    for (size_t i = 0; i < ws_ext->subscription_count; i++) {
+        const hl_ws_subscription_t* sub = ws_ext->subscriptions[i];
+        if (sub == except || !sub->active || sub->shared) continue;
+        if (strcmp(sub->subscription, subscription) == 0) return true;
+    }
+    return false;
 }
 
 /**
- * @brief WebSocket error handler
+ * @brief Check whether another redundant entry uses a server subscription (registry lock held)
  */
-static void ws_error_handler(const char* error, void* user_data) {
-    hl_client_t* client = (hl_client_t*)user_data;
-    if (!client) return;
-
-    printf("WS ERROR: %s\n", error);
+static bool redundant_subscription_in_use(const hl_client_ws_extension_t* ws_ext,
+                                          const char* subscription,
+                                          const hl_ws_subscription_t* except) {
+    for (size_t i = 0; i < ws_ext->subscription_count; i++) {
+        const hl_ws_subscription_t* sub = ws_ext->subscriptions[i];
+        if (sub == except || !sub->active || !sub->redundant) continue;
+        if (strcmp(sub->subscription, subscription) == 0) return true;
+    }
+    return false;
 }
 
 /**
- * @brief WebSocket connect handler
+ * @brief Append a request; method NULL stores the subscription object itself
  */
-static void ws_connect_handler(void* user_data) {
-    hl_client_t* client = (hl_client_t*)user_data;
-    if (!client) return;
+static bool requests_push(ws_requests_t* requests, const char* method, const char* subscription) {
+    if (requests->count >= requests->capacity) {
+        size_t new_capacity = requests->capacity ? requests->capacity * 2 : 16;
+        void* grown = realloc(requests->items, new_capacity * sizeof(*requests->items));
+        if (!grown) return false;
+        requests->items = grown;
+        requests->capacity = new_capacity;
+    }
 
-    printf("WS CONNECTED\n");
+    char* item = requests->items[requests->count++];
+    if (method) {
+        snprintf(item, WS_REQUEST_SIZE, "{\"method\":\"%s\",\"subscription\":%s}",
+                 method, subscription);
+    } else {
+        lv3_string_copy(item, subscription, WS_REQUEST_SIZE);
+    }
+    return true;
 }
 
 /**
- * @brief Initialize WebSocket for client
+ * @brief Pointer array over the collected requests (caller frees)
  */
-bool hl_ws_init_client(hl_client_t* client, bool testnet) {
-    if (!client) return false;
-
-    // Create WebSocket extension
-    hl_client_ws_extension_t* ws_ext = calloc(1, sizeof(hl_client_ws_extension_t));
-    if (!ws_ext) return false;
-
-    // Create WebSocket client
-    hl_ws_config_t config;
-    hl_ws_config_default(&config, testnet);
-
-    ws_ext->ws_client = hl_ws_client_create(&config);
-    if (!ws_ext->ws_client) {
-        free(ws_ext);
-        return false;
+static const char** requests_list(const ws_requests_t* requests) {
+    const char** list = malloc((requests->count ? requests->count : 1) * sizeof(char*));
+    if (!list) return NULL;
+    for (size_t i = 0; i < requests->count; i++) {
+        list[i] = requests->items[i];
     }
+    return list;
+}
 
-    // Set callbacks
-    hl_ws_client_set_message_callback(ws_ext->ws_client, ws_message_handler, client);
-    hl_ws_client_set_error_callback(ws_ext->ws_client, ws_error_handler, client);
-    hl_ws_client_set_connect_callback(ws_ext->ws_client, ws_connect_handler, client);
+static void requests_free(ws_requests_t* requests) {
+    free(requests->items);
+    memset(requests, 0, sizeof(*requests));
+}
 
-    // Store extension in client (this assumes client has a ws_extension field)
-    client->ws_extension = ws_ext;
+static int64_t pacer_now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
 
-    return true;
+static bool pacer_init(ws_pacer_t* pacer) {
+    hl_ws_bucket_init(&pacer->bucket, pacer_now_ns());
+    return pthread_mutex_init(&pacer->mutex, NULL) == 0;
 }
 
 /**
- * @brief Cleanup WebSocket for client
+ * @brief Send messages in batched writes, paced to the server's rate limit
+ *
+ * A burst of up to a minute's budget goes out at once; beyond that the
+ * caller sleeps until the bucket refills.
  */
-void hl_ws_cleanup_client(hl_client_t* client) {
-    if (!client || !client->ws_extension) return;
-
-    hl_client_ws_extension_t* ws_ext = (hl_client_ws_extension_t*)client->ws_extension;
+static bool pacer_send(ws_pacer_t* pacer, hl_ws_client_t* conn, const char* const* messages,
+                       size_t count) {
+    size_t sent = 0;
+    bool ok = true;
+
+    while (ok && sent < count) {
+        int64_t wait_ns = 0;
+        pthread_mutex_lock(&pacer->mutex);
+        size_t take = hl_ws_bucket_take(&pacer->bucket, count - sent, pacer_now_ns(), &wait_ns);
+        pthread_mutex_unlock(&pacer->mutex);
+
+        if (take == 0) {
+            struct timespec delay = { wait_ns / 1000000000LL, wait_ns % 1000000000LL };
+            nanosleep(&delay, NULL);
+            continue;
+        }
 
-    // Disconnect and destroy WebSocket client
-    if (ws_ext->ws_client) {
-        hl_ws_client_disconnect(ws_ext->ws_client);
-        hl_ws_client_destroy(ws_ext->ws_client);
+        ok = hl_ws_client_send_batch(conn, messages + sent, take);
+        sent += take;
     }
+    return ok;
+}
 
-    // Free subscriptions
-    free(ws_ext->subscriptions);
-    free(ws_ext);
+/**
+ * @brief Send collected requests through a pacer
+ */
+static bool requests_send(const ws_requests_t* requests, ws_pacer_t* pacer, hl_ws_client_t* conn) {
+    if (requests->count == 0) return true;
 
-    client->ws_extension = NULL;
+    const char** messages = requests_list(requests);
+    if (!messages) return false;
+
+    bool ok = pacer_send(pacer, conn, messages, requests->count);
+    free(messages);
+    return ok;
 }
 
 /**
- * @brief Watch ticker updates
+ * @brief Send collected requests on the backup connection, if it is up
  */
-const char* hl_watch_ticker(hl_client_t* client, const char* symbol,
-                           hl_ws_data_callback_t callback, void* user_data) {
-    if (!client || !symbol || !callback) return NULL;
-
-    hl_client_ws_extension_t* ws_ext = (hl_client_ws_extension_t*)client->ws_extension;
-    if (!ws_ext) return NULL;
+static void backup_send(hl_client_ws_extension_t* ws_ext, const ws_requests_t* requests) {
+    pthread_mutex_lock(&ws_ext->mutex);
+    hl_ws_client_t* backup = ws_ext->backup;
+    pthread_mutex_unlock(&ws_ext->mutex);
 
-    // Connect if not connected
-    if (!hl_ws_client_is_connected(ws_ext->ws_client)) {
-        if (!hl_ws_client_connect(ws_ext->ws_client)) {
-            return NULL;
-        }
+    if (backup && requests->count > 0 && hl_ws_client_is_connected(backup)) {
+        requests_send(requests, &ws_ext->backup_pacer, backup);
     }
+}
 
-    // Subscribe to ticker channel
-    char subscription_msg[256];
-    snprintf(subscription_msg, sizeof(subscription_msg),
-             "{\"method\":\"subscribe\",\"subscription\":{\"type\":\"ticker\",\"coin\":\"%s\"}}",
-             symbol);
-
-    if (!hl_ws_client_send_text(ws_ext->ws_client, subscription_msg)) {
-        return NULL;
+/**
+ * @brief Extract the coin a data payload refers to
+ *
+ * Book, bbo and asset context updates carry "coin", trades are an array of
+ * objects with "coin" and candles use "s".
+ */
+static const char* message_coin(const cJSON* data) {
+    const cJSON* item = data;
+    if (cJSON_IsArray(data)) {
+        item = cJSON_GetArrayItem(data, 0);
     }
+    if (!cJSON_IsObject(item)) return NULL;
 
-    return add_subscription(client, "ticker", symbol, callback, user_data);
+    const cJSON* coin = cJSON_GetObjectItem(item, "coin");
+    if (!cJSON_IsString(coin)) {
+        coin = cJSON_GetObjectItem(item, "s");
+    }
+    return cJSON_IsString(coin) ? coin->valuestring : NULL;
 }
 
 /**
- * @brief Watch multiple tickers
+ * @brief Extract the server timestamp a data payload carries
+ *
+ * Books, bbo and trades carry "time" in milliseconds.
  */
-const char* hl_watch_tickers(hl_client_t* client, const char** symbols, size_t symbols_count,
-                            hl_ws_data_callback_t callback, void* user_data) {
-    if (!client || !callback) return NULL;
+static int64_t message_time(const cJSON* data) {
+    const cJSON* item = data;
+    if (cJSON_IsArray(data)) {
+        item = cJSON_GetArrayItem(data, 0);
+    }
+    if (!cJSON_IsObject(item)) return 0;
 
-    // For simplicity, subscribe to all tickers
-    return hl_watch_ticker(client, "*", callback, user_data);
+    const cJSON* time = cJSON_GetObjectItem(item, "time");
+    return cJSON_IsNumber(time) ? (int64_t)time->valuedouble : 0;
 }
 
 /**
- * @brief Watch order book updates
+ * @brief Complete a post request taken out of its slot
+ *
+ * Typed requests parse the payload into an order or cancel result before
+ * their callback runs. Called without any lock held.
  */
-const char* hl_watch_order_book(hl_client_t* client, const char* symbol, uint32_t depth,
-                               hl_ws_data_callback_t callback, void* user_data) {
-    if (!client || !symbol || !callback) return NULL;
-
-    hl_client_ws_extension_t* ws_ext = (hl_client_ws_extension_t*)client->ws_extension;
-    if (!ws_ext) return NULL;
+static void complete_post(const ws_post_slot_t* post, hl_error_t status, const char* response) {
+    switch (post->kind) {
+        case WS_POST_RAW:
+            post->callback.raw(post->id, status, response, post->user_data);
+            break;
+
+        case WS_POST_ORDER: {
+            hl_order_result_t result;
+            memset(&result, 0, sizeof(result));
+            if (status == HL_SUCCESS) {
+                status = hl_parse_order_response(response, &result);
+            } else {
+                snprintf(result.error, sizeof(result.error), "%s", response ? response : "request failed");
+            }
+            post->callback.order(status, &result, post->user_data);
+            free(result.order_id);
+            break;
+        }
 
-    // Connect if not connected
-    if (!hl_ws_client_is_connected(ws_ext->ws_client)) {
-        if (!hl_ws_client_connect(ws_ext->ws_client)) {
-            return NULL;
+        case WS_POST_CANCEL: {
+            hl_cancel_result_t result;
+            memset(&result, 0, sizeof(result));
+            if (status == HL_SUCCESS) {
+                status = hl_parse_cancel_response(response, &result);
+            } else {
+                snprintf(result.error, sizeof(result.error), "%s", response ? response : "request failed");
+            }
+            post->callback.cancel(status, &result, post->user_data);
+            break;
         }
     }
+}
 
-    // Subscribe to order book channel
-    char subscription_msg[256];
-    snprintf(subscription_msg, sizeof(subscription_msg),
-             "{\"method\":\"subscribe\",\"subscription\":{\"type\":\"l2Book\",\"coin\":\"%s\"}}",
-             symbol);
-
-    if (!hl_ws_client_send_text(ws_ext->ws_client, subscription_msg)) {
-        return NULL;
+/**
+ * @brief Take the pending request for id out of its slot
+ * @return true if a request was pending
+ */
+static bool take_post(hl_client_ws_extension_t* ws_ext, uint64_t id, ws_post_slot_t* out) {
+    pthread_mutex_lock(&ws_ext->post_mutex);
+    ws_post_slot_t* slot = &ws_ext->posts[id % HL_WS_MAX_PENDING_POSTS];
+    bool found = slot->in_use && slot->id == id;
+    if (found) {
+        *out = *slot;
+        slot->in_use = false;
     }
-
-    return add_subscription(client, "l2Book", symbol, callback, user_data);
+    pthread_mutex_unlock(&ws_ext->post_mutex);
+    return found;
 }
 
 /**
- * @brief Watch OHLCV updates
+ * @brief Fail every pending post request (connection lost)
  */
-const char* hl_watch_ohlcv(hl_client_t* client, const char* symbol, const char* timeframe,
-                          hl_ws_data_callback_t callback, void* user_data) {
-    if (!client || !symbol || !timeframe || !callback) return NULL;
-
-    hl_client_ws_extension_t* ws_ext = (hl_client_ws_extension_t*)client->ws_extension;
-    if (!ws_ext) return NULL;
+static void fail_pending_posts(hl_client_ws_extension_t* ws_ext, const char* reason) {
+    for (size_t i = 0; i < HL_WS_MAX_PENDING_POSTS; i++) {
+        ws_post_slot_t post;
+
+        pthread_mutex_lock(&ws_ext->post_mutex);
+        bool found = ws_ext->posts[i].in_use;
+        if (found) {
+            post = ws_ext->posts[i];
+            ws_ext->posts[i].in_use = false;
+        }
+        pthread_mutex_unlock(&ws_ext->post_mutex);
 
-    // Connect if not connected
-    if (!hl_ws_client_is_connected(ws_ext->ws_client)) {
-        if (!hl_ws_client_connect(ws_ext->ws_client)) {
-            return NULL;
+        if (found) {
+            complete_post(&post, HL_ERROR_NETWORK, reason);
         }
     }
+}
+
+/**
+ * @brief Route a "post" channel response to its pending request
+ *
+ * Format: {"id":N,"response":{"type":"action"|"info"|"error","payload":...}}
+ */
+static void handle_post_response(hl_client_ws_extension_t* ws_ext, const cJSON* data) {
+    const cJSON* id = cJSON_GetObjectItem(data, "id");
+    const cJSON* response = cJSON_GetObjectItem(data, "response");
+    if (!cJSON_IsNumber(id) || !cJSON_IsObject(response)) return;
+
+    ws_post_slot_t post;
+    if (!take_post(ws_ext, (uint64_t)id->valuedouble, &post)) {
+        HL_LOG_DEBUG("WS: response for unknown post id %.0f", id->valuedouble);
+        return;
+    }
 
-    // Subscribe to OHLCV channel (placeholder - Hyperliquid may not have this)
-    char subscription_msg[256];
-    snprintf(subscription_msg, sizeof(subscription_msg),
-             "{\"method\":\"subscribe\",\"subscription\":{\"type\":\"candle\",\"coin\":\"%s\",\"interval\":\"%s\"}}",
-             symbol, timeframe);
+    const cJSON* type = cJSON_GetObjectItem(response, "type");
+    const cJSON* payload = cJSON_GetObjectItem(response, "payload");
 
-    if (!hl_ws_client_send_text(ws_ext->ws_client, subscription_msg)) {
-        return NULL;
+    if (cJSON_IsString(type) && strcmp(type->valuestring, "error") == 0) {
+        complete_post(&post, HL_ERROR_API,
+                      cJSON_IsString(payload) ? payload->valuestring : "post request failed");
+        return;
     }
 
-    return add_subscription(client, "candle", symbol, callback, user_data);
+    char* body = payload ? cJSON_PrintUnformatted(payload) : NULL;
+    complete_post(&post, body ? HL_SUCCESS : HL_ERROR_PARSE, body);
+    free(body);
 }
 
 /**
- * @brief Watch trades
+ * @brief Deliver a decoded top-of-book record to bbo subscribers
+ *
+ * @return true if subscribers of the full message also match, so the
+ *         message still needs a JSON parse
  */
-const char* hl_watch_trades(hl_client_t* client, const char* symbol,
-                           hl_ws_data_callback_t callback, void* user_data) {
-    if (!client || !symbol || !callback) return NULL;
+static bool dispatch_bbo(hl_client_ws_extension_t* ws_ext, hl_bbo_t* bbo, const char* coin,
+                         hl_bbo_source_t source) {
+    const char* channel = source == HL_BBO_SOURCE_BBO ? "bbo" : "l2Book";
+    bool needs_message = false;
 
-    hl_client_ws_extension_t* ws_ext = (hl_client_ws_extension_t*)client->ws_extension;
-    if (!ws_ext) return NULL;
+    if (ws_ext->client->mids) {
+        hl_mids_table_lookup(ws_ext->client->mids, coin, &bbo->asset_id);
+    }
 
-    // Connect if not connected
-    if (!hl_ws_client_is_connected(ws_ext->ws_client)) {
-        if (!hl_ws_client_connect(ws_ext->ws_client)) {
-            return NULL;
+    pthread_mutex_lock(&ws_ext->mutex);
+    registry_walk_begin(ws_ext);
+    for (size_t i = 0; i < ws_ext->subscription_count; i++) {
+        hl_ws_subscription_t* sub = ws_ext->subscriptions[i];
+        if (!sub->active || strcmp(sub->channel, channel) != 0) continue;
+        if (sub->coin[0] && strcmp(sub->coin, coin) != 0) continue;
+
+        if (sub->payload != HL_WS_PAYLOAD_BBO) {
+            needs_message = true;
+            continue;
         }
-    }
 
-    // Subscribe to trades channel
-    char subscription_msg[256];
-    snprintf(subscription_msg, sizeof(subscription_msg),
-             "{\"method\":\"subscribe\",\"subscription\":{\"type\":\"trades\",\"coin\":\"%s\"}}",
-             symbol);
+        sub->message_count++;
+        if (sub->stale) {
+            sub->stale = false;
+            notify_resync(ws_ext, sub, HL_WS_RESYNC_RECOVERED);
+        }
 
-    if (!hl_ws_client_send_text(ws_ext->ws_client, subscription_msg)) {
-        return NULL;
+        if (sub->callback) {
+            sub->callback(bbo, sub->user_data);
+        }
     }
+    registry_walk_end(ws_ext);
+    pthread_mutex_unlock(&ws_ext->mutex);
 
-    return add_subscription(client, "trades", symbol, callback, user_data);
+    return needs_message;
 }
 
 /**
- * @brief Watch user orders
+ * @brief One received message, decoded at most once
+ *
+ * A message read from a shared hub connection is routed to many clients;
+ * the top-of-book scan and the JSON parse run once for all of them.
  */
-const char* hl_watch_orders(hl_client_t* client, const char* symbol,
-                           hl_ws_data_callback_t callback, void* user_data) {
-    if (!client || !callback) return NULL;
+typedef struct {
+    const char* message;
+    size_t size;
+    int64_t recv_time_ns;
+    bool live;                          /**< Read from a connection, not replayed */
+    hl_ws_client_t* source;             /**< Connection it arrived on (live only) */
+
+    bool bbo_decoded;
+    hl_bbo_t bbo;
+    char bbo_coin[32];
+    hl_bbo_source_t bbo_source;
+
+    bool parsed;                        /**< JSON stage has run */
+    cJSON* json;
+    const char* channel;                /**< NULL if unparseable */
+    cJSON* data;
+    const char* coin;
+    const cJSON* interval;
+    int64_t server_time;
+    double age_ms;
+} ws_inbound_t;
+
+static void inbound_init(ws_inbound_t* in, const char* message, size_t size,
+                         int64_t recv_time_ns, bool live, hl_ws_client_t* source) {
+    memset(in, 0, sizeof(*in));
+    in->message = message;
+    in->size = size;
+    in->recv_time_ns = recv_time_ns;
+    in->live = live;
+    in->source = source;
+    in->bbo_decoded = hl_bbo_decode(message, size, recv_time_ns, &in->bbo, in->bbo_coin,
+                                    sizeof(in->bbo_coin), &in->bbo_source);
+}
 
-    hl_client_ws_extension_t* ws_ext = (hl_client_ws_extension_t*)client->ws_extension;
-    if (!ws_ext) return NULL;
+/**
+ * @brief Parse the message and extract routing fields, once
+ * @return true if the message has a channel and data
+ */
+static bool inbound_parse(ws_inbound_t* in) {
+    if (in->parsed) return in->channel != NULL;
+    in->parsed = true;
 
-    // Connect if not connected
-    if (!hl_ws_client_is_connected(ws_ext->ws_client)) {
-        if (!hl_ws_client_connect(ws_ext->ws_client)) {
-            return NULL;
-        }
+    in->json = cJSON_Parse(in->message);
+    if (!in->json) {
+        HL_LOG_DEBUG("WS: unparseable message (%zu bytes)", in->size);
+        return false;
     }
 
-    // Subscribe to user orders channel
-    const char* user_address = hl_client_get_wallet_address_old(client);
-    if (!user_address) return NULL;
+    const cJSON* channel = cJSON_GetObjectItem(in->json, "channel");
+    cJSON* data = cJSON_GetObjectItem(in->json, "data");
+    if (!cJSON_IsString(channel) || !data) return false;
 
-    char subscription_msg[256];
-    snprintf(subscription_msg, sizeof(subscription_msg),
-             "{\"method\":\"subscribe\",\"subscription\":{\"type\":\"orderUpdates\",\"user\":\"%s\"}}",
-             user_address);
+    if (strcmp(channel->valuestring, "error") == 0) {
+        HL_LOG_DEBUG("WS: server error: %s", cJSON_IsString(data) ? data->valuestring : "?");
+        return false;
+    }
 
-    if (!hl_ws_client_send_text(ws_ext->ws_client, subscription_msg)) {
-        return NULL;
+    in->channel = channel->valuestring;
+    in->data = data;
+    in->coin = message_coin(data);
+    in->interval = cJSON_IsObject(data) ? cJSON_GetObjectItem(data, "i") : NULL;
+    in->server_time = message_time(data);
+    if (in->server_time > 0) {
+        in->age_ms = in->live ? hl_ws_client_note_server_time(in->source, in->server_time)
+                              : (double)in->recv_time_ns / 1e6 - (double)in->server_time;
     }
+    return true;
+}
 
-    return add_subscription(client, "orderUpdates", symbol, callback, user_data);
+static void inbound_free(ws_inbound_t* in) {
+    cJSON_Delete(in->json);
+    in->json = NULL;
 }
 
+// ============================================================================
+// Feed arbitration
+// ============================================================================
+
 /**
- * @brief Watch user trades
+ * @brief Channels whose messages can be matched across connections
  */
-const char* hl_watch_my_trades(hl_client_t* client, const char* symbol,
-                              hl_ws_data_callback_t callback, void* user_data) {
-    if (!client || !callback) return NULL;
+static bool feed_channel_supported(const char* channel) {
+    return strcmp(channel, "l2Book") == 0 || strcmp(channel, "bbo") == 0 ||
+           strcmp(channel, "trades") == 0;
+}
 
-    hl_client_ws_extension_t* ws_ext = (hl_client_ws_extension_t*)client->ws_extension;
-    if (!ws_ext) return NULL;
+/**
+ * @brief First integer following @p field in the message text, 0 if none
+ */
+static int64_t raw_number(const char* message, const char* field) {
+    const char* at = strstr(message, field);
+    return at ? strtoll(at + strlen(field), NULL, 10) : 0;
+}
 
-    // Connect if not connected
-    if (!hl_ws_client_is_connected(ws_ext->ws_client)) {
-        if (!hl_ws_client_connect(ws_ext->ws_client)) {
-            return NULL;
-        }
+/**
+ * @brief Identity of a message that both feeds deliver
+ *
+ * Books and bbo are identified by exchange time, trades by the first trade
+ * id. Top-of-book messages are identified from the raw text, so they still
+ * skip the JSON parse.
+ *
+ * @return false if the message is not arbitrated
+ */
+static bool inbound_feed_key(ws_inbound_t* in, uint64_t* key, const char** channel,
+                             const char** coin) {
+    if (in->bbo_decoded) {
+        *channel = in->bbo_source == HL_BBO_SOURCE_BBO ? "bbo" : "l2Book";
+        *coin = in->bbo_coin;
+    } else {
+        if (!inbound_parse(in) || !in->coin) return false;
+        *channel = in->channel;
+        *coin = in->coin;
     }
+    if (!feed_channel_supported(*channel)) return false;
 
-    // Subscribe to user fills channel
-    const char* user_address = hl_client_get_wallet_address_old(client);
-    if (!user_address) return NULL;
+    int64_t time = raw_number(in->message, "\"time\":");
+    int64_t tid = strcmp(*channel, "trades") == 0 ? raw_number(in->message, "\"tid\":") : 0;
+    if (time <= 0 && tid <= 0) return false;
 
-    char subscription_msg[256];
-    snprintf(subscription_msg, sizeof(subscription_msg),
-             "{\"method\":\"subscribe\",\"subscription\":{\"type\":\"userFills\",\"user\":\"%s\"}}",
-             user_address);
+    *key = hl_ws_feed_key(*channel, *coin, time, tid);
+    return true;
+}
 
-    if (!hl_ws_client_send_text(ws_ext->ws_client, subscription_msg)) {
-        return NULL;
+/**
+ * @brief Check for an active subscription carried on both feeds (registry lock held)
+ */
+static bool feed_is_redundant(const hl_client_ws_extension_t* ws_ext, const char* channel,
+                              const char* coin) {
+    for (size_t i = 0; i < ws_ext->subscription_count; i++) {
+        const hl_ws_subscription_t* sub = ws_ext->subscriptions[i];
+        if (sub->active && sub->redundant && strcmp(sub->channel, channel) == 0 &&
+            strcmp(sub->coin, coin) == 0) {
+            return true;
+        }
     }
-
-    return add_subscription(client, "userFills", symbol, callback, user_data);
+    return false;
 }
 
 /**
- * @brief Unwatch subscription
+ * @brief Deliver one message to a client's subscriptions
+ *
+ * Routes each channel message to the subscriptions registered for its
+ * channel and coin. The first message after (re)subscribing is flagged as
+ * a snapshot and clears the subscription's stale state. Post responses are
+ * only taken from the client's own live connection.
  */
-bool hl_unwatch(hl_client_t* client, const char* subscription_id) {
-    if (!client || !subscription_id || !client->ws_extension) return false;
+static void deliver_message(hl_client_ws_extension_t* ws_ext, ws_inbound_t* in) {
+    // Top-of-book subscribers are served from the raw text; the JSON tree is
+    // only built if someone else wants the same message
+    if (in->bbo_decoded) {
+        hl_bbo_t bbo = in->bbo;
+        if (!dispatch_bbo(ws_ext, &bbo, in->bbo_coin, in->bbo_source)) return;
+    }
 
-    hl_client_ws_extension_t* ws_ext = (hl_client_ws_extension_t*)client->ws_extension;
+    if (!inbound_parse(in)) return;
 
-    // Find and deactivate subscription
-    for (size_t i = 0; i < ws_ext->subscription_count; i++) {
-        if (strcmp(ws_ext->subscriptions[i].subscription_id, subscription_id) == 0) {
-            ws_ext->subscriptions[i].active = false;
+    if (strcmp(in->channel, "post") == 0) {
+        if (in->live && in->source == ws_ext->ws_client) handle_post_response(ws_ext, in->data);
+        return;
+    }
+
+    // Shared tables are updated before callbacks so they observe the new values
+    if (strcmp(in->channel, "allMids") == 0 && ws_ext->client->mids) {
+        hl_mids_table_apply_json(ws_ext->client->mids, cJSON_GetObjectItem(in->data, "mids"),
+                                 in->recv_time_ns);
+    } else if (strcmp(in->channel, "activeAssetCtx") == 0) {
+        const cJSON* ctx_coin = cJSON_GetObjectItem(in->data, "coin");
+        if (cJSON_IsString(ctx_coin)) {
+            hl_client_update_market_ctx(ws_ext->client, ctx_coin->valuestring,
+                                        cJSON_GetObjectItem(in->data, "ctx"),
+                                        in->recv_time_ns / 1000000);
+        }
+    }
 
-            // Send unsubscribe message
-            char unsubscribe_msg[256];
-            snprintf(unsubscribe_msg, sizeof(unsubscribe_msg),
-                     "{\"method\":\"unsubscribe\",\"subscription\":{\"type\":\"%s\"}}",
-                     ws_ext->subscriptions[i].channel);
+    const char* coin = in->coin;
+    const cJSON* interval = in->interval;
+
+    hl_ws_message_t msg = {
+        .channel = in->channel,
+        .coin = coin,
+        .raw = in->message,
+        .raw_size = in->size,
+        .json = in->data,
+        .is_snapshot = false,
+        .server_time_ms = in->server_time,
+        .recv_time_ns = in->recv_time_ns,
+        .age_ms = in->age_ms
+    };
+
+    pthread_mutex_lock(&ws_ext->mutex);
+    registry_walk_begin(ws_ext);
+    for (size_t i = 0; i < ws_ext->subscription_count; i++) {
+        hl_ws_subscription_t* sub = ws_ext->subscriptions[i];
+        if (!sub->active || strcmp(sub->channel, msg.channel) != 0) continue;
+        if (sub->coin[0] && (!coin || strcmp(sub->coin, coin) != 0)) continue;
+        if (sub->payload != HL_WS_PAYLOAD_MESSAGE) continue;
+        if (sub->interval[0] && cJSON_IsString(interval) &&
+            strcmp(sub->interval, interval->valuestring) != 0) continue;
+
+        msg.is_snapshot = sub->message_count == 0;
+        sub->message_count++;
+
+        if (sub->stale) {
+            sub->stale = false;
+            notify_resync(ws_ext, sub, HL_WS_RESYNC_RECOVERED);
+        }
 
-            hl_ws_client_send_text(ws_ext->ws_client, unsubscribe_msg);
-            return true;
+        if (sub->callback) {
+            sub->callback(&msg, sub->user_data);
         }
     }
+    registry_walk_end(ws_ext);
+    pthread_mutex_unlock(&ws_ext->mutex);
+}
 
-    return false;
+/**
+ * @brief Route one message, dropping the later copy of a redundant topic
+ *
+ * Messages of topics carried on both the primary and the backup connection
+ * are delivered from whichever copy is processed first. Arbitration and
+ * delivery share the registry lock so the merged stream stays in order.
+ */
+static void route_message(hl_client_ws_extension_t* ws_ext, ws_inbound_t* in) {
+    uint64_t key;
+    const char* channel;
+    const char* coin;
+
+    if (!in->live || !atomic_load_explicit(&ws_ext->dual_feed, memory_order_acquire) ||
+        (in->source != ws_ext->ws_client && in->source != ws_ext->backup) ||
+        !inbound_feed_key(in, &key, &channel, &coin)) {
+        deliver_message(ws_ext, in);
+        return;
+    }
+
+    pthread_mutex_lock(&ws_ext->mutex);
+    int feed = in->source == ws_ext->backup ? 1 : 0;
+    bool deliver;
+    if (feed_is_redundant(ws_ext, channel, coin)) {
+        deliver = hl_ws_feed_admit(&ws_ext->feed, feed, key, in->recv_time_ns);
+    } else {
+        // In flight on the backup after the topic stopped being redundant
+        deliver = feed == 0;
+    }
+    if (deliver) {
+        deliver_message(ws_ext, in);
+    }
+    pthread_mutex_unlock(&ws_ext->mutex);
 }
 
 /**
- * @brief Create order via WebSocket (placeholder)
+ * @brief Route one message to a single client
+ *
+ * Shared by live traffic on the client's own connection and replay.
+ * Replayed messages skip post handling and leave the live connection's
+ * timing statistics alone.
  */
-hl_error_t hl_create_order_ws(hl_client_t* client,
-                             const hl_order_request_t* request,
-                             hl_order_result_t* result) {
-    // Placeholder - would implement WebSocket order creation
-    // Similar to REST API but over WebSocket
-    return HL_ERROR_NOT_IMPLEMENTED;
+static void dispatch_message(hl_client_ws_extension_t* ws_ext, const char* message, size_t size,
+                             int64_t recv_time_ns, bool live) {
+    ws_inbound_t in;
+    inbound_init(&in, message, size, recv_time_ns, live, live ? ws_ext->ws_client : NULL);
+    route_message(ws_ext, &in);
+    inbound_free(&in);
 }
 
 /**
- * @brief Cancel order via WebSocket (placeholder)
+ * @brief WebSocket message handler
  */
-hl_error_t hl_cancel_order_ws(hl_client_t* client,
-                             const char* symbol,
-                             const char* order_id,
-                             hl_cancel_result_t* result) {
-    // Placeholder - would implement WebSocket order cancellation
-    return HL_ERROR_NOT_IMPLEMENTED;
+static void ws_message_handler(const char* message, size_t size, void* user_data) {
+    hl_client_t* client = (hl_client_t*)user_data;
+    if (!client || !client->ws_extension) return;
+
+    hl_client_ws_extension_t* ws_ext = (hl_client_ws_extension_t*)client->ws_extension;
+    dispatch_message(ws_ext, message, size, hl_ws_client_last_rx_time_ns(ws_ext->ws_client), true);
+}
+
+/**
+ * @brief Replay handler: same dispatch, recorded timestamps
+ */
+static void ws_replay_handler(const char* message, size_t size, void* user_data) {
+    void** context = (void**)user_data;
+    hl_client_ws_extension_t* ws_ext = (hl_client_ws_extension_t*)context[0];
+    const hl_ws_replay_t* replay = (const hl_ws_replay_t*)context[1];
+
+    dispatch_message(ws_ext, message, size, hl_ws_replay_time_ns(replay), false);
+}
+
+/**
+ * @brief WebSocket error handler
+ */
+static void ws_error_handler(const char* error, void* user_data) {
+    hl_client_t* client = (hl_client_t*)user_data;
+    (void)error;
+    if (!client) return;
+
+    HL_LOG_DEBUG("WS ERROR: %s", error);
+}
+
+/**
+ * @brief WebSocket connect handler
+ *
+ * Replays every distinct server subscription of the registry, batched and
+ * paced. On the initial connect this sends subscriptions registered before
+ * connecting; after a reconnect it restores the whole registry. The
+ * requests are sent with the registry unlocked, so a sleeping pacer does
+ * not hold up watch and unwatch calls.
+ */
+static void ws_connect_handler(void* user_data) {
+    hl_client_t* client = (hl_client_t*)user_data;
+    if (!client || !client->ws_extension) return;
+
+    hl_client_ws_extension_t* ws_ext = (hl_client_ws_extension_t*)client->ws_extension;
+    ws_requests_t requests = {0};
+
+    pthread_mutex_lock(&ws_ext->mutex);
+
+    for (size_t i = 0; i < ws_ext->subscription_count; i++) {
+        hl_ws_subscription_t* sub = ws_ext->subscriptions[i];
+        if (!sub->active || sub->shared) continue;
+
+        sub->message_count = 0;
+
+        // Entries sharing a server subscription are sent once
+        bool duplicate = false;
+        for (size_t j = 0; j < i && !duplicate; j++) {
+            const hl_ws_subscription_t* earlier = ws_ext->subscriptions[j];
+            duplicate = earlier->active && !earlier->shared &&
+                        strcmp(earlier->subscription, sub->subscription) == 0;
+        }
+        if (!duplicate) {
+            requests_push(&requests, "subscribe", sub->subscription);
+        }
+    }
+
+    pthread_mutex_unlock(&ws_ext->mutex);
+
+    if (requests.count > HL_WS_MAX_SUBSCRIPTIONS) {
+        HL_LOG_WARN("WS: %zu subscriptions exceed the server limit of %d per connection",
+                    requests.count, HL_WS_MAX_SUBSCRIPTIONS);
+    }
+    if (!requests_send(&requests, &ws_ext->pacer, ws_ext->ws_client)) {
+        HL_LOG_DEBUG("WS: failed to replay %zu subscriptions", requests.count);
+    }
+
+    pthread_mutex_lock(&ws_ext->mutex);
+    registry_walk_begin(ws_ext);
+    for (size_t i = 0; i < ws_ext->subscription_count; i++) {
+        hl_ws_subscription_t* sub = ws_ext->subscriptions[i];
+        if (sub->active && !sub->shared && sub->stale) {
+            notify_resync(ws_ext, sub, HL_WS_RESYNC_RESUBSCRIBED);
+        }
+    }
+    registry_walk_end(ws_ext);
+
+    pthread_mutex_unlock(&ws_ext->mutex);
+    requests_free(&requests);
+}
+
+/**
+ * @brief WebSocket disconnect handler
+ *
+ * Everything built from the stream may have missed updates from here on,
+ * so each active subscription is marked stale until its next snapshot.
+ */
+static void ws_disconnect_handler(const char* reason, void* user_data) {
+    hl_client_t* client = (hl_client_t*)user_data;
+    if (!client || !client->ws_extension) return;
+
+    hl_client_ws_extension_t* ws_ext = (hl_client_ws_extension_t*)client->ws_extension;
+
+    (void)reason;
+    HL_LOG_DEBUG("WS DISCONNECTED: %s", reason);
+
+    pthread_mutex_lock(&ws_ext->mutex);
+    // Redundant topics keep streaming from the backup
+    bool backup_up = ws_ext->backup && hl_ws_client_is_connected(ws_ext->backup);
+    registry_walk_begin(ws_ext);
+    for (size_t i = 0; i < ws_ext->subscription_count; i++) {
+        hl_ws_subscription_t* sub = ws_ext->subscriptions[i];
+        if (!sub->active || sub->shared || (sub->redundant && backup_up)) continue;
+
+        sub->stale = true;
+        notify_resync(ws_ext, sub, HL_WS_RESYNC_STALE);
+    }
+    registry_walk_end(ws_ext);
+    pthread_mutex_unlock(&ws_ext->mutex);
+
+    // Responses to in-flight posts will never arrive on a new connection
+    fail_pending_posts(ws_ext, reason);
+}
+
+// ============================================================================
+// Shared hub
+// ============================================================================
+
+// One distinct server subscription and the number of client subscriptions using it
+typedef struct {
+    char subscription[256];
+    size_t refs;
+} ws_hub_entry_t;
+
+struct hl_ws_hub {
+    hl_ws_client_t* ws_client;
+    pthread_mutex_t mutex;              /**< Guards members (recursive), taken before their registry locks */
+    pthread_mutex_t entries_mutex;      /**< Guards entries, taken after any registry lock */
+    pthread_mutex_t send_mutex;         /**< Orders sends on the connection, taken after entries_mutex */
+    hl_client_ws_extension_t** members;
+    size_t member_count;
+    size_t member_capacity;
+    ws_hub_entry_t* entries;
+    size_t entry_count;
+    size_t entry_capacity;
+    ws_pacer_t pacer;                   /**< Paces sends on the shared connection */
+};
+
+/**
+ * @brief Subscriptions without a "user" field carry public data
+ */
+static bool ws_hub_is_public(const char* subscription) {
+    return strstr(subscription, "\"user\"") == NULL;
+}
+
+/**
+ * @brief Decode once, route to every attached client
+ */
+static void ws_hub_message_handler(const char* message, size_t size, void* user_data) {
+    hl_ws_hub_t* hub = (hl_ws_hub_t*)user_data;
+
+    ws_inbound_t in;
+    inbound_init(&in, message, size, hl_ws_client_last_rx_time_ns(hub->ws_client), true,
+                 hub->ws_client);
+
+    pthread_mutex_lock(&hub->mutex);
+    for (size_t i = 0; i < hub->member_count; i++) {
+        route_message(hub->members[i], &in);
+    }
+    pthread_mutex_unlock(&hub->mutex);
+
+    inbound_free(&in);
+}
+
+/**
+ * @brief Release entries_mutex, then send what was collected under it
+ *
+ * send_mutex is taken before entries_mutex is dropped, so requests reach
+ * the server in the order the entries changed. A sleeping pacer holds up
+ * only other senders, not the I/O thread or reference counting.
+ */
+static bool ws_hub_send_unlocked(hl_ws_hub_t* hub, const ws_requests_t* requests, bool send) {
+    pthread_mutex_lock(&hub->send_mutex);
+    pthread_mutex_unlock(&hub->entries_mutex);
+
+    bool ok = !send || requests_send(requests, &hub->pacer, hub->ws_client);
+    pthread_mutex_unlock(&hub->send_mutex);
+    return ok;
+}
+
+static void ws_hub_error_handler(const char* error, void* user_data) {
+    (void)error;
+    (void)user_data;
+    HL_LOG_DEBUG("WS HUB ERROR: %s", error);
+}
+
+/**
+ * @brief Replay every distinct subscription after (re)connecting
+ */
+static void ws_hub_connect_handler(void* user_data) {
+    hl_ws_hub_t* hub = (hl_ws_hub_t*)user_data;
+
+    ws_requests_t requests = {0};
+
+    pthread_mutex_lock(&hub->entries_mutex);
+    for (size_t i = 0; i < hub->entry_count; i++) {
+        requests_push(&requests, "subscribe", hub->entries[i].subscription);
+    }
+    if (!ws_hub_send_unlocked(hub, &requests, true)) {
+        HL_LOG_DEBUG("WS HUB: failed to replay %zu subscriptions", requests.count);
+    }
+
+    pthread_mutex_lock(&hub->mutex);
+    for (size_t m = 0; m < hub->member_count; m++) {
+        hl_client_ws_extension_t* ws_ext = hub->members[m];
+        pthread_mutex_lock(&ws_ext->mutex);
+        registry_walk_begin(ws_ext);
+        for (size_t i = 0; i < ws_ext->subscription_count; i++) {
+            hl_ws_subscription_t* sub = ws_ext->subscriptions[i];
+            if (!sub->active || !sub->shared) continue;
+
+            sub->message_count = 0;
+            if (sub->stale) {
+                notify_resync(ws_ext, sub, HL_WS_RESYNC_RESUBSCRIBED);
+            }
+        }
+        registry_walk_end(ws_ext);
+        pthread_mutex_unlock(&ws_ext->mutex);
+    }
+
+    pthread_mutex_unlock(&hub->mutex);
+    requests_free(&requests);
+}
+
+/**
+ * @brief Mark every shared subscription stale
+ */
+static void ws_hub_disconnect_handler(const char* reason, void* user_data) {
+    hl_ws_hub_t* hub = (hl_ws_hub_t*)user_data;
+
+    (void)reason;
+    HL_LOG_DEBUG("WS HUB DISCONNECTED: %s", reason);
+
+    pthread_mutex_lock(&hub->mutex);
+    for (size_t m = 0; m < hub->member_count; m++) {
+        hl_client_ws_extension_t* ws_ext = hub->members[m];
+        pthread_mutex_lock(&ws_ext->mutex);
+        registry_walk_begin(ws_ext);
+        for (size_t i = 0; i < ws_ext->subscription_count; i++) {
+            hl_ws_subscription_t* sub = ws_ext->subscriptions[i];
+            if (!sub->active || !sub->shared) continue;
+
+            sub->stale = true;
+            notify_resync(ws_ext, sub, HL_WS_RESYNC_STALE);
+        }
+        registry_walk_end(ws_ext);
+        pthread_mutex_unlock(&ws_ext->mutex);
+    }
+    pthread_mutex_unlock(&hub->mutex);
+}
+
+/**
+ * @brief Take a reference on each subscription, subscribing the new ones
+ *
+ * Connects the shared connection if needed; its connect handler then sends
+ * every entry. On failure no reference is kept.
+ */
+static bool ws_hub_ref_many(hl_ws_hub_t* hub, const char* const* subscriptions, size_t count) {
+    ws_requests_t requests = {0};
+    size_t taken = 0;
+    bool ok = true;
+
+    pthread_mutex_lock(&hub->entries_mutex);
+    for (; taken < count; taken++) {
+        ws_hub_entry_t* entry = NULL;
+        for (size_t i = 0; i < hub->entry_count; i++) {
+            if (strcmp(hub->entries[i].subscription, subscriptions[taken]) == 0) {
+                entry = &hub->entries[i];
+                break;
+            }
+        }
+
+        if (!entry) {
+            if (hub->entry_count >= hub->entry_capacity) {
+                size_t new_capacity = hub->entry_capacity ? hub->entry_capacity * 2 : 16;
+                ws_hub_entry_t* grown = realloc(hub->entries, new_capacity * sizeof(ws_hub_entry_t));
+                if (!grown) {
+                    ok = false;
+                    break;
+                }
+                hub->entries = grown;
+                hub->entry_capacity = new_capacity;
+            }
+            entry = &hub->entries[hub->entry_count++];
+            lv3_string_copy(entry->subscription, subscriptions[taken], sizeof(entry->subscription));
+            entry->refs = 0;
+        }
+
+        if (entry->refs++ == 0 && !requests_push(&requests, "subscribe", entry->subscription)) {
+            taken++;
+            ok = false;
+            break;
+        }
+    }
+
+    // A failed send is retried by the replay when the connection comes back
+    bool connected = hl_ws_client_is_connected(hub->ws_client);
+    ws_hub_send_unlocked(hub, &requests, ok && connected);
+    requests_free(&requests);
+
+    if (ok && !connected) {
+        ok = hl_ws_client_connect(hub->ws_client);
+    }
+
+    if (!ok) {
+        pthread_mutex_lock(&hub->entries_mutex);
+        for (size_t s = 0; s < taken; s++) {
+            for (size_t i = 0; i < hub->entry_count; i++) {
+                ws_hub_entry_t* entry = &hub->entries[i];
+                if (strcmp(entry->subscription, subscriptions[s]) != 0) continue;
+                // Entries dropping to zero were never sent
+                if (--entry->refs == 0) hub->entries[i] = hub->entries[--hub->entry_count];
+                break;
+            }
+        }
+        pthread_mutex_unlock(&hub->entries_mutex);
+    }
+    return ok;
+}
+
+/**
+ * @brief Drop a reference on each subscription, unsubscribing unused ones
+ */
+static void ws_hub_unref_many(hl_ws_hub_t* hub, const char* const* subscriptions, size_t count) {
+    ws_requests_t requests = {0};
+
+    pthread_mutex_lock(&hub->entries_mutex);
+    for (size_t s = 0; s < count; s++) {
+        for (size_t i = 0; i < hub->entry_count; i++) {
+            ws_hub_entry_t* entry = &hub->entries[i];
+            if (strcmp(entry->subscription, subscriptions[s]) != 0) continue;
+
+            if (--entry->refs == 0) {
+                requests_push(&requests, "unsubscribe", entry->subscription);
+                hub->entries[i] = hub->entries[--hub->entry_count];
+            }
+            break;
+        }
+    }
+
+    ws_hub_send_unlocked(hub, &requests, hl_ws_client_is_connected(hub->ws_client));
+    requests_free(&requests);
+}
+
+static bool ws_hub_ref(hl_ws_hub_t* hub, const char* subscription) {
+    return ws_hub_ref_many(hub, &subscription, 1);
+}
+
+/**
+ * @brief Remove a client from its hub and release its shared subscriptions
+ *
+ * The references are dropped after both locks are released, since the
+ * unsubscribes may wait on the pacer.
+ */
+static void ws_hub_detach(hl_ws_hub_t* hub, hl_client_ws_extension_t* ws_ext) {
+    ws_requests_t drops = {0};
+
+    pthread_mutex_lock(&hub->mutex);
+
+    for (size_t i = 0; i < hub->member_count; i++) {
+        if (hub->members[i] == ws_ext) {
+            hub->members[i] = hub->members[--hub->member_count];
+            break;
+        }
+    }
+
+    pthread_mutex_lock(&ws_ext->mutex);
+    for (size_t i = 0; i < ws_ext->subscription_count; i++) {
+        hl_ws_subscription_t* sub = ws_ext->subscriptions[i];
+        if (sub->active && sub->shared) {
+            sub->active = false;
+            requests_push(&drops, NULL, sub->subscription);
+        }
+    }
+    ws_ext->hub = NULL;
+    pthread_mutex_unlock(&ws_ext->mutex);
+
+    pthread_mutex_unlock(&hub->mutex);
+
+    if (drops.count > 0) {
+        const char** list = requests_list(&drops);
+        if (list) ws_hub_unref_many(hub, list, drops.count);
+        free(list);
+    }
+    requests_free(&drops);
+}
+
+/**
+ * @brief Create a hub
+ */
+hl_ws_hub_t* hl_ws_hub_create(bool testnet) {
+    hl_ws_hub_t* hub = calloc(1, sizeof(hl_ws_hub_t));
+    if (!hub) return NULL;
+
+    pthread_mutexattr_t attr;
+    pthread_mutexattr_init(&attr);
+    pthread_mutexattr_settype(&attr, PTHREAD_MUTEX_RECURSIVE);
+    int rc = pthread_mutex_init(&hub->mutex, &attr);
+    pthread_mutexattr_destroy(&attr);
+    if (rc != 0) {
+        free(hub);
+        return NULL;
+    }
+    if (pthread_mutex_init(&hub->entries_mutex, NULL) != 0) {
+        pthread_mutex_destroy(&hub->mutex);
+        free(hub);
+        return NULL;
+    }
+    if (pthread_mutex_init(&hub->send_mutex, NULL) != 0) {
+        pthread_mutex_destroy(&hub->entries_mutex);
+        pthread_mutex_destroy(&hub->mutex);
+        free(hub);
+        return NULL;
+    }
+    if (!pacer_init(&hub->pacer)) {
+        pthread_mutex_destroy(&hub->send_mutex);
+        pthread_mutex_destroy(&hub->entries_mutex);
+        pthread_mutex_destroy(&hub->mutex);
+        free(hub);
+        return NULL;
+    }
+
+    hl_ws_config_t config;
+    hl_ws_config_default(&config, testnet);
+    config.max_reconnect_attempts = 0;
+
+    hub->ws_client = hl_ws_client_create(&config);
+    if (!hub->ws_client) {
+        pthread_mutex_destroy(&hub->pacer.mutex);
+        pthread_mutex_destroy(&hub->send_mutex);
+        pthread_mutex_destroy(&hub->entries_mutex);
+        pthread_mutex_destroy(&hub->mutex);
+        free(hub);
+        return NULL;
+    }
+
+    hl_ws_client_set_message_callback(hub->ws_client, ws_hub_message_handler, hub);
+    hl_ws_client_set_error_callback(hub->ws_client, ws_hub_error_handler, hub);
+    hl_ws_client_set_connect_callback(hub->ws_client, ws_hub_connect_handler, hub);
+    hl_ws_client_set_disconnect_callback(hub->ws_client, ws_hub_disconnect_handler, hub);
+
+    return hub;
+}
+
+/**
+ * @brief Close the hub connection and free the hub
+ */
+void hl_ws_hub_destroy(hl_ws_hub_t* hub) {
+    if (!hub) return;
+
+    pthread_mutex_lock(&hub->mutex);
+    if (hub->member_count > 0) {
+        HL_LOG_WARN("WS hub destroyed with %zu clients attached", hub->member_count);
+    }
+    pthread_mutex_unlock(&hub->mutex);
+
+    // Detached one at a time, without holding the hub lock across the sends
+    for (;;) {
+        pthread_mutex_lock(&hub->mutex);
+        hl_client_ws_extension_t* member = hub->member_count > 0 ? hub->members[0] : NULL;
+        pthread_mutex_unlock(&hub->mutex);
+        if (!member) break;
+        ws_hub_detach(hub, member);
+    }
+
+    // Joins the I/O thread, so no handler runs after this
+    hl_ws_client_disconnect(hub->ws_client);
+    hl_ws_client_destroy(hub->ws_client);
+
+    pthread_mutex_destroy(&hub->pacer.mutex);
+    pthread_mutex_destroy(&hub->send_mutex);
+    pthread_mutex_destroy(&hub->entries_mutex);
+    pthread_mutex_destroy(&hub->mutex);
+    free(hub->members);
+    free(hub->entries);
+    free(hub);
+}
+
+/**
+ * @brief Route a client's public subscriptions through a hub
+ */
+bool hl_ws_attach_hub(hl_client_t* client, hl_ws_hub_t* hub) {
+    if (!client || !hub || !client->ws_extension) return false;
+
+    hl_client_ws_extension_t* ws_ext = (hl_client_ws_extension_t*)client->ws_extension;
+
+    pthread_mutex_lock(&hub->mutex);
+    pthread_mutex_lock(&ws_ext->mutex);
+
+    bool ok = ws_ext->hub == NULL;
+    if (ok && hub->member_count >= hub->member_capacity) {
+        size_t new_capacity = hub->member_capacity ? hub->member_capacity * 2 : 8;
+        hl_client_ws_extension_t** grown = realloc(hub->members,
+                                                   new_capacity * sizeof(hl_client_ws_extension_t*));
+        if (grown) {
+            hub->members = grown;
+            hub->member_capacity = new_capacity;
+        } else {
+            ok = false;
+        }
+    }
+    if (ok) {
+        hub->members[hub->member_count++] = ws_ext;
+        ws_ext->hub = hub;
+    }
+
+    pthread_mutex_unlock(&ws_ext->mutex);
+    pthread_mutex_unlock(&hub->mutex);
+    return ok;
+}
+
+/**
+ * @brief Attached clients and distinct server subscriptions of a hub
+ */
+void hl_ws_hub_get_counts(hl_ws_hub_t* hub, size_t* clients, size_t* subscriptions) {
+    if (!hub) return;
+
+    pthread_mutex_lock(&hub->mutex);
+    if (clients) *clients = hub->member_count;
+    pthread_mutex_unlock(&hub->mutex);
+
+    pthread_mutex_lock(&hub->entries_mutex);
+    if (subscriptions) *subscriptions = hub->entry_count;
+    pthread_mutex_unlock(&hub->entries_mutex);
+}
+
+/**
+ * @brief Connection timing statistics of the hub connection
+ */
+bool hl_ws_hub_get_stats(hl_ws_hub_t* hub, hl_ws_stats_t* stats) {
+    if (!hub || !stats) return false;
+    return hl_ws_client_get_stats(hub->ws_client, stats);
+}
+
+/**
+ * @brief Register subscription and send it (or connect, which replays it)
+ */
+static const char* watch_channel(hl_client_t* client, const char* channel, const char* symbol,
+                                 const char* coin, const char* interval, const char* subscription,
+                                 hl_ws_payload_t payload,
+                                 hl_ws_data_callback_t callback, void* user_data) {
+    hl_client_ws_extension_t* ws_ext = (hl_client_ws_extension_t*)client->ws_extension;
+    if (!ws_ext) return NULL;
+
+    // Register first so a reconnect racing with this call still replays it
+    pthread_mutex_lock(&ws_ext->mutex);
+    bool offline = ws_ext->offline;
+    hl_ws_hub_t* hub = offline ? NULL : ws_ext->hub;
+    hl_ws_subscription_t* sub = add_subscription(ws_ext, channel, symbol, coin, interval,
+                                                 subscription, payload, callback, user_data);
+    bool needs_send = false;
+    if (sub) {
+        sub->shared = hub && ws_hub_is_public(subscription);
+        // Another entry already holds this server subscription
+        needs_send = !sub->shared && !own_subscription_in_use(ws_ext, subscription, sub);
+    }
+    pthread_mutex_unlock(&ws_ext->mutex);
+    if (!sub) return NULL;
+
+    bool ok;
+    if (offline) {
+        // Sent by the connect handler once the client goes online
+        ok = true;
+    } else if (sub->shared) {
+        ok = ws_hub_ref(hub, subscription);
+    } else if (hl_ws_client_is_connected(ws_ext->ws_client)) {
+        char subscription_msg[WS_REQUEST_SIZE];
+        snprintf(subscription_msg, sizeof(subscription_msg),
+                 "{\"method\":\"subscribe\",\"subscription\":%s}", subscription);
+        const char* messages[1] = { subscription_msg };
+
+        // A failed send is retried by the replay if the connection comes back
+        ok = !needs_send || pacer_send(&ws_ext->pacer, ws_ext->ws_client, messages, 1) ||
+             ws_ext->ws_client->config.auto_reconnect;
+    } else {
+        // Connect handler sends the whole registry, including this entry
+        ok = hl_ws_client_connect(ws_ext->ws_client);
+    }
+
+    if (!ok) {
+        pthread_mutex_lock(&ws_ext->mutex);
+        sub->active = false;
+        pthread_mutex_unlock(&ws_ext->mutex);
+        return NULL;
+    }
+
+    return sub->subscription_id;
+}
+
+/**
+ * @brief Topic of a subscription group, resolved to its server subscription
+ */
+typedef struct {
+    const char* channel;
+    const char* symbol;
+    const char* interval;
+    char coin[32];
+    char subscription[256];
+} ws_topic_spec_t;
+
+static void topic_resolve(const char* channel, const char* symbol, const char* interval,
+                          ws_topic_spec_t* spec) {
+    memset(spec, 0, sizeof(*spec));
+    spec->channel = channel;
+    spec->symbol = symbol;
+    spec->interval = interval;
+
+    if (!symbol) {
+        snprintf(spec->subscription, sizeof(spec->subscription), "{\"type\":\"%s\"}", channel);
+        return;
+    }
+
+    hl_symbol_to_coin(symbol, spec->coin, sizeof(spec->coin));
+    if (interval) {
+        snprintf(spec->subscription, sizeof(spec->subscription),
+                 "{\"type\":\"%s\",\"coin\":\"%s\",\"interval\":\"%s\"}",
+                 channel, spec->coin, interval);
+    } else {
+        snprintf(spec->subscription, sizeof(spec->subscription),
+                 "{\"type\":\"%s\",\"coin\":\"%s\"}", channel, spec->coin);
+    }
+}
+
+/**
+ * @brief Make the entries registered under @p group_id match @p topics
+ *
+ * Entries no longer wanted are removed and new topics added; topics already
+ * subscribed are left alone. Only server subscriptions that appear or
+ * disappear are sent, unsubscribes first, in paced batches. Shared topics
+ * go through the attached hub. Removed entries of a subscription set
+ * (@p set_member) are freed; nothing outside the set refers to them.
+ */
+static hl_error_t ws_sync_group(hl_client_ws_extension_t* ws_ext, const char* group_id,
+                                bool set_member, const ws_topic_spec_t* topics, size_t count,
+                                hl_ws_data_callback_t callback, void* user_data,
+                                size_t* subscribed, size_t* unsubscribed) {
+    ws_requests_t subscribes = {0};
+    ws_requests_t unsubscribes = {0};
+    ws_requests_t hub_adds = {0};
+    ws_requests_t hub_drops = {0};
+    ws_requests_t backup_drops = {0};
+    hl_ws_subscription_t** fresh = count ? calloc(count, sizeof(hl_ws_subscription_t*)) : NULL;
+    hl_ws_topic_ref_t* wanted = count ? calloc(count, sizeof(hl_ws_topic_ref_t)) : NULL;
+    hl_ws_subscription_t** members = NULL;
+    hl_ws_topic_ref_t* current = NULL;
+    size_t member_count = 0;
+    size_t added = 0;
+    size_t removed = 0;
+    size_t own_active = 0;
+    hl_error_t err = HL_SUCCESS;
+
+    if (count && (!fresh || !wanted)) {
+        free(fresh);
+        free(wanted);
+        return HL_ERROR_MEMORY;
+    }
+    for (size_t t = 0; t < count; t++) {
+        wanted[t].subscription = topics[t].subscription;
+    }
+
+    pthread_mutex_lock(&ws_ext->mutex);
+    bool offline = ws_ext->offline;
+    hl_ws_hub_t* hub = offline ? NULL : ws_ext->hub;
+
+    members = calloc(ws_ext->subscription_count + 1, sizeof(hl_ws_subscription_t*));
+    current = calloc(ws_ext->subscription_count + 1, sizeof(hl_ws_topic_ref_t));
+    if (!members || !current) {
+        pthread_mutex_unlock(&ws_ext->mutex);
+        free(members);
+        free(current);
+        free(wanted);
+        free(fresh);
+        return HL_ERROR_MEMORY;
+    }
+    for (size_t i = 0; i < ws_ext->subscription_count; i++) {
+        hl_ws_subscription_t* sub = ws_ext->subscriptions[i];
+        if (!sub->active || strcmp(sub->subscription_id, group_id) != 0) continue;
+        members[member_count] = sub;
+        current[member_count++].subscription = sub->subscription;
+    }
+    hl_ws_topic_diff(current, member_count, wanted, count, NULL, NULL);
+
+    for (size_t m = 0; m < member_count; m++) {
+        hl_ws_subscription_t* sub = members[m];
+        if (!current[m].changed) continue;
+
+        sub->active = false;
+        removed++;
+        if (sub->shared) {
+            requests_push(&hub_drops, NULL, sub->subscription);
+        } else if (!own_subscription_in_use(ws_ext, sub->subscription, NULL)) {
+            requests_push(&unsubscribes, "unsubscribe", sub->subscription);
+        }
+        if (sub->redundant) {
+            sub->redundant = false;
+            if (!redundant_subscription_in_use(ws_ext, sub->subscription, NULL)) {
+                requests_push(&backup_drops, "unsubscribe", sub->subscription);
+            }
+        }
+    }
+
+    for (size_t t = 0; t < count; t++) {
+        const ws_topic_spec_t* topic = &topics[t];
+        if (!wanted[t].changed) continue;
+
+        hl_ws_payload_t payload = strcmp(topic->channel, "bbo") == 0 ? HL_WS_PAYLOAD_BBO
+                                                                     : HL_WS_PAYLOAD_MESSAGE;
+        hl_ws_subscription_t* sub = add_subscription(ws_ext, topic->channel, topic->symbol,
+                                                     topic->coin[0] ? topic->coin : NULL,
+                                                     topic->interval, topic->subscription,
+                                                     payload, callback, user_data);
+        if (!sub) {
+            err = HL_ERROR_MEMORY;
+            break;
+        }
+        lv3_string_copy(sub->subscription_id, group_id, sizeof(sub->subscription_id));
+        sub->set_member = set_member;
+        sub->shared = hub && ws_hub_is_public(sub->subscription);
+        fresh[added++] = sub;
+
+        if (sub->shared) {
+            requests_push(&hub_adds, NULL, sub->subscription);
+        } else if (!own_subscription_in_use(ws_ext, sub->subscription, sub)) {
+            requests_push(&subscribes, "subscribe", sub->subscription);
+        }
+    }
+
+    for (size_t i = 0; i < ws_ext->subscription_count; i++) {
+        const hl_ws_subscription_t* sub = ws_ext->subscriptions[i];
+        if (sub->active && !sub->shared) own_active++;
+    }
+    if (set_member && removed > 0) {
+        compact_subscriptions(ws_ext);
+    }
+    pthread_mutex_unlock(&ws_ext->mutex);
+
+    if (own_active > HL_WS_MAX_SUBSCRIPTIONS) {
+        HL_LOG_WARN("WS: %zu subscriptions registered, server allows %d per connection",
+                    own_active, HL_WS_MAX_SUBSCRIPTIONS);
+    }
+
+    bool own_failed = false;
+    bool hub_failed = false;
+    backup_send(ws_ext, &backup_drops);
+    if (!offline) {
+        if (hl_ws_client_is_connected(ws_ext->ws_client)) {
+            // Failed sends are retried by the replay if the connection comes back
+            requests_send(&unsubscribes, &ws_ext->pacer, ws_ext->ws_client);
+            requests_send(&subscribes, &ws_ext->pacer, ws_ext->ws_client);
+        } else if (subscribes.count > 0) {
+            // Connect handler sends the whole registry, including these entries
+            own_failed = !hl_ws_client_connect(ws_ext->ws_client);
+        }
+
+        if (hub && hub_drops.count > 0) {
+            const char** list = requests_list(&hub_drops);
+            if (list) ws_hub_unref_many(hub, list, hub_drops.count);
+            free(list);
+        }
+        if (hub && hub_adds.count > 0) {
+            const char** list = requests_list(&hub_adds);
+            hub_failed = !list || !ws_hub_ref_many(hub, list, hub_adds.count);
+            free(list);
+        }
+    }
+
+    if (own_failed || hub_failed) {
+        size_t kept = 0;
+        pthread_mutex_lock(&ws_ext->mutex);
+        for (size_t i = 0; i < added; i++) {
+            if (fresh[i]->shared ? hub_failed : own_failed) {
+                fresh[i]->active = false;
+            } else {
+                kept++;
+            }
+        }
+        if (set_member) {
+            compact_subscriptions(ws_ext);
+        }
+        pthread_mutex_unlock(&ws_ext->mutex);
+        added = kept;
+        err = HL_ERROR_NETWORK;
+    }
+
+    if (subscribed) *subscribed = added;
+    if (unsubscribed) *unsubscribed = removed;
+
+    free(members);
+    free(current);
+    free(wanted);
+    free(fresh);
+    requests_free(&subscribes);
+    requests_free(&unsubscribes);
+    requests_free(&hub_adds);
+    requests_free(&hub_drops);
+    requests_free(&backup_drops);
+    return err;
+}
+
+/**
+ * @brief Initialize WebSocket for client
+ */
+bool hl_ws_init_client(hl_client_t* client, bool testnet) {
+    if (!client) return false;
+
+    // Create WebSocket extension
+    hl_client_ws_extension_t* ws_ext = calloc(1, sizeof(hl_client_ws_extension_t));
+    if (!ws_ext) return false;
+
+    pthread_mutexattr_t attr;
+    pthread_mutexattr_init(&attr);
+    pthread_mutexattr_settype(&attr, PTHREAD_MUTEX_RECURSIVE);
+    int rc = pthread_mutex_init(&ws_ext->mutex, &attr);
+    pthread_mutexattr_destroy(&attr);
+    if (rc != 0) {
+        free(ws_ext);
+        return false;
+    }
+    if (pthread_mutex_init(&ws_ext->post_mutex, NULL) != 0) {
+        pthread_mutex_destroy(&ws_ext->mutex);
+        free(ws_ext);
+        return false;
+    }
+    if (pthread_cond_init(&ws_ext->post_cond, NULL) != 0) {
+        pthread_mutex_destroy(&ws_ext->post_mutex);
+        pthread_mutex_destroy(&ws_ext->mutex);
+        free(ws_ext);
+        return false;
+    }
+    if (!pacer_init(&ws_ext->pacer)) {
+        pthread_cond_destroy(&ws_ext->post_cond);
+        pthread_mutex_destroy(&ws_ext->post_mutex);
+        pthread_mutex_destroy(&ws_ext->mutex);
+        free(ws_ext);
+        return false;
+    }
+    ws_ext->next_post_id = 1;
+    ws_ext->client = client;
+
+    // Create WebSocket client
+    hl_ws_config_t config;
+    hl_ws_config_default(&config, testnet);
+    config.max_reconnect_attempts = 0;
+
+    ws_ext->ws_client = hl_ws_client_create(&config);
+    if (!ws_ext->ws_client) {
+        pthread_mutex_destroy(&ws_ext->pacer.mutex);
+        pthread_cond_destroy(&ws_ext->post_cond);
+        pthread_mutex_destroy(&ws_ext->post_mutex);
+        pthread_mutex_destroy(&ws_ext->mutex);
+        free(ws_ext);
+        return false;
+    }
+
+    // Store extension before any callback can fire
+    client->ws_extension = ws_ext;
+
+    // Set callbacks
+    hl_ws_client_set_message_callback(ws_ext->ws_client, ws_message_handler, client);
+    hl_ws_client_set_error_callback(ws_ext->ws_client, ws_error_handler, client);
+    hl_ws_client_set_connect_callback(ws_ext->ws_client, ws_connect_handler, client);
+    hl_ws_client_set_disconnect_callback(ws_ext->ws_client, ws_disconnect_handler, client);
+
+    return true;
+}
+
+/**
+ * @brief Cleanup WebSocket for client
+ */
+void hl_ws_cleanup_client(hl_client_t* client) {
+    if (!client || !client->ws_extension) return;
+
+    hl_client_ws_extension_t* ws_ext = (hl_client_ws_extension_t*)client->ws_extension;
+
+    // Once detached, the hub's I/O thread no longer routes to this client
+    if (ws_ext->hub) {
+        ws_hub_detach(ws_ext->hub, ws_ext);
+    }
+
+    // Disconnect and destroy WebSocket client (joins the I/O thread)
+    if (ws_ext->ws_client) {
+        hl_ws_client_disconnect(ws_ext->ws_client);
+        hl_ws_client_destroy(ws_ext->ws_client);
+    }
+    if (ws_ext->backup) {
+        hl_ws_client_disconnect(ws_ext->backup);
+        hl_ws_client_destroy(ws_ext->backup);
+        pthread_mutex_destroy(&ws_ext->backup_pacer.mutex);
+        hl_ws_feed_arbiter_free(&ws_ext->feed);
+    }
+    hl_ws_recorder_close(ws_ext->recorder);
+
+    // Free subscriptions
+    for (size_t i = 0; i < ws_ext->subscription_count; i++) {
+        free(ws_ext->subscriptions[i]);
+    }
+    free(ws_ext->subscriptions);
+    fail_pending_posts(ws_ext, "WebSocket closed");
+    pthread_mutex_destroy(&ws_ext->pacer.mutex);
+    pthread_cond_destroy(&ws_ext->post_cond);
+    pthread_mutex_destroy(&ws_ext->post_mutex);
+    pthread_mutex_destroy(&ws_ext->mutex);
+    free(ws_ext);
+
+    client->ws_extension = NULL;
+}
+
+/**
+ * @brief Set resync callback
+ */
+void hl_ws_set_resync_callback(hl_client_t* client,
+                               hl_ws_resync_callback_t callback,
+                               void* user_data) {
+    if (!client || !client->ws_extension) return;
+
+    hl_client_ws_extension_t* ws_ext = (hl_client_ws_extension_t*)client->ws_extension;
+
+    pthread_mutex_lock(&ws_ext->mutex);
+    ws_ext->on_resync = callback;
+    ws_ext->resync_user_data = user_data;
+    pthread_mutex_unlock(&ws_ext->mutex);
+}
+
+/**
+ * @brief Check whether a subscription is waiting for a fresh snapshot
+ */
+bool hl_ws_is_stale(hl_client_t* client, const char* subscription_id) {
+    if (!client || !subscription_id || !client->ws_extension) return false;
+
+    hl_client_ws_extension_t* ws_ext = (hl_client_ws_extension_t*)client->ws_extension;
+    bool stale = false;
+
+    pthread_mutex_lock(&ws_ext->mutex);
+    for (size_t i = 0; i < ws_ext->subscription_count && !stale; i++) {
+        const hl_ws_subscription_t* sub = ws_ext->subscriptions[i];
+        stale = sub->active && sub->stale && strcmp(sub->subscription_id, subscription_id) == 0;
+    }
+    pthread_mutex_unlock(&ws_ext->mutex);
+
+    return stale;
+}
+
+/**
+ * @brief Get connection timing statistics
+ */
+bool hl_ws_get_stats(hl_client_t* client, hl_ws_stats_t* stats) {
+    if (!client || !stats || !client->ws_extension) return false;
+
+    hl_client_ws_extension_t* ws_ext = (hl_client_ws_extension_t*)client->ws_extension;
+    return hl_ws_client_get_stats(ws_ext->ws_client, stats);
+}
+
+/**
+ * @brief Enable permessage-deflate for the client's WebSocket
+ */
+void hl_ws_set_compression(hl_client_t* client, bool enable, bool no_context_takeover) {
+    if (!client || !client->ws_extension) return;
+
+    hl_client_ws_extension_t* ws_ext = (hl_client_ws_extension_t*)client->ws_extension;
+    hl_ws_client_set_compression(ws_ext->ws_client, enable, no_context_takeover);
+}
+
+/**
+ * @brief Enable busy-poll receive mode for the client's WebSocket
+ */
+void hl_ws_set_busy_poll(hl_client_t* client, bool enable, int cpu, int busy_poll_us) {
+    if (!client || !client->ws_extension) return;
+
+    hl_client_ws_extension_t* ws_ext = (hl_client_ws_extension_t*)client->ws_extension;
+    hl_ws_client_set_busy_poll(ws_ext->ws_client, enable, cpu, busy_poll_us);
+}
+
+/**
+ * @brief Select the receive loop of the client's WebSocket
+ */
+void hl_ws_set_io_backend(hl_client_t* client, hl_ws_io_backend_t backend) {
+    if (!client || !client->ws_extension) return;
+
+    hl_client_ws_extension_t* ws_ext = (hl_client_ws_extension_t*)client->ws_extension;
+    hl_ws_client_set_io_backend(ws_ext->ws_client, backend);
+}
+
+/**
+ * @brief Start recording the client's WebSocket stream
+ */
+hl_error_t hl_ws_record_start(hl_client_t* client, const char* path, bool compress) {
+    if (!client || !path) return HL_ERROR_INVALID_PARAMS;
+    if (!client->ws_extension) return HL_ERROR_INVALID_PARAMS;
+
+    hl_client_ws_extension_t* ws_ext = (hl_client_ws_extension_t*)client->ws_extension;
+
+    hl_ws_recorder_t* recorder = hl_ws_recorder_open(path, compress);
+    if (!recorder) return HL_ERROR_INVALID_PARAMS;
+
+    pthread_mutex_lock(&ws_ext->mutex);
+    hl_ws_recorder_t* previous = ws_ext->recorder;
+    ws_ext->recorder = recorder;
+    pthread_mutex_unlock(&ws_ext->mutex);
+
+    // The transport writes under its own lock, so the old file is idle after this
+    hl_ws_client_set_recorder(ws_ext->ws_client, recorder);
+    hl_ws_recorder_close(previous);
+
+    return HL_SUCCESS;
+}
+
+/**
+ * @brief Stop recording
+ */
+void hl_ws_record_stop(hl_client_t* client) {
+    if (!client || !client->ws_extension) return;
+
+    hl_client_ws_extension_t* ws_ext = (hl_client_ws_extension_t*)client->ws_extension;
+
+    hl_ws_client_set_recorder(ws_ext->ws_client, NULL);
+
+    pthread_mutex_lock(&ws_ext->mutex);
+    hl_ws_recorder_t* recorder = ws_ext->recorder;
+    ws_ext->recorder = NULL;
+    pthread_mutex_unlock(&ws_ext->mutex);
+
+    hl_ws_recorder_close(recorder);
+}
+
+/**
+ * @brief Register subscriptions without connecting
+ */
+void hl_ws_set_offline(hl_client_t* client, bool offline) {
+    if (!client || !client->ws_extension) return;
+
+    hl_client_ws_extension_t* ws_ext = (hl_client_ws_extension_t*)client->ws_extension;
+
+    pthread_mutex_lock(&ws_ext->mutex);
+    ws_ext->offline = offline;
+    pthread_mutex_unlock(&ws_ext->mutex);
+}
+
+/**
+ * @brief Replay a capture file through the client's dispatch
+ */
+hl_error_t hl_ws_replay(hl_client_t* client, const char* path, double speed, uint64_t* delivered) {
+    if (delivered) *delivered = 0;
+    if (!client || !path) return HL_ERROR_INVALID_PARAMS;
+    if (!client->ws_extension) return HL_ERROR_INVALID_PARAMS;
+
+    hl_client_ws_extension_t* ws_ext = (hl_client_ws_extension_t*)client->ws_extension;
+
+    hl_ws_replay_t* replay = hl_ws_replay_open(path);
+    if (!replay) return HL_ERROR_PARSE;
+
+    void* context[2] = { ws_ext, replay };
+    uint64_t count = hl_ws_replay_run(replay, speed, ws_replay_handler, context);
+    hl_ws_replay_close(replay);
+
+    if (delivered) *delivered = count;
+    return HL_SUCCESS;
+}
+
+/**
+ * @brief Current time on the exchange clock
+ */
+int64_t hl_ws_server_time_ms(hl_client_t* client) {
+    hl_client_ws_extension_t* ws_ext = client ? (hl_client_ws_extension_t*)client->ws_extension : NULL;
+    return hl_ws_client_server_time_ms(ws_ext ? ws_ext->ws_client : NULL);
+}
+
+/**
+ * @brief Watch ticker updates
+ */
+const char* hl_watch_ticker(hl_client_t* client, const char* symbol,
+                           hl_ws_data_callback_t callback, void* user_data) {
+    if (!client || !symbol || !callback) return NULL;
+
+    char coin[32];
+    hl_symbol_to_coin(symbol, coin, sizeof(coin));
+
+    // Subscribe to ticker channel
+    char subscription[256];
+    snprintf(subscription, sizeof(subscription),
+             "{\"type\":\"ticker\",\"coin\":\"%s\"}", coin);
+
+    return watch_channel(client, "ticker", symbol, strcmp(coin, "*") == 0 ? NULL : coin,
+                         NULL, subscription, HL_WS_PAYLOAD_MESSAGE, callback, user_data);
+}
+
+/**
+ * @brief Watch multiple tickers
+ */
+const char* hl_watch_tickers(hl_client_t* client, const char** symbols, size_t symbols_count,
+                            hl_ws_data_callback_t callback, void* user_data) {
+    if (!client || !callback) return NULL;
+
+    if (!symbols || symbols_count == 0) {
+        return hl_watch_ticker(client, "*", callback, user_data);
+    }
+
+    hl_client_ws_extension_t* ws_ext = (hl_client_ws_extension_t*)client->ws_extension;
+    if (!ws_ext) return NULL;
+
+    ws_topic_spec_t* topics = calloc(symbols_count, sizeof(ws_topic_spec_t));
+    if (!topics) return NULL;
+    for (size_t i = 0; i < symbols_count; i++) {
+        if (!symbols[i]) {
+            free(topics);
+            return NULL;
+        }
+        topic_resolve("ticker", symbols[i], NULL, &topics[i]);
+    }
+
+    // One ID for the whole group so hl_unwatch drops every symbol
+    char group_id[37];
+    generate_subscription_id(group_id, sizeof(group_id));
+    size_t subscribed = 0;
+    hl_error_t err = ws_sync_group(ws_ext, group_id, false, topics, symbols_count,
+                                   callback, user_data, &subscribed, NULL);
+    free(topics);
+    if (err != HL_SUCCESS || subscribed == 0) {
+        hl_unwatch(client, group_id);
+        return NULL;
+    }
+
+    const char* id = NULL;
+    pthread_mutex_lock(&ws_ext->mutex);
+    for (size_t i = 0; i < ws_ext->subscription_count && !id; i++) {
+        const hl_ws_subscription_t* sub = ws_ext->subscriptions[i];
+        if (sub->active && strcmp(sub->subscription_id, group_id) == 0) {
+            id = sub->subscription_id;
+        }
+    }
+    pthread_mutex_unlock(&ws_ext->mutex);
+
+    return id;
+}
+
+/**
+ * @brief Load markets once so coins can be mapped to asset IDs
+ */
+static void ensure_markets(hl_client_t* client, hl_client_ws_extension_t* ws_ext) {
+    pthread_mutex_lock(&ws_ext->mutex);
+    bool offline = ws_ext->offline;
+    pthread_mutex_unlock(&ws_ext->mutex);
+
+    if (client->mids && !client->markets && !offline) {
+        hl_error_t err = hl_client_load_markets(client);
+        if (err != HL_SUCCESS) {
+            HL_LOG_WARN("Markets unavailable (error %d); asset IDs stay unbound", err);
+        }
+    }
+}
+
+/**
+ * @brief Watch mid prices of all assets
+ */
+const char* hl_watch_all_mids(hl_client_t* client, hl_ws_data_callback_t callback, void* user_data) {
+    if (!client || !client->ws_extension) return NULL;
+
+    hl_client_ws_extension_t* ws_ext = (hl_client_ws_extension_t*)client->ws_extension;
+
+    ensure_markets(client, ws_ext);
+
+    return watch_channel(client, "allMids", NULL, NULL, NULL, "{\"type\":\"allMids\"}",
+                         HL_WS_PAYLOAD_MESSAGE, callback, user_data);
+}
+
+/**
+ * @brief Stream one coin's asset context into the market registry
+ */
+const char* hl_watch_asset_ctx(hl_client_t* client, const char* symbol,
+                               hl_ws_data_callback_t callback, void* user_data) {
+    if (!client || !symbol || !client->ws_extension) return NULL;
+
+    hl_client_ws_extension_t* ws_ext = (hl_client_ws_extension_t*)client->ws_extension;
+    ensure_markets(client, ws_ext);
+
+    char coin[32];
+    hl_symbol_to_coin(symbol, coin, sizeof(coin));
+
+    char subscription[256];
+    snprintf(subscription, sizeof(subscription),
+             "{\"type\":\"activeAssetCtx\",\"coin\":\"%s\"}", coin);
+
+    return watch_channel(client, "activeAssetCtx", symbol, coin, NULL, subscription,
+                         HL_WS_PAYLOAD_MESSAGE, callback, user_data);
+}
+
+/**
+ * @brief Stream asset contexts of every perpetual market
+ */
+size_t hl_watch_asset_ctxs(hl_client_t* client, hl_ws_data_callback_t callback, void* user_data) {
+    if (!client || !client->ws_extension) return 0;
+
+    hl_client_ws_extension_t* ws_ext = (hl_client_ws_extension_t*)client->ws_extension;
+    ensure_markets(client, ws_ext);
+
+    // Copy symbols out; another thread may reload markets while we subscribe
+    pthread_mutex_lock(&client->markets_mutex);
+    size_t count = client->markets ? client->markets->count : 0;
+    char (*symbols)[64] = count ? calloc(count, sizeof(*symbols)) : NULL;
+    size_t swaps = 0;
+    for (size_t i = 0; symbols && i < count; i++) {
+        const hl_market_t* market = &client->markets->markets[i];
+        if (market->type == HL_MARKET_SWAP) {
+            lv3_string_copy(symbols[swaps++], market->symbol, sizeof(symbols[0]));
+        }
+    }
+    pthread_mutex_unlock(&client->markets_mutex);
+
+    size_t watched = 0;
+    for (size_t i = 0; i < swaps; i++) {
+        if (hl_watch_asset_ctx(client, symbols[i], callback, user_data)) {
+            watched++;
+        }
+    }
+    free(symbols);
+
+    return watched;
+}
+
+/**
+ * @brief Watch best bid and ask
+ */
+const char* hl_watch_bbo(hl_client_t* client, const char* symbol, hl_bbo_source_t source,
+                         hl_ws_data_callback_t callback, void* user_data) {
+    if (!client || !symbol || !callback || !client->ws_extension) return NULL;
+
+    hl_client_ws_extension_t* ws_ext = (hl_client_ws_extension_t*)client->ws_extension;
+    ensure_markets(client, ws_ext);
+
+    char coin[32];
+    hl_symbol_to_coin(symbol, coin, sizeof(coin));
+
+    const char* channel = source == HL_BBO_SOURCE_L2BOOK ? "l2Book" : "bbo";
+    char subscription[256];
+    snprintf(subscription, sizeof(subscription),
+             "{\"type\":\"%s\",\"coin\":\"%s\"}", channel, coin);
+
+    return watch_channel(client, channel, symbol, coin, NULL, subscription,
+                         HL_WS_PAYLOAD_BBO, callback, user_data);
+}
+
+/**
+ * @brief Watch order book updates
+ */
+const char* hl_watch_order_book(hl_client_t* client, const char* symbol, uint32_t depth,
+                               hl_ws_data_callback_t callback, void* user_data) {
+    (void)depth;
+    if (!client || !symbol || !callback) return NULL;
+
+    char coin[32];
+    hl_symbol_to_coin(symbol, coin, sizeof(coin));
+
+    // Subscribe to order book channel
+    char subscription[256];
+    snprintf(subscription, sizeof(subscription),
+             "{\"type\":\"l2Book\",\"coin\":\"%s\"}", coin);
+
+    return watch_channel(client, "l2Book", symbol, coin, NULL, subscription,
+                         HL_WS_PAYLOAD_MESSAGE, callback, user_data);
+}
+
+/**
+ * @brief Watch OHLCV updates
+ */
+const char* hl_watch_ohlcv(hl_client_t* client, const char* symbol, const char* timeframe,
+                          hl_ws_data_callback_t callback, void* user_data) {
+    if (!client || !symbol || !timeframe || !callback) return NULL;
+
+    char coin[32];
+    hl_symbol_to_coin(symbol, coin, sizeof(coin));
+
+    // Subscribe to candle channel
+    char subscription[256];
+    snprintf(subscription, sizeof(subscription),
+             "{\"type\":\"candle\",\"coin\":\"%s\",\"interval\":\"%s\"}",
+             coin, timeframe);
+
+    return watch_channel(client, "candle", symbol, coin, timeframe, subscription,
+                         HL_WS_PAYLOAD_MESSAGE, callback, user_data);
+}
+
+/**
+ * @brief Watch trades
+ */
+const char* hl_watch_trades(hl_client_t* client, const char* symbol,
+                           hl_ws_data_callback_t callback, void* user_data) {
+    if (!client || !symbol || !callback) return NULL;
+
+    char coin[32];
+    hl_symbol_to_coin(symbol, coin, sizeof(coin));
+
+    // Subscribe to trades channel
+    char subscription[256];
+    snprintf(subscription, sizeof(subscription),
+             "{\"type\":\"trades\",\"coin\":\"%s\"}", coin);
+
+    return watch_channel(client, "trades", symbol, coin, NULL, subscription,
+                         HL_WS_PAYLOAD_MESSAGE, callback, user_data);
+}
+
+/**
+ * @brief Watch user orders
+ */
+const char* hl_watch_orders(hl_client_t* client, const char* symbol,
+                           hl_ws_data_callback_t callback, void* user_data) {
+    if (!client || !callback) return NULL;
+
+    // Subscribe to user orders channel
+    const char* user_address = hl_client_get_wallet_address_old(client);
+    if (!user_address) return NULL;
+
+    char subscription[256];
+    snprintf(subscription, sizeof(subscription),
+             "{\"type\":\"orderUpdates\",\"user\":\"%s\"}", user_address);
+
+    return watch_channel(client, "orderUpdates", symbol, NULL, NULL, subscription,
+                         HL_WS_PAYLOAD_MESSAGE, callback, user_data);
+}
+
+/**
+ * @brief Watch user trades
+ */
+const char* hl_watch_my_trades(hl_client_t* client, const char* symbol,
+                              hl_ws_data_callback_t callback, void* user_data) {
+    if (!client || !callback) return NULL;
+
+    // Subscribe to user fills channel
+    const char* user_address = hl_client_get_wallet_address_old(client);
+    if (!user_address) return NULL;
+
+    char subscription[256];
+    snprintf(subscription, sizeof(subscription),
+             "{\"type\":\"userFills\",\"user\":\"%s\"}", user_address);
+
+    return watch_channel(client, "userFills", symbol, NULL, NULL, subscription,
+                         HL_WS_PAYLOAD_MESSAGE, callback, user_data);
+}
+
+/**
+ * @brief Unwatch subscription
+ */
+bool hl_unwatch(hl_client_t* client, const char* subscription_id) {
+    if (!client || !subscription_id || !client->ws_extension) return false;
+
+    hl_client_ws_extension_t* ws_ext = (hl_client_ws_extension_t*)client->ws_extension;
+    ws_requests_t unsubscribes = {0};
+    ws_requests_t hub_drops = {0};
+    ws_requests_t backup_drops = {0};
+    bool found = false;
+    bool set_member = false;
+
+    // Deactivate every entry of the ID (several for a group)
+    pthread_mutex_lock(&ws_ext->mutex);
+    hl_ws_hub_t* hub = ws_ext->hub;
+    for (size_t i = 0; i < ws_ext->subscription_count; i++) {
+        hl_ws_subscription_t* sub = ws_ext->subscriptions[i];
+        if (!sub->active || strcmp(sub->subscription_id, subscription_id) != 0) continue;
+
+        sub->active = false;
+        found = true;
+        set_member = set_member || sub->set_member;
+        if (sub->shared) {
+            requests_push(&hub_drops, NULL, sub->subscription);
+        } else if (!own_subscription_in_use(ws_ext, sub->subscription, NULL)) {
+            // The server identifies a subscription by its full object
+            requests_push(&unsubscribes, "unsubscribe", sub->subscription);
+        }
+        if (sub->redundant) {
+            sub->redundant = false;
+            if (!redundant_subscription_in_use(ws_ext, sub->subscription, NULL)) {
+                requests_push(&backup_drops, "unsubscribe", sub->subscription);
+            }
+        }
+    }
+    if (set_member) {
+        compact_subscriptions(ws_ext);
+    }
+    pthread_mutex_unlock(&ws_ext->mutex);
+
+    if (hl_ws_client_is_connected(ws_ext->ws_client)) {
+        requests_send(&unsubscribes, &ws_ext->pacer, ws_ext->ws_client);
+    }
+    backup_send(ws_ext, &backup_drops);
+    if (hub && hub_drops.count > 0) {
+        const char** list = requests_list(&hub_drops);
+        if (list) ws_hub_unref_many(hub, list, hub_drops.count);
+        free(list);
+    }
+
+    requests_free(&unsubscribes);
+    requests_free(&hub_drops);
+    requests_free(&backup_drops);
+    return found;
+}
+
+// ============================================================================
+// Subscription sets
+// ============================================================================
+
+struct hl_ws_sub_set {
+    hl_client_t* client;
+    hl_ws_data_callback_t callback;
+    void* user_data;
+    char id[37];                        /**< Subscription ID shared by every entry */
+};
+
+hl_ws_sub_set_t* hl_ws_sub_set_create(hl_client_t* client, hl_ws_data_callback_t callback,
+                                      void* user_data) {
+    if (!client || !callback || !client->ws_extension) return NULL;
+
+    hl_ws_sub_set_t* set = calloc(1, sizeof(hl_ws_sub_set_t));
+    if (!set) return NULL;
+
+    set->client = client;
+    set->callback = callback;
+    set->user_data = user_data;
+    generate_subscription_id(set->id, sizeof(set->id));
+    return set;
+}
+
+hl_error_t hl_ws_sub_set_apply(hl_ws_sub_set_t* set, const hl_ws_topic_t* topics, size_t count,
+                               size_t* subscribed, size_t* unsubscribed) {
+    if (!set || (count > 0 && !topics)) return HL_ERROR_INVALID_PARAMS;
+
+    hl_client_ws_extension_t* ws_ext = (hl_client_ws_extension_t*)set->client->ws_extension;
+    if (!ws_ext) return HL_ERROR_INVALID_PARAMS;
+
+    for (size_t i = 0; i < count; i++) {
+        const hl_ws_topic_t* topic = &topics[i];
+        if (!topic->channel || (topic->interval && !topic->symbol)) {
+            return HL_ERROR_INVALID_PARAMS;
+        }
+    }
+
+    ws_topic_spec_t* specs = count ? calloc(count, sizeof(ws_topic_spec_t)) : NULL;
+    if (count && !specs) return HL_ERROR_MEMORY;
+    for (size_t i = 0; i < count; i++) {
+        topic_resolve(topics[i].channel, topics[i].symbol, topics[i].interval, &specs[i]);
+    }
+
+    hl_error_t err = ws_sync_group(ws_ext, set->id, true, specs, count, set->callback,
+                                   set->user_data, subscribed, unsubscribed);
+    free(specs);
+    return err;
+}
+
+size_t hl_ws_sub_set_size(hl_ws_sub_set_t* set) {
+    if (!set || !set->client->ws_extension) return 0;
+
+    hl_client_ws_extension_t* ws_ext = (hl_client_ws_extension_t*)set->client->ws_extension;
+    size_t size = 0;
+
+    pthread_mutex_lock(&ws_ext->mutex);
+    for (size_t i = 0; i < ws_ext->subscription_count; i++) {
+        const hl_ws_subscription_t* sub = ws_ext->subscriptions[i];
+        if (sub->active && strcmp(sub->subscription_id, set->id) == 0) size++;
+    }
+    pthread_mutex_unlock(&ws_ext->mutex);
+
+    return size;
+}
+
+const char* hl_ws_sub_set_id(const hl_ws_sub_set_t* set) {
+    return set ? set->id : NULL;
+}
+
+void hl_ws_sub_set_destroy(hl_ws_sub_set_t* set) {
+    if (!set) return;
+
+    hl_unwatch(set->client, set->id);
+    free(set);
+}
+
+// ============================================================================
+// Redundant feeds
+// ============================================================================
+
+static void ws_backup_message_handler(const char* message, size_t size, void* user_data) {
+    hl_client_t* client = (hl_client_t*)user_data;
+    if (!client || !client->ws_extension) return;
+
+    hl_client_ws_extension_t* ws_ext = (hl_client_ws_extension_t*)client->ws_extension;
+    ws_inbound_t in;
+    inbound_init(&in, message, size, hl_ws_client_last_rx_time_ns(ws_ext->backup), true,
+                 ws_ext->backup);
+    route_message(ws_ext, &in);
+    inbound_free(&in);
+}
+
+/**
+ * @brief Replay every redundant subscription on the backup connection
+ */
+static void ws_backup_connect_handler(void* user_data) {
+    hl_client_t* client = (hl_client_t*)user_data;
+    if (!client || !client->ws_extension) return;
+
+    hl_client_ws_extension_t* ws_ext = (hl_client_ws_extension_t*)client->ws_extension;
+    ws_requests_t requests = {0};
+
+    pthread_mutex_lock(&ws_ext->mutex);
+    for (size_t i = 0; i < ws_ext->subscription_count; i++) {
+        const hl_ws_subscription_t* sub = ws_ext->subscriptions[i];
+        if (!sub->active || !sub->redundant) continue;
+
+        bool duplicate = false;
+        for (size_t j = 0; j < i && !duplicate; j++) {
+            const hl_ws_subscription_t* earlier = ws_ext->subscriptions[j];
+            duplicate = earlier->active && earlier->redundant &&
+                        strcmp(earlier->subscription, sub->subscription) == 0;
+        }
+        if (!duplicate) {
+            requests_push(&requests, "subscribe", sub->subscription);
+        }
+    }
+    hl_ws_client_t* backup = ws_ext->backup;
+    pthread_mutex_unlock(&ws_ext->mutex);
+
+    // Paced outside the registry lock, like the primary's replay
+    if (!requests_send(&requests, &ws_ext->backup_pacer, backup)) {
+        HL_LOG_DEBUG("WS BACKUP: failed to replay %zu subscriptions", requests.count);
+    }
+
+    requests_free(&requests);
+}
+
+static void ws_backup_disconnect_handler(const char* reason, void* user_data) {
+    (void)reason;
+    (void)user_data;
+    HL_LOG_DEBUG("WS BACKUP DISCONNECTED: %s", reason);
+}
+
+bool hl_ws_enable_dual_feed(hl_client_t* client, const char* backup_url) {
+    if (!client || !client->ws_extension) return false;
+
+    hl_client_ws_extension_t* ws_ext = (hl_client_ws_extension_t*)client->ws_extension;
+
+    pthread_mutex_lock(&ws_ext->mutex);
+    if (ws_ext->backup) {
+        pthread_mutex_unlock(&ws_ext->mutex);
+        return true;
+    }
+
+    // Same settings; without a URL of its own, prefer the next resolved address
+    hl_ws_config_t config = ws_ext->ws_client->config;
+    if (backup_url) {
+        config.url = backup_url;
+    } else {
+        config.address_index++;
+    }
+
+    hl_ws_feed_arbiter_t feed;
+    bool arbiter = hl_ws_feed_arbiter_init(&feed);
+    hl_ws_client_t* backup = arbiter ? hl_ws_client_create(&config) : NULL;
+    if (!backup || !pacer_init(&ws_ext->backup_pacer)) {
+        hl_ws_client_destroy(backup);
+        if (arbiter) hl_ws_feed_arbiter_free(&feed);
+        pthread_mutex_unlock(&ws_ext->mutex);
+        return false;
+    }
+
+    hl_ws_client_set_message_callback(backup, ws_backup_message_handler, client);
+    hl_ws_client_set_error_callback(backup, ws_error_handler, client);
+    hl_ws_client_set_connect_callback(backup, ws_backup_connect_handler, client);
+    hl_ws_client_set_disconnect_callback(backup, ws_backup_disconnect_handler, client);
+
+    ws_ext->feed = feed;
+    ws_ext->backup = backup;
+    atomic_store_explicit(&ws_ext->dual_feed, true, memory_order_release);
+    pthread_mutex_unlock(&ws_ext->mutex);
+
+    return true;
+}
+
+bool hl_ws_set_redundant(hl_client_t* client, const char* subscription_id, bool redundant) {
+    if (!client || !subscription_id || !client->ws_extension) return false;
+
+    hl_client_ws_extension_t* ws_ext = (hl_client_ws_extension_t*)client->ws_extension;
+    ws_requests_t requests = {0};
+    bool found = false;
+
+    pthread_mutex_lock(&ws_ext->mutex);
+    hl_ws_client_t* backup = ws_ext->backup;
+    for (size_t i = 0; backup && i < ws_ext->subscription_count; i++) {
+        hl_ws_subscription_t* sub = ws_ext->subscriptions[i];
+        if (!sub->active || strcmp(sub->subscription_id, subscription_id) != 0) continue;
+        if (sub->shared || !sub->coin[0] || !feed_channel_supported(sub->channel)) continue;
+
+        found = true;
+        if (sub->redundant == redundant) continue;
+
+        bool in_use = redundant_subscription_in_use(ws_ext, sub->subscription, sub);
+        sub->redundant = redundant;
+        if (!in_use) {
+            requests_push(&requests, redundant ? "subscribe" : "unsubscribe", sub->subscription);
+        }
+    }
+    pthread_mutex_unlock(&ws_ext->mutex);
+
+    bool ok = found;
+    if (found && hl_ws_client_is_connected(backup)) {
+        // A failed send is retried by the replay if the connection comes back
+        requests_send(&requests, &ws_ext->backup_pacer, backup);
+    } else if (found && redundant && requests.count > 0) {
+        // Connect handler sends every redundant entry
+        ok = hl_ws_client_connect(backup);
+        if (!ok) hl_ws_set_redundant(client, subscription_id, false);
+    }
+
+    requests_free(&requests);
+    return ok;
+}
+
+/**
+ * @brief Fill one feed's statistics, lag summarized like the connection's (registry lock held)
+ */
+static void feed_summarize(const hl_client_ws_extension_t* ws_ext, int feed,
+                           hl_ws_feed_stats_t* out) {
+    const hl_ws_feed_tally_t* tally = &ws_ext->feed.tally[feed];
+    hl_ws_client_t* conn = feed == 0 ? ws_ext->ws_client : ws_ext->backup;
+    uint64_t delivered = ws_ext->feed.tally[0].wins + ws_ext->feed.tally[1].wins;
+
+    memset(out, 0, sizeof(*out));
+    out->connected = hl_ws_client_is_connected(conn);
+    hl_ws_stats_t stats;
+    if (hl_ws_client_get_stats(conn, &stats)) {
+        memcpy(out->peer_address, stats.peer_address, sizeof(out->peer_address));
+    }
+    out->messages = tally->messages;
+    out->wins = tally->wins;
+    out->win_rate = delivered > 0 ? (double)tally->wins / (double)delivered : 0.0;
+
+    hl_ws_window_summarize(&tally->lag, &out->lag);
+}
+
+bool hl_ws_get_feed_stats(hl_client_t* client, hl_ws_feed_stats_t* primary,
+                          hl_ws_feed_stats_t* backup) {
+    if (!client || !client->ws_extension) return false;
+
+    hl_client_ws_extension_t* ws_ext = (hl_client_ws_extension_t*)client->ws_extension;
+
+    pthread_mutex_lock(&ws_ext->mutex);
+    bool ok = ws_ext->backup != NULL;
+    if (ok) {
+        if (primary) feed_summarize(ws_ext, 0, primary);
+        if (backup) feed_summarize(ws_ext, 1, backup);
+    }
+    pthread_mutex_unlock(&ws_ext->mutex);
+
+    return ok;
+}
+
+/**
+ * @brief Register a post request and send it
+ */
+static hl_error_t send_post(hl_client_ws_extension_t* ws_ext, const char* type, const char* payload,
+                            const ws_post_slot_t* request, uint64_t* request_id) {
+    if (!hl_ws_client_is_connected(ws_ext->ws_client) &&
+        !hl_ws_client_connect(ws_ext->ws_client)) {
+        return HL_ERROR_NETWORK;
+    }
+
+    size_t msg_size = strlen(payload) + 96;
+    char stack_msg[4096];
+    char* msg = msg_size <= sizeof(stack_msg) ? stack_msg : malloc(msg_size);
+    if (!msg) return HL_ERROR_MEMORY;
+
+    // Claim the slot before sending so a fast response always finds it
+    pthread_mutex_lock(&ws_ext->post_mutex);
+    uint64_t id = ws_ext->next_post_id++;
+    ws_post_slot_t* slot = &ws_ext->posts[id % HL_WS_MAX_PENDING_POSTS];
+    if (slot->in_use) {
+        pthread_mutex_unlock(&ws_ext->post_mutex);
+        if (msg != stack_msg) free(msg);
+        HL_LOG_DEBUG("WS: more than %d post requests in flight", HL_WS_MAX_PENDING_POSTS);
+        return HL_ERROR_API;
+    }
+    *slot = *request;
+    slot->id = id;
+    slot->in_use = true;
+    pthread_mutex_unlock(&ws_ext->post_mutex);
+
+    snprintf(msg, msg_size,
+             "{\"method\":\"post\",\"id\":%llu,\"request\":{\"type\":\"%s\",\"payload\":%s}}",
+             (unsigned long long)id, type, payload);
+
+    bool sent = hl_ws_client_send_text(ws_ext->ws_client, msg);
+    if (msg != stack_msg) free(msg);
+
+    if (!sent) {
+        ws_post_slot_t unused;
+        if (take_post(ws_ext, id, &unused)) {
+            return HL_ERROR_NETWORK;
+        }
+        // Already failed by the disconnect handler, which ran the callback
+    }
+
+    if (request_id) *request_id = id;
+    return HL_SUCCESS;
+}
+
+/**
+ * @brief Send post request
+ */
+hl_error_t hl_ws_post(hl_client_t* client, const char* type, const char* payload,
+                      hl_ws_post_callback_t callback, void* user_data,
+                      uint64_t* request_id) {
+    if (!client || !type || !payload || !callback) return HL_ERROR_INVALID_PARAMS;
+
+    hl_client_ws_extension_t* ws_ext = (hl_client_ws_extension_t*)client->ws_extension;
+    if (!ws_ext) return HL_ERROR_INVALID_PARAMS;
+
+    ws_post_slot_t request = {.kind = WS_POST_RAW, .user_data = user_data};
+    request.callback.raw = callback;
+
+    return send_post(ws_ext, type, payload, &request, request_id);
+}
+
+/**
+ * @brief Create order via WebSocket (non-blocking)
+ */
+hl_error_t hl_create_order_ws_async(hl_client_t* client,
+                                    const hl_order_request_api_t* request,
+                                    hl_ws_order_callback_t callback,
+                                    void* user_data) {
+    if (!client || !request || !callback) return HL_ERROR_INVALID_PARAMS;
+
+    hl_client_ws_extension_t* ws_ext = (hl_client_ws_extension_t*)client->ws_extension;
+    pthread_mutex_t* mutex = hl_client_get_mutex_old(client);
+    if (!ws_ext || !mutex) return HL_ERROR_INVALID_PARAMS;
+
+    char payload[4096];
+    char error[256];
+    pthread_mutex_lock(mutex);
+    hl_error_t err = hl_build_order_payload(client, request, payload, sizeof(payload),
+                                            error, sizeof(error));
+    pthread_mutex_unlock(mutex);
+    if (err != HL_SUCCESS) {
+        HL_LOG_DEBUG("WS order rejected locally: %s", error);
+        return err;
+    }
+
+    return hl_ws_post_order(client, payload, callback, user_data);
+}
+
+/**
+ * @brief Send a signed order payload as a post request
+ */
+hl_error_t hl_ws_post_order(hl_client_t* client, const char* payload,
+                            hl_ws_order_callback_t callback, void* user_data) {
+    if (!client || !payload || !callback) return HL_ERROR_INVALID_PARAMS;
+
+    hl_client_ws_extension_t* ws_ext = (hl_client_ws_extension_t*)client->ws_extension;
+    if (!ws_ext) return HL_ERROR_INVALID_PARAMS;
+
+    ws_post_slot_t post = {.kind = WS_POST_ORDER, .user_data = user_data};
+    post.callback.order = callback;
+
+    return send_post(ws_ext, "action", payload, &post, NULL);
+}
+
+/**
+ * @brief Cancel order via WebSocket (non-blocking)
+ */
+hl_error_t hl_cancel_order_ws_async(hl_client_t* client,
+                                    const char* symbol,
+                                    const char* order_id,
+                                    hl_ws_cancel_callback_t callback,
+                                    void* user_data) {
+    if (!client || !symbol || !order_id || !callback) return HL_ERROR_INVALID_PARAMS;
+
+    hl_client_ws_extension_t* ws_ext = (hl_client_ws_extension_t*)client->ws_extension;
+    pthread_mutex_t* mutex = hl_client_get_mutex_old(client);
+    if (!ws_ext || !mutex) return HL_ERROR_INVALID_PARAMS;
+
+    char payload[2048];
+    char error[256];
+    pthread_mutex_lock(mutex);
+    hl_error_t err = hl_build_cancel_payload(client, symbol, order_id, payload, sizeof(payload),
+                                             error, sizeof(error));
+    pthread_mutex_unlock(mutex);
+    if (err != HL_SUCCESS) {
+        HL_LOG_DEBUG("WS cancel rejected locally: %s", error);
+        return err;
+    }
+
+    ws_post_slot_t post = {.kind = WS_POST_CANCEL, .user_data = user_data};
+    post.callback.cancel = callback;
+
+    return send_post(ws_ext, "action", payload, &post, NULL);
+}
+
+// Waiter shared between a blocking call and its completion callback
+typedef struct {
+    hl_client_ws_extension_t* ws_ext;
+    bool done;
+    hl_error_t status;
+    hl_order_result_t* order_result;
+    hl_cancel_result_t* cancel_result;
+} ws_post_waiter_t;
+
+static void order_waiter_callback(hl_error_t status, const hl_order_result_t* result, void* user_data) {
+    ws_post_waiter_t* waiter = (ws_post_waiter_t*)user_data;
+
+    pthread_mutex_lock(&waiter->ws_ext->post_mutex);
+    *waiter->order_result = *result;
+    waiter->order_result->order_id = result->order_id ? strdup(result->order_id) : NULL;
+    waiter->status = status;
+    waiter->done = true;
+    pthread_cond_broadcast(&waiter->ws_ext->post_cond);
+    pthread_mutex_unlock(&waiter->ws_ext->post_mutex);
+}
+
+static void cancel_waiter_callback(hl_error_t status, const hl_cancel_result_t* result, void* user_data) {
+    ws_post_waiter_t* waiter = (ws_post_waiter_t*)user_data;
+
+    pthread_mutex_lock(&waiter->ws_ext->post_mutex);
+    *waiter->cancel_result = *result;
+    waiter->status = status;
+    waiter->done = true;
+    pthread_cond_broadcast(&waiter->ws_ext->post_cond);
+    pthread_mutex_unlock(&waiter->ws_ext->post_mutex);
+}
+
+/**
+ * @brief Wait for a blocking request's completion or its timeout
+ *
+ * A request that times out is withdrawn from its slot; if the I/O thread
+ * already took it, its callback is imminent and is waited for instead so
+ * the stack-allocated waiter is never touched after return.
+ */
+static hl_error_t wait_post(ws_post_waiter_t* waiter, uint64_t request_id) {
+    hl_client_ws_extension_t* ws_ext = waiter->ws_ext;
+    int timeout_ms = ws_ext->ws_client->config.timeout_ms;
+
+    struct timespec deadline;
+    clock_gettime(CLOCK_REALTIME, &deadline);
+    deadline.tv_sec += timeout_ms / 1000;
+    deadline.tv_nsec += (long)(timeout_ms % 1000) * 1000000L;
+    if (deadline.tv_nsec >= 1000000000L) {
+        deadline.tv_sec++;
+        deadline.tv_nsec -= 1000000000L;
+    }
+
+    pthread_mutex_lock(&ws_ext->post_mutex);
+    while (!waiter->done) {
+        if (pthread_cond_timedwait(&ws_ext->post_cond, &ws_ext->post_mutex, &deadline) == ETIMEDOUT) {
+            ws_post_slot_t* slot = &ws_ext->posts[request_id % HL_WS_MAX_PENDING_POSTS];
+            if (slot->in_use && slot->id == request_id) {
+                slot->in_use = false;
+                waiter->status = HL_ERROR_TIMEOUT;
+                break;
+            }
+            while (!waiter->done) {
+                pthread_cond_wait(&ws_ext->post_cond, &ws_ext->post_mutex);
+            }
+        }
+    }
+    pthread_mutex_unlock(&ws_ext->post_mutex);
+
+    return waiter->status;
+}
+
+/**
+ * @brief Create order via WebSocket (blocking)
+ */
+hl_error_t hl_create_order_ws(hl_client_t* client,
+                              const hl_order_request_api_t* request,
+                              hl_order_result_t* result) {
+    if (!client || !request || !result) return HL_ERROR_INVALID_PARAMS;
+
+    memset(result, 0, sizeof(hl_order_result_t));
+
+    hl_client_ws_extension_t* ws_ext = (hl_client_ws_extension_t*)client->ws_extension;
+    pthread_mutex_t* mutex = hl_client_get_mutex_old(client);
+    if (!ws_ext || !mutex) {
+        snprintf(result->error, sizeof(result->error), "WebSocket not initialized");
+        return HL_ERROR_INVALID_PARAMS;
+    }
+
+    char payload[4096];
+    pthread_mutex_lock(mutex);
+    hl_error_t err = hl_build_order_payload(client, request, payload, sizeof(payload),
+                                            result->error, sizeof(result->error));
+    pthread_mutex_unlock(mutex);
+    if (err != HL_SUCCESS) return err;
+
+    ws_post_waiter_t waiter = {.ws_ext = ws_ext, .order_result = result};
+    ws_post_slot_t post = {.kind = WS_POST_ORDER, .user_data = &waiter};
+    post.callback.order = order_waiter_callback;
+
+    uint64_t request_id = 0;
+    err = send_post(ws_ext, "action", payload, &post, &request_id);
+    if (err != HL_SUCCESS) {
+        snprintf(result->error, sizeof(result->error), "WebSocket send failed");
+        return err;
+    }
+
+    err = wait_post(&waiter, request_id);
+    if (err == HL_ERROR_TIMEOUT) {
+        snprintf(result->error, sizeof(result->error), "No response to order request");
+    }
+    return err;
+}
+
+/**
+ * @brief Cancel order via WebSocket (blocking)
+ */
+hl_error_t hl_cancel_order_ws(hl_client_t* client,
+                              const char* symbol,
+                              const char* order_id,
+                              hl_cancel_result_t* result) {
+    if (!client || !symbol || !order_id || !result) return HL_ERROR_INVALID_PARAMS;
+
+    memset(result, 0, sizeof(hl_cancel_result_t));
+
+    hl_client_ws_extension_t* ws_ext = (hl_client_ws_extension_t*)client->ws_extension;
+    pthread_mutex_t* mutex = hl_client_get_mutex_old(client);
+    if (!ws_ext || !mutex) {
+        snprintf(result->error, sizeof(result->error), "WebSocket not initialized");
+        return HL_ERROR_INVALID_PARAMS;
+    }
+
+    char payload[2048];
+    pthread_mutex_lock(mutex);
+    hl_error_t err = hl_build_cancel_payload(client, symbol, order_id, payload, sizeof(payload),
+                                             result->error, sizeof(result->error));
+    pthread_mutex_unlock(mutex);
+    if (err != HL_SUCCESS) return err;
+
+    ws_post_waiter_t waiter = {.ws_ext = ws_ext, .cancel_result = result};
+    ws_post_slot_t post = {.kind = WS_POST_CANCEL, .user_data = &waiter};
+    post.callback.cancel = cancel_waiter_callback;
+
+    uint64_t request_id = 0;
+    err = send_post(ws_ext, "action", payload, &post, &request_id);
+    if (err != HL_SUCCESS) {
+        snprintf(result->error, sizeof(result->error), "WebSocket send failed");
+        return err;
+    }
+
+    err = wait_post(&waiter, request_id);
+    if (err == HL_ERROR_TIMEOUT) {
+        snprintf(result->error, sizeof(result->error), "No response to cancel request");
+    }
+    return err;
 }
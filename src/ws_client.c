@@ -1,53 +1,1277 @@
 /**
  * @file ws_client.c
- * @brief WebSocket client implementation (basic framework)
+ * @brief WebSocket client implementation
+ *
+ * RFC 6455 client over plain TCP (ws://) or OpenSSL (wss://). The caller
+ * thread performs the initial connect and handshake; a background I/O thread
+ * then reads frames, answers pings, keeps the connection alive and, when
+ * auto_reconnect is enabled, reconnects with jittered exponential backoff.
+ * permessage-deflate (RFC 7692) is supported on the receive side.
+ *
+ * In busy-poll mode the I/O thread is pinned to a CPU and spins on
+ * non-blocking reads instead of sleeping in poll(), removing the scheduler
+ * wakeup from every delivered message at the cost of one core.
+ *
+ * With the io_uring backend the thread instead sleeps in io_uring_enter():
+ * a multishot receive keeps filling registered buffers, so one system call
+ * collects every read that completed since the last wakeup.
  */
 
+#define _GNU_SOURCE
+
 #include "hl_ws_client.h"
+#include "hl_internal.h"
+#include "hl_ws_record.h"
+#include "hl_ws_uring.h"
+#include "hl_logger.h"
 #include <stdlib.h>
 #include <string.h>
+#include <strings.h>
 #include <stdio.h>
+#include <errno.h>
+#include <time.h>
 #include <pthread.h>
+#include <sched.h>
+#include <stdatomic.h>
 #include <unistd.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <netdb.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <openssl/ssl.h>
+#include <openssl/err.h>
+#include <openssl/rand.h>
+#include <openssl/sha.h>
+#include <openssl/evp.h>
+#include <zlib.h>
+
+#define WS_OPCODE_CONTINUATION 0x0
+#define WS_OPCODE_TEXT         0x1
+#define WS_OPCODE_BINARY       0x2
+#define WS_OPCODE_CLOSE        0x8
+#define WS_OPCODE_PING         0x9
+#define WS_OPCODE_PONG         0xA
 
+#define WS_GUID "258EAFA5-E914-47DA-95CA-C5AB0DC85B11"
+#define WS_READ_CHUNK 16384
+#define WS_URING_BUFFERS 32
+#define WS_MAX_MESSAGE_SIZE (64u * 1024u * 1024u)
+#define WS_MAX_BACKOFF_SHIFT 16
 // Internal WebSocket client structure
 typedef struct {
     hl_ws_config_t config;
-    bool connected;
-    bool running;
+    char url[512];
+    char host[256];
+    char port[8];
+    char path[256];
+    bool tls;
+
+    atomic_bool connected;
+    atomic_bool running;
+    bool thread_started;
     pthread_t thread;
-    pthread_mutex_t mutex;
+    pthread_mutex_t mutex;              /**< Guards callbacks and wake condition */
+    pthread_mutex_t io_mutex;           /**< Guards socket/SSL state and tx buffer */
+    pthread_cond_t wake;                /**< Interrupts the reconnect backoff sleep */
 
     // Callbacks
     hl_ws_message_callback_t on_message;
     hl_ws_error_callback_t on_error;
     hl_ws_connect_callback_t on_connect;
+    hl_ws_disconnect_callback_t on_disconnect;
     void* user_data;
+    hl_ws_recorder_t* recorder;         /**< Optional capture sink (under mutex) */
 
-    // Connection state (placeholder for actual WebSocket implementation)
+    // Connection state
     int socket_fd;
+    SSL_CTX* ssl_ctx;
+    SSL* ssl;
+
+    // Receive side (I/O thread only)
+    uint8_t* rx_buf;
+    size_t rx_len;
+    size_t rx_cap;
+    char* msg_buf;
+    size_t msg_len;
+    size_t msg_cap;
+    uint8_t msg_opcode;
+    bool msg_compressed;
+
+    // permessage-deflate (I/O thread only)
+    bool deflate_active;                /**< Negotiated on the current connection */
+    bool deflate_reset_per_message;     /**< server_no_context_takeover agreed */
+    bool inflater_ready;
+    z_stream inflater;
+    char* inflate_buf;                  /**< Reusable decoded-message buffer */
+    size_t inflate_cap;
+
+    // Traffic counters
+    atomic_uint_least64_t rx_wire_bytes;
+    atomic_uint_least64_t rx_payload_bytes;
+    atomic_uint_least64_t rx_decoded_bytes;
+    atomic_uint_least64_t rx_messages;
+    atomic_uint_least64_t rx_compressed_messages;
+
+    // Transmit side (under io_mutex)
+    uint8_t* tx_buf;
+    size_t tx_cap;
+
+    // Keepalive and reconnect
+    uint64_t last_rx_ms;
+    uint64_t last_ping_ms;
+    int64_t rx_wall_ns;                 /**< Wall clock at the most recent read */
+
+    // Timing statistics (under stats_mutex)
+    pthread_mutex_t stats_mutex;
+    hl_ws_clock_t clock;                /**< RTT, delay and clock offset */
+    char peer_address[64];              /**< Address of the current connection */
+    uint64_t opens;                     /**< Connections established so far */
+    int reconnect_attempts;
+    uint64_t prng_state;
 } ws_client_internal_t;
 
 /**
- * @brief WebSocket client thread function (placeholder)
+ * @brief Monotonic clock in milliseconds
+ */
+static uint64_t ws_now_ms(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000 + (uint64_t)ts.tv_nsec / 1000000;
+}
+
+/**
+ * @brief Monotonic clock in nanoseconds
+ */
+static uint64_t ws_now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+/**
+ * @brief Wall clock in nanoseconds
+ */
+static int64_t ws_wall_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_REALTIME, &ts);
+    return (int64_t)ts.tv_sec * 1000000000LL + (int64_t)ts.tv_nsec;
+}
+
+/**
+ * @brief xorshift64* generator used for mask keys and backoff jitter
+ */
+static uint64_t ws_prng_next(ws_client_internal_t* internal) {
+    uint64_t x = internal->prng_state;
+    x ^= x >> 12;
+    x ^= x << 25;
+    x ^= x >> 27;
+    internal->prng_state = x;
+    return x * 0x2545F4914F6CDD1DULL;
+}
+
+/**
+ * @brief Report error through the error callback
+ */
+static void ws_report_error(ws_client_internal_t* internal, const char* error) {
+    pthread_mutex_lock(&internal->mutex);
+    hl_ws_error_callback_t on_error = internal->on_error;
+    void* user_data = internal->user_data;
+    pthread_mutex_unlock(&internal->mutex);
+
+    if (on_error) {
+        on_error(error, user_data);
+    } else {
+        HL_LOG_DEBUG("WebSocket error: %s", error);
+    }
+}
+
+/**
+ * @brief Split ws[s]://host[:port][/path] into its components
+ */
+static bool ws_parse_url(ws_client_internal_t* internal, const char* url) {
+    const char* rest;
+    if (strncmp(url, "wss://", 6) == 0) {
+        internal->tls = true;
+        rest = url + 6;
+    } else if (strncmp(url, "ws://", 5) == 0) {
+        internal->tls = false;
+        rest = url + 5;
+    } else {
+        return false;
+    }
+
+    const char* path = strchr(rest, '/');
+    size_t authority_len = path ? (size_t)(path - rest) : strlen(rest);
+    if (authority_len == 0 || authority_len >= sizeof(internal->host)) {
+        return false;
+    }
+
+    char authority[256];
+    memcpy(authority, rest, authority_len);
+    authority[authority_len] = '\0';
+
+    char* colon = strrchr(authority, ':');
+    if (colon) {
+        *colon = '\0';
+        snprintf(internal->port, sizeof(internal->port), "%s", colon + 1);
+    } else {
+        snprintf(internal->port, sizeof(internal->port), "%s", internal->tls ? "443" : "80");
+    }
+    snprintf(internal->host, sizeof(internal->host), "%s", authority);
+    snprintf(internal->path, sizeof(internal->path), "%s", path ? path : "/");
+
+    return internal->host[0] != '\0';
+}
+
+/**
+ * @brief Switch socket between blocking and non-blocking mode
+ */
+static bool ws_set_nonblocking(int fd, bool nonblocking) {
+    int flags = fcntl(fd, F_GETFL, 0);
+    if (flags < 0) return false;
+    flags = nonblocking ? (flags | O_NONBLOCK) : (flags & ~O_NONBLOCK);
+    return fcntl(fd, F_SETFL, flags) == 0;
+}
+
+/**
+ * @brief Spin-wait hint for the busy-poll loop
+ */
+static inline void ws_cpu_relax(void) {
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#elif defined(__aarch64__)
+    __asm__ __volatile__("yield");
+#endif
+}
+
+/**
+ * @brief Pin the calling thread to a CPU (cpu < 0 leaves affinity alone)
+ */
+static void ws_pin_current_thread(int cpu) {
+    if (cpu < 0) return;
+
+#ifdef __linux__
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    int rc = pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+    if (rc != 0) {
+        HL_LOG_DEBUG("WebSocket: failed to pin I/O thread to CPU %d (%d)", cpu, rc);
+    }
+#endif
+}
+
+/**
+ * @brief Resolve host and open a TCP connection within timeout_ms
+ *
+ * Addresses are tried starting with the @p preferred-th one (modulo the
+ * number resolved), so two connections to the same host can land on
+ * different endpoints. The address connected to is written to @p peer.
+ */
+static int ws_tcp_connect(const char* host, const char* port, int timeout_ms, int preferred,
+                          char* peer, size_t peer_size) {
+    struct addrinfo hints = {0};
+    struct addrinfo* result = NULL;
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+
+    if (getaddrinfo(host, port, &hints, &result) != 0) {
+        return -1;
+    }
+
+    size_t count = 0;
+    for (struct addrinfo* ai = result; ai; ai = ai->ai_next) {
+        count++;
+    }
+    size_t first = preferred > 0 && count > 0 ? (size_t)preferred % count : 0;
+
+    int fd = -1;
+    for (size_t n = 0; n < count && fd < 0; n++) {
+        struct addrinfo* ai = result;
+        for (size_t skip = (first + n) % count; skip > 0; skip--) {
+            ai = ai->ai_next;
+        }
+
+        fd = socket(ai->ai_family, ai->ai_socktype, ai->ai_protocol);
+        if (fd < 0) continue;
+
+        ws_set_nonblocking(fd, true);
+        int rc = connect(fd, ai->ai_addr, ai->ai_addrlen);
+        if (rc != 0 && errno == EINPROGRESS) {
+            struct pollfd pfd = {.fd = fd, .events = POLLOUT};
+            if (poll(&pfd, 1, timeout_ms) == 1) {
+                int so_error = 0;
+                socklen_t len = sizeof(so_error);
+                getsockopt(fd, SOL_SOCKET, SO_ERROR, &so_error, &len);
+                rc = so_error == 0 ? 0 : -1;
+            } else {
+                rc = -1;
+            }
+        }
+
+        if (rc == 0) {
+            if (getnameinfo(ai->ai_addr, ai->ai_addrlen, peer, (socklen_t)peer_size, NULL, 0,
+                            NI_NUMERICHOST) != 0) {
+                peer[0] = '\0';
+            }
+            break;
+        }
+        close(fd);
+        fd = -1;
+    }
+
+    freeaddrinfo(result);
+    if (fd < 0) return -1;
+
+    int one = 1;
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+    return fd;
+}
+
+/**
+ * @brief Write all bytes to the transport (caller holds io_mutex)
+ */
+static bool ws_raw_write(ws_client_internal_t* internal, const uint8_t* data, size_t len) {
+    size_t written = 0;
+
+    while (written < len) {
+        ssize_t n;
+        bool want_write = true;
+
+        if (internal->ssl) {
+            int rc = SSL_write(internal->ssl, data + written, (int)(len - written));
+            if (rc > 0) {
+                n = rc;
+            } else {
+                int err = SSL_get_error(internal->ssl, rc);
+                if (err != SSL_ERROR_WANT_WRITE && err != SSL_ERROR_WANT_READ) return false;
+                want_write = err == SSL_ERROR_WANT_WRITE;
+                n = 0;
+            }
+        } else {
+            n = send(internal->socket_fd, data + written, len - written, MSG_NOSIGNAL);
+            if (n < 0) {
+                if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) return false;
+                n = 0;
+            }
+        }
+
+        if (n == 0) {
+            struct pollfd pfd = {
+                .fd = internal->socket_fd,
+                .events = want_write ? POLLOUT : POLLIN
+            };
+            if (poll(&pfd, 1, internal->config.timeout_ms) <= 0) return false;
+            continue;
+        }
+        written += (size_t)n;
+    }
+
+    return true;
+}
+
+/**
+ * @brief Read available bytes from the transport (caller holds io_mutex)
+ * @return bytes read, 0 if nothing is available, -1 on close or error
+ */
+static ssize_t ws_raw_read(ws_client_internal_t* internal, uint8_t* buf, size_t cap) {
+    if (internal->ssl) {
+        int rc = SSL_read(internal->ssl, buf, (int)cap);
+        if (rc > 0) return rc;
+        int err = SSL_get_error(internal->ssl, rc);
+        if (err == SSL_ERROR_WANT_READ || err == SSL_ERROR_WANT_WRITE) return 0;
+        return -1;
+    }
+
+    ssize_t n = recv(internal->socket_fd, buf, cap, 0);
+    if (n > 0) return n;
+    if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR)) return 0;
+    return -1;
+}
+
+/**
+ * @brief Make sure a growable buffer can hold needed bytes
+ */
+static bool ws_reserve(void** buf, size_t* cap, size_t needed) {
+    if (needed <= *cap) return true;
+
+    size_t new_cap = *cap ? *cap : WS_READ_CHUNK;
+    while (new_cap < needed) new_cap *= 2;
+
+    void* grown = realloc(*buf, new_cap);
+    if (!grown) return false;
+
+    *buf = grown;
+    *cap = new_cap;
+    return true;
+}
+
+/**
+ * @brief Close socket and TLS session
+ */
+static void ws_close_transport(ws_client_internal_t* internal) {
+    pthread_mutex_lock(&internal->io_mutex);
+    if (internal->ssl) {
+        SSL_free(internal->ssl);
+        internal->ssl = NULL;
+    }
+    if (internal->socket_fd >= 0) {
+        close(internal->socket_fd);
+        internal->socket_fd = -1;
+    }
+    pthread_mutex_unlock(&internal->io_mutex);
+
+    internal->rx_len = 0;
+    internal->msg_len = 0;
+    internal->msg_opcode = 0;
+    internal->deflate_active = false;
+}
+
+/**
+ * @brief Perform the HTTP upgrade and validate Sec-WebSocket-Accept
+ */
+static bool ws_handshake(ws_client_internal_t* internal) {
+    uint8_t key_bytes[16];
+    for (size_t i = 0; i < sizeof(key_bytes); i += 8) {
+        uint64_t r = ws_prng_next(internal);
+        memcpy(key_bytes + i, &r, 8);
+    }
+
+    char key[32];
+    EVP_EncodeBlock((unsigned char*)key, key_bytes, sizeof(key_bytes));
+
+    // We never compress outgoing frames, so client_no_context_takeover is free
+    char extensions[160] = "";
+    if (internal->config.enable_compression) {
+        snprintf(extensions, sizeof(extensions),
+                 "Sec-WebSocket-Extensions: permessage-deflate; client_no_context_takeover%s\r\n",
+                 internal->config.compression_no_context_takeover ? "; server_no_context_takeover" : "");
+    }
+
+    bool default_port = strcmp(internal->port, internal->tls ? "443" : "80") == 0;
+    char request[1024];
+    int request_len = snprintf(request, sizeof(request),
+             "GET %s HTTP/1.1\r\n"
+             "Host: %s%s%s\r\n"
+             "Upgrade: websocket\r\n"
+             "Connection: Upgrade\r\n"
+             "Sec-WebSocket-Key: %s\r\n"
+             "Sec-WebSocket-Version: 13\r\n"
+             "%s"
+             "User-Agent: Hyperliquid-C-SDK/1.0\r\n"
+             "\r\n",
+             internal->path, internal->host,
+             default_port ? "" : ":", default_port ? "" : internal->port,
+             key, extensions);
+    if (request_len <= 0 || (size_t)request_len >= sizeof(request)) return false;
+
+    if (!ws_raw_write(internal, (const uint8_t*)request, (size_t)request_len)) {
+        return false;
+    }
+
+    // Read until end of headers; anything after them is already frame data
+    char response[4096];
+    size_t response_len = 0;
+    char* headers_end = NULL;
+    uint64_t deadline = ws_now_ms() + (uint64_t)internal->config.timeout_ms;
+
+    while (!headers_end) {
+        if (response_len >= sizeof(response) - 1 || ws_now_ms() > deadline) return false;
+
+        ssize_t n = ws_raw_read(internal, (uint8_t*)response + response_len,
+                                sizeof(response) - 1 - response_len);
+        if (n < 0) return false;
+        if (n == 0) {
+            struct pollfd pfd = {.fd = internal->socket_fd, .events = POLLIN};
+            poll(&pfd, 1, 50);
+            continue;
+        }
+
+        internal->rx_wall_ns = ws_wall_ns();
+        response_len += (size_t)n;
+        response[response_len] = '\0';
+        headers_end = strstr(response, "\r\n\r\n");
+    }
+
+    if (strncmp(response, "HTTP/1.1 101", 12) != 0) {
+        HL_LOG_DEBUG("WebSocket upgrade rejected: %.*s", 64, response);
+        return false;
+    }
+
+    // Expected accept = base64(SHA1(key + GUID))
+    char accept_src[96];
+    snprintf(accept_src, sizeof(accept_src), "%s%s", key, WS_GUID);
+    uint8_t digest[SHA_DIGEST_LENGTH];
+    SHA1((const unsigned char*)accept_src, strlen(accept_src), digest);
+    char expected[32];
+    EVP_EncodeBlock((unsigned char*)expected, digest, SHA_DIGEST_LENGTH);
+
+    bool accepted = false;
+    internal->deflate_active = false;
+    internal->deflate_reset_per_message = false;
+    for (char* line = strstr(response, "\r\n"); line && line < headers_end; line = strstr(line + 2, "\r\n")) {
+        const char* header = line + 2;
+        if (strncasecmp(header, "Sec-WebSocket-Accept:", 21) == 0) {
+            const char* value = header + 21;
+            while (*value == ' ') value++;
+            accepted = strncmp(value, expected, strlen(expected)) == 0;
+        } else if (strncasecmp(header, "Sec-WebSocket-Extensions:", 25) == 0 &&
+                   internal->config.enable_compression) {
+            const char* end = strstr(header, "\r\n");
+            size_t value_len = (size_t)(end - header);
+            char value[256];
+            if (value_len >= sizeof(value)) value_len = sizeof(value) - 1;
+            memcpy(value, header, value_len);
+            value[value_len] = '\0';
+
+            internal->deflate_active = strstr(value, "permessage-deflate") != NULL;
+            internal->deflate_reset_per_message = strstr(value, "server_no_context_takeover") != NULL;
+        }
+    }
+    if (!accepted) return false;
+
+    if (internal->deflate_active) {
+        // Raw deflate; a 15-bit window accepts any server_max_window_bits
+        int rc = internal->inflater_ready ? inflateReset(&internal->inflater)
+                                          : inflateInit2(&internal->inflater, -MAX_WBITS);
+        if (rc != Z_OK) return false;
+        internal->inflater_ready = true;
+    }
+
+    // Keep any frame bytes that arrived with the response
+    size_t header_bytes = (size_t)(headers_end + 4 - response);
+    size_t extra = response_len - header_bytes;
+    if (extra > 0) {
+        if (!ws_reserve((void**)&internal->rx_buf, &internal->rx_cap, extra)) return false;
+        memcpy(internal->rx_buf, response + header_bytes, extra);
+    }
+    internal->rx_len = extra;
+    atomic_fetch_add_explicit(&internal->rx_wire_bytes, extra, memory_order_relaxed);
+
+    return true;
+}
+
+/**
+ * @brief Establish TCP, TLS and WebSocket session
+ */
+static bool ws_open(ws_client_internal_t* internal) {
+    char peer[sizeof(internal->peer_address)] = "";
+    int fd = ws_tcp_connect(internal->host, internal->port, internal->config.timeout_ms,
+                            internal->config.address_index, peer, sizeof(peer));
+    if (fd < 0) {
+        return false;
+    }
+
+    pthread_mutex_lock(&internal->stats_mutex);
+    memcpy(internal->peer_address, peer, sizeof(peer));
+    pthread_mutex_unlock(&internal->stats_mutex);
+
+#ifdef SO_BUSY_POLL
+    if (internal->config.busy_poll && internal->config.busy_poll_us > 0) {
+        int busy_poll_us = internal->config.busy_poll_us;
+        if (setsockopt(fd, SOL_SOCKET, SO_BUSY_POLL, &busy_poll_us, sizeof(busy_poll_us)) != 0) {
+            HL_LOG_DEBUG("WebSocket: SO_BUSY_POLL not applied (errno %d)", errno);
+        }
+    }
+#endif
+
+    pthread_mutex_lock(&internal->io_mutex);
+    internal->socket_fd = fd;
+    internal->rx_len = 0;
+    internal->msg_len = 0;
+    internal->msg_opcode = 0;
+
+    bool ok = true;
+    if (internal->tls) {
+        if (!internal->ssl_ctx) {
+            internal->ssl_ctx = SSL_CTX_new(TLS_client_method());
+            if (internal->ssl_ctx) {
+                SSL_CTX_set_default_verify_paths(internal->ssl_ctx);
+                SSL_CTX_set_verify(internal->ssl_ctx, SSL_VERIFY_PEER, NULL);
+                SSL_CTX_set_mode(internal->ssl_ctx, SSL_MODE_ACCEPT_MOVING_WRITE_BUFFER);
+            }
+        }
+
+        internal->ssl = internal->ssl_ctx ? SSL_new(internal->ssl_ctx) : NULL;
+        ok = internal->ssl != NULL;
+        if (ok) {
+            SSL_set_fd(internal->ssl, fd);
+            SSL_set_tlsext_host_name(internal->ssl, internal->host);
+            SSL_set1_host(internal->ssl, internal->host);
+
+            // Drive the handshake over the non-blocking socket
+            uint64_t deadline = ws_now_ms() + (uint64_t)internal->config.timeout_ms;
+            for (;;) {
+                int rc = SSL_connect(internal->ssl);
+                if (rc == 1) break;
+
+                int err = SSL_get_error(internal->ssl, rc);
+                uint64_t now = ws_now_ms();
+                if ((err != SSL_ERROR_WANT_READ && err != SSL_ERROR_WANT_WRITE) || now >= deadline) {
+                    ok = false;
+                    break;
+                }
+                struct pollfd pfd = {
+                    .fd = fd,
+                    .events = err == SSL_ERROR_WANT_READ ? POLLIN : POLLOUT
+                };
+                poll(&pfd, 1, (int)(deadline - now));
+            }
+        }
+    }
+
+    if (ok) {
+        ok = ws_handshake(internal);
+    }
+    pthread_mutex_unlock(&internal->io_mutex);
+
+    if (!ok) {
+        ws_close_transport(internal);
+        return false;
+    }
+
+    uint64_t now = ws_now_ms();
+    internal->last_rx_ms = now;
+    internal->last_ping_ms = now;
+    internal->opens++;
+    return true;
+}
+
+/**
+ * @brief Encode one masked client frame at out (needs len + 14 bytes)
+ * @return frame size
+ */
+static size_t ws_encode_frame(ws_client_internal_t* internal, uint8_t* out,
+                              uint8_t opcode, const uint8_t* payload, size_t len) {
+    size_t pos = 0;
+    out[pos++] = (uint8_t)(0x80 | opcode);
+
+    if (len < 126) {
+        out[pos++] = (uint8_t)(0x80 | len);
+    } else if (len <= 0xFFFF) {
+        out[pos++] = 0x80 | 126;
+        out[pos++] = (uint8_t)(len >> 8);
+        out[pos++] = (uint8_t)len;
+    } else {
+        out[pos++] = 0x80 | 127;
+        for (int i = 7; i >= 0; i--) {
+            out[pos++] = (uint8_t)((uint64_t)len >> (i * 8));
+        }
+    }
+
+    uint32_t mask32 = (uint32_t)ws_prng_next(internal);
+    uint8_t mask[4];
+    memcpy(mask, &mask32, 4);
+    memcpy(out + pos, mask, 4);
+    pos += 4;
+
+    // Mask eight bytes at a time, then the tail
+    uint64_t mask64 = (uint64_t)mask32 | ((uint64_t)mask32 << 32);
+    size_t i = 0;
+    for (; i + 8 <= len; i += 8) {
+        uint64_t chunk;
+        memcpy(&chunk, payload + i, 8);
+        chunk ^= mask64;
+        memcpy(out + pos + i, &chunk, 8);
+    }
+    for (; i < len; i++) {
+        out[pos + i] = payload[i] ^ mask[i & 3];
+    }
+
+    return pos + len;
+}
+
+/**
+ * @brief Encode and write a batch of frames with a single write
+ */
+static bool ws_send_frames(ws_client_internal_t* internal, uint8_t opcode,
+                           const uint8_t* const* payloads, const size_t* lens, size_t count) {
+    if (!atomic_load(&internal->connected)) return false;
+
+    size_t total = 0;
+    for (size_t i = 0; i < count; i++) {
+        total += lens[i] + 14;
+    }
+
+    pthread_mutex_lock(&internal->io_mutex);
+
+    bool ok = internal->socket_fd >= 0 &&
+              ws_reserve((void**)&internal->tx_buf, &internal->tx_cap, total);
+    if (ok) {
+        size_t pos = 0;
+        for (size_t i = 0; i < count; i++) {
+            pos += ws_encode_frame(internal, internal->tx_buf + pos, opcode, payloads[i], lens[i]);
+        }
+        ok = ws_raw_write(internal, internal->tx_buf, pos);
+    }
+
+    pthread_mutex_unlock(&internal->io_mutex);
+    return ok;
+}
+
+static bool ws_send_control(ws_client_internal_t* internal, uint8_t opcode,
+                            const uint8_t* payload, size_t len) {
+    const uint8_t* payloads[1] = {payload};
+    size_t lens[1] = {len};
+    return ws_send_frames(internal, opcode, payloads, lens, 1);
+}
+
+/**
+ * @brief Run inflate over input, appending to inflate_buf
+ */
+static bool ws_inflate_chunk(ws_client_internal_t* internal, const uint8_t* data, size_t len,
+                             size_t* out_len) {
+    z_stream* zs = &internal->inflater;
+    zs->next_in = (Bytef*)data;
+    zs->avail_in = (uInt)len;
+
+    for (;;) {
+        if (*out_len > WS_MAX_MESSAGE_SIZE ||
+            !ws_reserve((void**)&internal->inflate_buf, &internal->inflate_cap,
+                        *out_len + WS_READ_CHUNK + 1)) {
+            return false;
+        }
+
+        uInt room = (uInt)(internal->inflate_cap - *out_len - 1);
+        zs->next_out = (Bytef*)internal->inflate_buf + *out_len;
+        zs->avail_out = room;
+
+        int rc = inflate(zs, Z_SYNC_FLUSH);
+        *out_len += room - zs->avail_out;
+
+        if (rc == Z_STREAM_END) {
+            inflateReset(zs);
+            return true;
+        }
+        if (rc != Z_OK && rc != Z_BUF_ERROR) {
+            return false;
+        }
+        if (zs->avail_in == 0 && zs->avail_out > 0) {
+            return true;
+        }
+    }
+}
+
+/**
+ * @brief Inflate one compressed message into the reusable inflate buffer
+ *
+ * The sender strips the trailing 00 00 ff ff of each flush; it is fed
+ * back separately instead of copying the payload to append it.
+ */
+static bool ws_inflate_message(ws_client_internal_t* internal, const uint8_t* data, size_t len,
+                               size_t* out_len) {
+    static const uint8_t tail[4] = {0x00, 0x00, 0xFF, 0xFF};
+
+    *out_len = 0;
+    if (!ws_inflate_chunk(internal, data, len, out_len) ||
+        !ws_inflate_chunk(internal, tail, sizeof(tail), out_len)) {
+        return false;
+    }
+
+    if (internal->deflate_reset_per_message) {
+        inflateReset(&internal->inflater);
+    }
+
+    internal->inflate_buf[*out_len] = '\0';
+    return true;
+}
+
+/**
+ * @brief Deliver a complete data message to the message callback
+ */
+static void ws_deliver_message(ws_client_internal_t* internal, const char* message, size_t size) {
+    pthread_mutex_lock(&internal->mutex);
+    hl_ws_message_callback_t on_message = internal->on_message;
+    void* user_data = internal->user_data;
+    if (internal->recorder) {
+        // Written under the lock so the recorder can be closed right after
+        // hl_ws_client_set_recorder(client, NULL) returns
+        hl_ws_recorder_write(internal->recorder, message, size, internal->rx_wall_ns);
+    }
+    pthread_mutex_unlock(&internal->mutex);
+
+    if (on_message) {
+        on_message(message, size, user_data);
+    }
+}
+
+/**
+ * @brief Decode (if compressed), count and deliver a complete message
+ * @param in_place payload points into rx_buf and has a spare byte after it
+ */
+static bool ws_deliver_payload(ws_client_internal_t* internal, uint8_t* payload, size_t len,
+                               bool in_place, const char** reason) {
+    atomic_fetch_add_explicit(&internal->rx_messages, 1, memory_order_relaxed);
+    atomic_fetch_add_explicit(&internal->rx_payload_bytes, len, memory_order_relaxed);
+
+    if (internal->msg_compressed) {
+        size_t decoded_len = 0;
+        if (!ws_inflate_message(internal, payload, len, &decoded_len)) {
+            *reason = "inflate failed";
+            return false;
+        }
+        atomic_fetch_add_explicit(&internal->rx_compressed_messages, 1, memory_order_relaxed);
+        atomic_fetch_add_explicit(&internal->rx_decoded_bytes, decoded_len, memory_order_relaxed);
+        ws_deliver_message(internal, internal->inflate_buf, decoded_len);
+        return true;
+    }
+
+    atomic_fetch_add_explicit(&internal->rx_decoded_bytes, len, memory_order_relaxed);
+    if (in_place) {
+        uint8_t saved = payload[len];
+        payload[len] = '\0';
+        ws_deliver_message(internal, (const char*)payload, len);
+        payload[len] = saved;
+    } else {
+        payload[len] = '\0';
+        ws_deliver_message(internal, (const char*)payload, len);
+    }
+    return true;
+}
+
+/**
+ * @brief Parse and handle every complete frame in rx_buf
+ * @return false if the connection must be dropped
+ */
+static bool ws_process_frames(ws_client_internal_t* internal, const char** reason) {
+    size_t pos = 0;
+
+    while (internal->rx_len - pos >= 2) {
+        const uint8_t* frame = internal->rx_buf + pos;
+        size_t avail = internal->rx_len - pos;
+
+        bool fin = (frame[0] & 0x80) != 0;
+        bool rsv1 = (frame[0] & 0x40) != 0;
+        uint8_t opcode = frame[0] & 0x0F;
+
+        // RSV1 marks a compressed message and is only valid on its first frame
+        if ((frame[0] & 0x30) || (rsv1 && (!internal->deflate_active ||
+                                           opcode == WS_OPCODE_CONTINUATION || opcode >= 0x8))) {
+            *reason = "unexpected reserved bits";
+            return false;
+        }
+        bool masked = (frame[1] & 0x80) != 0;
+        uint64_t len = frame[1] & 0x7F;
+        size_t header = 2;
+
+        if (len == 126) {
+            if (avail < 4) break;
+            len = ((uint64_t)frame[2] << 8) | frame[3];
+            header = 4;
+        } else if (len == 127) {
+            if (avail < 10) break;
+            len = 0;
+            for (int i = 0; i < 8; i++) {
+                len = (len << 8) | frame[2 + i];
+            }
+            header = 10;
+        }
+
+        if (len > WS_MAX_MESSAGE_SIZE) {
+            *reason = "frame too large";
+            return false;
+        }
+
+        uint8_t mask[4] = {0};
+        if (masked) {
+            if (avail < header + 4) break;
+            memcpy(mask, frame + header, 4);
+            header += 4;
+        }
+        if (avail < header + len) break;
+
+        uint8_t* payload = internal->rx_buf + pos + header;
+        if (masked) {
+            for (uint64_t i = 0; i < len; i++) payload[i] ^= mask[i & 3];
+        }
+        pos += header + (size_t)len;
+
+        switch (opcode) {
+            case WS_OPCODE_TEXT:
+            case WS_OPCODE_BINARY:
+            case WS_OPCODE_CONTINUATION: {
+                if (opcode != WS_OPCODE_CONTINUATION) {
+                    internal->msg_len = 0;
+                    internal->msg_opcode = opcode;
+                    internal->msg_compressed = rsv1;
+                } else if (internal->msg_opcode == 0) {
+                    *reason = "unexpected continuation frame";
+                    return false;
+                }
+
+                // Fast path: unfragmented message is delivered straight from rx_buf
+                if (fin && opcode != WS_OPCODE_CONTINUATION) {
+                    if (!ws_deliver_payload(internal, payload, (size_t)len, true, reason)) {
+                        return false;
+                    }
+                    internal->msg_opcode = 0;
+                    break;
+                }
+
+                if (internal->msg_len + len > WS_MAX_MESSAGE_SIZE ||
+                    !ws_reserve((void**)&internal->msg_buf, &internal->msg_cap,
+                                internal->msg_len + (size_t)len + 1)) {
+                    *reason = "message too large";
+                    return false;
+                }
+                memcpy(internal->msg_buf + internal->msg_len, payload, (size_t)len);
+                internal->msg_len += (size_t)len;
+
+                if (fin) {
+                    if (!ws_deliver_payload(internal, (uint8_t*)internal->msg_buf,
+                                            internal->msg_len, false, reason)) {
+                        return false;
+                    }
+                    internal->msg_len = 0;
+                    internal->msg_opcode = 0;
+                }
+                break;
+            }
+
+            case WS_OPCODE_PING:
+                ws_send_control(internal, WS_OPCODE_PONG, payload, (size_t)len);
+                break;
+
+            case WS_OPCODE_PONG:
+                // Our pings carry the monotonic send time
+                if (len == sizeof(uint64_t)) {
+                    uint64_t sent_ns;
+                    memcpy(&sent_ns, payload, sizeof(sent_ns));
+                    uint64_t now_ns = ws_now_ns();
+                    if (sent_ns <= now_ns && now_ns - sent_ns < 60000000000ULL) {
+                        double rtt_ms = (double)(now_ns - sent_ns) / 1e6;
+                        pthread_mutex_lock(&internal->stats_mutex);
+                        hl_ws_clock_add_rtt(&internal->clock, rtt_ms);
+                        pthread_mutex_unlock(&internal->stats_mutex);
+                    }
+                }
+                break;
+
+            case WS_OPCODE_CLOSE:
+                ws_send_control(internal, WS_OPCODE_CLOSE, payload, len >= 2 ? 2 : 0);
+                *reason = "closed by server";
+                return false;
+
+            default:
+                *reason = "unknown opcode";
+                return false;
+        }
+    }
+
+    // Compact unread bytes to the front of the buffer
+    if (pos > 0) {
+        memmove(internal->rx_buf, internal->rx_buf + pos, internal->rx_len - pos);
+        internal->rx_len -= pos;
+    }
+    return true;
+}
+
+/**
+ * @brief Read everything currently available and process it
+ * @return false if the connection must be dropped
+ */
+static bool ws_pump(ws_client_internal_t* internal, const char** reason) {
+    for (;;) {
+        if (!ws_reserve((void**)&internal->rx_buf, &internal->rx_cap,
+                        internal->rx_len + WS_READ_CHUNK + 1)) {
+            *reason = "out of memory";
+            return false;
+        }
+
+        pthread_mutex_lock(&internal->io_mutex);
+        ssize_t n = internal->socket_fd >= 0 ?
+            ws_raw_read(internal, internal->rx_buf + internal->rx_len,
+                        internal->rx_cap - internal->rx_len - 1) : -1;
+        pthread_mutex_unlock(&internal->io_mutex);
+
+        if (n < 0) {
+            *reason = "connection closed";
+            return false;
+        }
+        if (n == 0) {
+            return true;
+        }
+
+        internal->rx_wall_ns = ws_wall_ns();
+        atomic_fetch_add_explicit(&internal->rx_wire_bytes, (uint64_t)n, memory_order_relaxed);
+        internal->rx_len += (size_t)n;
+        internal->last_rx_ms = ws_now_ms();
+
+        if (!ws_process_frames(internal, reason)) {
+            return false;
+        }
+    }
+}
+
+/**
+ * @brief Tear down a lost connection and notify the disconnect callback
+ */
+static void ws_connection_lost(hl_ws_client_t* client, const char* reason) {
+    ws_client_internal_t* internal = (ws_client_internal_t*)client->internal;
+
+    atomic_store(&internal->connected, false);
+    client->connected = false;
+    ws_close_transport(internal);
+
+    if (!atomic_load(&internal->running)) return;
+
+    pthread_mutex_lock(&internal->mutex);
+    hl_ws_disconnect_callback_t on_disconnect = internal->on_disconnect;
+    void* user_data = internal->user_data;
+    pthread_mutex_unlock(&internal->mutex);
+
+    if (on_disconnect) {
+        on_disconnect(reason, user_data);
+    }
+}
+
+/**
+ * @brief Backoff before reconnect attempt n: min(cap, base * 2^n) with equal jitter
+ */
+static uint64_t ws_backoff_delay_ms(ws_client_internal_t* internal, int attempt) {
+    uint64_t base = internal->config.reconnect_delay_ms > 0 ?
+                    (uint64_t)internal->config.reconnect_delay_ms : 500;
+    uint64_t cap = internal->config.reconnect_max_delay_ms > 0 ?
+                   (uint64_t)internal->config.reconnect_max_delay_ms : 30000;
+    if (cap < base) cap = base;
+
+    int shift = attempt < WS_MAX_BACKOFF_SHIFT ? attempt : WS_MAX_BACKOFF_SHIFT;
+    uint64_t delay = base << shift;
+    if (delay > cap) delay = cap;
+
+    uint64_t half = delay / 2;
+    return half + ws_prng_next(internal) % (half + 1);
+}
+
+/**
+ * @brief Sleep until the delay expires or the client is stopped
+ */
+static void ws_backoff_sleep(ws_client_internal_t* internal, uint64_t delay_ms) {
+    struct timespec deadline;
+    clock_gettime(CLOCK_REALTIME, &deadline);
+    deadline.tv_sec += (time_t)(delay_ms / 1000);
+    deadline.tv_nsec += (long)(delay_ms % 1000) * 1000000L;
+    if (deadline.tv_nsec >= 1000000000L) {
+        deadline.tv_sec++;
+        deadline.tv_nsec -= 1000000000L;
+    }
+
+    pthread_mutex_lock(&internal->mutex);
+    while (atomic_load(&internal->running)) {
+        if (pthread_cond_timedwait(&internal->wake, &internal->mutex, &deadline) == ETIMEDOUT) {
+            break;
+        }
+    }
+    pthread_mutex_unlock(&internal->mutex);
+}
+
+/**
+ * @brief Reconnect with backoff until success, stop or attempts exhausted
+ * @return true once connected again
+ */
+static bool ws_reconnect(hl_ws_client_t* client) {
+    ws_client_internal_t* internal = (ws_client_internal_t*)client->internal;
+
+    while (atomic_load(&internal->running)) {
+        int max_attempts = internal->config.max_reconnect_attempts;
+        if (max_attempts > 0 && internal->reconnect_attempts >= max_attempts) {
+            ws_report_error(internal, "WebSocket reconnect attempts exhausted");
+            return false;
+        }
+
+        uint64_t delay = ws_backoff_delay_ms(internal, internal->reconnect_attempts);
+        internal->reconnect_attempts++;
+        HL_LOG_DEBUG("WebSocket reconnect attempt %d in %llu ms",
+                     internal->reconnect_attempts, (unsigned long long)delay);
+
+        ws_backoff_sleep(internal, delay);
+        if (!atomic_load(&internal->running)) return false;
+
+        if (ws_open(internal)) {
+            internal->reconnect_attempts = 0;
+            atomic_store(&internal->connected, true);
+            client->connected = true;
+
+            pthread_mutex_lock(&internal->mutex);
+            hl_ws_connect_callback_t on_connect = internal->on_connect;
+            void* user_data = internal->user_data;
+            pthread_mutex_unlock(&internal->mutex);
+
+            if (on_connect) {
+                on_connect(user_data);
+            }
+            return true;
+        }
+    }
+
+    return false;
+}
+
+// Completion context of the io_uring receive loop
+typedef struct {
+    ws_client_internal_t* internal;
+    const char* reason;                 /**< Set when the connection must be dropped */
+} ws_uring_ctx_t;
+
+/**
+ * @brief Handle one io_uring completion: received bytes or socket readiness
+ */
+static bool ws_uring_complete(void* arg, const uint8_t* data, ssize_t len) {
+    ws_uring_ctx_t* ctx = (ws_uring_ctx_t*)arg;
+    ws_client_internal_t* internal = ctx->internal;
+
+    if (len <= 0) {
+        ctx->reason = len == 0 ? "connection closed" : "socket error";
+        return false;
+    }
+
+    // Readiness of a TLS socket; records go through OpenSSL
+    if (!data) {
+        if (len & (POLLERR | POLLNVAL)) {
+            ctx->reason = "socket error";
+            return false;
+        }
+        return ws_pump(internal, &ctx->reason);
+    }
+
+    if (!ws_reserve((void**)&internal->rx_buf, &internal->rx_cap,
+                    internal->rx_len + (size_t)len + 1)) {
+        ctx->reason = "out of memory";
+        return false;
+    }
+    memcpy(internal->rx_buf + internal->rx_len, data, (size_t)len);
+
+    internal->rx_wall_ns = ws_wall_ns();
+    atomic_fetch_add_explicit(&internal->rx_wire_bytes, (uint64_t)len, memory_order_relaxed);
+    internal->rx_len += (size_t)len;
+    internal->last_rx_ms = ws_now_ms();
+
+    return ws_process_frames(internal, &ctx->reason);
+}
+
+/**
+ * @brief WebSocket client I/O thread
  */
 static void* ws_client_thread(void* arg) {
     hl_ws_client_t* client = (hl_ws_client_t*)arg;
     ws_client_internal_t* internal = (ws_client_internal_t*)client->internal;
 
-    while (internal->running) {
-        // Placeholder WebSocket loop
-        // In real implementation, this would handle WebSocket frames
+    int ping_interval = internal->config.ping_interval_ms > 0 ?
+                        internal->config.ping_interval_ms : 30000;
+    uint64_t idle_limit = (uint64_t)ping_interval * 2 + (uint64_t)internal->config.timeout_ms;
+    bool busy_poll = internal->config.busy_poll;
+
+    if (busy_poll) {
+        ws_pin_current_thread(internal->config.busy_poll_cpu);
+    }
+
+    hl_ws_uring_t* ring = NULL;
+    uint64_t watched_opens = 0;
+    if (!busy_poll && internal->config.io_backend == HL_WS_IO_URING) {
+        ring = hl_ws_uring_create(WS_READ_CHUNK, WS_URING_BUFFERS);
+        if (!ring) {
+            HL_LOG_WARN("WebSocket: io_uring unavailable, falling back to %s", "poll()");
+        }
+    }
+
+    while (atomic_load(&internal->running)) {
+        if (!atomic_load(&internal->connected)) {
+            if (ring) {
+                hl_ws_uring_unwatch(ring);
+            }
+            if (!internal->config.auto_reconnect || !ws_reconnect(client)) {
+                break;
+            }
+            continue;
+        }
+
+        const char* reason = NULL;
+
+        // Frames may already be buffered from the handshake response
+        if (internal->rx_len > 0 && !ws_process_frames(internal, &reason)) {
+            ws_connection_lost(client, reason);
+            continue;
+        }
+
+        if (busy_poll) {
+            // Spin on non-blocking reads; ws_pump stamps each read as it returns
+            uint64_t wire_before = atomic_load_explicit(&internal->rx_wire_bytes, memory_order_relaxed);
+            if (!ws_pump(internal, &reason)) {
+                ws_connection_lost(client, reason);
+                continue;
+            }
+            if (atomic_load_explicit(&internal->rx_wire_bytes, memory_order_relaxed) == wire_before) {
+                ws_cpu_relax();
+            }
+        } else if (ring) {
+            // Watch each new connection once; the request stays armed across waits
+            if (watched_opens != internal->opens) {
+                watched_opens = internal->opens;
+                bool watching = internal->tls ?
+                    hl_ws_uring_watch_poll(ring, internal->socket_fd) :
+                    hl_ws_uring_watch_recv(ring, internal->socket_fd);
+                if (!watching) {
+                    ws_connection_lost(client, "io_uring watch failed");
+                    continue;
+                }
+            }
+
+            uint64_t now = ws_now_ms();
+            uint64_t next_ping = internal->last_ping_ms + (uint64_t)ping_interval;
+            int wait_ms = next_ping > now ? (int)(next_ping - now) : 0;
+
+            ws_uring_ctx_t ctx = {.internal = internal, .reason = NULL};
+            int rc = hl_ws_uring_wait(ring, wait_ms, ws_uring_complete, &ctx);
+            if (!atomic_load(&internal->running)) break;
 
-        if (internal->connected) {
-            // Simulate heartbeat/ping
-            sleep(30); // 30 second intervals
+            if (ctx.reason || rc < 0) {
+                ws_connection_lost(client, ctx.reason ? ctx.reason : "io_uring wait failed");
+                continue;
+            }
         } else {
-            // Try to reconnect
-            sleep(internal->config.reconnect_delay_ms / 1000);
+            uint64_t now = ws_now_ms();
+            uint64_t next_ping = internal->last_ping_ms + (uint64_t)ping_interval;
+            int wait_ms = next_ping > now ? (int)(next_ping - now) : 0;
+
+            struct pollfd pfd = {.fd = internal->socket_fd, .events = POLLIN};
+            int rc = poll(&pfd, 1, wait_ms);
+            if (!atomic_load(&internal->running)) break;
+
+            if (rc > 0) {
+                if ((pfd.revents & (POLLERR | POLLNVAL)) || !ws_pump(internal, &reason)) {
+                    ws_connection_lost(client, reason ? reason : "socket error");
+                    continue;
+                }
+            } else if (rc < 0 && errno != EINTR) {
+                ws_connection_lost(client, "poll failed");
+                continue;
+            }
+        }
+
+        uint64_t now = ws_now_ms();
+        if (now - internal->last_rx_ms > idle_limit) {
+            ws_connection_lost(client, "keepalive timeout");
+            continue;
+        }
+        if (now - internal->last_ping_ms >= (uint64_t)ping_interval) {
+            internal->last_ping_ms = now;
+            uint64_t sent_ns = ws_now_ns();
+            if (!ws_send_control(internal, WS_OPCODE_PING, (const uint8_t*)&sent_ns, sizeof(sent_ns))) {
+                ws_connection_lost(client, "ping failed");
+            }
         }
     }
 
+    // Stopped, or gave up on the connection: either way the client is idle
+    // again and hl_ws_client_connect() may start over
+    atomic_store(&internal->running, false);
+    atomic_store(&internal->connected, false);
+    client->running = false;
+    client->connected = false;
+    ws_close_transport(internal);
+    hl_ws_uring_destroy(ring);
     return NULL;
 }
 
@@ -70,21 +1294,57 @@ hl_ws_client_t* hl_ws_client_create(const hl_ws_config_t* config) {
         return NULL;
     }
 
-    // Copy configuration
+    // Copy configuration (URL is copied so the caller's string may go away)
     memcpy(&internal->config, config, sizeof(hl_ws_config_t));
-    memcpy(&client->config, config, sizeof(hl_ws_config_t));
+    snprintf(internal->url, sizeof(internal->url), "%s", config->url);
+    internal->config.url = internal->url;
+    if (internal->config.timeout_ms <= 0) {
+        internal->config.timeout_ms = 10000;
+    }
+    memcpy(&client->config, &internal->config, sizeof(hl_ws_config_t));
 
-    // Initialize mutex
+    if (!ws_parse_url(internal, internal->url)) {
+        free(internal);
+        free(client);
+        return NULL;
+    }
+
+    // Initialize synchronization primitives
     if (pthread_mutex_init(&internal->mutex, NULL) != 0) {
         free(internal);
         free(client);
         return NULL;
     }
+    if (pthread_mutex_init(&internal->io_mutex, NULL) != 0) {
+        pthread_mutex_destroy(&internal->mutex);
+        free(internal);
+        free(client);
+        return NULL;
+    }
+    if (pthread_cond_init(&internal->wake, NULL) != 0) {
+        pthread_mutex_destroy(&internal->io_mutex);
+        pthread_mutex_destroy(&internal->mutex);
+        free(internal);
+        free(client);
+        return NULL;
+    }
+    if (pthread_mutex_init(&internal->stats_mutex, NULL) != 0) {
+        pthread_cond_destroy(&internal->wake);
+        pthread_mutex_destroy(&internal->io_mutex);
+        pthread_mutex_destroy(&internal->mutex);
+        free(internal);
+        free(client);
+        return NULL;
+    }
 
     // Set defaults
-    internal->connected = false;
-    internal->running = false;
+    atomic_init(&internal->connected, false);
+    atomic_init(&internal->running, false);
     internal->socket_fd = -1;
+    if (RAND_bytes((unsigned char*)&internal->prng_state, sizeof(internal->prng_state)) != 1 ||
+        internal->prng_state == 0) {
+        internal->prng_state = ws_now_ms() ^ (uint64_t)(uintptr_t)internal ^ 0x9E3779B97F4A7C15ULL;
+    }
 
     client->internal = internal;
     client->connected = false;
@@ -102,18 +1362,22 @@ void hl_ws_client_destroy(hl_ws_client_t* client) {
     ws_client_internal_t* internal = (ws_client_internal_t*)client->internal;
 
     if (internal) {
-        // Stop thread
-        internal->running = false;
-        if (client->running) {
-            pthread_join(internal->thread, NULL);
-        }
+        hl_ws_client_disconnect(client);
 
-        // Close socket (placeholder)
-        if (internal->socket_fd >= 0) {
-            close(internal->socket_fd);
+        if (internal->ssl_ctx) {
+            SSL_CTX_free(internal->ssl_ctx);
+        }
+        if (internal->inflater_ready) {
+            inflateEnd(&internal->inflater);
         }
+        free(internal->rx_buf);
+        free(internal->msg_buf);
+        free(internal->tx_buf);
+        free(internal->inflate_buf);
 
-        // Destroy mutex
+        pthread_mutex_destroy(&internal->stats_mutex);
+        pthread_cond_destroy(&internal->wake);
+        pthread_mutex_destroy(&internal->io_mutex);
         pthread_mutex_destroy(&internal->mutex);
 
         free(internal);
@@ -123,39 +1387,52 @@ void hl_ws_client_destroy(hl_ws_client_t* client) {
 }
 
 /**
- * @brief Connect to WebSocket server (placeholder)
+ * @brief Connect to WebSocket server
  */
 bool hl_ws_client_connect(hl_ws_client_t* client) {
     if (!client) return false;
 
     ws_client_internal_t* internal = (ws_client_internal_t*)client->internal;
 
-    // Placeholder WebSocket connection
-    // In real implementation, this would perform WebSocket handshake
+    if (atomic_load(&internal->running)) {
+        return atomic_load(&internal->connected);
+    }
+    if (internal->thread_started) {
+        // Reap an I/O thread that gave up reconnecting
+        pthread_join(internal->thread, NULL);
+        internal->thread_started = false;
+    }
 
-    pthread_mutex_lock(&internal->mutex);
+    if (!ws_open(internal)) {
+        ws_report_error(internal, "WebSocket connection failed");
+        return false;
+    }
 
-    // Simulate connection
-    internal->connected = true;
+    internal->reconnect_attempts = 0;
+    atomic_store(&internal->connected, true);
+    atomic_store(&internal->running, true);
     client->connected = true;
-    internal->running = true;
     client->running = true;
 
     // Start background thread
     if (pthread_create(&internal->thread, NULL, ws_client_thread, client) != 0) {
-        internal->connected = false;
+        atomic_store(&internal->connected, false);
+        atomic_store(&internal->running, false);
         client->connected = false;
-        internal->running = false;
         client->running = false;
-        pthread_mutex_unlock(&internal->mutex);
+        ws_close_transport(internal);
         return false;
     }
+    internal->thread_started = true;
 
+    // Call connect callback
+    pthread_mutex_lock(&internal->mutex);
+    hl_ws_connect_callback_t on_connect = internal->on_connect;
+    void* user_data = internal->user_data;
     pthread_mutex_unlock(&internal->mutex);
 
-    // Call connect callback
-    if (client->on_connect) {
-        client->on_connect(client->user_data);
+    if (on_connect) {
+        on_connect(user_data);
     }
 
     return true;
@@ -169,36 +1446,47 @@ void hl_ws_client_disconnect(hl_ws_client_t* client) {
 
     ws_client_internal_t* internal = (ws_client_internal_t*)client->internal;
 
+    // Stop first so the server's close reply is not treated as a drop
     pthread_mutex_lock(&internal->mutex);
+    atomic_store(&internal->running, false);
+    pthread_cond_broadcast(&internal->wake);
+    pthread_mutex_unlock(&internal->mutex);
 
-    internal->running = false;
-    client->running = false;
-    internal->connected = false;
-    client->connected = false;
+    // Polite close (status 1000) before tearing the socket down
+    if (atomic_load(&internal->connected)) {
+        const uint8_t normal_closure[2] = {0x03, 0xE8};
+        ws_send_control(internal, WS_OPCODE_CLOSE, normal_closure, sizeof(normal_closure));
+    }
 
-    // Close socket (placeholder)
+    // Wake the I/O thread out of poll()
+    pthread_mutex_lock(&internal->io_mutex);
     if (internal->socket_fd >= 0) {
-        close(internal->socket_fd);
-        internal->socket_fd = -1;
+        shutdown(internal->socket_fd, SHUT_RDWR);
     }
+    pthread_mutex_unlock(&internal->io_mutex);
 
-    pthread_mutex_unlock(&internal->mutex);
+    if (internal->thread_started) {
+        pthread_join(internal->thread, NULL);
+        internal->thread_started = false;
+    }
+
+    ws_close_transport(internal);
+    atomic_store(&internal->connected, false);
+    client->running = false;
+    client->connected = false;
 }
 
 /**
- * @brief Send message (placeholder)
+ * @brief Send message
  */
 bool hl_ws_client_send(hl_ws_client_t* client, const char* message, size_t size) {
     if (!client || !message || size == 0) return false;
 
     ws_client_internal_t* internal = (ws_client_internal_t*)client->internal;
 
-    if (!internal->connected) return false;
-
-    // Placeholder: just log the message
-    printf("WS SEND: %.*s\n", (int)size, message);
-
-    return true;
+    const uint8_t* payloads[1] = {(const uint8_t*)message};
+    size_t lens[1] = {size};
+    return ws_send_frames(internal, WS_OPCODE_TEXT, payloads, lens, 1);
 }
 
 /**
@@ -209,11 +1497,42 @@ bool hl_ws_client_send_text(hl_ws_client_t* client, const char* message) {
     return hl_ws_client_send(client, message, strlen(message));
 }
 
+/**
+ * @brief Send several text messages in one write
+ */
+bool hl_ws_client_send_batch(hl_ws_client_t* client, const char* const* messages, size_t count) {
+    if (!client || !messages) return false;
+    if (count == 0) return true;
+
+    ws_client_internal_t* internal = (ws_client_internal_t*)client->internal;
+
+    const uint8_t** payloads = malloc(count * sizeof(*payloads));
+    size_t* lens = malloc(count * sizeof(*lens));
+    if (!payloads || !lens) {
+        free(payloads);
+        free(lens);
+        return false;
+    }
+
+    for (size_t i = 0; i < count; i++) {
+        payloads[i] = (const uint8_t*)messages[i];
+        lens[i] = messages[i] ? strlen(messages[i]) : 0;
+    }
+
+    bool ok = ws_send_frames(internal, WS_OPCODE_TEXT, payloads, lens, count);
+
+    free(payloads);
+    free(lens);
+    return ok;
+}
+
 /**
  * @brief Check connection status
  */
 bool hl_ws_client_is_connected(const hl_ws_client_t* client) {
-    return client ? client->connected : false;
+    if (!client) return false;
+    const ws_client_internal_t* internal = (const ws_client_internal_t*)client->internal;
+    return atomic_load(&internal->connected);
 }
 
 /**
@@ -270,6 +1589,154 @@ void hl_ws_client_set_connect_callback(hl_ws_client_t* client,
     pthread_mutex_unlock(&internal->mutex);
 }
 
+/**
+ * @brief Set disconnect callback
+ */
+void hl_ws_client_set_disconnect_callback(hl_ws_client_t* client,
+                                         hl_ws_disconnect_callback_t callback,
+                                         void* user_data) {
+    if (!client) return;
+
+    ws_client_internal_t* internal = (ws_client_internal_t*)client->internal;
+
+    pthread_mutex_lock(&internal->mutex);
+    client->on_disconnect = callback;
+    client->user_data = user_data;
+    internal->on_disconnect = callback;
+    internal->user_data = user_data;
+    pthread_mutex_unlock(&internal->mutex);
+}
+
+/**
+ * @brief Configure permessage-deflate for subsequent connections
+ */
+void hl_ws_client_set_compression(hl_ws_client_t* client, bool enable, bool no_context_takeover) {
+    if (!client) return;
+
+    ws_client_internal_t* internal = (ws_client_internal_t*)client->internal;
+
+    // Read by the I/O thread only while building the next handshake
+    pthread_mutex_lock(&internal->io_mutex);
+    internal->config.enable_compression = enable;
+    internal->config.compression_no_context_takeover = no_context_takeover;
+    client->config.enable_compression = enable;
+    client->config.compression_no_context_takeover = no_context_takeover;
+    pthread_mutex_unlock(&internal->io_mutex);
+}
+
+/**
+ * @brief Configure busy-poll receive mode
+ */
+void hl_ws_client_set_busy_poll(hl_ws_client_t* client, bool enable, int cpu, int busy_poll_us) {
+    if (!client) return;
+
+    ws_client_internal_t* internal = (ws_client_internal_t*)client->internal;
+
+    pthread_mutex_lock(&internal->io_mutex);
+    internal->config.busy_poll = enable;
+    internal->config.busy_poll_cpu = cpu;
+    internal->config.busy_poll_us = busy_poll_us;
+    client->config.busy_poll = enable;
+    client->config.busy_poll_cpu = cpu;
+    client->config.busy_poll_us = busy_poll_us;
+    pthread_mutex_unlock(&internal->io_mutex);
+}
+
+/**
+ * @brief Select the receive loop of the I/O thread
+ */
+void hl_ws_client_set_io_backend(hl_ws_client_t* client, hl_ws_io_backend_t backend) {
+    if (!client) return;
+
+    ws_client_internal_t* internal = (ws_client_internal_t*)client->internal;
+
+    pthread_mutex_lock(&internal->io_mutex);
+    internal->config.io_backend = backend;
+    client->config.io_backend = backend;
+    pthread_mutex_unlock(&internal->io_mutex);
+}
+
+/**
+ * @brief Tee received messages into a recorder
+ */
+void hl_ws_client_set_recorder(hl_ws_client_t* client, hl_ws_recorder_t* recorder) {
+    if (!client) return;
+
+    ws_client_internal_t* internal = (ws_client_internal_t*)client->internal;
+
+    pthread_mutex_lock(&internal->mutex);
+    internal->recorder = recorder;
+    pthread_mutex_unlock(&internal->mutex);
+}
+
+/**
+ * @brief Wall-clock time of the read that produced the current message
+ */
+int64_t hl_ws_client_last_rx_time_ns(const hl_ws_client_t* client) {
+    if (!client) return 0;
+    const ws_client_internal_t* internal = (const ws_client_internal_t*)client->internal;
+    return internal->rx_wall_ns;
+}
+
+/**
+ * @brief Get connection timing statistics
+ */
+bool hl_ws_client_get_stats(const hl_ws_client_t* client, hl_ws_stats_t* stats) {
+    if (!client || !stats) return false;
+
+    ws_client_internal_t* internal = (ws_client_internal_t*)client->internal;
+
+    pthread_mutex_lock(&internal->stats_mutex);
+    hl_ws_window_summarize(&internal->clock.rtt, &stats->rtt);
+    hl_ws_window_summarize(&internal->clock.delay, &stats->delay);
+    stats->clock_offset_ms = internal->clock.offset_ms;
+    stats->clock_offset_valid = internal->clock.offset_valid;
+    memcpy(stats->peer_address, internal->peer_address, sizeof(stats->peer_address));
+    pthread_mutex_unlock(&internal->stats_mutex);
+
+    stats->compression_active = internal->deflate_active;
+    stats->rx_wire_bytes = atomic_load_explicit(&internal->rx_wire_bytes, memory_order_relaxed);
+    stats->rx_payload_bytes = atomic_load_explicit(&internal->rx_payload_bytes, memory_order_relaxed);
+    stats->rx_decoded_bytes = atomic_load_explicit(&internal->rx_decoded_bytes, memory_order_relaxed);
+    stats->rx_messages = atomic_load_explicit(&internal->rx_messages, memory_order_relaxed);
+    stats->rx_compressed_messages = atomic_load_explicit(&internal->rx_compressed_messages,
+                                                         memory_order_relaxed);
+
+    return true;
+}
+
+/**
+ * @brief Feed a server timestamp from the message being dispatched
+ */
+double hl_ws_client_note_server_time(hl_ws_client_t* client, int64_t server_time_ms) {
+    if (!client || server_time_ms <= 0) return 0.0;
+
+    ws_client_internal_t* internal = (ws_client_internal_t*)client->internal;
+    double delay_ms = (double)internal->rx_wall_ns / 1e6 - (double)server_time_ms;
+
+    pthread_mutex_lock(&internal->stats_mutex);
+    double age_ms = hl_ws_clock_add_delay(&internal->clock, delay_ms);
+    pthread_mutex_unlock(&internal->stats_mutex);
+
+    return age_ms;
+}
+
+/**
+ * @brief Current time on the server's clock
+ */
+int64_t hl_ws_client_server_time_ms(const hl_ws_client_t* client) {
+    int64_t local_ms = ws_wall_ns() / 1000000;
+    if (!client) return local_ms;
+
+    ws_client_internal_t* internal = (ws_client_internal_t*)client->internal;
+
+    pthread_mutex_lock(&internal->stats_mutex);
+    double offset = internal->clock.offset_valid ? internal->clock.offset_ms : 0.0;
+    pthread_mutex_unlock(&internal->stats_mutex);
+
+    return local_ms - (int64_t)offset;
+}
+
 /**
  * @brief Get default configuration
  */
@@ -279,9 +1746,17 @@ void hl_ws_config_default(hl_ws_config_t* config, bool testnet) {
     config->url = testnet ?
         "wss://api.hyperliquid-testnet.xyz/ws" :
         "wss://api.hyperliquid.xyz/ws";
-    config->reconnect_delay_ms = 5000;
+    config->reconnect_delay_ms = 500;
+    config->reconnect_max_delay_ms = 30000;
     config->ping_interval_ms = 30000;
     config->timeout_ms = 10000;
     config->auto_reconnect = true;
     config->max_reconnect_attempts = 10;
+    config->enable_compression = false;
+    config->compression_no_context_takeover = false;
+    config->busy_poll = false;
+    config->busy_poll_cpu = -1;
+    config->busy_poll_us = 0;
+    config->address_index = 0;
+    config->io_backend = HL_WS_IO_POLL;
 }
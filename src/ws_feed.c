@@ -0,0 +1,71 @@
+/**
+ * @file ws_feed.c
+ * @brief Arbitration between two copies of the same stream
+ *
+ * Copies are matched by a key over channel, coin and exchange stamps. The
+ * first copy processed is delivered; the second is dropped and records
+ * how far its feed was behind. websocket.c calls these under the registry
+ * lock.
+ */
+
+#include "hl_internal.h"
+
+/**
+ * @brief Allocate the seen slots and clear the tallies
+ */
+bool hl_ws_feed_arbiter_init(hl_ws_feed_arbiter_t* arbiter) {
+    memset(arbiter, 0, sizeof(*arbiter));
+    arbiter->seen = calloc(HL_WS_FEED_SEEN_SLOTS, sizeof(hl_ws_feed_seen_t));
+    return arbiter->seen != NULL;
+}
+
+void hl_ws_feed_arbiter_free(hl_ws_feed_arbiter_t* arbiter) {
+    free(arbiter->seen);
+    arbiter->seen = NULL;
+}
+
+/**
+ * @brief FNV-1a over channel and coin, mixed with the message stamps
+ *
+ * Never 0, which marks an empty slot.
+ */
+uint64_t hl_ws_feed_key(const char* channel, const char* coin, int64_t time, int64_t tid) {
+    const uint64_t prime = 1099511628211ULL;
+    uint64_t hash = 14695981039346656037ULL;
+
+    for (const char* c = channel; *c; c++) hash = (hash ^ (uint8_t)*c) * prime;
+    hash = (hash ^ '/') * prime;
+    for (const char* c = coin; *c; c++) hash = (hash ^ (uint8_t)*c) * prime;
+    hash = (hash ^ (uint64_t)time) * prime;
+    hash = (hash ^ (uint64_t)tid) * prime;
+
+    return hash | 1;
+}
+
+/**
+ * @brief Admit the first copy of a message, record the lag of the second
+ *
+ * @return true if the copy should be delivered
+ */
+bool hl_ws_feed_admit(hl_ws_feed_arbiter_t* arbiter, int feed, uint64_t key,
+                      int64_t recv_time_ns) {
+    hl_ws_feed_seen_t* seen = &arbiter->seen[key & (HL_WS_FEED_SEEN_SLOTS - 1)];
+    hl_ws_feed_tally_t* tally = &arbiter->tally[feed];
+    tally->messages++;
+
+    if (seen->key == key && seen->feed != feed) {
+        // The other feed won. A copy read first that lost the race for the
+        // lock is a loss with zero lag.
+        double lag_ms = (double)(recv_time_ns - seen->recv_time_ns) / 1e6;
+        hl_ws_window_add(&tally->lag, lag_ms > 0.0 ? lag_ms : 0.0);
+        seen->key = 0;
+        return false;
+    }
+
+    // New message, or its slot was taken by a later one: deliver
+    seen->key = key;
+    seen->recv_time_ns = recv_time_ns;
+    seen->feed = (uint8_t)feed;
+    tally->wins++;
+    return true;
+}
@@ -0,0 +1,343 @@
+/**
+ * @file ws_record.c
+ * @brief Capture and replay of raw WebSocket streams
+ *
+ * The recorder appends messages through a large stdio buffer from the I/O
+ * thread; the reader maps the whole file and walks it record by record, so
+ * replaying an uncompressed capture never copies message bytes.
+ */
+
+#define _GNU_SOURCE
+
+#include "hl_ws_record.h"
+#include "hl_logger.h"
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <errno.h>
+#include <time.h>
+#include <pthread.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <zlib.h>
+
+#define WS_RECORD_HEADER_SIZE 32
+#define WS_RECORD_PREFIX_SIZE 16
+#define WS_RECORD_STDIO_BUFFER (1u << 20)
+#define WS_RECORD_MAX_MESSAGE (256u << 20)
+
+struct hl_ws_recorder {
+    FILE* file;
+    char* stdio_buf;
+    bool compress;
+    uint8_t* zbuf;                  /**< Reusable compression buffer */
+    size_t zcap;
+    uint64_t count;
+    pthread_mutex_t mutex;
+};
+
+struct hl_ws_replay {
+    const uint8_t* base;
+    size_t size;
+    size_t offset;                  /**< Next record */
+    int64_t last_recv_ns;           /**< Timestamp of the last returned record */
+    uint32_t flags;
+    char* buf;                      /**< Reusable decompression buffer */
+    size_t cap;
+};
+
+typedef struct {
+    uint32_t stored_len;
+    uint32_t raw_len;               /**< Equal to stored_len when not compressed */
+    int64_t recv_time_ns;
+} ws_record_prefix_t;
+
+/**
+ * @brief Record size including prefix and padding (at least one NUL byte)
+ */
+static size_t ws_record_span(uint32_t stored_len) {
+    return WS_RECORD_PREFIX_SIZE + (((size_t)stored_len + 8) & ~(size_t)7);
+}
+
+// ============================================================================
+// Recorder
+// ============================================================================
+
+/**
+ * @brief Create a capture file
+ */
+hl_ws_recorder_t* hl_ws_recorder_open(const char* path, bool compress) {
+    if (!path) return NULL;
+
+    hl_ws_recorder_t* recorder = calloc(1, sizeof(hl_ws_recorder_t));
+    if (!recorder) return NULL;
+
+    recorder->file = fopen(path, "wb");
+    if (!recorder->file) {
+        HL_LOG_ERROR("Cannot open capture file %s: %s", path, strerror(errno));
+        free(recorder);
+        return NULL;
+    }
+
+    recorder->stdio_buf = malloc(WS_RECORD_STDIO_BUFFER);
+    if (recorder->stdio_buf) {
+        setvbuf(recorder->file, recorder->stdio_buf, _IOFBF, WS_RECORD_STDIO_BUFFER);
+    }
+    recorder->compress = compress;
+    pthread_mutex_init(&recorder->mutex, NULL);
+
+    uint8_t header[WS_RECORD_HEADER_SIZE] = {0};
+    uint32_t version = HL_WS_RECORD_VERSION;
+    uint32_t flags = compress ? HL_WS_RECORD_FLAG_COMPRESSED : 0;
+    memcpy(header, HL_WS_RECORD_MAGIC, 8);
+    memcpy(header + 8, &version, sizeof(version));
+    memcpy(header + 12, &flags, sizeof(flags));
+
+    if (fwrite(header, 1, sizeof(header), recorder->file) != sizeof(header)) {
+        hl_ws_recorder_close(recorder);
+        return NULL;
+    }
+
+    return recorder;
+}
+
+/**
+ * @brief Append one message
+ */
+bool hl_ws_recorder_write(hl_ws_recorder_t* recorder, const char* message, size_t size,
+                          int64_t recv_time_ns) {
+    if (!recorder || !message || size > WS_RECORD_MAX_MESSAGE) return false;
+
+    static const uint8_t zeros[8] = {0};
+
+    pthread_mutex_lock(&recorder->mutex);
+
+    const uint8_t* data = (const uint8_t*)message;
+    ws_record_prefix_t prefix = {
+        .stored_len = (uint32_t)size,
+        .raw_len = (uint32_t)size,
+        .recv_time_ns = recv_time_ns
+    };
+
+    if (recorder->compress) {
+        uLongf bound = compressBound((uLong)size);
+        if (bound > recorder->zcap) {
+            uint8_t* grown = realloc(recorder->zbuf, bound);
+            if (grown) {
+                recorder->zbuf = grown;
+                recorder->zcap = bound;
+            }
+        }
+        uLongf zlen = (uLongf)recorder->zcap;
+        // Small messages often grow under deflate; keep whichever is smaller
+        if (bound <= recorder->zcap &&
+            compress2(recorder->zbuf, &zlen, data, (uLong)size, Z_BEST_SPEED) == Z_OK &&
+            zlen < size) {
+            data = recorder->zbuf;
+            prefix.stored_len = (uint32_t)zlen;
+        }
+    }
+
+    size_t padding = ws_record_span(prefix.stored_len) - WS_RECORD_PREFIX_SIZE - prefix.stored_len;
+    bool ok = fwrite(&prefix, 1, sizeof(prefix), recorder->file) == sizeof(prefix) &&
+              fwrite(data, 1, prefix.stored_len, recorder->file) == prefix.stored_len &&
+              fwrite(zeros, 1, padding, recorder->file) == padding;
+    if (ok) recorder->count++;
+
+    pthread_mutex_unlock(&recorder->mutex);
+    return ok;
+}
+
+/**
+ * @brief Number of messages written
+ */
+uint64_t hl_ws_recorder_count(const hl_ws_recorder_t* recorder) {
+    if (!recorder) return 0;
+    hl_ws_recorder_t* mutable_recorder = (hl_ws_recorder_t*)recorder;
+    pthread_mutex_lock(&mutable_recorder->mutex);
+    uint64_t count = recorder->count;
+    pthread_mutex_unlock(&mutable_recorder->mutex);
+    return count;
+}
+
+/**
+ * @brief Flush and close capture file
+ */
+void hl_ws_recorder_close(hl_ws_recorder_t* recorder) {
+    if (!recorder) return;
+
+    if (recorder->file) {
+        fclose(recorder->file);
+    }
+    pthread_mutex_destroy(&recorder->mutex);
+    free(recorder->stdio_buf);
+    free(recorder->zbuf);
+    free(recorder);
+}
+
+// ============================================================================
+// Replay
+// ============================================================================
+
+/**
+ * @brief Open a capture file for reading
+ */
+hl_ws_replay_t* hl_ws_replay_open(const char* path) {
+    if (!path) return NULL;
+
+    int fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        HL_LOG_ERROR("Cannot open capture file %s: %s", path, strerror(errno));
+        return NULL;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size < WS_RECORD_HEADER_SIZE) {
+        close(fd);
+        return NULL;
+    }
+
+    void* base = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (base == MAP_FAILED) return NULL;
+
+    madvise(base, (size_t)st.st_size, MADV_SEQUENTIAL);
+
+    uint32_t version;
+    uint32_t flags;
+    memcpy(&version, (const uint8_t*)base + 8, sizeof(version));
+    memcpy(&flags, (const uint8_t*)base + 12, sizeof(flags));
+    if (memcmp(base, HL_WS_RECORD_MAGIC, 8) != 0 || version != HL_WS_RECORD_VERSION) {
+        HL_LOG_ERROR("%s is not a capture file", path);
+        munmap(base, (size_t)st.st_size);
+        return NULL;
+    }
+
+    hl_ws_replay_t* replay = calloc(1, sizeof(hl_ws_replay_t));
+    if (!replay) {
+        munmap(base, (size_t)st.st_size);
+        return NULL;
+    }
+
+    replay->base = base;
+    replay->size = (size_t)st.st_size;
+    replay->offset = WS_RECORD_HEADER_SIZE;
+    replay->flags = flags;
+    return replay;
+}
+
+/**
+ * @brief Read the next message
+ */
+bool hl_ws_replay_next(hl_ws_replay_t* replay, const char** message, size_t* size,
+                       int64_t* recv_time_ns) {
+    if (!replay || !message || !size) return false;
+
+    if (replay->size - replay->offset < WS_RECORD_PREFIX_SIZE) return false;
+
+    ws_record_prefix_t prefix;
+    memcpy(&prefix, replay->base + replay->offset, sizeof(prefix));
+
+    size_t span = ws_record_span(prefix.stored_len);
+    if (span > replay->size - replay->offset || prefix.raw_len > WS_RECORD_MAX_MESSAGE) {
+        HL_LOG_ERROR("Truncated capture record at offset %zu", replay->offset);
+        return false;
+    }
+
+    const uint8_t* data = replay->base + replay->offset + WS_RECORD_PREFIX_SIZE;
+
+    if (prefix.stored_len == prefix.raw_len) {
+        // Stored verbatim; the padding provides the terminating NUL
+        *message = (const char*)data;
+    } else {
+        if ((size_t)prefix.raw_len + 1 > replay->cap) {
+            char* grown = realloc(replay->buf, (size_t)prefix.raw_len + 1);
+            if (!grown) return false;
+            replay->buf = grown;
+            replay->cap = (size_t)prefix.raw_len + 1;
+        }
+        uLongf out_len = prefix.raw_len;
+        if (uncompress((Bytef*)replay->buf, &out_len, data, prefix.stored_len) != Z_OK ||
+            out_len != prefix.raw_len) {
+            HL_LOG_ERROR("Corrupt compressed record at offset %zu", replay->offset);
+            return false;
+        }
+        replay->buf[out_len] = '\0';
+        *message = replay->buf;
+    }
+
+    *size = prefix.raw_len;
+    replay->last_recv_ns = prefix.recv_time_ns;
+    if (recv_time_ns) *recv_time_ns = prefix.recv_time_ns;
+    replay->offset += span;
+    return true;
+}
+
+/**
+ * @brief Recorded receive time of the message last returned
+ */
+int64_t hl_ws_replay_time_ns(const hl_ws_replay_t* replay) {
+    return replay ? replay->last_recv_ns : 0;
+}
+
+/**
+ * @brief Rewind to the first message
+ */
+void hl_ws_replay_rewind(hl_ws_replay_t* replay) {
+    if (!replay) return;
+    replay->offset = WS_RECORD_HEADER_SIZE;
+    replay->last_recv_ns = 0;
+}
+
+/**
+ * @brief Feed every message to a callback, paced by recorded timestamps
+ */
+uint64_t hl_ws_replay_run(hl_ws_replay_t* replay, double speed,
+                          hl_ws_message_callback_t callback, void* user_data) {
+    if (!replay || !callback) return 0;
+
+    const char* message;
+    size_t size;
+    int64_t recv_ns;
+    int64_t first_recv_ns = 0;
+    struct timespec start;
+    uint64_t delivered = 0;
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+
+    while (hl_ws_replay_next(replay, &message, &size, &recv_ns)) {
+        if (delivered == 0) first_recv_ns = recv_ns;
+
+        if (speed > 0.0 && recv_ns > first_recv_ns) {
+            // Absolute deadlines keep callback time from accumulating as drift
+            int64_t due_ns = (int64_t)((double)(recv_ns - first_recv_ns) / speed);
+            struct timespec deadline = start;
+            deadline.tv_sec += (time_t)(due_ns / 1000000000LL);
+            deadline.tv_nsec += (long)(due_ns % 1000000000LL);
+            if (deadline.tv_nsec >= 1000000000L) {
+                deadline.tv_sec++;
+                deadline.tv_nsec -= 1000000000L;
+            }
+            while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &deadline, NULL) == EINTR) {
+            }
+        }
+
+        callback(message, size, user_data);
+        delivered++;
+    }
+
+    return delivered;
+}
+
+/**
+ * @brief Close replay handle
+ */
+void hl_ws_replay_close(hl_ws_replay_t* replay) {
+    if (!replay) return;
+
+    munmap((void*)replay->base, replay->size);
+    free(replay->buf);
+    free(replay);
+}
@@ -0,0 +1,101 @@
+/**
+ * @file ws_stats.c
+ * @brief Rolling latency windows and the server clock-offset estimator
+ *
+ * Pure bookkeeping over samples the WebSocket client measures: ping/pong
+ * round trips and the delay of server-stamped messages. Callers provide
+ * their own locking.
+ */
+
+#include "hl_internal.h"
+
+/**
+ * @brief Add a sample to a rolling window, tracking the minimum incrementally
+ */
+void hl_ws_window_add(hl_ws_window_t* window, double value) {
+    size_t slot = window->next;
+    bool evicts_min = window->count == HL_WS_STATS_WINDOW && slot == window->min_index;
+    window->values[slot] = value;
+    window->next = (slot + 1) % HL_WS_STATS_WINDOW;
+    if (window->count < HL_WS_STATS_WINDOW) window->count++;
+    window->total++;
+
+    if (evicts_min) {
+        // The minimum was just overwritten; rescan
+        for (size_t i = 0; i < window->count; i++) {
+            if (window->values[i] < window->values[window->min_index]) {
+                window->min_index = i;
+            }
+        }
+    } else if (window->count == 1 || value <= window->values[window->min_index]) {
+        window->min_index = slot;
+    }
+}
+
+static int compare_double(const void* a, const void* b) {
+    double x = *(const double*)a;
+    double y = *(const double*)b;
+    return (x > y) - (x < y);
+}
+
+/**
+ * @brief Summarize a rolling window into min/mean/percentiles/max
+ */
+void hl_ws_window_summarize(const hl_ws_window_t* window, hl_ws_latency_t* out) {
+    memset(out, 0, sizeof(*out));
+    out->total_samples = window->total;
+    out->window_samples = window->count;
+    if (window->count == 0) return;
+
+    double sorted[HL_WS_STATS_WINDOW];
+    double sum = 0.0;
+    memcpy(sorted, window->values, window->count * sizeof(double));
+    for (size_t i = 0; i < window->count; i++) sum += sorted[i];
+    qsort(sorted, window->count, sizeof(double), compare_double);
+
+    size_t n = window->count;
+    out->last = window->values[(window->next + HL_WS_STATS_WINDOW - 1) % HL_WS_STATS_WINDOW];
+    out->min = sorted[0];
+    out->mean = sum / (double)n;
+    out->p50 = sorted[(n - 1) * 50 / 100];
+    out->p90 = sorted[(n - 1) * 90 / 100];
+    out->p99 = sorted[(n - 1) * 99 / 100];
+    out->max = sorted[n - 1];
+}
+
+/**
+ * @brief Re-derive the offset from the delay and RTT minima
+ *
+ * The least delayed message spent at least half the fastest round trip on
+ * the wire; what is left of its delay is the difference between the clocks.
+ */
+static void clock_update_offset(hl_ws_clock_t* clock) {
+    if (clock->delay.count == 0) return;
+
+    double min_delay = clock->delay.values[clock->delay.min_index];
+    double half_rtt = clock->rtt.total > 0 ? clock->rtt_min_ms / 2.0 : 0.0;
+    clock->offset_ms = min_delay - half_rtt;
+    clock->offset_valid = true;
+}
+
+/**
+ * @brief Record a ping/pong round trip
+ */
+void hl_ws_clock_add_rtt(hl_ws_clock_t* clock, double rtt_ms) {
+    hl_ws_window_add(&clock->rtt, rtt_ms);
+    if (clock->rtt.total == 1 || rtt_ms < clock->rtt_min_ms) {
+        clock->rtt_min_ms = rtt_ms;
+        clock_update_offset(clock);
+    }
+}
+
+/**
+ * @brief Record receive time minus server timestamp
+ *
+ * @return The sample's delay corrected by the current offset
+ */
+double hl_ws_clock_add_delay(hl_ws_clock_t* clock, double delay_ms) {
+    hl_ws_window_add(&clock->delay, delay_ms);
+    clock_update_offset(clock);
+    return delay_ms - clock->offset_ms;
+}
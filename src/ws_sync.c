@@ -0,0 +1,81 @@
+/**
+ * @file ws_sync.c
+ * @brief Subscription set diffing and the send token bucket
+ *
+ * Pure functions over caller-owned state; websocket.c holds the registry
+ * and connection locks around them.
+ */
+
+#include "hl_internal.h"
+
+/**
+ * @brief Mark dropped current entries and new wanted entries
+ *
+ * A wanted entry repeated in the list is only added once.
+ */
+void hl_ws_topic_diff(hl_ws_topic_ref_t* current, size_t current_count,
+                      hl_ws_topic_ref_t* wanted, size_t wanted_count,
+                      size_t* added, size_t* removed) {
+    size_t dropped = 0;
+    size_t fresh = 0;
+
+    for (size_t i = 0; i < current_count; i++) {
+        bool kept = false;
+        for (size_t t = 0; t < wanted_count && !kept; t++) {
+            kept = strcmp(wanted[t].subscription, current[i].subscription) == 0;
+        }
+        current[i].changed = !kept;
+        if (!kept) dropped++;
+    }
+
+    for (size_t t = 0; t < wanted_count; t++) {
+        bool present = false;
+        for (size_t u = 0; u < t && !present; u++) {
+            present = strcmp(wanted[u].subscription, wanted[t].subscription) == 0;
+        }
+        for (size_t i = 0; i < current_count && !present; i++) {
+            present = strcmp(current[i].subscription, wanted[t].subscription) == 0;
+        }
+        wanted[t].changed = !present;
+        if (!present) fresh++;
+    }
+
+    if (added) *added = fresh;
+    if (removed) *removed = dropped;
+}
+
+/**
+ * @brief Start with a full minute's budget
+ */
+void hl_ws_bucket_init(hl_ws_bucket_t* bucket, int64_t now_ns) {
+    bucket->tokens = HL_WS_MESSAGES_PER_MINUTE;
+    bucket->refill_ns = now_ns;
+}
+
+/**
+ * @brief Take tokens for the next write
+ *
+ * Refills at HL_WS_MESSAGES_PER_MINUTE per minute up to one minute's
+ * budget, then takes up to one batch of @p wanted messages.
+ *
+ * @return Messages that may be written now; 0 with @p wait_ns set to the
+ *         time until the next token when the bucket is empty
+ */
+size_t hl_ws_bucket_take(hl_ws_bucket_t* bucket, size_t wanted, int64_t now_ns,
+                         int64_t* wait_ns) {
+    const double per_ns = HL_WS_MESSAGES_PER_MINUTE / 60e9;
+
+    if (now_ns > bucket->refill_ns) {
+        bucket->tokens += (double)(now_ns - bucket->refill_ns) * per_ns;
+        if (bucket->tokens > HL_WS_MESSAGES_PER_MINUTE) bucket->tokens = HL_WS_MESSAGES_PER_MINUTE;
+        bucket->refill_ns = now_ns;
+    }
+
+    size_t take = wanted;
+    if (take > HL_WS_SEND_BATCH) take = HL_WS_SEND_BATCH;
+    if (take > (size_t)bucket->tokens) take = (size_t)bucket->tokens;
+    bucket->tokens -= (double)take;
+
+    if (wait_ns) *wait_ns = take ? 0 : (int64_t)((1.0 - bucket->tokens) / per_ns) + 1;
+    return take;
+}
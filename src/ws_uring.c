@@ -0,0 +1,404 @@
+/**
+ * @file ws_uring.c
+ * @brief io_uring receive loop for WebSocket connections
+ *
+ * One small ring per I/O thread, driven through the raw system calls. Plain
+ * sockets are read with multishot receive into a registered pool of
+ * provided buffers: one armed request keeps delivering data, and a single
+ * io_uring_enter() both submits any re-arm and waits for the next batch of
+ * completions. TLS sockets use multishot poll instead, since their records
+ * have to be read through OpenSSL.
+ */
+
+#define _GNU_SOURCE
+
+#include "hl_ws_uring.h"
+#include "hl_logger.h"
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef __linux__
+#include <linux/io_uring.h>
+#endif
+
+// Multishot receive (Linux 6.0) implies provided buffer rings (5.19)
+#if defined(__linux__) && defined(IORING_RECV_MULTISHOT)
+
+#include <errno.h>
+#include <poll.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#define URING_ENTRIES 8
+#define URING_BUFFER_GROUP 0
+
+struct hl_ws_uring {
+    int fd;
+
+    // Submission queue
+    void* ring_map;
+    size_t ring_map_size;
+    unsigned* sq_head;
+    unsigned* sq_tail;
+    unsigned sq_mask;
+    unsigned sq_entries;
+    unsigned* sq_array;
+    struct io_uring_sqe* sqes;
+    size_t sqes_size;
+    unsigned to_submit;                 /**< Queued but not yet submitted */
+
+    // Completion queue
+    unsigned* cq_head;
+    unsigned* cq_tail;
+    unsigned cq_mask;
+    struct io_uring_cqe* cqes;
+
+    // Provided buffers
+    struct io_uring_buf_ring* buf_ring;
+    size_t buf_ring_size;
+    uint16_t buf_tail;
+    uint8_t* buffers;
+    size_t buffer_size;
+    unsigned buffer_count;
+
+    // Current watch
+    int watch_fd;                       /**< -1 when nothing is watched */
+    bool watch_recv;                    /**< Multishot receive, else multishot poll */
+    bool watch_armed;                   /**< Kernel still holds the multishot request */
+    uint64_t generation;                /**< user_data of the current watch */
+};
+
+static int uring_setup(unsigned entries, struct io_uring_params* params) {
+    return (int)syscall(__NR_io_uring_setup, entries, params);
+}
+
+static int uring_enter(int fd, unsigned to_submit, unsigned min_complete, unsigned flags,
+                       const void* arg, size_t arg_size) {
+    return (int)syscall(__NR_io_uring_enter, fd, to_submit, min_complete, flags, arg, arg_size);
+}
+
+static int uring_register(int fd, unsigned opcode, const void* arg, unsigned count) {
+    return (int)syscall(__NR_io_uring_register, fd, opcode, arg, count);
+}
+
+/**
+ * @brief Queue one request; the caller fills the returned entry
+ */
+static struct io_uring_sqe* uring_queue(hl_ws_uring_t* ring) {
+    unsigned head = __atomic_load_n(ring->sq_head, __ATOMIC_ACQUIRE);
+    unsigned tail = *ring->sq_tail;
+    if (tail - head >= ring->sq_entries) return NULL;
+
+    struct io_uring_sqe* sqe = &ring->sqes[tail & ring->sq_mask];
+    memset(sqe, 0, sizeof(*sqe));
+    ring->sq_array[tail & ring->sq_mask] = tail & ring->sq_mask;
+    return sqe;
+}
+
+/**
+ * @brief Publish the entry returned by uring_queue()
+ */
+static void uring_commit(hl_ws_uring_t* ring) {
+    __atomic_store_n(ring->sq_tail, *ring->sq_tail + 1, __ATOMIC_RELEASE);
+    ring->to_submit++;
+}
+
+/**
+ * @brief Hand a buffer back to the kernel's pool
+ */
+static void uring_recycle(hl_ws_uring_t* ring, unsigned bid) {
+    struct io_uring_buf* buf = &ring->buf_ring->bufs[ring->buf_tail & (ring->buffer_count - 1)];
+    buf->addr = (uint64_t)(uintptr_t)(ring->buffers + (size_t)bid * ring->buffer_size);
+    buf->len = (uint32_t)ring->buffer_size;
+    buf->bid = (uint16_t)bid;
+    ring->buf_tail++;
+    __atomic_store_n(&ring->buf_ring->tail, ring->buf_tail, __ATOMIC_RELEASE);
+}
+
+hl_ws_uring_t* hl_ws_uring_create(size_t buffer_size, unsigned buffer_count) {
+    if (buffer_size == 0 || buffer_count == 0 || (buffer_count & (buffer_count - 1)) != 0 ||
+        buffer_count > 32768) {
+        return NULL;
+    }
+
+    hl_ws_uring_t* ring = calloc(1, sizeof(hl_ws_uring_t));
+    if (!ring) return NULL;
+    ring->fd = -1;
+    ring->watch_fd = -1;
+
+    // Only the I/O thread submits; defer completion work to its waits
+    struct io_uring_params params;
+    memset(&params, 0, sizeof(params));
+#if defined(IORING_SETUP_SINGLE_ISSUER) && defined(IORING_SETUP_DEFER_TASKRUN)
+    params.flags = IORING_SETUP_SINGLE_ISSUER | IORING_SETUP_DEFER_TASKRUN;
+#endif
+    ring->fd = uring_setup(URING_ENTRIES, &params);
+    if (ring->fd < 0 && params.flags != 0) {
+        memset(&params, 0, sizeof(params));
+        ring->fd = uring_setup(URING_ENTRIES, &params);
+    }
+    if (ring->fd < 0) {
+        HL_LOG_DEBUG("io_uring: setup failed (errno %d)", errno);
+        free(ring);
+        return NULL;
+    }
+    if (!(params.features & IORING_FEAT_SINGLE_MMAP) || !(params.features & IORING_FEAT_EXT_ARG)) {
+        HL_LOG_DEBUG("io_uring: kernel lacks %s", "single mmap or extended wait arguments");
+        hl_ws_uring_destroy(ring);
+        return NULL;
+    }
+
+    size_t sq_size = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    size_t cq_size = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+    ring->ring_map_size = sq_size > cq_size ? sq_size : cq_size;
+    ring->ring_map = mmap(NULL, ring->ring_map_size, PROT_READ | PROT_WRITE,
+                          MAP_SHARED | MAP_POPULATE, ring->fd, IORING_OFF_SQ_RING);
+    if (ring->ring_map == MAP_FAILED) {
+        ring->ring_map = NULL;
+        hl_ws_uring_destroy(ring);
+        return NULL;
+    }
+
+    ring->sqes_size = params.sq_entries * sizeof(struct io_uring_sqe);
+    ring->sqes = mmap(NULL, ring->sqes_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                      ring->fd, IORING_OFF_SQES);
+    if (ring->sqes == MAP_FAILED) {
+        ring->sqes = NULL;
+        hl_ws_uring_destroy(ring);
+        return NULL;
+    }
+
+    uint8_t* base = ring->ring_map;
+    ring->sq_head = (unsigned*)(base + params.sq_off.head);
+    ring->sq_tail = (unsigned*)(base + params.sq_off.tail);
+    ring->sq_mask = *(unsigned*)(base + params.sq_off.ring_mask);
+    ring->sq_entries = *(unsigned*)(base + params.sq_off.ring_entries);
+    ring->sq_array = (unsigned*)(base + params.sq_off.array);
+    ring->cq_head = (unsigned*)(base + params.cq_off.head);
+    ring->cq_tail = (unsigned*)(base + params.cq_off.tail);
+    ring->cq_mask = *(unsigned*)(base + params.cq_off.ring_mask);
+    ring->cqes = (struct io_uring_cqe*)(base + params.cq_off.cqes);
+
+    // Buffer ring: page-aligned descriptors shared with the kernel
+    long page = sysconf(_SC_PAGESIZE);
+    size_t descriptors = buffer_count * sizeof(struct io_uring_buf);
+    ring->buf_ring_size = (descriptors + (size_t)page - 1) & ~((size_t)page - 1);
+    ring->buf_ring = mmap(NULL, ring->buf_ring_size, PROT_READ | PROT_WRITE,
+                          MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    ring->buffer_size = buffer_size;
+    ring->buffer_count = buffer_count;
+    ring->buffers = malloc(buffer_size * buffer_count);
+    if (ring->buf_ring == MAP_FAILED || !ring->buffers) {
+        if (ring->buf_ring == MAP_FAILED) ring->buf_ring = NULL;
+        hl_ws_uring_destroy(ring);
+        return NULL;
+    }
+
+    struct io_uring_buf_reg reg;
+    memset(&reg, 0, sizeof(reg));
+    reg.ring_addr = (uint64_t)(uintptr_t)ring->buf_ring;
+    reg.ring_entries = buffer_count;
+    reg.bgid = URING_BUFFER_GROUP;
+    if (uring_register(ring->fd, IORING_REGISTER_PBUF_RING, &reg, 1) != 0) {
+        HL_LOG_DEBUG("io_uring: buffer ring registration failed (errno %d)", errno);
+        hl_ws_uring_destroy(ring);
+        return NULL;
+    }
+    for (unsigned bid = 0; bid < buffer_count; bid++) {
+        uring_recycle(ring, bid);
+    }
+
+    return ring;
+}
+
+void hl_ws_uring_destroy(hl_ws_uring_t* ring) {
+    if (!ring) return;
+
+    // Closing the ring cancels outstanding requests and drops the buffer ring
+    if (ring->fd >= 0) close(ring->fd);
+    if (ring->sqes) munmap(ring->sqes, ring->sqes_size);
+    if (ring->ring_map) munmap(ring->ring_map, ring->ring_map_size);
+    if (ring->buf_ring) munmap(ring->buf_ring, ring->buf_ring_size);
+    free(ring->buffers);
+    free(ring);
+}
+
+/**
+ * @brief Queue the multishot request of the current watch
+ */
+static bool uring_arm(hl_ws_uring_t* ring) {
+    struct io_uring_sqe* sqe = uring_queue(ring);
+    if (!sqe) return false;
+
+    sqe->fd = ring->watch_fd;
+    sqe->user_data = ring->generation;
+    if (ring->watch_recv) {
+        sqe->opcode = IORING_OP_RECV;
+        sqe->ioprio = IORING_RECV_MULTISHOT;
+        sqe->flags = IOSQE_BUFFER_SELECT;
+        sqe->buf_group = URING_BUFFER_GROUP;
+    } else {
+        sqe->opcode = IORING_OP_POLL_ADD;
+        sqe->len = IORING_POLL_ADD_MULTI;
+        sqe->poll32_events = POLLIN | POLLRDHUP;
+    }
+    uring_commit(ring);
+
+    ring->watch_armed = true;
+    return true;
+}
+
+/**
+ * @brief Queue cancellation of the current multishot request
+ */
+static void uring_cancel(hl_ws_uring_t* ring) {
+    if (!ring->watch_armed) return;
+
+    struct io_uring_sqe* sqe = uring_queue(ring);
+    if (sqe) {
+        sqe->opcode = IORING_OP_ASYNC_CANCEL;
+        sqe->addr = ring->generation;
+        uring_commit(ring);
+    }
+    ring->watch_armed = false;
+}
+
+static bool uring_watch(hl_ws_uring_t* ring, int fd, bool recv) {
+    if (!ring || fd < 0) return false;
+
+    // Stop the previous request; its late completions no longer match
+    uring_cancel(ring);
+
+    ring->generation++;
+    ring->watch_fd = fd;
+    ring->watch_recv = recv;
+    return uring_arm(ring);
+}
+
+void hl_ws_uring_unwatch(hl_ws_uring_t* ring) {
+    if (!ring || ring->watch_fd < 0) return;
+
+    uring_cancel(ring);
+    ring->generation++;
+    ring->watch_fd = -1;
+
+    // Submit now so the kernel drops its reference to the socket
+    int rc = uring_enter(ring->fd, ring->to_submit, 0, IORING_ENTER_GETEVENTS, NULL, 0);
+    if (rc > 0) {
+        ring->to_submit -= (unsigned)rc < ring->to_submit ? (unsigned)rc : ring->to_submit;
+    }
+}
+
+bool hl_ws_uring_watch_recv(hl_ws_uring_t* ring, int fd) {
+    return uring_watch(ring, fd, true);
+}
+
+bool hl_ws_uring_watch_poll(hl_ws_uring_t* ring, int fd) {
+    return uring_watch(ring, fd, false);
+}
+
+int hl_ws_uring_wait(hl_ws_uring_t* ring, int timeout_ms, hl_ws_uring_handler_t handler,
+                     void* ctx) {
+    if (!ring || !handler) return -1;
+
+    // The kernel ends a multishot receive when the pool runs dry
+    if (!ring->watch_armed && ring->watch_fd >= 0 && !uring_arm(ring)) return -1;
+
+    if (timeout_ms < 0) timeout_ms = 0;
+    struct __kernel_timespec ts = {
+        .tv_sec = timeout_ms / 1000,
+        .tv_nsec = (long long)(timeout_ms % 1000) * 1000000LL
+    };
+    struct io_uring_getevents_arg arg;
+    memset(&arg, 0, sizeof(arg));
+    arg.sigmask_sz = _NSIG / 8;
+    arg.ts = (uint64_t)(uintptr_t)&ts;
+
+    // Submit and wait in one call
+    int rc = uring_enter(ring->fd, ring->to_submit, 1,
+                         IORING_ENTER_GETEVENTS | IORING_ENTER_EXT_ARG, &arg, sizeof(arg));
+    if (rc >= 0) {
+        ring->to_submit -= (unsigned)rc < ring->to_submit ? (unsigned)rc : ring->to_submit;
+    } else if (errno != ETIME && errno != EINTR && errno != EBUSY) {
+        return -1;
+    }
+
+    unsigned head = *ring->cq_head;
+    unsigned tail = __atomic_load_n(ring->cq_tail, __ATOMIC_ACQUIRE);
+    bool stopped = false;
+    int handled = 0;
+
+    while (head != tail) {
+        const struct io_uring_cqe* cqe = &ring->cqes[head & ring->cq_mask];
+        int res = cqe->res;
+        unsigned flags = cqe->flags;
+        bool current = cqe->user_data != 0 && cqe->user_data == ring->generation;
+        head++;
+
+        bool has_buffer = (flags & IORING_CQE_F_BUFFER) != 0;
+        unsigned bid = flags >> IORING_CQE_BUFFER_SHIFT;
+
+        if (current) {
+            if (!(flags & IORING_CQE_F_MORE)) ring->watch_armed = false;
+
+            if (ring->watch_recv && res == -ENOBUFS) {
+                // Pool ran dry; re-armed on the next wait once buffers are back
+            } else if (!stopped) {
+                const uint8_t* data = has_buffer && res > 0 ?
+                    ring->buffers + (size_t)bid * ring->buffer_size : NULL;
+                if (res <= 0 && !ring->watch_armed) {
+                    // Peer closed or failed; do not re-arm on this socket
+                    ring->watch_fd = -1;
+                }
+                stopped = !handler(ctx, data, res);
+                handled++;
+            }
+        }
+
+        if (has_buffer) uring_recycle(ring, bid);
+    }
+    __atomic_store_n(ring->cq_head, head, __ATOMIC_RELEASE);
+
+    return handled;
+}
+
+#else
+
+hl_ws_uring_t* hl_ws_uring_create(size_t buffer_size, unsigned buffer_count) {
+    (void)buffer_size;
+    (void)buffer_count;
+    return NULL;
+}
+
+void hl_ws_uring_destroy(hl_ws_uring_t* ring) {
+    (void)ring;
+}
+
+bool hl_ws_uring_watch_recv(hl_ws_uring_t* ring, int fd) {
+    (void)ring;
+    (void)fd;
+    return false;
+}
+
+bool hl_ws_uring_watch_poll(hl_ws_uring_t* ring, int fd) {
+    (void)ring;
+    (void)fd;
+    return false;
+}
+
+void hl_ws_uring_unwatch(hl_ws_uring_t* ring) {
+    (void)ring;
+}
+
+int hl_ws_uring_wait(hl_ws_uring_t* ring, int timeout_ms, hl_ws_uring_handler_t handler,
+                     void* ctx) {
+    (void)ring;
+    (void)timeout_ms;
+    (void)handler;
+    (void)ctx;
+    return -1;
+}
+
+#endif
@@ -58,13 +58,6 @@ void test_destroy_client(hl_client_t* client) {
     }
 }
 
-void test_assert(bool condition, const char* message) {
-    if (!condition) {
-        printf("❌ ASSERTION FAILED: %s\n", message);
-        abort();
-    }
-}
-
 void test_assert_success(hl_error_t err, const char* context) {
     if (err != HL_SUCCESS) {
         printf("❌ %s failed with error: %s\n", context, hl_error_string(err));
@@ -72,65 +65,6 @@ void test_assert_success(hl_error_t err, const char* context) {
     }
 }
 
-void test_assert_not_null(void* ptr, const char* context) {
-    if (!ptr) {
-        printf("❌ %s returned NULL\n", context);
-        abort();
-    }
-}
-
-void test_assert_equals(int expected, int actual, const char* message) {
-    if (expected != actual) {
-        printf("❌ %s: expected %d, got %d\n", message, expected, actual);
-        abort();
-    }
-}
-
-void test_print_header(const char* test_name) {
-    printf("\n╔══════════════════════════════════════════╗\n");
-    printf("║  TEST: %-32s ║\n", test_name);
-    printf("╚══════════════════════════════════════════╝\n\n");
-}
-
-void test_print_result(const char* test_name, test_result_t result) {
-    switch (result) {
-        case TEST_PASS:
-            printf("✅ %s PASSED\n", test_name);
-            break;
-        case TEST_FAIL:
-            printf("❌ %s FAILED\n", test_name);
-            break;
-        case TEST_SKIP:
-            printf("⏭️  %s SKIPPED\n", test_name);
-            break;
-    }
-}
-
-int test_run(const char* name, test_func_t func) {
-    printf("Running %s...\n", name);
-    test_result_t result = func();
-    test_print_result(name, result);
-    return result == TEST_PASS ? 0 : 1;
-}
-
-int test_run_suite(const char* suite_name, test_func_t* tests, size_t count) {
-    test_print_header(suite_name);
-
-    int failed = 0;
-    for (size_t i = 0; i < count; i++) {
-        if (test_run("Test", tests[i]) != 0) {
-            failed++;
-        }
-    }
-
-    printf("\nSuite Summary: %zu tests, %d failed\n", count, failed);
-    return failed;
-}
-
-void test_sleep_ms(int ms) {
-    usleep(ms * 1000);
-}
-
 char* test_random_string(size_t length) {
     static const char charset[] = "abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789";
     char* str = malloc(length + 1);
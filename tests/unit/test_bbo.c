@@ -0,0 +1,259 @@
+/**
+ * @file test_bbo.c
+ * @brief Top-of-book decoding of captured bbo and l2Book messages
+ *
+ * Messages are shaped like the ones the exchange sends, including both
+ * quoted and bare numbers, missing sides and key orders other than the
+ * usual one.
+ */
+
+#include "../helpers/test_common.h"
+#include "../../include/hl_bbo.h"
+#include <math.h>
+
+#define RECV_TIME_NS 1708622398700000000LL
+
+static bool near(double a, double b) {
+    return fabs(a - b) < 1e-9;
+}
+
+static bool decode(const char* message, hl_bbo_t* bbo, char coin[32], hl_bbo_source_t* source) {
+    return hl_bbo_decode(message, strlen(message), RECV_TIME_NS, bbo, coin, 32, source);
+}
+
+/**
+ * @brief bbo channel with both sides, quoted numbers
+ */
+test_result_t test_bbo_channel(void) {
+    const char* message =
+        "{\"channel\":\"bbo\",\"data\":{\"coin\":\"BTC\",\"time\":1708622398623,"
+        "\"bbo\":[{\"px\":\"51235.0\",\"sz\":\"0.0171\",\"n\":1},"
+        "{\"px\":\"51236.0\",\"sz\":\"2.30283\",\"n\":4}]}}";
+
+    hl_bbo_t bbo;
+    char coin[32];
+    hl_bbo_source_t source = HL_BBO_SOURCE_L2BOOK;
+    test_assert(decode(message, &bbo, coin, &source), "Decode bbo");
+    test_assert(strcmp(coin, "BTC") == 0, "Coin");
+    test_assert(source == HL_BBO_SOURCE_BBO, "Source is bbo");
+    test_assert(bbo.asset_id == HL_BBO_UNKNOWN_ASSET, "Asset left unbound");
+    test_assert(near(bbo.bid_px, 51235.0) && near(bbo.bid_sz, 0.0171), "Bid");
+    test_assert(near(bbo.ask_px, 51236.0) && near(bbo.ask_sz, 2.30283), "Ask");
+    test_assert(bbo.recv_time_ns == RECV_TIME_NS, "Receive time");
+    test_assert(bbo.exchange_offset_us == -77000, "Exchange offset");
+    test_assert(hl_bbo_exchange_time_ms(&bbo) == 1708622398623LL, "Exchange time");
+
+    printf("✅ bbo channel test passed\n");
+    return TEST_PASS;
+}
+
+/**
+ * @brief A null side decodes as price and size 0
+ */
+test_result_t test_bbo_null_sides(void) {
+    const char* no_bid =
+        "{\"channel\":\"bbo\",\"data\":{\"coin\":\"PURR/USDC\",\"time\":1708622398623,"
+        "\"bbo\":[null,{\"px\":\"0.2141\",\"sz\":\"1200.0\",\"n\":2}]}}";
+    const char* no_ask =
+        "{\"channel\":\"bbo\",\"data\":{\"coin\":\"@107\",\"time\":1708622398623,"
+        "\"bbo\":[{\"px\":\"31.05\",\"sz\":\"4.2\",\"n\":1}, null]}}";
+
+    hl_bbo_t bbo;
+    char coin[32];
+    test_assert(decode(no_bid, &bbo, coin, NULL), "Decode without bid");
+    test_assert(strcmp(coin, "PURR/USDC") == 0, "Spot pair coin");
+    test_assert(bbo.bid_px == 0.0 && bbo.bid_sz == 0.0, "Missing bid is zero");
+    test_assert(near(bbo.ask_px, 0.2141) && near(bbo.ask_sz, 1200.0), "Ask");
+
+    test_assert(decode(no_ask, &bbo, coin, NULL), "Decode without ask");
+    test_assert(strcmp(coin, "@107") == 0, "Spot index coin");
+    test_assert(near(bbo.bid_px, 31.05) && near(bbo.bid_sz, 4.2), "Bid");
+    test_assert(bbo.ask_px == 0.0 && bbo.ask_sz == 0.0, "Missing ask is zero");
+
+    printf("✅ bbo null side test passed\n");
+    return TEST_PASS;
+}
+
+/**
+ * @brief l2Book: first level of each side, quoted or bare numbers
+ */
+test_result_t test_bbo_l2book(void) {
+    const char* quoted =
+        "{\"channel\":\"l2Book\",\"data\":{\"coin\":\"ETH\",\"time\":1708622398650,"
+        "\"levels\":[[{\"px\":\"2950.5\",\"sz\":\"12.1\",\"n\":3},"
+        "{\"px\":\"2950.4\",\"sz\":\"8.0\",\"n\":1}],"
+        "[{\"px\":\"2950.6\",\"sz\":\"3.75\",\"n\":2},"
+        "{\"px\":\"2950.7\",\"sz\":\"40.0\",\"n\":5}]]}}";
+    const char* bare =
+        "{\"channel\": \"l2Book\", \"data\": {\"coin\": \"SOL\", \"time\": 1708622398650, "
+        "\"levels\": [ [ {\"px\": 101.25, \"sz\": 7, \"n\": 1} ], "
+        "[ {\"px\": 101.5, \"sz\": 0.5, \"n\": 1} ] ]}}";
+
+    hl_bbo_t bbo;
+    char coin[32];
+    hl_bbo_source_t source = HL_BBO_SOURCE_BBO;
+    test_assert(decode(quoted, &bbo, coin, &source), "Decode quoted l2Book");
+    test_assert(source == HL_BBO_SOURCE_L2BOOK, "Source is l2Book");
+    test_assert(strcmp(coin, "ETH") == 0, "Coin");
+    test_assert(near(bbo.bid_px, 2950.5) && near(bbo.bid_sz, 12.1), "Best bid, not a deeper level");
+    test_assert(near(bbo.ask_px, 2950.6) && near(bbo.ask_sz, 3.75), "Best ask, not a deeper level");
+    test_assert(bbo.exchange_offset_us == -50000, "Exchange offset");
+
+    test_assert(decode(bare, &bbo, coin, NULL), "Decode bare numbers with whitespace");
+    test_assert(strcmp(coin, "SOL") == 0, "Coin");
+    test_assert(near(bbo.bid_px, 101.25) && near(bbo.bid_sz, 7.0), "Bid");
+    test_assert(near(bbo.ask_px, 101.5) && near(bbo.ask_sz, 0.5), "Ask");
+
+    printf("✅ l2Book test passed\n");
+    return TEST_PASS;
+}
+
+/**
+ * @brief An empty side of l2Book decodes as zero
+ */
+test_result_t test_bbo_l2book_empty_side(void) {
+    const char* no_bids =
+        "{\"channel\":\"l2Book\",\"data\":{\"coin\":\"HYPE\",\"time\":1708622398650,"
+        "\"levels\":[[],[{\"px\":\"24.1\",\"sz\":\"310\",\"n\":4}]]}}";
+    const char* no_asks =
+        "{\"channel\":\"l2Book\",\"data\":{\"coin\":\"HYPE\",\"time\":1708622398650,"
+        "\"levels\":[[{\"px\":\"24.0\",\"sz\":\"55\",\"n\":1}],[]]}}";
+
+    hl_bbo_t bbo;
+    char coin[32];
+    test_assert(decode(no_bids, &bbo, coin, NULL), "Decode empty bid array");
+    test_assert(bbo.bid_px == 0.0 && bbo.bid_sz == 0.0, "Empty bids are zero");
+    test_assert(near(bbo.ask_px, 24.1) && near(bbo.ask_sz, 310.0), "Ask");
+
+    test_assert(decode(no_asks, &bbo, coin, NULL), "Decode empty ask array");
+    test_assert(near(bbo.bid_px, 24.0) && near(bbo.bid_sz, 55.0), "Bid");
+    test_assert(bbo.ask_px == 0.0 && bbo.ask_sz == 0.0, "Empty asks are zero");
+
+    printf("✅ l2Book empty side test passed\n");
+    return TEST_PASS;
+}
+
+/**
+ * @brief Keys in another order: "levels" ahead of "coin" and "time"
+ */
+test_result_t test_bbo_key_order(void) {
+    const char* message =
+        "{\"channel\":\"l2Book\",\"data\":{\"levels\":[[{\"px\":\"0.9\",\"sz\":\"1000\",\"n\":1}],"
+        "[{\"px\":\"0.91\",\"sz\":\"2000\",\"n\":1}]],\"coin\":\"DOGE\",\"time\":1708622398600}}";
+
+    hl_bbo_t bbo;
+    char coin[32];
+    test_assert(decode(message, &bbo, coin, NULL), "Decode levels ahead of coin");
+    test_assert(strcmp(coin, "DOGE") == 0, "Coin after levels");
+    test_assert(near(bbo.bid_px, 0.9) && near(bbo.ask_px, 0.91), "Levels");
+    test_assert(bbo.exchange_offset_us == -100000, "Time after levels");
+
+    printf("✅ key order test passed\n");
+    return TEST_PASS;
+}
+
+/**
+ * @brief The exchange offset saturates instead of wrapping
+ */
+test_result_t test_bbo_offset_clamp(void) {
+    const char* message =
+        "{\"channel\":\"bbo\",\"data\":{\"coin\":\"BTC\",\"time\":1708622398623,"
+        "\"bbo\":[null,null]}}";
+    const char* no_time =
+        "{\"channel\":\"bbo\",\"data\":{\"coin\":\"BTC\",\"bbo\":[null,null]}}";
+    size_t len = strlen(message);
+
+    hl_bbo_t bbo;
+    char coin[32];
+    // Received an hour before the exchange stamped it
+    test_assert(hl_bbo_decode(message, len, RECV_TIME_NS - 3600000000000LL, &bbo, coin,
+                              sizeof(coin), NULL), "Decode early receipt");
+    test_assert(bbo.exchange_offset_us == INT32_MAX, "Clamped to INT32_MAX");
+
+    // An hour after
+    test_assert(hl_bbo_decode(message, len, RECV_TIME_NS + 3600000000000LL, &bbo, coin,
+                              sizeof(coin), NULL), "Decode late receipt");
+    test_assert(bbo.exchange_offset_us == INT32_MIN, "Clamped to INT32_MIN");
+
+    test_assert(hl_bbo_decode(no_time, strlen(no_time), RECV_TIME_NS, &bbo, coin,
+                              sizeof(coin), NULL), "Decode without time");
+    test_assert(bbo.exchange_offset_us == 0, "No time, no offset");
+
+    printf("✅ exchange offset clamp test passed\n");
+    return TEST_PASS;
+}
+
+/**
+ * @brief Other channels and malformed updates are refused
+ */
+test_result_t test_bbo_rejections(void) {
+    const char* rejected[] = {
+        // Other channels
+        "{\"channel\":\"trades\",\"data\":[{\"coin\":\"BTC\",\"px\":\"51235.0\"}]}",
+        "{\"channel\":\"bboX\",\"data\":{\"coin\":\"BTC\",\"bbo\":[null,null]}}",
+        "{\"channel\":\"subscriptionResponse\",\"data\":{\"method\":\"subscribe\"}}",
+        // No data, no coin, coin not a string
+        "{\"channel\":\"bbo\"}",
+        "{\"channel\":\"bbo\",\"data\":{\"time\":1,\"bbo\":[null,null]}}",
+        "{\"channel\":\"bbo\",\"data\":{\"coin\":7,\"bbo\":[null,null]}}",
+        // Malformed bbo arrays
+        "{\"channel\":\"bbo\",\"data\":{\"coin\":\"BTC\"}}",
+        "{\"channel\":\"bbo\",\"data\":{\"coin\":\"BTC\",\"bbo\":null}}",
+        "{\"channel\":\"bbo\",\"data\":{\"coin\":\"BTC\",\"bbo\":[null]}}",
+        "{\"channel\":\"bbo\",\"data\":{\"coin\":\"BTC\",\"bbo\":[{\"px\":\"1\"},null]}}",
+        "{\"channel\":\"bbo\",\"data\":{\"coin\":\"BTC\",\"bbo\":[{\"px\":\"x\",\"sz\":\"1\"},null]}}",
+        // Malformed l2Book levels
+        "{\"channel\":\"l2Book\",\"data\":{\"coin\":\"BTC\",\"levels\":{}}}",
+        "{\"channel\":\"l2Book\",\"data\":{\"coin\":\"BTC\",\"levels\":[[]]}}",
+        "{\"channel\":\"l2Book\",\"data\":{\"coin\":\"BTC\",\"levels\":[{\"px\":\"1\",\"sz\":\"1\"}]}}",
+        "{\"channel\":\"l2Book\",\"data\":{\"coin\":\"BTC\",\"levels\":[[{\"sz\":\"1\"}],[]]}}"
+    };
+
+    hl_bbo_t bbo;
+    char coin[32];
+    for (size_t i = 0; i < sizeof(rejected) / sizeof(rejected[0]); i++) {
+        if (decode(rejected[i], &bbo, coin, NULL)) {
+            printf("   accepted: %s\n", rejected[i]);
+            test_assert(false, "Malformed message refused");
+        }
+    }
+
+    // Coin longer than the caller's buffer
+    const char* message =
+        "{\"channel\":\"bbo\",\"data\":{\"coin\":\"BTC\",\"bbo\":[null,null]}}";
+    test_assert(!hl_bbo_decode(message, strlen(message), RECV_TIME_NS, &bbo, coin, 3, NULL),
+                "Coin that does not fit is refused");
+    test_assert(hl_bbo_decode(message, strlen(message), RECV_TIME_NS, &bbo, coin, 4, NULL),
+                "Coin that just fits is accepted");
+
+    // Bad arguments
+    test_assert(!hl_bbo_decode(NULL, 10, RECV_TIME_NS, &bbo, coin, sizeof(coin), NULL),
+                "NULL message");
+    test_assert(!hl_bbo_decode(message, 0, RECV_TIME_NS, &bbo, coin, sizeof(coin), NULL),
+                "Empty message");
+    test_assert(!hl_bbo_decode(message, strlen(message), RECV_TIME_NS, NULL, coin,
+                               sizeof(coin), NULL), "NULL record");
+    test_assert(!hl_bbo_decode(message, strlen(message), RECV_TIME_NS, &bbo, coin, 0, NULL),
+                "No room for the coin");
+
+    printf("✅ rejection test passed\n");
+    return TEST_PASS;
+}
+
+int main(void) {
+    printf("╔══════════════════════════════════════════╗\n");
+    printf("║  UNIT TESTS: Top of book                  ║\n");
+    printf("╚══════════════════════════════════════════╝\n\n");
+
+    test_func_t tests[] = {
+        test_bbo_channel,
+        test_bbo_null_sides,
+        test_bbo_l2book,
+        test_bbo_l2book_empty_side,
+        test_bbo_key_order,
+        test_bbo_offset_clamp,
+        test_bbo_rejections
+    };
+
+    return test_run_suite("Top of Book Unit Tests", tests, sizeof(tests)/sizeof(test_func_t));
+}
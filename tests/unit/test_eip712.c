@@ -0,0 +1,90 @@
+/**
+ * @file test_eip712.c
+ * @brief Known-answer tests for user-signed EIP-712 actions
+ *
+ * The registry's precompiled type hashes are checked against their type
+ * strings, and signatures against the vectors of the reference Python SDK.
+ */
+
+#include "../helpers/test_common.h"
+#include "../../include/hl_crypto_internal.h"
+
+static const char* TEST_KEY = "0x0123456789012345678901234567890123456789012345678901234567890123";
+
+static bool signature_equals(const uint8_t signature[65], const char* r, const char* s, int v) {
+    char hex[67];
+    bytes_to_hex(signature, 32, hex, true);
+    if (strcmp(hex, r) != 0) return false;
+    bytes_to_hex(signature + 32, 32, hex, true);
+    if (strcmp(hex, s) != 0) return false;
+    return signature[64] == v;
+}
+
+/**
+ * @brief Every precompiled type hash is keccak256 of its type string
+ */
+test_result_t test_eip712_type_hashes(void) {
+    for (int type = 0; type < EIP712_USER_TYPE_COUNT; type++) {
+        const eip712_user_type_def_t* def = eip712_user_type((eip712_user_type_t)type);
+        test_assert(def != NULL, "Registered type");
+        test_assert(def->field_count >= 1 && def->field_count <= EIP712_MAX_FIELDS,
+                    "Field count");
+        test_assert(def->fields[def->field_count - 1].kind == EIP712_FIELD_UINT64,
+                    "Nonce is the last field");
+
+        uint8_t hash[32];
+        keccak256((const uint8_t*)def->type_string, strlen(def->type_string), hash);
+        test_assert(memcmp(hash, def->type_hash, 32) == 0, "Type hash matches type string");
+    }
+    test_assert(eip712_user_type(EIP712_USER_TYPE_COUNT) == NULL, "Unknown type is refused");
+
+    printf("✅ EIP-712 type hash test passed\n");
+    return TEST_PASS;
+}
+
+/**
+ * @brief usdSend and withdraw3 signatures match the reference SDK
+ */
+test_result_t test_eip712_sign_transfers(void) {
+    hl_signer_t* signer = hl_signer_create(TEST_KEY);
+    test_assert(signer != NULL, "Signer created");
+
+    eip712_value_t values[3];
+    values[0].string = "0x5e9ee1089755c3435139848e47e6635505d5a13a";
+    values[1].string = "1";
+    values[2].uint64 = 1687816341423ULL;
+
+    uint8_t signature[65];
+    test_assert(eip712_sign_user_action(signer, EIP712_USD_SEND, true, values, signature) == 0,
+                "Sign usdSend");
+    test_assert(signature_equals(signature,
+                                 "0x637b37dd731507cdd24f46532ca8ba6eec616952c56218baeff04144e4a77073",
+                                 "0x11a6a24900e6e314136d2592e2f8d502cd89b7c15b198e1bee043c9589f9fad7",
+                                 27),
+                "usdSend signature");
+
+    test_assert(eip712_sign_user_action(signer, EIP712_WITHDRAW, true, values, signature) == 0,
+                "Sign withdraw3");
+    test_assert(signature_equals(signature,
+                                 "0x8363524c799e90ce9bc41022f7c39b4e9bdba786e5f9c72b20e43e1462c37cf9",
+                                 "0x58b1411a775938b83e29182e8ef74975f9054c8e97ebf5ec2dc8d51bfc893881",
+                                 28),
+                "withdraw3 signature");
+
+    hl_signer_destroy(signer);
+    printf("✅ EIP-712 transfer signature test passed\n");
+    return TEST_PASS;
+}
+
+int main(void) {
+    printf("╔══════════════════════════════════════════╗\n");
+    printf("║  UNIT TESTS: EIP-712                      ║\n");
+    printf("╚══════════════════════════════════════════╝\n\n");
+
+    test_func_t tests[] = {
+        test_eip712_type_hashes,
+        test_eip712_sign_transfers
+    };
+
+    return test_run_suite("EIP-712 Unit Tests", tests, sizeof(tests)/sizeof(test_func_t));
+}
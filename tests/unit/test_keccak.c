@@ -0,0 +1,214 @@
+/**
+ * @file test_keccak.c
+ * @brief Known-answer tests for the Keccak-f[1600] permutations
+ *
+ * The unrolled permutation is checked against the textbook loop it
+ * replaced, keccak256 against published digests, and the multi-buffer
+ * paths against keccak256.
+ */
+
+#include "../helpers/test_common.h"
+#include "../../include/hl_crypto_internal.h"
+
+#define KECCAK256_RATE 136
+
+static uint64_t xorshift_state = 0x9e3779b97f4a7c15ULL;
+
+static uint64_t next_random(void) {
+    xorshift_state ^= xorshift_state << 13;
+    xorshift_state ^= xorshift_state >> 7;
+    xorshift_state ^= xorshift_state << 17;
+    return xorshift_state;
+}
+
+static bool digest_equals_hex(const uint8_t digest[32], const char* expected_hex) {
+    char hex[65];
+    bytes_to_hex(digest, 32, hex, false);
+    return strcmp(hex, expected_hex) == 0;
+}
+
+/**
+ * @brief keccak256 over the reference permutation, one byte at a time
+ */
+static void reference_keccak256(const uint8_t* input, size_t len, uint8_t out[32]) {
+    uint64_t s[25] = {0};
+    size_t offset = 0;
+
+    for (size_t i = 0; i < len; i++) {
+        s[offset / 8] ^= (uint64_t)input[i] << (8 * (offset % 8));
+        if (++offset == KECCAK256_RATE) {
+            keccakf_loop(s);
+            offset = 0;
+        }
+    }
+
+    // Keccak padding: 0x01 ... 0x80
+    s[offset / 8] ^= (uint64_t)0x01 << (8 * (offset % 8));
+    s[(KECCAK256_RATE - 1) / 8] ^= (uint64_t)0x80 << (8 * ((KECCAK256_RATE - 1) % 8));
+    keccakf_loop(s);
+
+    for (size_t i = 0; i < 32; i++) {
+        out[i] = (uint8_t)(s[i / 8] >> (8 * (i % 8)));
+    }
+}
+
+/**
+ * @brief Permutation of the all-zero state
+ */
+test_result_t test_keccakf_zero_state(void) {
+    uint64_t loop[25] = {0};
+    uint64_t unrolled[25] = {0};
+
+    keccakf_loop(loop);
+    keccakf_unrolled(unrolled);
+
+    test_assert(loop[0] == 0xF1258F7940E1DDE7ULL, "Loop permutation first lane");
+    test_assert(loop[24] == 0xEAF1FF7B5CECA249ULL, "Loop permutation last lane");
+    test_assert(memcmp(loop, unrolled, sizeof(loop)) == 0, "Unrolled matches loop on zero state");
+
+    // Second application covers complemented lanes on a non-trivial input
+    keccakf_loop(loop);
+    keccakf_unrolled(unrolled);
+    test_assert(memcmp(loop, unrolled, sizeof(loop)) == 0, "Unrolled matches loop when chained");
+
+    printf("✅ Keccak-f zero state test passed\n");
+    return TEST_PASS;
+}
+
+/**
+ * @brief Permutations agree on random and all-ones states
+ */
+test_result_t test_keccakf_random_states(void) {
+    uint64_t loop[25];
+    uint64_t unrolled[25];
+
+    memset(loop, 0xff, sizeof(loop));
+    memcpy(unrolled, loop, sizeof(loop));
+    keccakf_loop(loop);
+    keccakf_unrolled(unrolled);
+    test_assert(memcmp(loop, unrolled, sizeof(loop)) == 0, "Unrolled matches loop on all-ones state");
+
+    for (int round = 0; round < 1000; round++) {
+        for (int i = 0; i < 25; i++) {
+            loop[i] = next_random();
+        }
+        memcpy(unrolled, loop, sizeof(loop));
+        keccakf_loop(loop);
+        keccakf_unrolled(unrolled);
+        test_assert(memcmp(loop, unrolled, sizeof(loop)) == 0, "Unrolled matches loop on random state");
+    }
+
+    printf("✅ Keccak-f random state test passed\n");
+    return TEST_PASS;
+}
+
+/**
+ * @brief keccak256 against published digests
+ */
+test_result_t test_keccak256_known_answers(void) {
+    static const struct {
+        const char* input;
+        const char* digest;
+    } vectors[] = {
+        {"", "c5d2460186f7233c927e7db2dcc703c0e500b653ca82273b7bfad8045d85a470"},
+        {"abc", "4e03657aea45a94fc7d47ba826c8d667c0d1e6e33a64a036ec44f58fa12d6c45"},
+        {"EIP712Domain(string name,string version,uint256 chainId,address verifyingContract)",
+         "8b73c3c69bb8fe3d512ecc4cf759cc79239f7b179b0ffacaa9a75d522b39400f"},
+        {"Agent(string source,bytes32 connectionId)",
+         "26f05c2f7239b6983075e58321292d77b3aa173d19b27257ac96ab362570f508"},
+    };
+    uint8_t digest[32];
+
+    for (size_t i = 0; i < sizeof(vectors) / sizeof(vectors[0]); i++) {
+        keccak256((const uint8_t*)vectors[i].input, strlen(vectors[i].input), digest);
+        test_assert(digest_equals_hex(digest, vectors[i].digest), vectors[i].input);
+    }
+
+    printf("✅ keccak256 known answer test passed\n");
+    return TEST_PASS;
+}
+
+/**
+ * @brief keccak256 matches the reference sponge across block boundaries
+ */
+test_result_t test_keccak256_lengths(void) {
+    uint8_t input[3 * KECCAK256_RATE + 1];
+    uint8_t digest[32];
+    uint8_t expected[32];
+
+    for (size_t i = 0; i < sizeof(input); i++) {
+        input[i] = (uint8_t)next_random();
+    }
+
+    for (size_t len = 0; len <= sizeof(input); len++) {
+        keccak256(input, len, digest);
+        reference_keccak256(input, len, expected);
+        test_assert(memcmp(digest, expected, 32) == 0, "keccak256 matches reference sponge");
+    }
+
+    printf("✅ keccak256 length sweep test passed\n");
+    return TEST_PASS;
+}
+
+/**
+ * @brief Every multi-buffer width the CPU supports matches keccak256
+ */
+test_result_t test_keccak256_batch(void) {
+    enum { MAX_INPUTS = 19, MAX_LEN = 2 * KECCAK256_RATE + 20 };
+    static uint8_t data[MAX_INPUTS][MAX_LEN];
+    const uint8_t* inputs[MAX_INPUTS];
+    size_t lengths[MAX_INPUTS] = {0};
+    uint8_t digests[MAX_INPUTS][32];
+    uint8_t expected[32];
+    static const size_t widths[] = {1, 4, 8};
+
+    for (size_t j = 0; j < MAX_INPUTS; j++) {
+        for (size_t i = 0; i < MAX_LEN; i++) {
+            data[j][i] = (uint8_t)next_random();
+        }
+        inputs[j] = data[j];
+    }
+
+    size_t supported = keccak256_batch_ways();
+    test_assert(supported == 1 || supported == 4 || supported == 8, "Batch width");
+
+    for (size_t w = 0; w < sizeof(widths) / sizeof(widths[0]); w++) {
+        if (widths[w] > supported) {
+            test_assert(keccak256_batch_with(widths[w], inputs, lengths, 1, digests) != 0,
+                        "Unsupported width is refused");
+            continue;
+        }
+
+        // Mixed lengths in one group, across block boundaries
+        for (size_t count = 0; count <= MAX_INPUTS; count++) {
+            for (size_t j = 0; j < count; j++) {
+                lengths[j] = (size_t)(next_random() % MAX_LEN);
+            }
+            test_assert(keccak256_batch_with(widths[w], inputs, lengths, count, digests) == 0,
+                        "keccak256_batch_with");
+            for (size_t j = 0; j < count; j++) {
+                keccak256(inputs[j], lengths[j], expected);
+                test_assert(memcmp(digests[j], expected, 32) == 0, "Batch digest matches keccak256");
+            }
+        }
+    }
+
+    printf("✅ keccak256 batch test passed (up to %zu-wide)\n", supported);
+    return TEST_PASS;
+}
+
+int main(void) {
+    printf("╔══════════════════════════════════════════╗\n");
+    printf("║  UNIT TESTS: Keccak                       ║\n");
+    printf("╚══════════════════════════════════════════╝\n\n");
+
+    test_func_t tests[] = {
+        test_keccakf_zero_state,
+        test_keccakf_random_states,
+        test_keccak256_known_answers,
+        test_keccak256_lengths,
+        test_keccak256_batch
+    };
+
+    return test_run_suite("Keccak Unit Tests", tests, sizeof(tests)/sizeof(test_func_t));
+}
@@ -0,0 +1,426 @@
+/**
+ * @file test_kill_switch.c
+ * @brief Kill switch signing, tracking and firing against a stubbed client
+ *
+ * The switch is linked with a real signer and mid table. Client calls are
+ * stubbed: nonces come from a counter that can hold the signing thread
+ * mid-signature, the WebSocket post and the /exchange POST record the body
+ * they were given, and the orderUpdates subscription hands its callback to
+ * the test. Every body sent is checked against signing its orders and
+ * nonce directly.
+ */
+
+#define _GNU_SOURCE
+
+#include "../helpers/test_common.h"
+#include "../../include/hl_internal.h"
+#include "../../include/hl_kill_switch.h"
+#include "../../include/hl_signer.h"
+#include "../../include/hl_mids.h"
+#include "../../include/hl_markets.h"
+#include <cjson/cJSON.h>
+#include <stdatomic.h>
+
+static const char* TEST_KEY = "0x0123456789012345678901234567890123456789012345678901234567890123";
+
+static hl_signer_t* test_signer;
+static hl_mids_table_t* test_mids;
+static char fake_client;
+#define CLIENT ((hl_client_t*)&fake_client)
+
+// The switch under test, so the nonce stub can probe its lock
+static hl_kill_switch_t* current_ks;
+static pthread_t main_thread;
+
+// Nonces: a counter from the wall clock; the signing thread can be held
+static atomic_uint_least64_t next_nonce;
+static pthread_mutex_t gate_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t gate_cond = PTHREAD_COND_INITIALIZER;
+static bool gate_closed;
+static bool worker_waiting;
+static int main_nonces;
+static bool main_nonce_locked;
+
+// Transports: the last body sent and how
+static char* sent_payload;
+static int ws_posts;
+static int http_posts;
+static bool ws_up = true;
+
+// Order tracking: the stream callback and the open orders to seed from
+static hl_ws_data_callback_t orders_callback;
+static void* orders_user_data;
+static int unwatches;
+static hl_order_t open_orders[3];
+static size_t open_order_count;
+
+static pthread_t probe_thread;
+static bool probe_started;
+static atomic_bool probe_done;
+
+static void* probe_lock(void* arg) {
+    (void)arg;
+    hl_kill_switch_count(current_ks);
+    atomic_store(&probe_done, true);
+    return NULL;
+}
+
+uint64_t hl_client_next_nonce(hl_client_t* client) {
+    (void)client;
+    if (pthread_equal(pthread_self(), main_thread)) {
+        // Only an unarmed fire signs on the caller's thread. The switch is
+        // locked if another thread cannot read its count meanwhile.
+        main_nonces++;
+        atomic_store(&probe_done, false);
+        probe_started = pthread_create(&probe_thread, NULL, probe_lock, NULL) == 0;
+        if (probe_started) {
+            test_sleep_ms(50);
+            main_nonce_locked = !atomic_load(&probe_done);
+        }
+    } else {
+        pthread_mutex_lock(&gate_mutex);
+        worker_waiting = true;
+        pthread_cond_broadcast(&gate_cond);
+        while (gate_closed) {
+            pthread_cond_wait(&gate_cond, &gate_mutex);
+        }
+        worker_waiting = false;
+        pthread_mutex_unlock(&gate_mutex);
+    }
+    return atomic_fetch_add(&next_nonce, 1);
+}
+
+hl_signer_t* hl_client_get_signer(const hl_client_t* client) {
+    (void)client;
+    return test_signer;
+}
+
+bool hl_client_is_testnet_old(hl_client_t* client) {
+    (void)client;
+    return true;
+}
+
+hl_mids_table_t* hl_client_mids(hl_client_t* client) {
+    (void)client;
+    return test_mids;
+}
+
+hl_error_t hl_ws_post(hl_client_t* client, const char* type, const char* payload,
+                      hl_ws_post_callback_t callback, void* user_data, uint64_t* request_id) {
+    (void)client; (void)callback; (void)user_data; (void)request_id;
+    if (!ws_up) return HL_ERROR_NETWORK;
+    test_assert(strcmp(type, "action") == 0, "Posted as an action");
+    free(sent_payload);
+    sent_payload = strdup(payload);
+    ws_posts++;
+    return HL_SUCCESS;
+}
+
+static pthread_mutex_t http_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+http_client_t* hl_client_get_http_old(hl_client_t* client) {
+    (void)client;
+    return (http_client_t*)&fake_client;
+}
+
+pthread_mutex_t* hl_client_get_mutex_old(hl_client_t* client) {
+    (void)client;
+    return &http_mutex;
+}
+
+lv3_error_t http_client_post(http_client_t* client, const char* url, const char* body,
+                             const char* headers, http_response_t* response) {
+    (void)client; (void)headers;
+    test_assert(strstr(url, "testnet") != NULL, "Testnet endpoint");
+    free(sent_payload);
+    sent_payload = strdup(body);
+    http_posts++;
+    response->status_code = 200;
+    response->body = strdup("{\"status\":\"ok\",\"response\":{\"type\":\"cancel\"}}");
+    return LV3_SUCCESS;
+}
+
+void http_response_free(http_response_t* response) {
+    free(response->body);
+    response->body = NULL;
+}
+
+const char* hl_watch_orders(hl_client_t* client, const char* symbol,
+                            hl_ws_data_callback_t callback, void* user_data) {
+    (void)client; (void)symbol;
+    orders_callback = callback;
+    orders_user_data = user_data;
+    return "orderUpdates:1";
+}
+
+bool hl_unwatch(hl_client_t* client, const char* subscription_id) {
+    (void)client;
+    test_assert(strcmp(subscription_id, "orderUpdates:1") == 0, "Own subscription");
+    unwatches++;
+    return true;
+}
+
+hl_error_t hl_fetch_open_orders(hl_client_t* client, const char* symbol, const char* since,
+                                uint32_t limit, hl_orders_t* orders) {
+    (void)client; (void)symbol; (void)since; (void)limit;
+    orders->orders = open_orders;
+    orders->count = open_order_count;
+    return HL_SUCCESS;
+}
+
+void hl_free_orders(hl_orders_t* orders) {
+    orders->orders = NULL;
+    orders->count = 0;
+}
+
+void hl_symbol_to_coin(const char* symbol, char* coin, size_t size) {
+    size_t len = strcspn(symbol, "/");
+    if (len >= size) len = size - 1;
+    memcpy(coin, symbol, len);
+    coin[len] = '\0';
+}
+
+static void reset_stubs(void) {
+    free(sent_payload);
+    sent_payload = NULL;
+    ws_posts = http_posts = unwatches = main_nonces = 0;
+    main_nonce_locked = false;
+    ws_up = true;
+    orders_callback = NULL;
+    orders_user_data = NULL;
+    open_order_count = 0;
+}
+
+static void set_gate(bool closed) {
+    pthread_mutex_lock(&gate_mutex);
+    gate_closed = closed;
+    pthread_cond_broadcast(&gate_cond);
+    pthread_mutex_unlock(&gate_mutex);
+}
+
+/**
+ * @brief Wait until the signing thread is held at the gate
+ */
+static void wait_worker_held(void) {
+    pthread_mutex_lock(&gate_mutex);
+    while (!worker_waiting) {
+        pthread_cond_wait(&gate_cond, &gate_mutex);
+    }
+    pthread_mutex_unlock(&gate_mutex);
+}
+
+static void wait_armed(hl_kill_switch_t* ks) {
+    for (int i = 0; i < 5000 && !hl_kill_switch_is_armed(ks); i++) {
+        test_sleep_ms(1);
+    }
+    test_assert(hl_kill_switch_is_armed(ks), "Armed in time");
+}
+
+static hl_kill_switch_t* create_switch(bool track_orders) {
+    hl_kill_switch_t* ks = hl_kill_switch_create(CLIENT, 0, track_orders);
+    test_assert(ks != NULL, "Kill switch created");
+    current_ks = ks;
+    return ks;
+}
+
+/**
+ * @brief Check a body against signing its cancels and nonce directly
+ *
+ * @return The body's nonce
+ */
+static uint64_t check_signed(const char* payload, const hl_cancel_t* cancels, size_t count) {
+    test_assert(payload != NULL, "A body was sent");
+    const char* nonce_field = strstr(payload, "\"nonce\":");
+    test_assert(nonce_field != NULL, "Body has a nonce");
+    uint64_t nonce = strtoull(nonce_field + 8, NULL, 10);
+
+    char* expected = hl_kill_switch_sign_cancels(test_signer, true, cancels, count, nonce);
+    test_assert(expected != NULL, "Sign cancels");
+    test_assert(strcmp(payload, expected) == 0, "Body signs these cancels and nonce");
+    free(expected);
+    return nonce;
+}
+
+/**
+ * @brief Firing an armed switch sends the stored body, then re-signs
+ */
+test_result_t test_kill_switch_fire_presigned(void) {
+    reset_stubs();
+    hl_kill_switch_t* ks = create_switch(false);
+    hl_cancel_t cancels[] = { { 0, 1001 }, { 3, 1002 } };
+
+    test_assert(hl_kill_switch_is_armed(ks), "Empty set is armed");
+    test_assert(hl_kill_switch_fire(ks) == HL_SUCCESS && ws_posts == 0,
+                "Nothing to send for an empty set");
+
+    test_assert(hl_kill_switch_add(ks, 0, 1001) == HL_SUCCESS, "Add order");
+    test_assert(hl_kill_switch_add(ks, 3, 1002) == HL_SUCCESS, "Add second order");
+    test_assert(hl_kill_switch_add(ks, 3, 1002) == HL_SUCCESS, "Duplicate add");
+    test_assert(hl_kill_switch_count(ks) == 2, "Duplicate not counted");
+    wait_armed(ks);
+
+    test_assert(hl_kill_switch_fire(ks) == HL_SUCCESS, "Fire");
+    test_assert(ws_posts == 1 && http_posts == 0, "Sent once on the WebSocket");
+    test_assert(main_nonces == 0, "Nothing signed when firing");
+    uint64_t nonce = check_signed(sent_payload, cancels, 2);
+
+    // The nonce is spent: the switch signs a fresh action
+    wait_armed(ks);
+
+    // Without a WebSocket the body goes to /exchange
+    ws_up = false;
+    test_assert(hl_kill_switch_fire(ks) == HL_SUCCESS, "Fire over HTTP");
+    test_assert(http_posts == 1 && ws_posts == 1 && main_nonces == 0, "Stored body POSTed");
+    test_assert(check_signed(sent_payload, cancels, 2) > nonce, "Re-signed with a fresh nonce");
+
+    hl_kill_switch_destroy(ks);
+    test_assert(unwatches == 0, "Nothing to unsubscribe");
+    printf("✅ pre-signed fire test passed\n");
+    return TEST_PASS;
+}
+
+/**
+ * @brief A change outdates the stored action; the next one covers the new set
+ */
+test_result_t test_kill_switch_resign_on_change(void) {
+    reset_stubs();
+    hl_kill_switch_t* ks = create_switch(false);
+
+    test_assert(hl_kill_switch_add(ks, 0, 2001) == HL_SUCCESS, "Add order");
+    wait_armed(ks);
+
+    // Hold the signing thread so the outdated state can be observed
+    set_gate(true);
+    test_assert(hl_kill_switch_add(ks, 1, 2002) == HL_SUCCESS, "Add another order");
+    wait_worker_held();
+    test_assert(!hl_kill_switch_is_armed(ks), "Outdated action is not armed");
+
+    test_assert(!hl_kill_switch_remove(ks, 9999), "Unknown order");
+    test_assert(hl_kill_switch_remove(ks, 2001), "Remove order");
+    test_assert(hl_kill_switch_count(ks) == 1, "One order left");
+    set_gate(false);
+
+    // The action signed for the intermediate set is dropped, not installed
+    wait_armed(ks);
+    test_assert(hl_kill_switch_fire(ks) == HL_SUCCESS, "Fire");
+    test_assert(ws_posts == 1 && main_nonces == 0, "Stored action sent");
+    hl_cancel_t remaining[] = { { 1, 2002 } };
+    check_signed(sent_payload, remaining, 1);
+
+    hl_kill_switch_destroy(ks);
+    printf("✅ re-sign on change test passed\n");
+    return TEST_PASS;
+}
+
+/**
+ * @brief Firing before the thread caught up signs on the spot, under the lock
+ */
+test_result_t test_kill_switch_fire_unarmed(void) {
+    reset_stubs();
+    hl_kill_switch_t* ks = create_switch(false);
+
+    set_gate(true);
+    test_assert(hl_kill_switch_add(ks, 0, 3001) == HL_SUCCESS, "Add order");
+    wait_worker_held();
+    test_assert(hl_kill_switch_add(ks, 5, 3002) == HL_SUCCESS, "Add while signing");
+    test_assert(!hl_kill_switch_is_armed(ks), "Not armed");
+
+    test_assert(hl_kill_switch_fire(ks) == HL_SUCCESS, "Fire");
+    test_assert(main_nonces == 1, "Signed by the caller");
+    test_assert(probe_started && main_nonce_locked, "Signed with the switch locked");
+    pthread_join(probe_thread, NULL);
+    test_assert(atomic_load(&probe_done), "Unlocked after firing");
+    test_assert(ws_posts == 1, "Sent");
+    hl_cancel_t cancels[] = { { 0, 3001 }, { 5, 3002 } };
+    check_signed(sent_payload, cancels, 2);
+
+    // The held signature is for one order only and is thrown away
+    set_gate(false);
+    wait_armed(ks);
+    test_assert(hl_kill_switch_fire(ks) == HL_SUCCESS, "Fire the stored action");
+    test_assert(ws_posts == 2 && main_nonces == 1, "Stored action sent");
+    check_signed(sent_payload, cancels, 2);
+
+    hl_kill_switch_destroy(ks);
+    printf("✅ unarmed fire test passed\n");
+    return TEST_PASS;
+}
+
+/**
+ * @brief Open orders seed the set; orderUpdates add and remove orders
+ */
+test_result_t test_kill_switch_track_orders(void) {
+    reset_stubs();
+    snprintf(open_orders[0].symbol, sizeof(open_orders[0].symbol), "BTC/USDC:USDC");
+    snprintf(open_orders[0].id, sizeof(open_orders[0].id), "11");
+    snprintf(open_orders[1].symbol, sizeof(open_orders[1].symbol), "ETH/USDC:USDC");
+    snprintf(open_orders[1].id, sizeof(open_orders[1].id), "12");
+    snprintf(open_orders[2].symbol, sizeof(open_orders[2].symbol), "NOPE/USDC:USDC");
+    snprintf(open_orders[2].id, sizeof(open_orders[2].id), "99");
+    open_order_count = 3;
+
+    hl_kill_switch_t* ks = create_switch(true);
+    test_assert(orders_callback != NULL, "Subscribed to orderUpdates");
+    test_assert(hl_kill_switch_count(ks) == 2, "Seeded with the known coins");
+
+    // SOL rests, BTC fills, an unknown coin is skipped
+    cJSON* updates = cJSON_Parse(
+        "[{\"order\":{\"coin\":\"SOL\",\"oid\":13},\"status\":\"open\"},"
+        "{\"order\":{\"coin\":\"BTC\",\"oid\":11},\"status\":\"filled\"},"
+        "{\"order\":{\"coin\":\"NOPE\",\"oid\":98},\"status\":\"open\"},"
+        "{\"order\":{\"coin\":\"ETH\",\"oid\":14},\"status\":\"triggered\"}]");
+    test_assert(updates != NULL, "Updates parsed");
+    hl_ws_message_t msg = { .channel = "orderUpdates", .json = updates };
+    orders_callback(&msg, orders_user_data);
+    cJSON_Delete(updates);
+    test_assert(hl_kill_switch_count(ks) == 3, "Set follows the stream");
+
+    wait_armed(ks);
+    test_assert(hl_kill_switch_fire(ks) == HL_SUCCESS, "Fire");
+    // Removal moves the last order into the freed slot
+    hl_cancel_t cancels[] = { { 5, 13 }, { 1, 12 }, { 1, 14 } };
+    check_signed(sent_payload, cancels, 3);
+
+    hl_kill_switch_destroy(ks);
+    test_assert(unwatches == 1, "Unsubscribed on destroy");
+    printf("✅ order tracking test passed\n");
+    return TEST_PASS;
+}
+
+int main(void) {
+    printf("╔══════════════════════════════════════════╗\n");
+    printf("║  UNIT TESTS: Kill switch                  ║\n");
+    printf("╚══════════════════════════════════════════╝\n\n");
+
+    main_thread = pthread_self();
+    struct timespec ts;
+    clock_gettime(CLOCK_REALTIME, &ts);
+    atomic_init(&next_nonce, (uint64_t)ts.tv_sec * 1000 + (uint64_t)ts.tv_nsec / 1000000);
+    test_signer = hl_signer_create(TEST_KEY);
+    test_assert(test_signer != NULL, "Signer created");
+
+    static hl_market_t markets[3];
+    const char* coins[] = { "BTC", "ETH", "SOL" };
+    const uint32_t assets[] = { 0, 1, 5 };
+    for (size_t i = 0; i < 3; i++) {
+        markets[i].type = HL_MARKET_SWAP;
+        markets[i].asset_id = assets[i];
+        snprintf(markets[i].base, sizeof(markets[i].base), "%s", coins[i]);
+    }
+    hl_markets_t market_list = { markets, 3 };
+    test_mids = hl_mids_table_create();
+    test_assert(hl_mids_table_bind_markets(test_mids, &market_list) == 3, "Mids bound");
+
+    test_func_t tests[] = {
+        test_kill_switch_fire_presigned,
+        test_kill_switch_resign_on_change,
+        test_kill_switch_fire_unarmed,
+        test_kill_switch_track_orders
+    };
+
+    int status = test_run_suite("Kill Switch Unit Tests", tests, sizeof(tests)/sizeof(test_func_t));
+    reset_stubs();
+    hl_mids_table_destroy(test_mids);
+    hl_signer_destroy(test_signer);
+    return status;
+}
@@ -0,0 +1,223 @@
+/**
+ * @file test_mids.c
+ * @brief Mid-price table: binding, lookup and allMids updates
+ *
+ * Markets are built in memory; allMids objects are parsed from literal
+ * messages in the exchange's format, spot pairs keyed by "@<index>".
+ */
+
+#define _GNU_SOURCE
+
+#include "../helpers/test_common.h"
+#include "../../include/hl_mids.h"
+#include "../../include/hl_markets.h"
+#include "../../include/hl_internal.h"
+#include <pthread.h>
+#include <stdatomic.h>
+#include <cjson/cJSON.h>
+
+#define UPDATE_NS 1708622398700000000LL
+
+static hl_market_t MARKETS[5];
+static hl_markets_t markets = { MARKETS, 5 };
+
+static void add_market(size_t i, hl_market_type_t type, const char* symbol, const char* base,
+                       uint32_t asset_id) {
+    memset(&MARKETS[i], 0, sizeof(MARKETS[i]));
+    MARKETS[i].type = type;
+    snprintf(MARKETS[i].symbol, sizeof(MARKETS[i].symbol), "%s", symbol);
+    snprintf(MARKETS[i].base, sizeof(MARKETS[i].base), "%s", base);
+    MARKETS[i].asset_id = asset_id;
+}
+
+static void build_markets(void) {
+    add_market(0, HL_MARKET_SWAP, "BTC/USDC:USDC", "BTC", 0);
+    add_market(1, HL_MARKET_SWAP, "ETH/USDC:USDC", "ETH", 1);
+    add_market(2, HL_MARKET_SPOT, "PURR/USDC", "PURR", 0);
+    add_market(3, HL_MARKET_SPOT, "HYPE/USDC", "HYPE", 107);
+    // Past the perp capacity: not bound
+    add_market(4, HL_MARKET_SWAP, "FAR/USDC:USDC", "FAR", HL_MIDS_PERP_CAPACITY);
+}
+
+static bool lookup_is(const hl_mids_table_t* table, const char* coin, uint32_t expected) {
+    uint32_t asset_id = UINT32_MAX;
+    return hl_mids_table_lookup(table, coin, &asset_id) && asset_id == expected;
+}
+
+/**
+ * @brief Perps by base coin, spot by "@<index>" and by pair name
+ */
+test_result_t test_mids_bind_lookup(void) {
+    hl_mids_table_t* table = hl_mids_table_create();
+    test_assert(table != NULL, "Table created");
+    build_markets();
+
+    test_assert(hl_mids_table_bind_markets(table, &markets) == 4, "Bound coins");
+
+    uint32_t asset_id;
+    test_assert(lookup_is(table, "BTC", 0), "Perp by base coin");
+    test_assert(lookup_is(table, "ETH", 1), "Second perp");
+    test_assert(lookup_is(table, "@0", HL_MIDS_SPOT_BASE), "Spot by index");
+    test_assert(lookup_is(table, "PURR/USDC", HL_MIDS_SPOT_BASE), "Spot by pair name");
+    test_assert(lookup_is(table, "@107", HL_MIDS_SPOT_BASE + 107), "Spot index past ten");
+    test_assert(lookup_is(table, "HYPE/USDC", HL_MIDS_SPOT_BASE + 107), "Second pair name");
+    test_assert(!hl_mids_table_lookup(table, "FAR", &asset_id), "Out of range perp unbound");
+    test_assert(!hl_mids_table_lookup(table, "@1", &asset_id), "Unknown spot index");
+    test_assert(!hl_mids_table_lookup(table, "@10", &asset_id), "Index prefix is not a match");
+    test_assert(!hl_mids_table_lookup(table, "BTC/USDC:USDC", &asset_id),
+                "Perp symbols are not keys");
+    test_assert(!hl_mids_table_lookup(table, "", &asset_id), "Empty key");
+    test_assert(!hl_mids_table_lookup(NULL, "BTC", &asset_id), "No table");
+
+    // Rebinding after a reload moves a key and keeps prices
+    test_assert(hl_mids_set(table, 1, 3500.0, UPDATE_NS), "Set ETH");
+    MARKETS[1].asset_id = 7;
+    test_assert(hl_mids_table_bind_markets(table, &markets) == 4, "Rebound coins");
+    test_assert(lookup_is(table, "ETH", 7), "Key moved");
+    hl_mid_t mid;
+    test_assert(hl_mids_get(table, 1, &mid) && mid.mid == 3500.0, "Price kept");
+    test_assert(!hl_mids_get_coin(table, "ETH", &mid), "New slot has no price yet");
+
+    hl_mids_table_destroy(table);
+    printf("✅ bind and lookup test passed\n");
+    return TEST_PASS;
+}
+
+/**
+ * @brief An allMids object updates every bound coin as one batch
+ */
+test_result_t test_mids_apply(void) {
+    hl_mids_table_t* table = hl_mids_table_create();
+    test_assert(table != NULL, "Table created");
+    build_markets();
+    hl_mids_table_bind_markets(table, &markets);
+
+    cJSON* mids = cJSON_Parse("{\"BTC\":\"65000.5\",\"ETH\":3500.25,\"@107\":\"25.125\","
+                              "\"PURR/USDC\":\"0.2\",\"DOGE\":\"0.1\",\"@3\":\"9.0\","
+                              "\"BAD\":true}");
+    test_assert(mids != NULL, "Parse allMids");
+
+    uint64_t version = hl_mids_version(table);
+    test_assert(hl_mids_table_apply_json(table, mids, UPDATE_NS) == 4, "Bound coins applied");
+    test_assert(hl_mids_version(table) == version + 1, "One version per batch");
+
+    hl_mid_t mid;
+    test_assert(hl_mids_get_coin(table, "BTC", &mid) && mid.mid == 65000.5, "String price");
+    test_assert(mid.update_ns == UPDATE_NS && mid.updates == 1, "Receive time and count");
+    test_assert(hl_mids_get_coin(table, "ETH", &mid) && mid.mid == 3500.25, "Number price");
+    test_assert(hl_mids_get(table, HL_MIDS_SPOT_BASE + 107, &mid) && mid.mid == 25.125,
+                "Spot price by index key");
+    test_assert(hl_mids_get_coin(table, "HYPE/USDC", &mid) && mid.mid == 25.125,
+                "Same entry by pair name");
+    test_assert(hl_mids_get_coin(table, "@0", &mid) && mid.mid == 0.2,
+                "Pair name key updates the index entry");
+    test_assert(!hl_mids_get(table, HL_MIDS_SPOT_BASE + 3, &mid), "Unbound index ignored");
+
+    test_assert(hl_mids_table_apply_json(table, mids, UPDATE_NS + 1) == 4, "Applied again");
+    test_assert(hl_mids_get_coin(table, "BTC", &mid) && mid.updates == 2 &&
+                mid.update_ns == UPDATE_NS + 1, "Second update counted");
+    cJSON_Delete(mids);
+
+    // Nothing applied: no new version
+    version = hl_mids_version(table);
+    mids = cJSON_Parse("{\"DOGE\":\"0.1\"}");
+    test_assert(hl_mids_table_apply_json(table, mids, UPDATE_NS) == 0, "Nothing bound");
+    cJSON_Delete(mids);
+    mids = cJSON_Parse("[\"BTC\"]");
+    test_assert(hl_mids_table_apply_json(table, mids, UPDATE_NS) == 0, "Not an object");
+    cJSON_Delete(mids);
+    test_assert(hl_mids_version(table) == version, "Version unchanged");
+
+    hl_mids_table_destroy(table);
+    printf("✅ allMids apply test passed\n");
+    return TEST_PASS;
+}
+
+/**
+ * @brief Single prices: range checks and the default receive time
+ */
+test_result_t test_mids_set_get(void) {
+    hl_mids_table_t* table = hl_mids_table_create();
+    test_assert(table != NULL, "Table created");
+
+    hl_mid_t mid;
+    test_assert(!hl_mids_get(table, 0, &mid), "No price before the first update");
+    test_assert(hl_mids_set(table, HL_MIDS_PERP_CAPACITY - 1, 1.5, UPDATE_NS), "Last perp");
+    test_assert(hl_mids_set(table, HL_MIDS_SPOT_BASE + HL_MIDS_SPOT_CAPACITY - 1, 2.5,
+                            UPDATE_NS), "Last spot");
+    test_assert(!hl_mids_set(table, HL_MIDS_PERP_CAPACITY, 1.0, UPDATE_NS), "Past the perps");
+    test_assert(!hl_mids_set(table, HL_MIDS_SPOT_BASE - 1, 1.0, UPDATE_NS), "Below spot");
+    test_assert(!hl_mids_set(table, HL_MIDS_SPOT_BASE + HL_MIDS_SPOT_CAPACITY, 1.0, UPDATE_NS),
+                "Past the spot pairs");
+    test_assert(hl_mids_version(table) == 2, "Version per update");
+
+    test_assert(hl_mids_set(table, 5, 9.0, 0), "Set without a time");
+    test_assert(hl_mids_get(table, 5, &mid) && mid.update_ns > UPDATE_NS, "Wall clock used");
+
+    hl_mids_table_destroy(table);
+    printf("✅ set and get test passed\n");
+    return TEST_PASS;
+}
+
+typedef struct {
+    hl_mids_table_t* table;
+    atomic_bool done;
+    atomic_bool consistent;
+} reader_state_t;
+
+static void* mids_reader(void* arg) {
+    reader_state_t* state = arg;
+    hl_mid_t mid;
+    while (!atomic_load(&state->done)) {
+        if (hl_mids_get(state->table, 0, &mid) &&
+            (mid.mid != (double)mid.update_ns || (uint64_t)mid.update_ns != mid.updates)) {
+            atomic_store(&state->consistent, false);
+        }
+    }
+    return NULL;
+}
+
+/**
+ * @brief Readers never see half of an update
+ */
+test_result_t test_mids_concurrent_readers(void) {
+    reader_state_t state;
+    state.table = hl_mids_table_create();
+    test_assert(state.table != NULL, "Table created");
+    atomic_init(&state.done, false);
+    atomic_init(&state.consistent, true);
+
+    pthread_t readers[3];
+    for (size_t i = 0; i < 3; i++) {
+        test_assert(pthread_create(&readers[i], NULL, mids_reader, &state) == 0,
+                    "Start reader");
+    }
+    // Every field of update n is n
+    for (int64_t n = 1; n <= 200000; n++) {
+        hl_mids_set(state.table, 0, (double)n, n);
+    }
+    atomic_store(&state.done, true);
+    for (size_t i = 0; i < 3; i++) {
+        pthread_join(readers[i], NULL);
+    }
+
+    test_assert(atomic_load(&state.consistent), "Consistent readings");
+    hl_mids_table_destroy(state.table);
+    printf("✅ concurrent reader test passed\n");
+    return TEST_PASS;
+}
+
+int main(void) {
+    printf("╔══════════════════════════════════════════╗\n");
+    printf("║  UNIT TESTS: Mid-price table              ║\n");
+    printf("╚══════════════════════════════════════════╝\n\n");
+
+    test_func_t tests[] = {
+        test_mids_bind_lookup,
+        test_mids_apply,
+        test_mids_set_get,
+        test_mids_concurrent_readers
+    };
+
+    return test_run_suite("Mid-Price Table Unit Tests", tests, sizeof(tests)/sizeof(test_func_t));
+}
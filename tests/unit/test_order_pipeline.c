@@ -0,0 +1,198 @@
+/**
+ * @file test_order_pipeline.c
+ * @brief The order pipeline's bounded MPMC job queue
+ *
+ * Jobs are plain structs here; no client or pipeline is created.
+ */
+
+#define _GNU_SOURCE
+
+#include "../helpers/test_common.h"
+#include "../../include/hl_internal.h"
+
+#define JOB_COUNT 16
+#define PRODUCERS 4
+#define CONSUMERS 4
+#define ITEMS_PER_PRODUCER 50000
+
+typedef struct {
+    int id;
+} test_job_t;
+
+/**
+ * @brief Capacity is the next power of two, at least two
+ */
+test_result_t test_queue_capacity(void) {
+    static const size_t requested[] = { 0, 1, 2, 3, 5, 8, 65 };
+    static const size_t expected[] = { 2, 2, 2, 4, 8, 8, 128 };
+
+    for (size_t i = 0; i < sizeof(requested) / sizeof(requested[0]); i++) {
+        hl_job_queue_t queue;
+        test_assert(hl_job_queue_init(&queue, requested[i]), "Queue created");
+        test_assert(queue.mask + 1 == expected[i], "Capacity rounded up");
+        hl_job_queue_free(&queue);
+    }
+
+    printf("✅ queue capacity test passed\n");
+    return TEST_PASS;
+}
+
+/**
+ * @brief One thread: jobs come out in the order they went in
+ */
+test_result_t test_queue_fifo(void) {
+    static test_job_t jobs[JOB_COUNT];
+    hl_job_queue_t queue;
+    test_assert(hl_job_queue_init(&queue, JOB_COUNT + 1), "Queue created");
+
+    // Full queue, then many laps of a partly filled ring
+    for (size_t i = 0; i < JOB_COUNT; i++) {
+        hl_job_queue_push(&queue, &jobs[i]);
+    }
+    hl_job_queue_push(&queue, NULL);
+    for (size_t i = 0; i < JOB_COUNT; i++) {
+        test_assert(hl_job_queue_pop(&queue) == &jobs[i], "Oldest job first");
+    }
+    test_assert(hl_job_queue_pop(&queue) == NULL, "Stop marker passes through");
+
+    size_t pushed = 0, popped = 0;
+    for (size_t lap = 0; lap < 1000; lap++) {
+        size_t burst = 1 + lap % (JOB_COUNT - 1);
+        for (size_t i = 0; i < burst; i++) {
+            hl_job_queue_push(&queue, &jobs[pushed++ % JOB_COUNT]);
+        }
+        for (size_t i = 0; i < burst; i++) {
+            test_assert(hl_job_queue_pop(&queue) == &jobs[popped++ % JOB_COUNT],
+                        "Order across laps");
+        }
+    }
+
+    hl_job_queue_free(&queue);
+    printf("✅ queue FIFO test passed\n");
+    return TEST_PASS;
+}
+
+typedef struct {
+    test_job_t jobs[JOB_COUNT];
+    uint64_t stamp[JOB_COUNT];          /**< Producer << 32 | sequence, set before a push */
+    hl_job_queue_t free_jobs;
+    hl_job_queue_t work;
+    atomic_int seen[PRODUCERS][ITEMS_PER_PRODUCER];
+    atomic_bool ordered;
+} stress_t;
+
+typedef struct {
+    stress_t* stress;
+    uint32_t id;
+} stress_thread_t;
+
+static void* stress_producer(void* arg) {
+    stress_thread_t* t = arg;
+    stress_t* s = t->stress;
+    for (uint32_t seq = 0; seq < ITEMS_PER_PRODUCER; seq++) {
+        test_job_t* job = hl_job_queue_pop(&s->free_jobs);
+        s->stamp[job - s->jobs] = (uint64_t)t->id << 32 | seq;
+        hl_job_queue_push(&s->work, job);
+    }
+    return NULL;
+}
+
+static void* stress_consumer(void* arg) {
+    stress_thread_t* t = arg;
+    stress_t* s = t->stress;
+    int64_t last[PRODUCERS];
+    for (size_t i = 0; i < PRODUCERS; i++) {
+        last[i] = -1;
+    }
+
+    test_job_t* job;
+    while ((job = hl_job_queue_pop(&s->work)) != NULL) {
+        uint64_t stamp = s->stamp[job - s->jobs];
+        uint32_t producer = (uint32_t)(stamp >> 32);
+        uint32_t seq = (uint32_t)stamp;
+        hl_job_queue_push(&s->free_jobs, job);
+
+        // FIFO: one consumer sees each producer's jobs in push order
+        if ((int64_t)seq <= last[producer]) {
+            atomic_store(&s->ordered, false);
+        }
+        last[producer] = seq;
+        atomic_fetch_add(&s->seen[producer][seq], 1);
+    }
+    return NULL;
+}
+
+/**
+ * @brief Jobs circulate between two queues as in the pipeline
+ *
+ * Producers take free jobs and publish them; consumers take published
+ * jobs and free them. With far fewer jobs than transfers, every cell is
+ * reused many times under contention on both ends.
+ */
+test_result_t test_queue_stress(void) {
+    stress_t* s = calloc(1, sizeof(stress_t));
+    test_assert(s != NULL, "Allocate stress state");
+    test_assert(hl_job_queue_init(&s->free_jobs, JOB_COUNT), "Free queue created");
+    test_assert(hl_job_queue_init(&s->work, JOB_COUNT + CONSUMERS), "Work queue created");
+    atomic_init(&s->ordered, true);
+    for (size_t i = 0; i < JOB_COUNT; i++) {
+        hl_job_queue_push(&s->free_jobs, &s->jobs[i]);
+    }
+
+    pthread_t producers[PRODUCERS], consumers[CONSUMERS];
+    stress_thread_t producer_args[PRODUCERS], consumer_args[CONSUMERS];
+    for (uint32_t i = 0; i < CONSUMERS; i++) {
+        consumer_args[i] = (stress_thread_t){ s, i };
+        test_assert(pthread_create(&consumers[i], NULL, stress_consumer, &consumer_args[i]) == 0,
+                    "Start consumer");
+    }
+    for (uint32_t i = 0; i < PRODUCERS; i++) {
+        producer_args[i] = (stress_thread_t){ s, i };
+        test_assert(pthread_create(&producers[i], NULL, stress_producer, &producer_args[i]) == 0,
+                    "Start producer");
+    }
+
+    for (size_t i = 0; i < PRODUCERS; i++) {
+        pthread_join(producers[i], NULL);
+    }
+    for (size_t i = 0; i < CONSUMERS; i++) {
+        hl_job_queue_push(&s->work, NULL);
+    }
+    for (size_t i = 0; i < CONSUMERS; i++) {
+        pthread_join(consumers[i], NULL);
+    }
+
+    test_assert(atomic_load(&s->ordered), "Per-producer order kept");
+    for (size_t p = 0; p < PRODUCERS; p++) {
+        for (size_t i = 0; i < ITEMS_PER_PRODUCER; i++) {
+            test_assert(atomic_load(&s->seen[p][i]) == 1, "Every job delivered exactly once");
+        }
+    }
+
+    // Every job is back on the free queue
+    for (size_t i = 0; i < JOB_COUNT; i++) {
+        test_job_t* job = hl_job_queue_pop(&s->free_jobs);
+        test_assert(job >= s->jobs && job < s->jobs + JOB_COUNT, "Job returned");
+    }
+
+    hl_job_queue_free(&s->work);
+    hl_job_queue_free(&s->free_jobs);
+    free(s);
+    printf("✅ queue stress test passed\n");
+    return TEST_PASS;
+}
+
+int main(void) {
+    printf("╔══════════════════════════════════════════╗\n");
+    printf("║  UNIT TESTS: Order pipeline queue         ║\n");
+    printf("╚══════════════════════════════════════════╝\n\n");
+
+    test_func_t tests[] = {
+        test_queue_capacity,
+        test_queue_fifo,
+        test_queue_stress
+    };
+
+    return test_run_suite("Order Pipeline Queue Unit Tests", tests,
+                          sizeof(tests)/sizeof(test_func_t));
+}
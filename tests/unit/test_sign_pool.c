@@ -0,0 +1,184 @@
+/**
+ * @file test_sign_pool.c
+ * @brief Batch signing on the pool against one action at a time
+ *
+ * Every batch result must be the signature that hashing and signing the
+ * item on its own gives, whatever the pool size, batch length or mix of
+ * keys, networks and action types.
+ */
+
+#include "../helpers/test_common.h"
+#include "../../include/hl_sign_pool.h"
+#include "../../include/hl_crypto_internal.h"
+#include <pthread.h>
+
+static const char* KEYS[] = {
+    "0x0123456789012345678901234567890123456789012345678901234567890123",
+    "0xe908f86dbb4d55ac876378565aafeabc187f6690f046459397b17d9b9a19688e"
+};
+
+#define BASE_NONCE 1700000000000ULL
+#define MAX_ITEMS 100
+
+static hl_order_request_t ORDERS[] = {
+    { .a = 0, .b = true, .p = "51235.0", .s = "0.01", .r = false, .limit = {.tif = "Gtc"} },
+    { .a = 3, .b = false, .p = "187.25", .s = "12.5", .r = true, .limit = {.tif = "Ioc"} }
+};
+static hl_cancel_t CANCELS[] = { { 0, 91234567890ULL }, { 3, 91234567891ULL } };
+
+static hl_order_action_t ORDER_ACTION = { ORDERS, 2, "na" };
+static hl_cancel_action_t CANCEL_ACTION = { CANCELS, 2 };
+
+static hl_signer_t* signers[2];
+
+/**
+ * @brief Item i: alternating actions, keys and networks, vault on some
+ */
+static void fill_items(hl_sign_item_t* items, size_t count) {
+    for (size_t i = 0; i < count; i++) {
+        items[i].signer = signers[i % 2];
+        items[i].testnet = (i / 2) % 2 == 1;
+        items[i].action.action_type = i % 3 == 2 ? "cancel" : "order";
+        items[i].action.action_data = i % 3 == 2 ? (const void*)&CANCEL_ACTION
+                                                 : (const void*)&ORDER_ACTION;
+        items[i].action.nonce = BASE_NONCE + i;
+        items[i].action.vault_address =
+            i % 5 == 4 ? "0x5e9ee1089755c3435139848e47e6635505d5a13a" : NULL;
+    }
+}
+
+/**
+ * @brief The signature the item gets when signed on its own
+ */
+static void sign_one(const hl_sign_item_t* item, uint8_t signature[65]) {
+    uint8_t connection_id[32];
+    test_assert(hl_build_action_hash(item->action.action_type, item->action.action_data,
+                                     item->action.nonce, item->action.vault_address,
+                                     connection_id) == 0, "Hash item");
+    test_assert(eip712_sign_agent_signer(item->signer, "Exchange", 1337,
+                                         item->testnet ? "b" : "a", connection_id,
+                                         signature) == 0, "Sign item");
+}
+
+static void check_batch(hl_sign_pool_t* pool, size_t count) {
+    hl_sign_item_t items[MAX_ITEMS] = {0};
+    hl_sign_result_t results[MAX_ITEMS];
+    fill_items(items, count);
+    memset(results, 0xAA, sizeof(results));
+
+    test_assert(hl_sign_pool_sign(pool, items, count, results) == HL_SUCCESS, "Sign batch");
+    for (size_t i = 0; i < count; i++) {
+        uint8_t expected[65];
+        sign_one(&items[i], expected);
+        test_assert(results[i].error == HL_SUCCESS, "Item signed");
+        test_assert(memcmp(results[i].signature, expected, 65) == 0,
+                    "Batch signature equals single signature");
+    }
+}
+
+/**
+ * @brief Batches of every shape on pools of one and several threads
+ */
+test_result_t test_sign_pool_matches_single(void) {
+    static const size_t threads[] = { 1, 4 };
+    static const size_t counts[] = { 1, 7, 8, 9, 17, 64, MAX_ITEMS };
+
+    for (size_t t = 0; t < sizeof(threads) / sizeof(threads[0]); t++) {
+        hl_sign_pool_t* pool = hl_sign_pool_create(threads[t]);
+        test_assert(pool != NULL, "Pool created");
+        for (size_t c = 0; c < sizeof(counts) / sizeof(counts[0]); c++) {
+            check_batch(pool, counts[c]);
+        }
+        hl_sign_pool_destroy(pool);
+    }
+
+    printf("✅ batch equals single signing test passed\n");
+    return TEST_PASS;
+}
+
+/**
+ * @brief A bad item fails alone; the rest of its chunk is still signed
+ */
+test_result_t test_sign_pool_item_errors(void) {
+    hl_sign_pool_t* pool = hl_sign_pool_create(4);
+    test_assert(pool != NULL, "Pool created");
+
+    hl_sign_item_t items[20];
+    hl_sign_result_t results[20];
+    fill_items(items, 20);
+    items[3].action.action_type = "notAnAction";
+    items[12].signer = NULL;
+
+    test_assert(hl_sign_pool_sign(pool, items, 20, results) == HL_ERROR_INVALID_PARAMS,
+                "First failing item's error");
+    test_assert(results[3].error == HL_ERROR_INVALID_PARAMS, "Unknown action refused");
+    test_assert(results[12].error == HL_ERROR_AUTH, "Missing signer refused");
+
+    for (size_t i = 0; i < 20; i++) {
+        if (i == 3 || i == 12) {
+            continue;
+        }
+        uint8_t expected[65];
+        sign_one(&items[i], expected);
+        test_assert(results[i].error == HL_SUCCESS &&
+                    memcmp(results[i].signature, expected, 65) == 0, "Good items signed");
+    }
+
+    test_assert(hl_sign_pool_sign(pool, items, 0, NULL) == HL_SUCCESS, "Empty batch");
+    test_assert(hl_sign_pool_sign(NULL, items, 1, results) == HL_ERROR_INVALID_PARAMS,
+                "No pool");
+
+    hl_sign_pool_destroy(pool);
+    printf("✅ per-item error test passed\n");
+    return TEST_PASS;
+}
+
+static void* submit_thread(void* arg) {
+    hl_sign_pool_t* pool = arg;
+    for (int i = 0; i < 20; i++) {
+        check_batch(pool, MAX_ITEMS);
+    }
+    return NULL;
+}
+
+/**
+ * @brief Batches from several callers share the pool
+ */
+test_result_t test_sign_pool_concurrent_callers(void) {
+    hl_sign_pool_t* pool = hl_sign_pool_create(3);
+    test_assert(pool != NULL, "Pool created");
+
+    pthread_t callers[3];
+    for (size_t i = 0; i < 3; i++) {
+        test_assert(pthread_create(&callers[i], NULL, submit_thread, pool) == 0,
+                    "Start caller");
+    }
+    for (size_t i = 0; i < 3; i++) {
+        pthread_join(callers[i], NULL);
+    }
+
+    hl_sign_pool_destroy(pool);
+    printf("✅ concurrent callers test passed\n");
+    return TEST_PASS;
+}
+
+int main(void) {
+    printf("╔══════════════════════════════════════════╗\n");
+    printf("║  UNIT TESTS: Sign pool                    ║\n");
+    printf("╚══════════════════════════════════════════╝\n\n");
+
+    signers[0] = hl_signer_create(KEYS[0]);
+    signers[1] = hl_signer_create(KEYS[1]);
+    test_assert(signers[0] && signers[1], "Signers created");
+
+    test_func_t tests[] = {
+        test_sign_pool_matches_single,
+        test_sign_pool_item_errors,
+        test_sign_pool_concurrent_callers
+    };
+
+    int status = test_run_suite("Sign Pool Unit Tests", tests, sizeof(tests)/sizeof(test_func_t));
+    hl_signer_destroy(signers[1]);
+    hl_signer_destroy(signers[0]);
+    return status;
+}
@@ -0,0 +1,163 @@
+/**
+ * @file test_signer.c
+ * @brief Nonce allocation by the signer
+ *
+ * Nonces must stay unique and strictly increasing when several threads
+ * take them at once, and must never run more than an hour ahead of the
+ * clock passed in.
+ */
+
+#define _GNU_SOURCE
+
+#include "../helpers/test_common.h"
+#include "../../include/hl_signer.h"
+#include <pthread.h>
+#include <stdint.h>
+
+static const char* TEST_KEY = "0x0123456789012345678901234567890123456789012345678901234567890123";
+
+#define NOW_MS 1700000000000ULL
+#define MAX_LEAD_MS (60ULL * 60 * 1000)
+
+#define THREAD_COUNT 8
+#define BLOCKS_PER_THREAD 5000
+#define MAX_BLOCK 4
+
+/**
+ * @brief Nonces follow the clock and run ahead of it only when it stalls
+ */
+test_result_t test_signer_nonce_sequence(void) {
+    hl_signer_t* signer = hl_signer_create(TEST_KEY);
+    test_assert(signer != NULL, "Signer created");
+
+    test_assert(hl_signer_next_nonce(signer, NOW_MS) == NOW_MS, "First nonce is the clock");
+    test_assert(hl_signer_next_nonce(signer, NOW_MS) == NOW_MS + 1, "Same millisecond");
+    test_assert(hl_signer_next_nonce(signer, NOW_MS - 10) == NOW_MS + 2, "Clock went back");
+    test_assert(hl_signer_next_nonce(signer, NOW_MS + 100) == NOW_MS + 100, "Clock moved on");
+
+    test_assert(hl_signer_reserve_nonces(signer, NOW_MS + 100, 10) == NOW_MS + 101,
+                "Block starts after the last nonce");
+    test_assert(hl_signer_next_nonce(signer, NOW_MS + 100) == NOW_MS + 111,
+                "Next nonce follows the block");
+
+    test_assert(hl_signer_reserve_nonces(signer, NOW_MS, 0) == 0, "Empty block refused");
+    test_assert(hl_signer_next_nonce(NULL, NOW_MS) == 0, "No signer");
+
+    hl_signer_destroy(signer);
+    printf("✅ nonce sequence test passed\n");
+    return TEST_PASS;
+}
+
+/**
+ * @brief No nonce is handed out more than an hour ahead of the clock
+ */
+test_result_t test_signer_nonce_lead_cap(void) {
+    hl_signer_t* signer = hl_signer_create(TEST_KEY);
+    test_assert(signer != NULL, "Signer created");
+
+    test_assert(hl_signer_reserve_nonces(signer, NOW_MS, MAX_LEAD_MS + 2) == 0,
+                "Block past the cap refused");
+    test_assert(hl_signer_reserve_nonces(signer, NOW_MS, MAX_LEAD_MS + 1) == NOW_MS,
+                "Block up to the cap granted");
+    test_assert(hl_signer_next_nonce(signer, NOW_MS) == 0, "Nonce past the cap refused");
+    test_assert(hl_signer_reserve_nonces(signer, NOW_MS, 1) == 0, "Still refused");
+
+    // A refusal takes nothing; the clock catching up frees the next value
+    test_assert(hl_signer_next_nonce(signer, NOW_MS + 1) == NOW_MS + MAX_LEAD_MS + 1,
+                "Granted once the clock moves");
+
+    hl_signer_destroy(signer);
+    printf("✅ nonce lead cap test passed\n");
+    return TEST_PASS;
+}
+
+typedef struct {
+    hl_signer_t* signer;
+    unsigned seed;
+    uint64_t* nonces;
+    size_t count;
+    bool increasing;
+} nonce_thread_t;
+
+static void* nonce_thread(void* arg) {
+    nonce_thread_t* t = (nonce_thread_t*)arg;
+    uint64_t previous = 0;
+    t->increasing = true;
+
+    for (size_t i = 0; i < BLOCKS_PER_THREAD; i++) {
+        size_t block = 1 + (size_t)(rand_r(&t->seed) % MAX_BLOCK);
+        // The clock mostly stalls, so threads contend for the same values
+        uint64_t now = NOW_MS + i / 1000;
+        uint64_t first = hl_signer_reserve_nonces(t->signer, now, block);
+        if (first == 0 || first <= previous) {
+            t->increasing = false;
+            return NULL;
+        }
+        for (size_t j = 0; j < block; j++) {
+            t->nonces[t->count++] = first + j;
+        }
+        previous = first + block - 1;
+    }
+    return NULL;
+}
+
+static int compare_u64(const void* a, const void* b) {
+    uint64_t x = *(const uint64_t*)a;
+    uint64_t y = *(const uint64_t*)b;
+    return x < y ? -1 : x > y;
+}
+
+/**
+ * @brief Concurrent allocation: increasing per thread, unique overall
+ */
+test_result_t test_signer_nonce_threads(void) {
+    hl_signer_t* signer = hl_signer_create(TEST_KEY);
+    test_assert(signer != NULL, "Signer created");
+
+    size_t per_thread = BLOCKS_PER_THREAD * MAX_BLOCK;
+    uint64_t* nonces = malloc(THREAD_COUNT * per_thread * sizeof(uint64_t));
+    test_assert(nonces != NULL, "Allocate nonce log");
+
+    pthread_t threads[THREAD_COUNT];
+    nonce_thread_t state[THREAD_COUNT];
+    for (size_t i = 0; i < THREAD_COUNT; i++) {
+        state[i] = (nonce_thread_t){ signer, (unsigned)i + 1, nonces + i * per_thread, 0, false };
+        test_assert(pthread_create(&threads[i], NULL, nonce_thread, &state[i]) == 0,
+                    "Start thread");
+    }
+
+    size_t total = 0;
+    for (size_t i = 0; i < THREAD_COUNT; i++) {
+        pthread_join(threads[i], NULL);
+        test_assert(state[i].increasing, "Strictly increasing within a thread");
+        memmove(nonces + total, state[i].nonces, state[i].count * sizeof(uint64_t));
+        total += state[i].count;
+    }
+
+    qsort(nonces, total, sizeof(uint64_t), compare_u64);
+    for (size_t i = 1; i < total; i++) {
+        test_assert(nonces[i] != nonces[i - 1], "Unique across threads");
+    }
+    // Nothing was skipped either: the stalled clock packs them end to end
+    test_assert(nonces[0] == NOW_MS && nonces[total - 1] == NOW_MS + total - 1,
+                "Contiguous allocation");
+
+    free(nonces);
+    hl_signer_destroy(signer);
+    printf("✅ concurrent nonce test passed\n");
+    return TEST_PASS;
+}
+
+int main(void) {
+    printf("╔══════════════════════════════════════════╗\n");
+    printf("║  UNIT TESTS: Signer nonces                ║\n");
+    printf("╚══════════════════════════════════════════╝\n\n");
+
+    test_func_t tests[] = {
+        test_signer_nonce_sequence,
+        test_signer_nonce_lead_cap,
+        test_signer_nonce_threads
+    };
+
+    return test_run_suite("Signer Nonce Unit Tests", tests, sizeof(tests)/sizeof(test_func_t));
+}
@@ -0,0 +1,179 @@
+/**
+ * @file test_ws_client.c
+ * @brief WebSocket client connection lifecycle
+ *
+ * A loopback server thread completes the upgrade and then hangs up, so the
+ * client sees a dropped connection without any network access.
+ */
+
+#define _GNU_SOURCE
+
+#include "../helpers/test_common.h"
+#include "../../include/hl_ws_client.h"
+#include <pthread.h>
+#include <stdatomic.h>
+#include <unistd.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <openssl/evp.h>
+#include <openssl/sha.h>
+
+#define WS_GUID "258EAFA5-E914-47DA-95CA-C5AB0DC85B11"
+
+// Server side of the loopback connection
+typedef struct {
+    int listen_fd;
+    int sessions;                       /**< Connections to accept, then hang up */
+} drop_server_t;
+
+static atomic_int connects;
+static atomic_int disconnects;
+
+static void on_connect(void* user_data) {
+    (void)user_data;
+    atomic_fetch_add(&connects, 1);
+}
+
+static void on_disconnect(const char* reason, void* user_data) {
+    (void)reason;
+    (void)user_data;
+    atomic_fetch_add(&disconnects, 1);
+}
+
+/**
+ * @brief Answer one upgrade request on @p fd
+ */
+static void drop_server_upgrade(int fd) {
+    char request[2048];
+    size_t len = 0;
+    while (len < sizeof(request) - 1) {
+        ssize_t n = read(fd, request + len, sizeof(request) - 1 - len);
+        if (n <= 0) return;
+        len += (size_t)n;
+        request[len] = '\0';
+        if (strstr(request, "\r\n\r\n")) break;
+    }
+
+    const char* key = strcasestr(request, "Sec-WebSocket-Key:");
+    if (!key) return;
+    key += 18;
+    while (*key == ' ') key++;
+
+    char accept_src[96];
+    size_t key_len = strcspn(key, "\r\n");
+    snprintf(accept_src, sizeof(accept_src), "%.*s%s", (int)key_len, key, WS_GUID);
+    unsigned char digest[SHA_DIGEST_LENGTH];
+    SHA1((const unsigned char*)accept_src, strlen(accept_src), digest);
+    char accept[32];
+    EVP_EncodeBlock((unsigned char*)accept, digest, SHA_DIGEST_LENGTH);
+
+    char response[256];
+    int response_len = snprintf(response, sizeof(response),
+                                "HTTP/1.1 101 Switching Protocols\r\n"
+                                "Upgrade: websocket\r\n"
+                                "Connection: Upgrade\r\n"
+                                "Sec-WebSocket-Accept: %s\r\n"
+                                "\r\n", accept);
+    if (write(fd, response, (size_t)response_len) != response_len) return;
+}
+
+static void* drop_server_thread(void* arg) {
+    drop_server_t* server = (drop_server_t*)arg;
+
+    for (int i = 0; i < server->sessions; i++) {
+        int fd = accept(server->listen_fd, NULL, NULL);
+        if (fd < 0) break;
+        drop_server_upgrade(fd);
+        usleep(50000);
+        close(fd);
+    }
+    return NULL;
+}
+
+/**
+ * @brief Listen on an ephemeral loopback port
+ */
+static int drop_server_listen(int* port) {
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    if (fd < 0) return -1;
+
+    struct sockaddr_in addr = {0};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    socklen_t addr_len = sizeof(addr);
+    if (bind(fd, (struct sockaddr*)&addr, sizeof(addr)) != 0 ||
+        listen(fd, 4) != 0 ||
+        getsockname(fd, (struct sockaddr*)&addr, &addr_len) != 0) {
+        close(fd);
+        return -1;
+    }
+    *port = ntohs(addr.sin_port);
+    return fd;
+}
+
+/**
+ * @brief Wait up to two seconds for the I/O thread to give up
+ */
+static bool wait_idle(hl_ws_client_t* client) {
+    for (int i = 0; i < 200; i++) {
+        if (!hl_ws_client_is_connected(client) && !client->running) return true;
+        usleep(10000);
+    }
+    return false;
+}
+
+/**
+ * @brief A dropped connection without auto reconnect leaves the client reusable
+ */
+test_result_t test_ws_client_reconnect_after_drop(void) {
+    int port = 0;
+    drop_server_t server = {.listen_fd = drop_server_listen(&port), .sessions = 2};
+    test_assert(server.listen_fd >= 0, "Loopback listener");
+
+    pthread_t thread;
+    test_assert(pthread_create(&thread, NULL, drop_server_thread, &server) == 0,
+                "Server thread started");
+
+    char url[64];
+    snprintf(url, sizeof(url), "ws://127.0.0.1:%d/ws", port);
+    hl_ws_config_t config = {
+        .url = url,
+        .timeout_ms = 2000,
+        .auto_reconnect = false,
+        .busy_poll_cpu = -1
+    };
+    hl_ws_client_t* client = hl_ws_client_create(&config);
+    test_assert(client != NULL, "Client created");
+    hl_ws_client_set_connect_callback(client, on_connect, NULL);
+    hl_ws_client_set_disconnect_callback(client, on_disconnect, NULL);
+
+    test_assert(hl_ws_client_connect(client), "First connect");
+    test_assert(wait_idle(client), "Drop seen, I/O thread stopped");
+    test_assert(atomic_load(&disconnects) == 1, "Disconnect reported once");
+
+    test_assert(hl_ws_client_connect(client), "Connect again after the drop");
+    test_assert(hl_ws_client_is_connected(client) || atomic_load(&disconnects) == 2,
+                "Second session opened");
+    test_assert(atomic_load(&connects) == 2, "Connect reported twice");
+    test_assert(wait_idle(client), "Second drop seen");
+
+    hl_ws_client_destroy(client);
+    pthread_join(thread, NULL);
+    close(server.listen_fd);
+
+    printf("✅ reconnect after drop test passed\n");
+    return TEST_PASS;
+}
+
+int main(void) {
+    printf("╔══════════════════════════════════════════╗\n");
+    printf("║  UNIT TESTS: WebSocket client lifecycle   ║\n");
+    printf("╚══════════════════════════════════════════╝\n\n");
+
+    test_func_t tests[] = {
+        test_ws_client_reconnect_after_drop
+    };
+
+    return test_run_suite("WebSocket Client Unit Tests", tests,
+                          sizeof(tests)/sizeof(test_func_t));
+}
@@ -0,0 +1,150 @@
+/**
+ * @file test_ws_feed.c
+ * @brief Dual-feed dedup keys and first-copy arbitration
+ *
+ * Copies are fed by hand with chosen receive times; no connection is
+ * opened.
+ */
+
+#include "../helpers/test_common.h"
+#include "../../include/hl_internal.h"
+
+#define T0 1708622398700000000LL
+#define MS 1000000LL
+
+/**
+ * @brief Keys separate channel, coin and both stamps, and are never empty
+ */
+test_result_t test_feed_key(void) {
+    uint64_t key = hl_ws_feed_key("l2Book", "BTC", 1708622398700, 0);
+
+    test_assert(key != 0 && (key & 1), "Never the empty marker");
+    test_assert(key == hl_ws_feed_key("l2Book", "BTC", 1708622398700, 0), "Deterministic");
+    test_assert(key != hl_ws_feed_key("bbo", "BTC", 1708622398700, 0), "Channel");
+    test_assert(key != hl_ws_feed_key("l2Book", "ETH", 1708622398700, 0), "Coin");
+    test_assert(key != hl_ws_feed_key("l2Book", "BTC", 1708622398701, 0), "Time");
+    test_assert(hl_ws_feed_key("trades", "BTC", 1708622398700, 91) !=
+                hl_ws_feed_key("trades", "BTC", 1708622398700, 92), "Trade id");
+    // The separator keeps channel and coin apart
+    test_assert(hl_ws_feed_key("bbo", "XBTC", 1, 0) != hl_ws_feed_key("bboX", "BTC", 1, 0),
+                "Channel and coin boundary");
+    test_assert(hl_ws_feed_key("", "", 0, 0) != 0, "Empty fields");
+
+    printf("✅ feed key test passed\n");
+    return TEST_PASS;
+}
+
+/**
+ * @brief First copy delivered, second dropped with its lag recorded
+ */
+test_result_t test_feed_admit(void) {
+    hl_ws_feed_arbiter_t arbiter;
+    test_assert(hl_ws_feed_arbiter_init(&arbiter), "Arbiter created");
+    uint64_t a = hl_ws_feed_key("l2Book", "BTC", 1, 0);
+    uint64_t b = hl_ws_feed_key("l2Book", "BTC", 2, 0);
+
+    test_assert(hl_ws_feed_admit(&arbiter, 0, a, T0), "Primary first");
+    test_assert(!hl_ws_feed_admit(&arbiter, 1, a, T0 + 3 * MS), "Backup copy dropped");
+    test_assert(hl_ws_feed_admit(&arbiter, 1, b, T0 + 5 * MS), "Backup first");
+    test_assert(!hl_ws_feed_admit(&arbiter, 0, b, T0 + 6 * MS), "Primary copy dropped");
+
+    const hl_ws_feed_tally_t* primary = &arbiter.tally[0];
+    const hl_ws_feed_tally_t* backup = &arbiter.tally[1];
+    test_assert(primary->messages == 2 && primary->wins == 1, "Primary tally");
+    test_assert(backup->messages == 2 && backup->wins == 1, "Backup tally");
+    test_assert(backup->lag.total == 1 && backup->lag.values[0] == 3.0, "Backup lag");
+    test_assert(primary->lag.total == 1 && primary->lag.values[0] == 1.0, "Primary lag");
+
+    // A pair clears its slot: a third copy is a new message
+    test_assert(hl_ws_feed_admit(&arbiter, 1, a, T0 + 7 * MS), "Late repeat delivered");
+    // Repeats on the feed that won are not duplicates of the other feed
+    test_assert(hl_ws_feed_admit(&arbiter, 1, a, T0 + 8 * MS), "Same feed repeat");
+    test_assert(backup->wins == 3 && backup->lag.total == 1, "Repeats are wins");
+
+    hl_ws_feed_arbiter_free(&arbiter);
+    printf("✅ feed admit test passed\n");
+    return TEST_PASS;
+}
+
+/**
+ * @brief A copy read first that loses the lock is a loss with zero lag
+ */
+test_result_t test_feed_admit_read_order(void) {
+    hl_ws_feed_arbiter_t arbiter;
+    test_assert(hl_ws_feed_arbiter_init(&arbiter), "Arbiter created");
+    uint64_t key = hl_ws_feed_key("trades", "ETH", 1, 77);
+
+    test_assert(hl_ws_feed_admit(&arbiter, 1, key, T0 + 2 * MS), "Backup took the lock first");
+    test_assert(!hl_ws_feed_admit(&arbiter, 0, key, T0), "Primary read earlier, dropped");
+    test_assert(arbiter.tally[0].wins == 0 && arbiter.tally[0].lag.values[0] == 0.0,
+                "Counted as a loss with no lag");
+
+    // Another key in the same slot evicts the first; its copy is delivered again
+    uint64_t other = key + HL_WS_FEED_SEEN_SLOTS;
+    test_assert(hl_ws_feed_admit(&arbiter, 0, key, T0 + 3 * MS), "Fresh copy");
+    test_assert(hl_ws_feed_admit(&arbiter, 0, other, T0 + 4 * MS), "Colliding key");
+    test_assert(hl_ws_feed_admit(&arbiter, 1, key, T0 + 5 * MS), "Evicted key delivered");
+
+    hl_ws_feed_arbiter_free(&arbiter);
+    printf("✅ feed read order test passed\n");
+    return TEST_PASS;
+}
+
+/**
+ * @brief Win counts and lag percentiles over a long race
+ */
+test_result_t test_feed_lag_stats(void) {
+    hl_ws_feed_arbiter_t arbiter;
+    test_assert(hl_ws_feed_arbiter_init(&arbiter), "Arbiter created");
+
+    // Primary wins three in four by up to 99 ms; the backup wins the rest by 1 ms
+    uint64_t primary_wins = 0;
+    for (int64_t i = 0; i < 1000; i++) {
+        uint64_t key = hl_ws_feed_key("bbo", "SOL", 1700000000000 + i, 0);
+        int64_t at = T0 + i * 1000 * MS;
+        if (i % 4 != 3) {
+            hl_ws_feed_admit(&arbiter, 0, key, at);
+            hl_ws_feed_admit(&arbiter, 1, key, at + (i % 100 + 1) * MS);
+            primary_wins++;
+        } else {
+            hl_ws_feed_admit(&arbiter, 1, key, at);
+            hl_ws_feed_admit(&arbiter, 0, key, at + MS);
+        }
+    }
+
+    const hl_ws_feed_tally_t* primary = &arbiter.tally[0];
+    const hl_ws_feed_tally_t* backup = &arbiter.tally[1];
+    test_assert(primary->messages == 1000 && backup->messages == 1000, "Every copy counted");
+    test_assert(primary->wins == primary_wins && backup->wins == 1000 - primary_wins, "Wins");
+    test_assert(primary->wins + backup->wins == 1000, "Each message delivered once");
+
+    hl_ws_latency_t lag;
+    hl_ws_window_summarize(&primary->lag, &lag);
+    test_assert(lag.total_samples == 250 && lag.min == 1.0 && lag.max == 1.0,
+                "Primary lost by 1 ms");
+    hl_ws_window_summarize(&backup->lag, &lag);
+    test_assert(lag.total_samples == 750 && lag.window_samples == HL_WS_STATS_WINDOW,
+                "Backup lag window");
+    test_assert(lag.min == 1.0 && lag.max == 99.0, "Backup lag range");
+    test_assert(lag.p50 > 40.0 && lag.p50 < 60.0 && lag.p99 >= 98.0, "Backup lag percentiles");
+
+    hl_ws_feed_arbiter_free(&arbiter);
+    printf("✅ feed lag statistics test passed\n");
+    return TEST_PASS;
+}
+
+int main(void) {
+    printf("╔══════════════════════════════════════════╗\n");
+    printf("║  UNIT TESTS: Dual-feed arbitration        ║\n");
+    printf("╚══════════════════════════════════════════╝\n\n");
+
+    test_func_t tests[] = {
+        test_feed_key,
+        test_feed_admit,
+        test_feed_admit_read_order,
+        test_feed_lag_stats
+    };
+
+    return test_run_suite("Dual-Feed Arbitration Unit Tests", tests,
+                          sizeof(tests)/sizeof(test_func_t));
+}
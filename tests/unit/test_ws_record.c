@@ -0,0 +1,326 @@
+/**
+ * @file test_ws_record.c
+ * @brief Capture files: recorder and replay round trips
+ *
+ * Captures are written to temporary files, read back through the mapped
+ * replay reader and checked byte for byte against what was recorded.
+ */
+
+#define _GNU_SOURCE
+
+#include "../helpers/test_common.h"
+#include "../../include/hl_ws_record.h"
+#include <stdint.h>
+#include <time.h>
+#include <sys/stat.h>
+
+#define HEADER_SIZE 32
+#define PREFIX_SIZE 16
+#define BASE_TIME_NS 1708622398000000000LL
+
+static const char* MESSAGES[] = {
+    "",
+    "{}",
+    "1234567",
+    "12345678",
+    "{\"channel\":\"pong\"}",
+    "{\"channel\":\"trades\",\"data\":[{\"coin\":\"BTC\",\"side\":\"B\",\"px\":\"51235.0\","
+    "\"sz\":\"0.01\",\"time\":1708622398623,\"tid\":118906512037719}]}"
+};
+#define MESSAGE_COUNT (sizeof(MESSAGES) / sizeof(MESSAGES[0]))
+
+static void temp_path(char path[64]) {
+    snprintf(path, 64, "/tmp/test_ws_record_XXXXXX");
+    int fd = mkstemp(path);
+    test_assert(fd >= 0, "Create temporary file");
+    close(fd);
+}
+
+static int64_t message_time(size_t i) {
+    return BASE_TIME_NS + (int64_t)i * 25000000LL;
+}
+
+static void write_capture(const char* path, bool compress, const char* const* messages,
+                          size_t count) {
+    hl_ws_recorder_t* recorder = hl_ws_recorder_open(path, compress);
+    test_assert(recorder != NULL, "Open recorder");
+    for (size_t i = 0; i < count; i++) {
+        test_assert(hl_ws_recorder_write(recorder, messages[i], strlen(messages[i]),
+                                         message_time(i)), "Write record");
+    }
+    test_assert(hl_ws_recorder_count(recorder) == count, "Recorder count");
+    hl_ws_recorder_close(recorder);
+}
+
+static size_t file_size(const char* path) {
+    struct stat st;
+    test_assert(stat(path, &st) == 0, "Stat capture");
+    return (size_t)st.st_size;
+}
+
+/**
+ * @brief Read a capture back and compare every record
+ */
+static void check_replay(const char* path, const char* const* messages, size_t count) {
+    hl_ws_replay_t* replay = hl_ws_replay_open(path);
+    test_assert(replay != NULL, "Open replay");
+
+    const char* message;
+    size_t size;
+    int64_t recv_time_ns;
+    for (size_t i = 0; i < count; i++) {
+        test_assert(hl_ws_replay_next(replay, &message, &size, &recv_time_ns), "Read record");
+        test_assert(size == strlen(messages[i]), "Record length");
+        test_assert(memcmp(message, messages[i], size) == 0, "Record bytes");
+        test_assert(message[size] == '\0', "Record is NUL-terminated");
+        test_assert(recv_time_ns == message_time(i), "Record timestamp");
+    }
+    test_assert(!hl_ws_replay_next(replay, &message, &size, &recv_time_ns), "End of capture");
+
+    hl_ws_replay_close(replay);
+}
+
+/**
+ * @brief Uncompressed records: layout, padding and zero-copy reads
+ */
+test_result_t test_ws_record_uncompressed(void) {
+    char path[64];
+    temp_path(path);
+    write_capture(path, false, MESSAGES, MESSAGE_COUNT);
+
+    // Every record pads to 8 bytes with at least one NUL
+    size_t expected = HEADER_SIZE;
+    for (size_t i = 0; i < MESSAGE_COUNT; i++) {
+        expected += PREFIX_SIZE + ((strlen(MESSAGES[i]) + 8) & ~(size_t)7);
+    }
+    test_assert(file_size(path) == expected, "File size includes padding");
+
+    uint8_t header[HEADER_SIZE];
+    FILE* file = fopen(path, "rb");
+    test_assert(file && fread(header, 1, sizeof(header), file) == sizeof(header), "Read header");
+    fclose(file);
+    uint32_t version, flags;
+    memcpy(&version, header + 8, sizeof(version));
+    memcpy(&flags, header + 12, sizeof(flags));
+    test_assert(memcmp(header, HL_WS_RECORD_MAGIC, 8) == 0, "Magic");
+    test_assert(version == HL_WS_RECORD_VERSION, "Version");
+    test_assert(flags == 0, "Not flagged as compressed");
+
+    check_replay(path, MESSAGES, MESSAGE_COUNT);
+
+    // Verbatim records are returned in place, 8-byte aligned
+    hl_ws_replay_t* replay = hl_ws_replay_open(path);
+    const char* message;
+    size_t size;
+    while (hl_ws_replay_next(replay, &message, &size, NULL)) {
+        test_assert((uintptr_t)message % 8 == 0, "Record aligned in the mapping");
+    }
+    hl_ws_replay_close(replay);
+
+    unlink(path);
+    printf("✅ uncompressed round trip test passed\n");
+    return TEST_PASS;
+}
+
+/**
+ * @brief Compressed records, and small records that are stored verbatim
+ */
+test_result_t test_ws_record_compressed(void) {
+    static char book[8192];
+    size_t len = 0;
+    len += (size_t)snprintf(book + len, sizeof(book) - len,
+                            "{\"channel\":\"l2Book\",\"data\":{\"coin\":\"BTC\",\"levels\":[[");
+    for (int i = 0; i < 100; i++) {
+        len += (size_t)snprintf(book + len, sizeof(book) - len,
+                                "%s{\"px\":\"%d.0\",\"sz\":\"1.5\",\"n\":3}", i ? "," : "",
+                                51000 - i);
+    }
+    snprintf(book + len, sizeof(book) - len, "],[]]}}");
+
+    const char* messages[] = { book, "{}", MESSAGES[5], book };
+    size_t count = sizeof(messages) / sizeof(messages[0]);
+
+    char path[64];
+    temp_path(path);
+    write_capture(path, true, messages, count);
+
+    // The book deflates; "{}" would grow and is kept as is
+    FILE* file = fopen(path, "rb");
+    uint8_t header[HEADER_SIZE];
+    uint32_t lens[2];
+    test_assert(file && fread(header, 1, sizeof(header), file) == sizeof(header) &&
+                fread(lens, sizeof(uint32_t), 2, file) == 2, "Read first prefix");
+    fclose(file);
+    uint32_t flags;
+    memcpy(&flags, header + 12, sizeof(flags));
+    test_assert(flags == HL_WS_RECORD_FLAG_COMPRESSED, "Flagged as compressed");
+    test_assert(lens[1] == strlen(book) && lens[0] < lens[1] / 4, "Book stored deflated");
+    test_assert(file_size(path) < strlen(book), "Capture smaller than one book");
+
+    check_replay(path, messages, count);
+
+    unlink(path);
+    printf("✅ compressed round trip test passed\n");
+    return TEST_PASS;
+}
+
+/**
+ * @brief A record cut short at the end of the file is not returned
+ */
+test_result_t test_ws_record_truncated(void) {
+    char path[64];
+    temp_path(path);
+    write_capture(path, false, MESSAGES, MESSAGE_COUNT);
+    size_t full = file_size(path);
+
+    const char* message;
+    size_t size;
+    int64_t recv_time_ns;
+
+    // Lose the tail of the last record, then its whole body, then part of its prefix
+    size_t last = PREFIX_SIZE + ((strlen(MESSAGES[MESSAGE_COUNT - 1]) + 8) & ~(size_t)7);
+    size_t cuts[] = { 1, last - PREFIX_SIZE, last - 4 };
+    for (size_t c = 0; c < sizeof(cuts) / sizeof(cuts[0]); c++) {
+        test_assert(truncate(path, (off_t)(full - cuts[c])) == 0, "Truncate capture");
+
+        hl_ws_replay_t* replay = hl_ws_replay_open(path);
+        test_assert(replay != NULL, "Open truncated capture");
+        size_t read = 0;
+        while (hl_ws_replay_next(replay, &message, &size, &recv_time_ns)) {
+            test_assert(memcmp(message, MESSAGES[read], size) == 0, "Complete records intact");
+            read++;
+        }
+        test_assert(read == MESSAGE_COUNT - 1, "Partial record dropped");
+        test_assert(!hl_ws_replay_next(replay, &message, &size, &recv_time_ns),
+                    "Stays at the end");
+        hl_ws_replay_close(replay);
+    }
+
+    // Header only; shorter than a header; not a capture
+    test_assert(truncate(path, HEADER_SIZE) == 0, "Truncate to header");
+    hl_ws_replay_t* replay = hl_ws_replay_open(path);
+    test_assert(replay && !hl_ws_replay_next(replay, &message, &size, NULL), "Empty capture");
+    hl_ws_replay_close(replay);
+
+    test_assert(truncate(path, HEADER_SIZE - 1) == 0, "Truncate into header");
+    test_assert(hl_ws_replay_open(path) == NULL, "Short file refused");
+
+    FILE* file = fopen(path, "wb");
+    char junk[HEADER_SIZE * 2];
+    memset(junk, 'x', sizeof(junk));
+    test_assert(file && fwrite(junk, 1, sizeof(junk), file) == sizeof(junk), "Write junk");
+    fclose(file);
+    test_assert(hl_ws_replay_open(path) == NULL, "Bad magic refused");
+
+    unlink(path);
+    printf("✅ truncated capture test passed\n");
+    return TEST_PASS;
+}
+
+/**
+ * @brief Rewind restarts at the first record
+ */
+test_result_t test_ws_record_rewind(void) {
+    char path[64];
+    temp_path(path);
+    write_capture(path, true, MESSAGES, MESSAGE_COUNT);
+
+    hl_ws_replay_t* replay = hl_ws_replay_open(path);
+    test_assert(replay != NULL, "Open replay");
+
+    const char* message;
+    size_t size;
+    for (int pass = 0; pass < 2; pass++) {
+        size_t read = 0;
+        while (hl_ws_replay_next(replay, &message, &size, NULL)) {
+            test_assert(size == strlen(MESSAGES[read]) &&
+                        memcmp(message, MESSAGES[read], size) == 0, "Same records after rewind");
+            read++;
+        }
+        test_assert(read == MESSAGE_COUNT, "Every record on each pass");
+
+        hl_ws_replay_rewind(replay);
+        test_assert(hl_ws_replay_time_ns(replay) == 0, "Rewind clears the timestamp");
+    }
+
+    hl_ws_replay_close(replay);
+    unlink(path);
+    printf("✅ rewind test passed\n");
+    return TEST_PASS;
+}
+
+typedef struct {
+    hl_ws_replay_t* replay;
+    size_t delivered;
+    bool timestamps_match;
+} replay_state_t;
+
+static void replay_callback(const char* message, size_t size, void* user_data) {
+    replay_state_t* state = (replay_state_t*)user_data;
+    (void)message;
+    (void)size;
+    if (hl_ws_replay_time_ns(state->replay) != message_time(state->delivered)) {
+        state->timestamps_match = false;
+    }
+    state->delivered++;
+}
+
+static double elapsed_ms(const struct timespec* start) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (double)(now.tv_sec - start->tv_sec) * 1e3 +
+           (double)(now.tv_nsec - start->tv_nsec) / 1e6;
+}
+
+/**
+ * @brief The callback sees each record's timestamp; pacing follows it
+ */
+test_result_t test_ws_record_replay_time(void) {
+    char path[64];
+    temp_path(path);
+    write_capture(path, false, MESSAGES, MESSAGE_COUNT);
+
+    hl_ws_replay_t* replay = hl_ws_replay_open(path);
+    test_assert(replay != NULL, "Open replay");
+    test_assert(hl_ws_replay_time_ns(replay) == 0, "No timestamp before the first record");
+
+    replay_state_t state = { replay, 0, true };
+    test_assert(hl_ws_replay_run(replay, 0.0, replay_callback, &state) == MESSAGE_COUNT,
+                "Unpaced run delivers every record");
+    test_assert(state.delivered == MESSAGE_COUNT && state.timestamps_match,
+                "Callback sees each record's timestamp");
+    test_assert(hl_ws_replay_time_ns(replay) == message_time(MESSAGE_COUNT - 1),
+                "Timestamp of the last record");
+
+    // Records span 125 ms; at double speed the run takes at least half that
+    hl_ws_replay_rewind(replay);
+    state.delivered = 0;
+    struct timespec start;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    test_assert(hl_ws_replay_run(replay, 2.0, replay_callback, &state) == MESSAGE_COUNT,
+                "Paced run delivers every record");
+    double span_ms = (double)(message_time(MESSAGE_COUNT - 1) - message_time(0)) / 1e6;
+    test_assert(elapsed_ms(&start) >= span_ms / 2.0, "Paced by recorded timestamps");
+    test_assert(state.timestamps_match, "Paced callback sees each timestamp");
+
+    hl_ws_replay_close(replay);
+    unlink(path);
+    printf("✅ replay timestamp test passed\n");
+    return TEST_PASS;
+}
+
+int main(void) {
+    printf("╔══════════════════════════════════════════╗\n");
+    printf("║  UNIT TESTS: Capture files                ║\n");
+    printf("╚══════════════════════════════════════════╝\n\n");
+
+    test_func_t tests[] = {
+        test_ws_record_uncompressed,
+        test_ws_record_compressed,
+        test_ws_record_truncated,
+        test_ws_record_rewind,
+        test_ws_record_replay_time
+    };
+
+    return test_run_suite("Capture File Unit Tests", tests, sizeof(tests)/sizeof(test_func_t));
+}
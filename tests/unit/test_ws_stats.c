@@ -0,0 +1,145 @@
+/**
+ * @file test_ws_stats.c
+ * @brief Latency windows and the server clock-offset estimator
+ *
+ * Samples are fed by hand; no connection is opened.
+ */
+
+#include "../helpers/test_common.h"
+#include "../../include/hl_internal.h"
+
+/**
+ * @brief Percentiles index the sorted window at (n - 1) * P / 100
+ */
+test_result_t test_window_percentiles(void) {
+    hl_ws_window_t window;
+    memset(&window, 0, sizeof(window));
+
+    hl_ws_latency_t latency;
+    hl_ws_window_summarize(&window, &latency);
+    test_assert(latency.window_samples == 0 && latency.total_samples == 0, "Empty window");
+    test_assert(latency.p50 == 0.0 && latency.max == 0.0, "Empty summary is zero");
+
+    // 1..100 in a scrambled order
+    for (int i = 0; i < 100; i++) {
+        hl_ws_window_add(&window, (double)((i * 37 + 37) % 100 + 1));
+    }
+    hl_ws_window_summarize(&window, &latency);
+    test_assert(latency.window_samples == 100 && latency.total_samples == 100, "Counts");
+    test_assert(latency.min == 1.0 && latency.max == 100.0, "Extremes");
+    test_assert(latency.mean == 50.5, "Mean");
+    test_assert(latency.p50 == 50.0, "Median");
+    test_assert(latency.p90 == 90.0, "90th percentile");
+    test_assert(latency.p99 == 99.0, "99th percentile");
+    test_assert(latency.last == (double)((99 * 37 + 37) % 100 + 1), "Last sample");
+
+    hl_ws_window_t single;
+    memset(&single, 0, sizeof(single));
+    hl_ws_window_add(&single, 4.5);
+    hl_ws_window_summarize(&single, &latency);
+    test_assert(latency.min == 4.5 && latency.p50 == 4.5 && latency.p99 == 4.5 &&
+                latency.max == 4.5, "One sample is every percentile");
+
+    printf("✅ window percentile test passed\n");
+    return TEST_PASS;
+}
+
+/**
+ * @brief The window keeps the latest samples and its minimum follows them
+ */
+test_result_t test_window_rolls(void) {
+    hl_ws_window_t window;
+    memset(&window, 0, sizeof(window));
+
+    for (int i = 0; i < HL_WS_STATS_WINDOW; i++) {
+        hl_ws_window_add(&window, (double)i);
+    }
+    test_assert(window.values[window.min_index] == 0.0, "Minimum of a full window");
+
+    // Overwrites the slot holding the minimum
+    hl_ws_window_add(&window, 1000.0);
+    test_assert(window.values[window.min_index] == 1.0, "Minimum rescanned");
+
+    for (int i = 0; i < 100; i++) {
+        hl_ws_window_add(&window, 2000.0 + i);
+    }
+    hl_ws_latency_t latency;
+    hl_ws_window_summarize(&window, &latency);
+    test_assert(latency.window_samples == HL_WS_STATS_WINDOW, "Window is capped");
+    test_assert(latency.total_samples == HL_WS_STATS_WINDOW + 101, "Every sample counted");
+    test_assert(latency.min == 101.0, "Old samples dropped");
+    test_assert(window.values[window.min_index] == latency.min, "Tracked minimum agrees");
+    test_assert(latency.max == 2099.0 && latency.last == 2099.0, "Newest sample");
+
+    printf("✅ rolling window test passed\n");
+    return TEST_PASS;
+}
+
+/**
+ * @brief Offset is the least delay less half the fastest round trip
+ */
+test_result_t test_clock_offset(void) {
+    hl_ws_clock_t clock;
+    memset(&clock, 0, sizeof(clock));
+
+    hl_ws_clock_add_rtt(&clock, 20.0);
+    test_assert(!clock.offset_valid, "No offset before a server timestamp");
+
+    test_assert(hl_ws_clock_add_delay(&clock, 50.0) == 10.0, "Age of the first sample");
+    test_assert(clock.offset_valid && clock.offset_ms == 40.0, "Delay minus half the RTT");
+
+    test_assert(hl_ws_clock_add_delay(&clock, 45.0) == 10.0, "Lower delay moves the offset");
+    test_assert(clock.offset_ms == 35.0, "New delay minimum");
+    test_assert(hl_ws_clock_add_delay(&clock, 60.0) == 25.0, "Higher delay is age");
+    test_assert(clock.offset_ms == 35.0, "Offset unchanged by a slower message");
+
+    hl_ws_clock_add_rtt(&clock, 30.0);
+    test_assert(clock.rtt_min_ms == 20.0 && clock.offset_ms == 35.0, "Slower ping ignored");
+    hl_ws_clock_add_rtt(&clock, 10.0);
+    test_assert(clock.rtt_min_ms == 10.0 && clock.offset_ms == 40.0, "Faster ping applied");
+
+    // A server clock ahead of ours gives a negative offset
+    test_assert(hl_ws_clock_add_delay(&clock, -100.0) == 5.0, "Half a round trip old");
+    test_assert(clock.offset_ms == -105.0, "Negative offset");
+
+    printf("✅ clock offset test passed\n");
+    return TEST_PASS;
+}
+
+/**
+ * @brief Without pings the offset is the bare delay minimum
+ */
+test_result_t test_clock_offset_follows_window(void) {
+    hl_ws_clock_t clock;
+    memset(&clock, 0, sizeof(clock));
+
+    hl_ws_clock_add_delay(&clock, 50.0);
+    test_assert(clock.offset_ms == 50.0, "No RTT to subtract");
+
+    // Once the old minimum leaves the window the offset follows the clocks
+    for (int i = 0; i < HL_WS_STATS_WINDOW; i++) {
+        hl_ws_clock_add_delay(&clock, 200.0 + i % 7);
+    }
+    test_assert(clock.offset_ms == 200.0, "Minimum of the current window");
+
+    hl_ws_clock_add_rtt(&clock, 8.0);
+    test_assert(clock.offset_ms == 196.0, "RTT applied to the current minimum");
+
+    printf("✅ clock offset window test passed\n");
+    return TEST_PASS;
+}
+
+int main(void) {
+    printf("╔══════════════════════════════════════════╗\n");
+    printf("║  UNIT TESTS: WebSocket timing statistics  ║\n");
+    printf("╚══════════════════════════════════════════╝\n\n");
+
+    test_func_t tests[] = {
+        test_window_percentiles,
+        test_window_rolls,
+        test_clock_offset,
+        test_clock_offset_follows_window
+    };
+
+    return test_run_suite("WebSocket Timing Unit Tests", tests, sizeof(tests)/sizeof(test_func_t));
+}
@@ -0,0 +1,167 @@
+/**
+ * @file test_ws_sync.c
+ * @brief Subscription set diffing and the send token bucket
+ *
+ * The bucket runs on a simulated clock; nothing is sent.
+ */
+
+#include "../helpers/test_common.h"
+#include "../../include/hl_internal.h"
+
+#define MINUTE_NS 60000000000LL
+#define TOKEN_NS (MINUTE_NS / HL_WS_MESSAGES_PER_MINUTE)
+
+static void refs(hl_ws_topic_ref_t* out, const char* const* subscriptions, size_t count) {
+    for (size_t i = 0; i < count; i++) {
+        out[i].subscription = subscriptions[i];
+        out[i].changed = false;
+    }
+}
+
+/**
+ * @brief Only dropped and new topics are marked, repeats added once
+ */
+test_result_t test_topic_diff(void) {
+    static const char* const now[] = { "A", "B", "C" };
+    static const char* const want[] = { "B", "D", "D", "A", "E" };
+    hl_ws_topic_ref_t current[3], wanted[5];
+    size_t added = 99, removed = 99;
+
+    refs(current, now, 3);
+    refs(wanted, want, 5);
+    hl_ws_topic_diff(current, 3, wanted, 5, &added, &removed);
+    test_assert(added == 2 && removed == 1, "Counts");
+    test_assert(!current[0].changed && !current[1].changed && current[2].changed,
+                "Only C dropped");
+    test_assert(!wanted[0].changed && wanted[1].changed && !wanted[2].changed &&
+                !wanted[3].changed && wanted[4].changed, "D once and E added");
+
+    // Same set in another order: nothing to send
+    static const char* const same[] = { "C", "A", "B" };
+    refs(wanted, same, 3);
+    hl_ws_topic_diff(current, 3, wanted, 3, &added, &removed);
+    test_assert(added == 0 && removed == 0, "Reordered set unchanged");
+
+    // Empty lists
+    hl_ws_topic_diff(current, 3, NULL, 0, &added, &removed);
+    test_assert(added == 0 && removed == 3, "Empty set drops everything");
+    refs(wanted, want, 5);
+    hl_ws_topic_diff(NULL, 0, wanted, 5, &added, &removed);
+    test_assert(added == 4 && !wanted[2].changed, "Fresh group adds distinct topics");
+
+    printf("✅ topic diff test passed\n");
+    return TEST_PASS;
+}
+
+/**
+ * @brief Rebalancing 150 of 1000 coins sends 150 of each
+ */
+test_result_t test_topic_diff_rebalance(void) {
+    static char names[HL_WS_MAX_SUBSCRIPTIONS + 150][48];
+    static hl_ws_topic_ref_t current[HL_WS_MAX_SUBSCRIPTIONS];
+    static hl_ws_topic_ref_t wanted[HL_WS_MAX_SUBSCRIPTIONS];
+
+    for (size_t i = 0; i < HL_WS_MAX_SUBSCRIPTIONS + 150; i++) {
+        snprintf(names[i], sizeof(names[i]), "{\"type\":\"l2Book\",\"coin\":\"C%zu\"}", i);
+    }
+    for (size_t i = 0; i < HL_WS_MAX_SUBSCRIPTIONS; i++) {
+        current[i].subscription = names[i];
+        wanted[i].subscription = names[i + 150];
+    }
+
+    size_t added = 0, removed = 0;
+    hl_ws_topic_diff(current, HL_WS_MAX_SUBSCRIPTIONS, wanted, HL_WS_MAX_SUBSCRIPTIONS,
+                     &added, &removed);
+    test_assert(added == 150 && removed == 150, "Only the changed coins");
+    for (size_t i = 0; i < HL_WS_MAX_SUBSCRIPTIONS; i++) {
+        test_assert(current[i].changed == (i < 150), "Dropped coins");
+        test_assert(wanted[i].changed == (i >= HL_WS_MAX_SUBSCRIPTIONS - 150), "New coins");
+    }
+    test_assert(HL_WS_MAX_SUBSCRIPTIONS - removed + added <= HL_WS_MAX_SUBSCRIPTIONS,
+                "Stays under the server limit");
+
+    printf("✅ topic diff rebalance test passed\n");
+    return TEST_PASS;
+}
+
+/**
+ * @brief A full minute's budget goes out at once, one batch per write
+ */
+test_result_t test_bucket_burst(void) {
+    hl_ws_bucket_t bucket;
+    int64_t t = 1000000000LL;
+    int64_t wait_ns = -1;
+    hl_ws_bucket_init(&bucket, t);
+
+    test_assert(hl_ws_bucket_take(&bucket, 7, t, &wait_ns) == 7 && wait_ns == 0, "Short write");
+    size_t sent = 7;
+    size_t take;
+    while ((take = hl_ws_bucket_take(&bucket, 100000, t, &wait_ns)) > 0) {
+        test_assert(take <= HL_WS_SEND_BATCH, "Batch cap");
+        sent += take;
+    }
+    test_assert(sent == HL_WS_MESSAGES_PER_MINUTE, "One minute's budget");
+    test_assert(wait_ns > TOKEN_NS - 10 && wait_ns <= TOKEN_NS + 1, "Wait for one token");
+
+    test_assert(hl_ws_bucket_take(&bucket, 5, t + wait_ns, &wait_ns) == 1, "One token later");
+    test_assert(hl_ws_bucket_take(&bucket, 5, t + TOKEN_NS / 2, &wait_ns) == 0,
+                "Earlier time does not refill");
+
+    // A long idle period refills one minute's budget, no more
+    t += 3600 * 1000000000LL;
+    sent = 0;
+    while ((take = hl_ws_bucket_take(&bucket, 100000, t, &wait_ns)) > 0) {
+        sent += take;
+    }
+    test_assert(sent == HL_WS_MESSAGES_PER_MINUTE, "Refill capped");
+
+    printf("✅ bucket burst test passed\n");
+    return TEST_PASS;
+}
+
+/**
+ * @brief Sustained sends run at 2000 a minute
+ */
+test_result_t test_bucket_rate(void) {
+    hl_ws_bucket_t bucket;
+    int64_t start = 5000000000LL;
+    int64_t t = start;
+    hl_ws_bucket_init(&bucket, t);
+
+    // Drain the burst, then keep sending as fast as the bucket allows
+    size_t sent = 0;
+    size_t in_last_minute = 0;
+    while (t < start + 10 * MINUTE_NS) {
+        int64_t wait_ns = 0;
+        size_t take = hl_ws_bucket_take(&bucket, HL_WS_SEND_BATCH, t, &wait_ns);
+        sent += take;
+        if (t >= start + 9 * MINUTE_NS) in_last_minute += take;
+        if (take == 0) {
+            test_assert(wait_ns > 0, "Told to wait");
+            t += wait_ns;
+        }
+    }
+
+    test_assert(sent >= 11 * HL_WS_MESSAGES_PER_MINUTE - 1 &&
+                sent <= 11 * HL_WS_MESSAGES_PER_MINUTE + 1, "Burst plus ten minutes' refill");
+    test_assert(in_last_minute <= HL_WS_MESSAGES_PER_MINUTE + 1, "Steady-state rate");
+    test_assert(in_last_minute >= HL_WS_MESSAGES_PER_MINUTE - 1, "Bucket never stalls");
+
+    printf("✅ bucket rate test passed\n");
+    return TEST_PASS;
+}
+
+int main(void) {
+    printf("╔══════════════════════════════════════════╗\n");
+    printf("║  UNIT TESTS: Subscription sync            ║\n");
+    printf("╚══════════════════════════════════════════╝\n\n");
+
+    test_func_t tests[] = {
+        test_topic_diff,
+        test_topic_diff_rebalance,
+        test_bucket_burst,
+        test_bucket_rate
+    };
+
+    return test_run_suite("Subscription Sync Unit Tests", tests, sizeof(tests)/sizeof(test_func_t));
+}